@@ -106,6 +106,10 @@ CaptureSettings::operator QVariant() const
   opts[lit("refAllResources")] = options.refAllResources;
   opts[lit("captureAllCmdLists")] = options.captureAllCmdLists;
   opts[lit("debugOutputMute")] = options.debugOutputMute;
+  opts[lit("captureMemoryBudgetMB")] = options.captureMemoryBudgetMB;
+  opts[lit("retroactiveFrames")] = options.retroactiveFrames;
+  opts[lit("retroactiveMemoryBudgetMB")] = options.retroactiveMemoryBudgetMB;
+  opts[lit("retroactiveCPUBudget")] = options.retroactiveCPUBudget;
   ret[lit("options")] = opts;
 
   ret[lit("queuedFrameCap")] = queuedFrameCap;
@@ -149,6 +153,12 @@ CaptureSettings::CaptureSettings(const QVariant &v)
   options.refAllResources = opts[lit("refAllResources")].toBool();
   options.captureAllCmdLists = opts[lit("captureAllCmdLists")].toBool();
   options.debugOutputMute = opts[lit("debugOutputMute")].toBool();
+  options.captureMemoryBudgetMB = opts[lit("captureMemoryBudgetMB")].toUInt();
+  options.retroactiveFrames = opts[lit("retroactiveFrames")].toUInt();
+  if(opts.contains(lit("retroactiveMemoryBudgetMB")))
+    options.retroactiveMemoryBudgetMB = opts[lit("retroactiveMemoryBudgetMB")].toUInt();
+  if(opts.contains(lit("retroactiveCPUBudget")))
+    options.retroactiveCPUBudget = opts[lit("retroactiveCPUBudget")].toUInt();
 
   if(data.contains(lit("queuedFrameCap")))
     queuedFrameCap = data[lit("queuedFrameCap")].toUInt();
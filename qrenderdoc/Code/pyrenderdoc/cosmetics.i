@@ -162,6 +162,10 @@ DEFINE_SAFE_EQUALITY(EnvironmentModification)
 DEFINE_SAFE_EQUALITY(EventUsage)
 DEFINE_SAFE_EQUALITY(PathEntry)
 DEFINE_SAFE_EQUALITY(PixelModification)
+DEFINE_SAFE_EQUALITY(ReplayChunkTiming)
+DEFINE_SAFE_EQUALITY(APICallTelemetry)
+DEFINE_SAFE_EQUALITY(ReplayEventTiming)
+DEFINE_SAFE_EQUALITY(ReplayPhaseTiming)
 DEFINE_SAFE_EQUALITY(ResourceDescription)
 DEFINE_SAFE_EQUALITY(ResourceId)
 DEFINE_SAFE_EQUALITY(LineColumnInfo)
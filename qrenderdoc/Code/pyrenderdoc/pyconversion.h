@@ -485,6 +485,145 @@ struct TypeConversion<rdcpair<A, B>, false>
   static PyObject *ConvertToPy(const rdcpair<A, B> &in) { return ConvertToPy(in, NULL); }
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+// read-only object that takes ownership of a native array's storage and exposes it through the
+// python buffer protocol. Returned wrapped in a memoryview, so it can be indexed, sliced, unpacked
+// with struct or wrapped by numpy without the data ever being copied into a python object.
+
+template <typename T>
+struct BufferFormat;
+
+#define BUFFER_FORMAT(type, fmt)                \
+  template <>                                   \
+  struct BufferFormat<type>                     \
+  {                                             \
+    static const char *format() { return fmt; } \
+  };
+
+BUFFER_FORMAT(uint8_t, "B")
+BUFFER_FORMAT(int8_t, "b")
+BUFFER_FORMAT(uint16_t, "H")
+BUFFER_FORMAT(int16_t, "h")
+BUFFER_FORMAT(uint32_t, "I")
+BUFFER_FORMAT(int32_t, "i")
+BUFFER_FORMAT(uint64_t, "Q")
+BUFFER_FORMAT(int64_t, "q")
+BUFFER_FORMAT(float, "f")
+BUFFER_FORMAT(double, "d")
+
+#undef BUFFER_FORMAT
+
+struct NativeBufferObject
+{
+  PyObject_HEAD
+
+  // the owned storage, and a function to free it again
+  void *storage;
+  void (*destroy)(void *storage);
+
+  void *data;
+  Py_ssize_t count;
+  Py_ssize_t itemSize;
+  const char *format;
+};
+
+inline int NativeBuffer_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  NativeBufferObject *buf = (NativeBufferObject *)self;
+
+  if(flags & PyBUF_WRITABLE)
+  {
+    view->obj = NULL;
+    PyErr_SetString(PyExc_BufferError, "native buffers are read-only");
+    return -1;
+  }
+
+  // PyBuffer_FillInfo only describes unsigned bytes, so fill out the view ourselves to be able to
+  // describe typed arrays
+  view->obj = self;
+  Py_INCREF(self);
+
+  view->buf = buf->data;
+  view->len = buf->count * buf->itemSize;
+  view->readonly = 1;
+  view->itemsize = buf->itemSize;
+  view->format = (flags & PyBUF_FORMAT) ? (char *)buf->format : NULL;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) ? &buf->count : NULL;
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &buf->itemSize : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+
+  return 0;
+}
+
+inline void NativeBuffer_dealloc(PyObject *self)
+{
+  NativeBufferObject *buf = (NativeBufferObject *)self;
+
+  buf->destroy(buf->storage);
+
+  Py_TYPE(self)->tp_free(self);
+}
+
+inline PyTypeObject *NativeBufferType()
+{
+  static PyBufferProcs bufferProcs = {&NativeBuffer_getbuffer, NULL};
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(NULL, 0)};
+  static bool ready = false;
+
+  if(ready)
+    return &type;
+
+  type.tp_name = "renderdoc.NativeBuffer";
+  type.tp_doc = "Read-only data owned by RenderDoc, accessible through the buffer protocol.";
+  type.tp_basicsize = sizeof(NativeBufferObject);
+  type.tp_flags = Py_TPFLAGS_DEFAULT;
+  type.tp_dealloc = &NativeBuffer_dealloc;
+  type.tp_as_buffer = &bufferProcs;
+
+  if(PyType_Ready(&type) < 0)
+    return NULL;
+
+  ready = true;
+
+  return &type;
+}
+
+// takes ownership of the array's storage by swapping it out, leaving the array empty, and returns
+// a memoryview over it.
+template <typename T>
+inline PyObject *MakeNativeBuffer(rdcarray<T> &in)
+{
+  PyTypeObject *type = NativeBufferType();
+  if(!type)
+    return NULL;
+
+  NativeBufferObject *buf = PyObject_New(NativeBufferObject, type);
+  if(!buf)
+    return NULL;
+
+  rdcarray<T> *storage = new rdcarray<T>;
+  storage->swap(in);
+
+  // empty arrays have no storage, but the buffer protocol requires a valid pointer
+  static T empty = T();
+
+  buf->storage = storage;
+  buf->destroy = [](void *s) { delete (rdcarray<T> *)s; };
+  buf->data = storage->empty() ? &empty : storage->data();
+  buf->count = (Py_ssize_t)storage->size();
+  buf->itemSize = (Py_ssize_t)sizeof(T);
+  buf->format = BufferFormat<T>::format();
+
+  PyObject *view = PyMemoryView_FromObject((PyObject *)buf);
+
+  // the memoryview holds its own reference if it was created
+  Py_DECREF(buf);
+
+  return view;
+}
+
 // specialisation for bytebuf
 template <>
 struct TypeConversion<bytebuf, false>
@@ -493,13 +632,23 @@ struct TypeConversion<bytebuf, false>
   // nicer failure error messages out with the index that failed
   static int ConvertFromPy(PyObject *in, bytebuf &out, int *failIdx)
   {
-    if(!PyBytes_Check(in))
+    // accept anything that exposes contiguous bytes - bytes, bytearray, memoryview, numpy arrays -
+    // so callers don't need to make an intermediate bytes copy
+    if(!PyObject_CheckBuffer(in))
       return SWIG_TypeError;
 
-    Py_ssize_t len = PyBytes_Size(in);
+    Py_buffer view = {};
+
+    if(PyObject_GetBuffer(in, &view, PyBUF_CONTIG_RO) != 0)
+    {
+      PyErr_Clear();
+      return SWIG_TypeError;
+    }
+
+    out.resize((size_t)view.len);
+    memcpy(out.data(), view.buf, out.size());
 
-    out.resize((size_t)len);
-    memcpy(out.data(), PyBytes_AsString(in), out.size());
+    PyBuffer_Release(&view);
 
     return SWIG_OK;
   }
@@ -517,6 +666,9 @@ struct TypeConversion<bytebuf, false>
   }
 
   static PyObject *ConvertToPy(const bytebuf &in) { return ConvertToPy(in, NULL); }
+  // bytebufs returned by value are temporaries, so instead of copying into a bytes object we take
+  // their storage and return a read-only memoryview over it
+  static PyObject *ConvertToPyMove(bytebuf &in) { return MakeNativeBuffer(in); }
 };
 
 // specialisation for array
@@ -96,6 +96,18 @@
 }
 %typemap(freearg) rdcarray<rdcstr> *supportedProtocols { }
 
+// same for RENDERDOC_GetRemoteServerStats
+%typemap(in, numinputs=0) RemoteServerStats *stats (RemoteServerStats outStats) { $1 = &outStats; }
+%typemap(argout) RemoteServerStats *stats {
+  PyObject *retVal = $result;
+  $result = PyTuple_New(2);
+  if($result)
+  {
+    PyTuple_SetItem($result, 0, retVal);
+    PyTuple_SetItem($result, 1, SWIG_NewPointerObj(new RemoteServerStats(outStats$argnum), $descriptor(struct RemoteServerStats*), SWIG_POINTER_OWN));
+  }
+}
+
 // same for RENDERDOC_CreateRemoteServerConnection
 %typemap(in, numinputs=0) IRemoteServer **rend (IRemoteServer *outRenderer) {
   outRenderer = NULL;
@@ -178,6 +190,18 @@ SIMPLE_TYPEMAPS(rdcstr)
 SIMPLE_TYPEMAPS(rdcdatetime)
 SIMPLE_TYPEMAPS(bytebuf)
 
+// bytebufs returned by value from functions (e.g. GetBufferData/GetTextureData) are temporaries, so
+// python can take over their storage directly instead of copying. Struct members are still copied
+// into bytes objects
+%typemap(out) bytebuf {
+  $result = TypeConversion<bytebuf>::ConvertToPyMove(($1_ltype &)$1);
+}
+
+// similarly return the histogram as a typed read-only view instead of building a list
+%typemap(out) rdcarray<uint32_t> GetHistogram {
+  $result = MakeNativeBuffer(($1_ltype &)$1);
+}
+
 FIXED_ARRAY_TYPEMAPS(ResourceId)
 FIXED_ARRAY_TYPEMAPS(double)
 FIXED_ARRAY_TYPEMAPS(float)
@@ -292,6 +316,11 @@ TEMPLATE_ARRAY_INSTANTIATE(rdcarray, DebugMessage)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, EnvironmentModification)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, EventUsage)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PathEntry)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, RemoteServerSession)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ReplayChunkTiming)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, APICallTelemetry)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ReplayEventTiming)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ReplayPhaseTiming)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PixelModification)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceDescription)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceId)
@@ -150,9 +150,21 @@ public:
     RDTreeWidgetItem *parentItem = itemForIndex(parent);
 
     if(parentItem)
-      return parentItem->childCount() > 0;
+      return parentItem->childCount() > 0 || parentItem->m_lazyChildren;
     return false;
   }
+
+  bool canFetchMore(const QModelIndex &parent) const override
+  {
+    RDTreeWidgetItem *parentItem = itemForIndex(parent);
+
+    return parentItem && parentItem->m_lazyChildren;
+  }
+
+  void fetchMore(const QModelIndex &parent) override
+  {
+    widget->populateLazyChildren(itemForIndex(parent));
+  }
   Qt::ItemFlags flags(const QModelIndex &index) const override
   {
     if(!index.isValid())
@@ -710,8 +722,20 @@ RDTreeWidgetItem *RDTreeWidget::itemAt(const QPoint &p) const
   return m_model->itemForIndex(indexAt(p));
 }
 
+void RDTreeWidget::populateLazyChildren(RDTreeWidgetItem *item)
+{
+  if(!item || !item->m_lazyChildren)
+    return;
+
+  // clear the flag first so that adding children doesn't re-enter
+  item->m_lazyChildren = false;
+  emit populateItem(item);
+}
+
 void RDTreeWidget::expandItem(RDTreeWidgetItem *item)
 {
+  // populate synchronously, so that callers walking the children after expanding see them
+  populateLazyChildren(item);
   expand(m_model->indexForItem(item, 0));
 }
 void RDTreeWidget::expandAllItems(RDTreeWidgetItem *item)
@@ -66,6 +66,10 @@ public:
   void clear();
   inline int dataCount() const { return m_text.count(); }
   inline int childCount() const { return m_children.count(); }
+  // marks the item as having children that haven't been added yet. The widget will emit
+  // populateItem() the first time they're needed, e.g. when the item is expanded.
+  inline void setLazyChildren(bool lazy) { m_lazyChildren = lazy; }
+  inline bool lazyChildren() const { return m_lazyChildren; }
   inline RDTreeWidgetItem *parent() const { return m_parent; }
   inline RDTreeWidget *treeWidget() const { return m_widget; }
   inline void setBold(bool bold)
@@ -167,6 +171,7 @@ private:
   QBrush m_back;
   QBrush m_fore;
   QVariant m_tag;
+  bool m_lazyChildren = false;
 };
 
 class RDTreeWidgetItemIterator
@@ -248,6 +253,7 @@ public:
 
   RDTreeWidgetItem *itemAt(const QPoint &p) const;
   RDTreeWidgetItem *itemAt(int x, int y) const { return itemAt(QPoint(x, y)); }
+  void populateLazyChildren(RDTreeWidgetItem *item);
   void expandItem(RDTreeWidgetItem *item);
   void expandAllItems(RDTreeWidgetItem *item);
   void collapseItem(RDTreeWidgetItem *item);
@@ -267,6 +273,7 @@ signals:
   void currentItemChanged(RDTreeWidgetItem *current, RDTreeWidgetItem *previous);
   void hoverItemChanged(RDTreeWidgetItem *item);
   void itemSelectionChanged();
+  void populateItem(RDTreeWidgetItem *item);
 
 public slots:
 
@@ -24,6 +24,7 @@
 
 #include "BufferViewer.h"
 #include <float.h>
+#include <QCache>
 #include <QDoubleSpinBox>
 #include <QFontDatabase>
 #include <QItemSelection>
@@ -572,12 +573,14 @@ public:
   {
     emit beginResetModel();
     config.reset();
+    displayCache.clear();
   }
   void endReset(const BufferConfiguration &conf)
   {
     config = conf;
     cacheColumns();
     totalColumnCount = columnLookup.count() + reservedColumnCount();
+    displayCache.clear();
     emit endResetModel();
   }
   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override
@@ -781,114 +784,25 @@ public:
 
       if(role == Qt::DisplayRole)
       {
-        if(config.unclampedNumRows > 0 && row >= config.numRows - 2)
-        {
-          if(col < 2 && row == config.numRows - 1)
-            return QString::number(config.unclampedNumRows - config.numRows);
-
-          return lit("...");
-        }
-
         if(col >= 0 && col < totalColumnCount && row < config.numRows)
         {
-          if(col == 0)
-            return row;
-
-          uint32_t idx = row;
-
-          if(config.indices && config.indices->hasData())
-          {
-            idx = CalcIndex(config.indices, row, config.baseVertex, config.primRestart);
-
-            if(config.primRestart && idx == config.primRestart)
-              return col == 1 ? lit("--") : lit(" Restart");
-
-            if(idx == ~0U)
-              return outOfBounds();
-          }
-
-          if(col == 1 && meshView)
-          {
-            // if we have separate displayIndices, fetch that for display instead
-            if(config.displayIndices && config.displayIndices->hasData())
-              idx = CalcIndex(config.displayIndices, row, config.displayBaseVertex,
-                              config.primRestart);
-
-            if(idx == ~0U)
-              return outOfBounds();
-
-            return idx;
-          }
+          // rows are decoded in blocks and cached, so repeated paints while scrolling or resizing
+          // only index into already formatted data.
+          uint32_t block = row / DisplayCacheBlockRows;
 
-          const FormatElement &el = elementForColumn(col);
-
-          if(useGenerics(col))
-            return interpretGeneric(col, el);
-
-          uint32_t instIdx = 0;
-          if(el.instancerate > 0)
-            instIdx = config.curInstance / el.instancerate;
+          const QVector<QVariant> *blockData = displayCache.object(block);
 
-          if(el.buffer < config.buffers.size())
+          if(!blockData)
           {
-            const byte *data = config.buffers[el.buffer]->data();
-            const byte *end = config.buffers[el.buffer]->end();
-
-            if(!el.perinstance)
-              data += config.buffers[el.buffer]->stride * idx;
-            else
-              data += config.buffers[el.buffer]->stride * instIdx;
-
-            data += el.offset;
-
-            // only slightly wasteful, we need to fetch all variants together
-            // since some formats are packed and can't be read individually
-            QVariantList list = el.GetVariants(data, end);
-
-            int comp = componentForIndex(col);
+            uint32_t firstRow = block * DisplayCacheBlockRows;
+            QVector<QVariant> *decoded = new QVector<QVariant>;
+            decodeRows(firstRow, qMin(DisplayCacheBlockRows, config.numRows - firstRow), *decoded);
 
-            if(comp < list.count())
-            {
-              uint32_t rowdim = el.matrixdim;
-              uint32_t coldim = el.format.compCount;
-
-              if(rowdim == 1)
-              {
-                QVariant v;
-
-                if(el.rowmajor)
-                  v = list[comp];
-                else
-                  v = list[comp * rowdim];
-
-                RichResourceTextInitialise(v);
-
-                if(RichResourceTextCheck(v))
-                  return v;
-
-                return interpretVariant(v, el);
-              }
-              else
-              {
-                QString ret;
-
-                for(uint32_t r = 0; r < rowdim; r++)
-                {
-                  if(r > 0)
-                    ret += lit("\n");
-
-                  if(el.rowmajor)
-                    ret += interpretVariant(list[comp + r * coldim], el);
-                  else
-                    ret += interpretVariant(list[r + comp * rowdim], el);
-                }
-
-                return ret;
-              }
-            }
+            blockData = decoded;
+            displayCache.insert(block, decoded, decoded->count());
           }
 
-          return outOfBounds();
+          return blockData->at((row % DisplayCacheBlockRows) * totalColumnCount + col);
         }
       }
     }
@@ -965,6 +879,130 @@ public:
   }
 
   const BufferConfiguration &getConfig() { return config; }
+  // decode and format the display data for a range of rows in bulk, with one entry per column for
+  // each row. Each row's index is only calculated once, and each element is only decoded once for
+  // all of its component columns.
+  // This doesn't touch any cached data so it's safe to call from a background thread, as long as
+  // the model isn't reset at the same time.
+  void decodeRows(uint32_t firstRow, uint32_t numRows, QVector<QVariant> &out) const
+  {
+    const int numCols = totalColumnCount;
+    const int reserved = reservedColumnCount();
+
+    out.resize(int(numRows) * numCols);
+
+    for(uint32_t r = 0; r < numRows; r++)
+    {
+      const uint32_t row = firstRow + r;
+      QVariant *rowOut = out.data() + r * numCols;
+
+      if(config.unclampedNumRows > 0 && row >= config.numRows - 2)
+      {
+        for(int col = 0; col < numCols; col++)
+        {
+          if(col < 2 && row == config.numRows - 1)
+            rowOut[col] = QString::number(config.unclampedNumRows - config.numRows);
+          else
+            rowOut[col] = lit("...");
+        }
+
+        continue;
+      }
+
+      rowOut[0] = row;
+
+      uint32_t idx = row;
+
+      if(config.indices && config.indices->hasData())
+      {
+        idx = CalcIndex(config.indices, row, config.baseVertex, config.primRestart);
+
+        if(config.primRestart && idx == config.primRestart)
+        {
+          for(int col = 1; col < numCols; col++)
+            rowOut[col] = col == 1 ? lit("--") : lit(" Restart");
+
+          continue;
+        }
+
+        if(idx == ~0U)
+        {
+          for(int col = 1; col < numCols; col++)
+            rowOut[col] = outOfBounds();
+
+          continue;
+        }
+      }
+
+      if(meshView)
+      {
+        uint32_t displayIdx = idx;
+
+        // if we have separate displayIndices, fetch that for display instead
+        if(config.displayIndices && config.displayIndices->hasData())
+          displayIdx =
+              CalcIndex(config.displayIndices, row, config.displayBaseVertex, config.primRestart);
+
+        if(displayIdx == ~0U)
+          rowOut[1] = outOfBounds();
+        else
+          rowOut[1] = displayIdx;
+      }
+
+      int col = reserved;
+
+      while(col < numCols)
+      {
+        const int elIdx = columnLookup[col - reserved];
+        const FormatElement &el = config.columns[elIdx];
+
+        // all of an element's component columns are contiguous
+        int elCols = 1;
+        while(col + elCols < numCols && columnLookup[col + elCols - reserved] == elIdx)
+          elCols++;
+
+        if(useGenerics(col))
+        {
+          for(int c = 0; c < elCols; c++)
+            rowOut[col + c] = interpretGeneric(col + c, el);
+        }
+        else
+        {
+          QVariantList list;
+
+          if(el.buffer < config.buffers.size())
+          {
+            uint32_t instIdx = 0;
+            if(el.instancerate > 0)
+              instIdx = config.curInstance / el.instancerate;
+
+            const byte *data = config.buffers[el.buffer]->data();
+            const byte *end = config.buffers[el.buffer]->end();
+
+            if(!el.perinstance)
+              data += config.buffers[el.buffer]->stride * idx;
+            else
+              data += config.buffers[el.buffer]->stride * instIdx;
+
+            data += el.offset;
+
+            // we need to fetch all variants together since some formats are packed and can't be
+            // read individually, but we do it once for all the columns
+            list = el.GetVariants(data, end);
+          }
+
+          for(int c = 0; c < elCols; c++)
+            rowOut[col + c] = interpretComponent(list, componentForIndex(col + c), el);
+        }
+
+        col += elCols;
+      }
+    }
+  }
+
+  // the number of rows decoded at once when exporting
+  static const uint32_t ExportBlockRows = 4096;
+
 private:
   // constant data over the item model's lifetime
   // The view that this model is for
@@ -1000,6 +1038,11 @@ private:
   // are we using the alpha channel for secondary data
   bool secondaryElAlpha = false;
 
+  // LRU cache of decoded display data, in blocks of rows. The cost of each block is the number of
+  // cells in it. Only accessed from the main UI thread
+  static const uint32_t DisplayCacheBlockRows = 64;
+  mutable QCache<uint32_t, QVector<QVariant>> displayCache{256 * 1024};
+
   int reservedColumnCount() const { return (meshView ? 2 : 1); }
   int componentForIndex(int col) const { return componentLookup[col - reservedColumnCount()]; }
   int firstColumnForElement(int el) const
@@ -1077,6 +1120,46 @@ private:
   }
 
   QString outOfBounds() const { return lit("---"); }
+  QVariant interpretComponent(const QVariantList &list, int comp, const FormatElement &el) const
+  {
+    if(comp >= list.count())
+      return outOfBounds();
+
+    uint32_t rowdim = el.matrixdim;
+    uint32_t coldim = el.format.compCount;
+
+    if(rowdim == 1)
+    {
+      QVariant v;
+
+      if(el.rowmajor)
+        v = list[comp];
+      else
+        v = list[comp * rowdim];
+
+      RichResourceTextInitialise(v);
+
+      if(RichResourceTextCheck(v))
+        return v;
+
+      return interpretVariant(v, el);
+    }
+
+    QString ret;
+
+    for(uint32_t r = 0; r < rowdim; r++)
+    {
+      if(r > 0)
+        ret += lit("\n");
+
+      if(el.rowmajor)
+        ret += interpretVariant(list[comp + r * coldim], el);
+      else
+        ret += interpretVariant(list[r + comp * rowdim], el);
+    }
+
+    return ret;
+  }
   QString interpretGeneric(int col, const FormatElement &el) const
   {
     int comp = componentForIndex(col);
@@ -3490,7 +3573,7 @@ void BufferViewer::exportData(const BufferExport &params)
     else if(params.format == BufferExport::CSV)
     {
       // this works identically no matter whether we're mesh view or what, we just iterate the
-      // elements and call the model's data()
+      // elements and format them the same way the model displays them
 
       QTextStream s(f);
 
@@ -3504,17 +3587,31 @@ void BufferViewer::exportData(const BufferExport &params)
 
       s << "\n";
 
-      for(int row = 0; row < model->rowCount(); row++)
+      // decode rows in bulk rather than going through data() per-cell, which would also thrash the
+      // model's display cache
+      const int numCols = model->columnCount();
+      const uint32_t numRows = (uint32_t)model->rowCount();
+
+      QVector<QVariant> block;
+
+      for(uint32_t firstRow = 0; firstRow < numRows; firstRow += BufferItemModel::ExportBlockRows)
       {
-        for(int col = 0; col < model->columnCount(); col++)
+        uint32_t blockRows = qMin(BufferItemModel::ExportBlockRows, numRows - firstRow);
+
+        model->decodeRows(firstRow, blockRows, block);
+
+        for(uint32_t r = 0; r < blockRows; r++)
         {
-          s << model->data(model->index(row, col), Qt::DisplayRole).toString();
+          for(int col = 0; col < numCols; col++)
+          {
+            s << block[int(r) * numCols + col].toString();
 
-          if(col + 1 < model->columnCount())
-            s << ", ";
-        }
+            if(col + 1 < numCols)
+              s << ", ";
+          }
 
-        s << "\n";
+          s << "\n";
+        }
       }
     }
 
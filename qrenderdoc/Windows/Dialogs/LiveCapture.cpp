@@ -24,6 +24,7 @@
 
 #include "LiveCapture.h"
 #include <QDesktopServices>
+#include <QLabel>
 #include <QMenu>
 #include <QMetaProperty>
 #include <QMouseEvent>
@@ -33,11 +34,13 @@
 #include <QStyledItemDelegate>
 #include <QToolBar>
 #include <QToolButton>
+#include <QVBoxLayout>
 #include "3rdparty/toolwindowmanager/ToolWindowManager.h"
 #include "Code/QRDUtils.h"
 #include "Code/Resources.h"
 #include "Code/qprocessinfo.h"
 #include "Widgets/Extended/RDLabel.h"
+#include "Widgets/Extended/RDTreeWidget.h"
 #include "Windows/MainWindow.h"
 #include "ui_LiveCapture.h"
 
@@ -145,6 +148,12 @@ LiveCapture::LiveCapture(ICaptureContext &ctx, const QString &hostname, const QS
 
     bottomTools->addAction(previewToggle);
 
+    telemetryToggle = new QAction(tr("Telemetry"), this);
+    telemetryToggle->setCheckable(true);
+    telemetryToggle->setToolTip(tr("Show the overhead of capturing in the target while it runs"));
+
+    bottomTools->addAction(telemetryToggle);
+
     QMenu *openMenu = new QMenu(tr("&Open in..."), this);
     QAction *thisAction = new QAction(tr("This instance"), this);
     newWindowAction = new QAction(tr("New instance"), this);
@@ -166,6 +175,8 @@ LiveCapture::LiveCapture(ICaptureContext &ctx, const QString &hostname, const QS
     bottomTools->addAction(deleteAction);
 
     QObject::connect(previewToggle, &QAction::toggled, this, &LiveCapture::previewToggle_toggled);
+    QObject::connect(telemetryToggle, &QAction::toggled, this,
+                     &LiveCapture::telemetryToggle_toggled);
     QObject::connect(openButton, &QToolButton::clicked, this, &LiveCapture::openCapture_triggered);
     QObject::connect(thisAction, &QAction::triggered, this, &LiveCapture::openCapture_triggered);
     QObject::connect(newWindowAction, &QAction::triggered, this,
@@ -175,6 +186,24 @@ LiveCapture::LiveCapture(ICaptureContext &ctx, const QString &hostname, const QS
 
     QObject::connect(ui->captures, &RDListWidget::keyPress, this, &LiveCapture::captures_keyPress);
 
+    telemetryPanel = new QWidget(this);
+
+    QVBoxLayout *telemetryLayout = new QVBoxLayout(telemetryPanel);
+    telemetryLayout->setContentsMargins(0, 0, 0, 0);
+
+    telemetrySummary = new QLabel(telemetryPanel);
+    telemetrySummary->setWordWrap(true);
+
+    telemetryCalls = new RDTreeWidget(telemetryPanel);
+    telemetryCalls->setColumns({tr("Function"), tr("Calls / frame"), tr("ms / frame")});
+    telemetryCalls->setRootIsDecorated(false);
+
+    telemetryLayout->addWidget(telemetrySummary);
+    telemetryLayout->addWidget(telemetryCalls);
+
+    telemetryPanel->setVisible(false);
+
+    ui->mainLayout->addWidget(telemetryPanel);
     ui->mainLayout->addWidget(bottomTools);
   }
 }
@@ -922,6 +951,52 @@ void LiveCapture::cleanItems()
   ui->captures->clear();
 }
 
+void LiveCapture::telemetryToggle_toggled(bool checked)
+{
+  telemetrySummary->setText(tr("Waiting for telemetry from the target..."));
+  telemetryCalls->clear();
+  telemetryPanel->setVisible(checked);
+
+  // the connection thread picks up the change and forwards it to the target
+  m_TelemetryEnabled = checked;
+  m_TelemetryChanged.release();
+}
+
+void LiveCapture::updateTelemetry(const CaptureTelemetryData &telemetry)
+{
+  // ignore any telemetry that was in flight when it was disabled
+  if(!telemetryToggle->isChecked() || telemetry.numFrames == 0)
+    return;
+
+  double frames = telemetry.numFrames;
+
+  telemetrySummary->setText(
+      tr("Frame time %1 ms, of which %2 ms in hooked calls and %3 ms tracking mapped memory.\n"
+         "Serialised %4 KB per frame, %5 MB currently held in captured chunks.")
+          .arg(telemetry.frameTime * 1000.0, 0, 'f', 2)
+          .arg(telemetry.hookedTime * 1000.0, 0, 'f', 2)
+          .arg(telemetry.mapTrackingTime * 1000.0, 0, 'f', 2)
+          .arg(double(telemetry.serialisedBytes) / 1024.0, 0, 'f', 1)
+          .arg(double(telemetry.chunkMemory) / (1024.0 * 1024.0), 0, 'f', 1));
+
+  // calls are sorted with the most expensive first, only list the top few
+  const int maxCalls = 20;
+
+  telemetryCalls->beginUpdate();
+  telemetryCalls->clear();
+
+  for(int i = 0; i < telemetry.calls.count() && i < maxCalls; i++)
+  {
+    const APICallTelemetry &call = telemetry.calls[i];
+
+    telemetryCalls->addTopLevelItem(
+        new RDTreeWidgetItem({QString(call.function), QString::number(call.count / frames, 'f', 1),
+                              QString::number(call.duration * 1000.0 / frames, 'f', 3)}));
+  }
+
+  telemetryCalls->endUpdate();
+}
+
 void LiveCapture::previewToggle_toggled(bool checked)
 {
   if(m_IgnorePreviewToggle)
@@ -1213,6 +1288,9 @@ void LiveCapture::connectionThreadEntry()
     for(uint32_t del : dels)
       m_Connection->DeleteCapture(del);
 
+    if(m_TelemetryChanged.tryAcquire())
+      m_Connection->SetTelemetryEnabled(m_TelemetryEnabled);
+
     if(!m_Disconnect.available())
     {
       m_Connection->Shutdown();
@@ -1313,6 +1391,12 @@ void LiveCapture::connectionThreadEntry()
       uint32_t windows = msg.capturableWindowCount;
       GUIInvoke::call(this, [this, windows]() { ui->cycleActiveWindow->setEnabled(windows > 1); });
     }
+
+    if(msg.type == TargetControlMessageType::CaptureTelemetry)
+    {
+      CaptureTelemetryData telemetry = msg.telemetry;
+      GUIInvoke::call(this, [this, telemetry]() { updateTelemetry(telemetry); });
+    }
   }
 
   GUIInvoke::call(this, [this]() {
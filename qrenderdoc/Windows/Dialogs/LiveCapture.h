@@ -38,11 +38,13 @@ class LiveCapture;
 
 class QSplitter;
 class QAction;
+class QLabel;
 class QToolButton;
 class QListWidgetItem;
 class QMenu;
 class LambdaThread;
 class RDLabel;
+class RDTreeWidget;
 class MainWindow;
 class QKeyEvent;
 class NameEditOnlyDelegate;
@@ -87,6 +89,7 @@ private slots:
   void saveCapture_triggered();
   void deleteCapture_triggered();
   void previewToggle_toggled(bool);
+  void telemetryToggle_toggled(bool);
 
   void preview_mouseClick(QMouseEvent *e);
   void preview_mouseMove(QMouseEvent *e);
@@ -140,6 +143,7 @@ private:
   void captureCopied(uint32_t ID, const QString &localPath);
   void captureAdded(const NewCaptureData &newCapture);
   void connectionClosed();
+  void updateTelemetry(const CaptureTelemetryData &telemetry);
 
   void selfClose();
 
@@ -163,6 +167,8 @@ private:
   QSemaphore m_QueueCapture;
   QSemaphore m_CopyCapture;
   QSemaphore m_Disconnect;
+  QSemaphore m_TelemetryChanged;
+  bool m_TelemetryEnabled = false;
   int m_CaptureNumFrames = 1;
   int m_QueueCaptureFrameNum = 0;
   int m_CaptureCounter = 0;
@@ -183,6 +189,11 @@ private:
   QAction *newWindowAction;
   QAction *saveAction;
   QAction *deleteAction;
+  QAction *telemetryToggle;
+
+  QWidget *telemetryPanel;
+  QLabel *telemetrySummary;
+  RDTreeWidget *telemetryCalls;
 
   QTimer childUpdateTimer, countdownTimer;
 
@@ -47,6 +47,8 @@ struct EventItemTag
   EventItemTag(uint32_t eventId, uint32_t lastEventID) : EID(eventId), lastEID(lastEventID) {}
   uint32_t EID = 0;
   uint32_t lastEID = 0;
+  // index into EventBrowser::m_Nodes, or -1 for the frame root
+  int node = -1;
   double duration = -1.0;
   bool current = false;
   bool find = false;
@@ -135,6 +137,8 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
   QObject::connect(ui->closeFind, &QToolButton::clicked, this, &EventBrowser::on_HideFindJump);
   QObject::connect(ui->closeJump, &QToolButton::clicked, this, &EventBrowser::on_HideFindJump);
   QObject::connect(ui->events, &RDTreeWidget::keyPress, this, &EventBrowser::events_keyPress);
+  QObject::connect(ui->events, &RDTreeWidget::populateItem, this,
+                   &EventBrowser::events_populateItem);
   ui->jumpStrip->hide();
   ui->findStrip->hide();
   ui->bookmarkStrip->hide();
@@ -247,13 +251,29 @@ void EventBrowser::OnCaptureLoaded()
 
   RDTreeWidgetItem *framestart =
       new RDTreeWidgetItem({tr("Capture Start"), lit("0"), lit("0"), QString()});
-  framestart->setTag(QVariant::fromValue(EventItemTag(0, 0)));
+  EventItemTag startTag(0, 0);
+  startTag.node = 0;
+  framestart->setTag(QVariant::fromValue(startTag));
 
   frame->addChild(framestart);
 
-  QPair<uint32_t, uint32_t> lastEIDDraw = AddDrawcalls(frame, m_Ctx.CurDrawcalls());
+  EventNode start = {};
+  start.searchName = framestart->text(COL_NAME).toLower();
+  start.parent = -1;
+  start.end = 1;
+  start.duration = -1.0;
+  start.item = framestart;
+  m_Nodes.push_back(start);
+  m_EIDIndex[0] = 0;
+
+  QPair<uint32_t, uint32_t> lastEIDDraw = AddEventNodes(-1, m_Ctx.CurDrawcalls());
   frame->setTag(QVariant::fromValue(EventItemTag(0, lastEIDDraw.first)));
 
+  // only the top-level items are created up front, the rest are created on expansion
+  CreateChildItems(frame, -1);
+
+  m_FrameItem = frame;
+
   ui->events->addTopLevelItem(frame);
 
   ui->events->expandItem(frame);
@@ -278,6 +298,14 @@ void EventBrowser::OnCaptureClosed()
 
   ui->events->clear();
 
+  m_FrameItem = NULL;
+  m_Nodes.clear();
+  m_EIDIndex.clear();
+  m_SearchText.clear();
+  m_SearchMatches.clear();
+  m_FindNodes.clear();
+  m_Times.clear();
+
   ui->find->setEnabled(false);
   ui->gotoEID->setEnabled(false);
   ui->timeDraws->setEnabled(false);
@@ -345,8 +373,8 @@ bool EventBrowser::ShouldHide(const DrawcallDescription &drawcall)
   return false;
 }
 
-QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
-                                                     const rdcarray<DrawcallDescription> &draws)
+QPair<uint32_t, uint32_t> EventBrowser::AddEventNodes(int parent,
+                                                      const rdcarray<DrawcallDescription> &draws)
 {
   uint lastEID = 0, lastDraw = 0;
 
@@ -357,23 +385,19 @@ QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
     if(ShouldHide(d))
       continue;
 
-    QVariant name = QString(d.name);
+    int idx = m_Nodes.count();
 
-    RichResourceTextInitialise(name);
+    EventNode node = {};
+    node.draw = &d;
+    node.searchName = QString(d.name).toLower();
+    node.parent = parent;
+    node.duration = -1.0;
+    m_Nodes.push_back(node);
 
-    RDTreeWidgetItem *child = new RDTreeWidgetItem(
-        {name, QString::number(d.eventId), QString::number(d.drawcallId), lit("---")});
-
-    QPair<uint32_t, uint32_t> last = AddDrawcalls(child, d.children);
+    QPair<uint32_t, uint32_t> last = AddEventNodes(idx, d.children);
     lastEID = last.first;
     lastDraw = last.second;
 
-    if(lastEID > d.eventId)
-    {
-      child->setText(COL_EID, QFormatStr("%1-%2").arg(d.eventId).arg(lastEID));
-      child->setText(COL_DRAW, QFormatStr("%1-%2").arg(d.drawcallId).arg(lastDraw));
-    }
-
     if(lastEID == 0)
     {
       lastEID = d.eventId;
@@ -383,82 +407,148 @@ QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
         lastEID = draws[i + 1].eventId;
     }
 
-    child->setTag(QVariant::fromValue(EventItemTag(draws[i].eventId, lastEID)));
+    EventNode &n = m_Nodes[idx];
+    n.EID = d.eventId;
+    n.lastEID = lastEID;
+    n.lastDraw = lastDraw;
+    n.end = m_Nodes.count();
+
+    // nodes are indexed after their children, so a marker never replaces the leaf it ends on. Later
+    // leaves replace earlier ones, so 'set' markers lose to the draw whose EID they inherit.
+    auto it = m_EIDIndex.find(lastEID);
+    if(it == m_EIDIndex.end() || n.end == idx + 1 || m_Nodes[it.value()].end != it.value() + 1)
+      m_EIDIndex[lastEID] = idx;
+  }
 
-    if(m_Ctx.Config().EventBrowser_ApplyColors)
-    {
-      // if alpha isn't 0, assume the colour is valid
-      if((d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && d.markerColor[3] > 0.0f)
-      {
-        QColor col = QColor::fromRgb(
-            qRgb(d.markerColor[0] * 255.0f, d.markerColor[1] * 255.0f, d.markerColor[2] * 255.0f));
+  return qMakePair(lastEID, lastDraw);
+}
 
-        child->setTreeColor(col, 3.0f);
+RDTreeWidgetItem *EventBrowser::CreateItem(int idx)
+{
+  EventNode &n = m_Nodes[idx];
+  const DrawcallDescription &d = *n.draw;
 
-        if(m_Ctx.Config().EventBrowser_ColorEventRow)
-        {
-          QColor textCol = ui->events->palette().color(QPalette::Text);
+  QVariant name = QString(d.name);
 
-          child->setBackgroundColor(col);
-          child->setForegroundColor(contrastingColor(col, textCol));
-        }
-      }
+  RichResourceTextInitialise(name);
+
+  RDTreeWidgetItem *item = new RDTreeWidgetItem(
+      {name, QString::number(d.eventId), QString::number(d.drawcallId), lit("---")});
+
+  if(n.end > idx + 1)
+  {
+    if(n.lastEID > d.eventId)
+    {
+      item->setText(COL_EID, QFormatStr("%1-%2").arg(d.eventId).arg(n.lastEID));
+      item->setText(COL_DRAW, QFormatStr("%1-%2").arg(d.drawcallId).arg(n.lastDraw));
     }
 
-    parent->addChild(child);
+    // children are only created when this item is expanded
+    item->setLazyChildren(true);
   }
 
-  return qMakePair(lastEID, lastDraw);
-}
+  EventItemTag tag(n.EID, n.lastEID);
+  tag.node = idx;
+  tag.duration = n.duration;
+  tag.find = n.find;
+  tag.bookmark = hasBookmark(n.lastEID) && FindEventNode(n.lastEID) == idx;
+  item->setTag(QVariant::fromValue(tag));
 
-void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results)
-{
-  if(node == NULL)
-    return;
+  if(!m_Times.empty())
+    UpdateDurationText(item, n.duration);
 
-  // parent nodes take the value of the sum of their children
-  double duration = 0.0;
+  if(tag.find || tag.bookmark)
+    RefreshIcon(item, tag);
 
-  // look up leaf nodes in the dictionary
-  if(node->childCount() == 0)
+  if(m_Ctx.Config().EventBrowser_ApplyColors)
   {
-    uint32_t eid = node->tag().value<EventItemTag>().EID;
+    // if alpha isn't 0, assume the colour is valid
+    if((d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && d.markerColor[3] > 0.0f)
+    {
+      QColor col = QColor::fromRgb(
+          qRgb(d.markerColor[0] * 255.0f, d.markerColor[1] * 255.0f, d.markerColor[2] * 255.0f));
 
-    duration = -1.0;
+      item->setTreeColor(col, 3.0f);
 
-    for(const CounterResult &r : results)
-    {
-      if(r.eventId == eid)
-        duration = r.value.d;
+      if(m_Ctx.Config().EventBrowser_ColorEventRow)
+      {
+        QColor textCol = ui->events->palette().color(QPalette::Text);
+
+        item->setBackgroundColor(col);
+        item->setForegroundColor(contrastingColor(col, textCol));
+      }
     }
+  }
 
-    double secs = duration;
+  n.item = item;
 
-    if(m_TimeUnit == TimeUnit::Milliseconds)
-      secs *= 1000.0;
-    else if(m_TimeUnit == TimeUnit::Microseconds)
-      secs *= 1000000.0;
-    else if(m_TimeUnit == TimeUnit::Nanoseconds)
-      secs *= 1000000000.0;
+  return item;
+}
 
-    node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-    EventItemTag tag = node->tag().value<EventItemTag>();
-    tag.duration = duration;
-    node->setTag(QVariant::fromValue(tag));
+void EventBrowser::CreateChildItems(RDTreeWidgetItem *parentItem, int parent)
+{
+  // the children of a node are the subtrees that follow it until the end of its own subtree
+  int end = parent < 0 ? m_Nodes.count() : m_Nodes[parent].end;
 
-    return;
+  for(int c = parent + 1; c < end; c = m_Nodes[c].end)
+  {
+    if(m_Nodes[c].item == NULL)
+      parentItem->addChild(CreateItem(c));
   }
+}
+
+RDTreeWidgetItem *EventBrowser::GetItem(int idx)
+{
+  if(idx < 0 || idx >= m_Nodes.count())
+    return NULL;
+
+  // top-level items are always created, so walk up populating parents until we reach one
+  if(m_Nodes[idx].item == NULL)
+    ui->events->populateLazyChildren(GetItem(m_Nodes[idx].parent));
+
+  return m_Nodes[idx].item;
+}
+
+void EventBrowser::events_populateItem(RDTreeWidgetItem *item)
+{
+  CreateChildItems(item, item->tag().value<EventItemTag>().node);
+}
+
+void EventBrowser::SetDrawcallTimes(const rdcarray<CounterResult> &results)
+{
+  QHash<uint32_t, double> times;
+  for(const CounterResult &r : results)
+    times[r.eventId] = r.value.d;
 
-  for(int i = 0; i < node->childCount(); i++)
+  // look up leaf nodes in the results, parent nodes take the value of the sum of their children
+  for(int i = 0; i < m_Nodes.count(); i++)
+    m_Nodes[i].duration = m_Nodes[i].end == i + 1 ? times.value(m_Nodes[i].EID, -1.0) : 0.0;
+
+  double frameDuration = 0.0;
+
+  // walk backwards so every child is summed into its parent before the parent is visited
+  for(int i = m_Nodes.count() - 1; i >= 0; i--)
   {
-    SetDrawcallTimes(node->child(i), results);
+    const EventNode &n = m_Nodes[i];
 
-    double nd = node->child(i)->tag().value<EventItemTag>().duration;
+    if(n.duration > 0.0)
+    {
+      if(n.parent >= 0)
+        m_Nodes[n.parent].duration += n.duration;
+      else
+        frameDuration += n.duration;
+    }
 
-    if(nd > 0.0)
-      duration += nd;
+    if(n.item)
+      UpdateDurationText(n.item, n.duration);
   }
 
+  if(m_FrameItem)
+    UpdateDurationText(m_FrameItem, frameDuration);
+}
+
+void EventBrowser::UpdateDurationText(RDTreeWidgetItem *item, double duration)
+{
   double secs = duration;
 
   if(m_TimeUnit == TimeUnit::Milliseconds)
@@ -468,10 +558,10 @@ void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<Count
   else if(m_TimeUnit == TimeUnit::Nanoseconds)
     secs *= 1000000000.0;
 
-  node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-  EventItemTag tag = node->tag().value<EventItemTag>();
+  item->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
+  EventItemTag tag = item->tag().value<EventItemTag>();
   tag.duration = duration;
-  node->setTag(QVariant::fromValue(tag));
+  item->setTag(QVariant::fromValue(tag));
 }
 
 void EventBrowser::on_find_clicked()
@@ -510,7 +600,7 @@ void EventBrowser::on_timeDraws_clicked()
       if(ui->events->topLevelItemCount() == 0)
         return;
 
-      SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
+      SetDrawcallTimes(m_Times);
       ui->events->update();
     });
   });
@@ -1011,8 +1101,10 @@ void EventBrowser::events_contextMenu(const QPoint &pos)
   collapseAll.setIcon(Icons::arrow_in());
   selectCols.setIcon(Icons::timeline_marker());
 
-  expandAll.setEnabled(item && item->childCount() > 0);
-  collapseAll.setEnabled(item && item->childCount() > 0);
+  bool hasChildren = item && (item->childCount() > 0 || item->lazyChildren());
+
+  expandAll.setEnabled(hasChildren);
+  collapseAll.setEnabled(hasChildren);
 
   QObject::connect(&expandAll, &QAction::triggered,
                    [this, item]() { ui->events->expandAllItems(item); });
@@ -1075,16 +1167,7 @@ void EventBrowser::repopulateBookmarks()
 
       highlightBookmarks();
 
-      RDTreeWidgetItem *found = NULL;
-      FindEventNode(found, ui->events->topLevelItem(0), EID);
-
-      if(found)
-      {
-        EventItemTag tag = found->tag().value<EventItemTag>();
-        tag.bookmark = true;
-        found->setTag(QVariant::fromValue(tag));
-        RefreshIcon(found, tag);
-      }
+      SetBookmarkIcon(EID, true);
 
       m_BookmarkStripLayout->removeItem(m_BookmarkSpacer);
       m_BookmarkStripLayout->addWidget(but);
@@ -1100,16 +1183,7 @@ void EventBrowser::repopulateBookmarks()
       delete m_BookmarkButtons[EID];
       m_BookmarkButtons.remove(EID);
 
-      RDTreeWidgetItem *found = NULL;
-      FindEventNode(found, ui->events->topLevelItem(0), EID);
-
-      if(found)
-      {
-        EventItemTag tag = found->tag().value<EventItemTag>();
-        tag.bookmark = false;
-        found->setTag(QVariant::fromValue(tag));
-        RefreshIcon(found, tag);
-      }
+      SetBookmarkIcon(EID, false);
     }
   }
 
@@ -1172,32 +1246,16 @@ void EventBrowser::RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag)
     item->setIcon(COL_NAME, QIcon());
 }
 
-bool EventBrowser::FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId)
+int EventBrowser::FindEventNode(uint32_t eventId)
 {
-  // do a reverse search to find the last match (in case of 'set' markers that
-  // inherit the event of the next real draw).
-  for(int i = parent->childCount() - 1; i >= 0; i--)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    uint nEID = n->tag().value<EventItemTag>().lastEID;
-    uint fEID = found ? found->tag().value<EventItemTag>().lastEID : 0;
-
-    if(nEID >= eventId && (found == NULL || nEID <= fEID))
-      found = n;
+  // find the first node ending at or after this EID, in case of EIDs that are hidden or inside
+  // a marker's range
+  auto it = m_EIDIndex.lowerBound(eventId);
 
-    if(nEID == eventId && n->childCount() == 0)
-      return true;
-
-    if(n->childCount() > 0)
-    {
-      bool exact = FindEventNode(found, n, eventId);
-      if(exact)
-        return true;
-    }
-  }
+  if(it == m_EIDIndex.end())
+    return -1;
 
-  return false;
+  return it.value();
 }
 
 void EventBrowser::ExpandNode(RDTreeWidgetItem *node)
@@ -1218,8 +1276,7 @@ bool EventBrowser::SelectEvent(uint32_t eventId)
   if(!m_Ctx.IsCaptureLoaded())
     return false;
 
-  RDTreeWidgetItem *found = NULL;
-  FindEventNode(found, ui->events->topLevelItem(0), eventId);
+  RDTreeWidgetItem *found = GetItem(FindEventNode(eventId));
   if(found != NULL)
   {
     ui->events->setCurrentItem(found);
@@ -1232,52 +1289,40 @@ bool EventBrowser::SelectEvent(uint32_t eventId)
   return false;
 }
 
-void EventBrowser::ClearFindIcons(RDTreeWidgetItem *parent)
+void EventBrowser::SetBookmarkIcon(uint32_t EID, bool bookmark)
 {
-  for(int i = 0; i < parent->childCount(); i++)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
+  int idx = FindEventNode(EID);
 
-    EventItemTag tag = n->tag().value<EventItemTag>();
-    tag.find = false;
-    n->setTag(QVariant::fromValue(tag));
-    RefreshIcon(n, tag);
+  // items that haven't been created yet pick up the bookmark when they are
+  RDTreeWidgetItem *found = idx >= 0 ? m_Nodes[idx].item : NULL;
 
-    if(n->childCount() > 0)
-      ClearFindIcons(n);
+  if(found)
+  {
+    EventItemTag tag = found->tag().value<EventItemTag>();
+    tag.bookmark = bookmark;
+    found->setTag(QVariant::fromValue(tag));
+    RefreshIcon(found, tag);
   }
 }
 
 void EventBrowser::ClearFindIcons()
 {
-  if(m_Ctx.IsCaptureLoaded() && ui->events->topLevelItemCount() > 0)
-    ClearFindIcons(ui->events->topLevelItem(0));
-}
-
-int EventBrowser::SetFindIcons(RDTreeWidgetItem *parent, QString filter)
-{
-  int results = 0;
-
-  for(int i = 0; i < parent->childCount(); i++)
+  for(int idx : m_FindNodes)
   {
-    RDTreeWidgetItem *n = parent->child(i);
+    m_Nodes[idx].find = false;
+
+    RDTreeWidgetItem *n = m_Nodes[idx].item;
 
-    if(n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
+    if(n)
     {
       EventItemTag tag = n->tag().value<EventItemTag>();
-      tag.find = true;
+      tag.find = false;
       n->setTag(QVariant::fromValue(tag));
       RefreshIcon(n, tag);
-      results++;
-    }
-
-    if(n->childCount() > 0)
-    {
-      results += SetFindIcons(n, filter);
     }
   }
 
-  return results;
+  m_FindNodes.clear();
 }
 
 int EventBrowser::SetFindIcons(QString filter)
@@ -1285,63 +1330,58 @@ int EventBrowser::SetFindIcons(QString filter)
   if(filter.isEmpty() || !m_Ctx.IsCaptureLoaded())
     return 0;
 
-  return SetFindIcons(ui->events->topLevelItem(0), filter);
-}
+  m_FindNodes = GetSearchMatches(filter);
 
-RDTreeWidgetItem *EventBrowser::FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after)
-{
-  for(int i = 0; i < parent->childCount(); i++)
+  for(int idx : m_FindNodes)
   {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+    m_Nodes[idx].find = true;
 
-    if(eid > after && n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-      return n;
+    RDTreeWidgetItem *n = m_Nodes[idx].item;
 
-    if(n->childCount() > 0)
+    if(n)
     {
-      RDTreeWidgetItem *found = FindNode(n, filter, after);
-
-      if(found != NULL)
-        return found;
+      EventItemTag tag = n->tag().value<EventItemTag>();
+      tag.find = true;
+      n->setTag(QVariant::fromValue(tag));
+      RefreshIcon(n, tag);
     }
   }
 
-  return NULL;
+  return m_FindNodes.count();
 }
 
-int EventBrowser::FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward)
+const QVector<int> &EventBrowser::GetSearchMatches(QString filter)
 {
-  if(parent == NULL)
-    return -1;
-
-  for(int i = forward ? 0 : parent->childCount() - 1; i >= 0 && i < parent->childCount();
-      i += forward ? 1 : -1)
-  {
-    auto n = parent->child(i);
+  filter = filter.toLower();
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+  if(filter == m_SearchText)
+    return m_SearchMatches;
 
-    bool matchesAfter = (forward && eid > after) || (!forward && eid < after);
+  QVector<int> matches;
 
-    if(matchesAfter)
+  // if the new search contains the previous one it can only match a subset of the previous
+  // matches, so only those need to be checked. This is the common case while typing.
+  if(!m_SearchText.isEmpty() && filter.contains(m_SearchText))
+  {
+    for(int idx : m_SearchMatches)
     {
-      QString name = n->text(COL_NAME);
-      if(name.contains(filter, Qt::CaseInsensitive))
-        return (int)eid;
+      if(m_Nodes[idx].searchName.contains(filter))
+        matches.push_back(idx);
     }
-
-    if(n->childCount() > 0)
+  }
+  else
+  {
+    for(int idx = 0; idx < m_Nodes.count(); idx++)
     {
-      int found = FindEvent(n, filter, after, forward);
-
-      if(found > 0)
-        return found;
+      if(m_Nodes[idx].searchName.contains(filter))
+        matches.push_back(idx);
     }
   }
 
-  return -1;
+  m_SearchText = filter;
+  m_SearchMatches.swap(matches);
+
+  return m_SearchMatches;
 }
 
 int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
@@ -1349,7 +1389,27 @@ int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
   if(!m_Ctx.IsCaptureLoaded())
     return 0;
 
-  return FindEvent(ui->events->topLevelItem(0), filter, after, forward);
+  const QVector<int> &matches = GetSearchMatches(filter);
+
+  // matches are in tree order, so the first one past 'after' is the next one in the tree
+  if(forward)
+  {
+    for(int idx : matches)
+    {
+      if(m_Nodes[idx].lastEID > after)
+        return (int)m_Nodes[idx].lastEID;
+    }
+  }
+  else
+  {
+    for(int i = matches.count() - 1; i >= 0; i--)
+    {
+      if(m_Nodes[matches[i]].lastEID < after)
+        return (int)m_Nodes[matches[i]].lastEID;
+    }
+  }
+
+  return -1;
 }
 
 void EventBrowser::Find(bool forward)
@@ -1394,5 +1454,5 @@ void EventBrowser::UpdateDurationColumn()
   ui->events->setHeaderText(COL_DURATION, tr("Duration (%1)").arg(UnitSuffix(m_TimeUnit)));
 
   if(!m_Times.empty())
-    SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
+    SetDrawcallTimes(m_Times);
 }
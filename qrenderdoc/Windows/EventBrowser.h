@@ -87,6 +87,7 @@ private slots:
   void findHighlight_timeout();
   void events_keyPress(QKeyEvent *event);
   void events_contextMenu(const QPoint &pos);
+  void events_populateItem(RDTreeWidgetItem *item);
 
 public slots:
   void clearBookmarks();
@@ -95,28 +96,48 @@ public slots:
   void jumpToBookmark(int idx);
 
 private:
+  // a node in the event tree. The whole visible tree is flattened into m_Nodes in pre-order when
+  // the capture is loaded, which is cheap compared to creating widget items. Items are only created
+  // for a node's children when it's expanded, and the flat list doubles as the search index.
+  struct EventNode
+  {
+    const DrawcallDescription *draw;
+    // lower-cased name for case-insensitive searching
+    QString searchName;
+    uint32_t EID;
+    uint32_t lastEID;
+    uint32_t lastDraw;
+    // index of the parent node, or -1 for top-level nodes under the frame root
+    int parent;
+    // one past the last node in this node's subtree, so the first child (if any) is at index + 1
+    int end;
+    double duration;
+    bool find;
+    RDTreeWidgetItem *item;
+  };
+
   bool ShouldHide(const DrawcallDescription &drawcall);
-  QPair<uint32_t, uint32_t> AddDrawcalls(RDTreeWidgetItem *parent,
-                                         const rdcarray<DrawcallDescription> &draws);
-  void SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results);
+  QPair<uint32_t, uint32_t> AddEventNodes(int parent, const rdcarray<DrawcallDescription> &draws);
+  void CreateChildItems(RDTreeWidgetItem *parentItem, int parent);
+  RDTreeWidgetItem *CreateItem(int idx);
+  RDTreeWidgetItem *GetItem(int idx);
+  void SetDrawcallTimes(const rdcarray<CounterResult> &results);
+  void UpdateDurationText(RDTreeWidgetItem *item, double duration);
 
   void ExpandNode(RDTreeWidgetItem *node);
 
-  bool FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId);
+  int FindEventNode(uint32_t eventId);
   bool SelectEvent(uint32_t eventId);
+  void SetBookmarkIcon(uint32_t EID, bool bookmark);
 
-  void ClearFindIcons(RDTreeWidgetItem *parent);
   void ClearFindIcons();
-
-  int SetFindIcons(RDTreeWidgetItem *parent, QString filter);
   int SetFindIcons(QString filter);
+  const QVector<int> &GetSearchMatches(QString filter);
 
   void repopulateBookmarks();
   void highlightBookmarks();
   bool hasBookmark(RDTreeWidgetItem *node);
 
-  RDTreeWidgetItem *FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after);
-  int FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward);
   int FindEvent(QString filter, uint32_t after, bool forward);
   void Find(bool forward);
 
@@ -139,6 +160,17 @@ private:
   QSpacerItem *m_BookmarkSpacer;
   QMap<uint32_t, QToolButton *> m_BookmarkButtons;
 
+  QVector<EventNode> m_Nodes;
+  // lastEID -> node index of the node that selecting that EID should land on
+  QMap<uint32_t, int> m_EIDIndex;
+  RDTreeWidgetItem *m_FrameItem = NULL;
+
+  // the last search and its matches in pre-order, so extending the search only re-filters them
+  QString m_SearchText;
+  QVector<int> m_SearchMatches;
+  // the nodes currently showing the find icon
+  QVector<int> m_FindNodes;
+
   void RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag);
 
   Ui::EventBrowser *ui;
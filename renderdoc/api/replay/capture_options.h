@@ -199,6 +199,61 @@ Default - enabled
 ``False`` - API debugging is displayed as normal.
 )");
   bool debugOutputMute;
+
+  DOCUMENT(R"(The amount of memory in megabytes that captured data is allowed to occupy in the
+process.
+
+When this is exceeded the contents of older large chunks of captured data are moved to a temporary
+file on disk, and read back only when they are needed again - typically when the capture is written
+out. Data that the capture layer still needs direct access to stays in memory regardless, so this is
+a target rather than a hard limit.
+
+Default - 0
+
+``0`` - No limit, all captured data is kept in memory.
+
+``N`` - Keep at most ``N`` megabytes of captured data in memory where possible.
+)");
+  uint32_t captureMemoryBudgetMB;
+
+  DOCUMENT(R"(The number of recent frames to hold in memory for retroactive capture.
+
+While this is enabled, frames are captured in the background and kept in memory instead of being
+written to disk. Triggering a capture then saves the most recently completed frames, and queueing a
+capture of a frame that has already been presented saves it if it is still held.
+
+Default - 0
+
+``0`` - Disabled, only frames that are explicitly captured are recorded.
+
+``N`` - Hold up to the ``N`` most recent frames in memory.
+)");
+  uint32_t retroactiveFrames;
+
+  DOCUMENT(R"(The amount of memory in megabytes that frames held for retroactive capture may
+occupy. The oldest frames are dropped to stay under this.
+
+Default - 512
+
+``0`` - No limit, only :data:`retroactiveFrames` bounds the memory used.
+
+``N`` - Hold at most ``N`` megabytes of frames in memory.
+)");
+  uint32_t retroactiveMemoryBudgetMB;
+
+  DOCUMENT(R"(The percentage of the application's time that may be spent recording frames for
+retroactive capture.
+
+After each held frame, recording pauses for long enough that the time spent capturing stays within
+this share of the total. Frames held in memory may therefore not be consecutive.
+
+Default - 25
+
+``100`` - Record every frame regardless of the overhead.
+
+``N`` - Spend at most ``N`` percent of the time recording frames.
+)");
+  uint32_t retroactiveCPUBudget;
 };
 
 DECLARE_REFLECTION_STRUCT(CaptureOptions);
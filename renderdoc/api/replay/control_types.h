@@ -536,6 +536,96 @@ struct NewChildData
 
 DECLARE_REFLECTION_STRUCT(NewChildData);
 
+DOCUMENT("Information about how much memory captured data is using in the target.");
+struct CaptureMemoryData
+{
+  DOCUMENT("");
+  CaptureMemoryData() = default;
+  CaptureMemoryData(const CaptureMemoryData &) = default;
+
+  DOCUMENT("The number of bytes of captured data held in memory.");
+  uint64_t resident = 0;
+  DOCUMENT("The number of bytes of captured data moved to disk to stay within the memory budget.");
+  uint64_t spilled = 0;
+  DOCUMENT(R"(The memory budget in bytes for captured data, or 0 if there is no limit.
+
+See :data:`CaptureOptions.captureMemoryBudgetMB`.
+)");
+  uint64_t budget = 0;
+};
+
+DECLARE_REFLECTION_STRUCT(CaptureMemoryData);
+
+DOCUMENT("The number of calls made to one hooked API function and the time spent inside them.");
+struct APICallTelemetry
+{
+  DOCUMENT("");
+  APICallTelemetry() = default;
+  APICallTelemetry(const APICallTelemetry &) = default;
+  bool operator==(const APICallTelemetry &o) const
+  {
+    return function == o.function && count == o.count && duration == o.duration;
+  }
+  bool operator<(const APICallTelemetry &o) const
+  {
+    if(!(function == o.function))
+      return function < o.function;
+    if(!(count == o.count))
+      return count < o.count;
+    if(!(duration == o.duration))
+      return duration < o.duration;
+    return false;
+  }
+  DOCUMENT("The name of the hooked function.");
+  rdcstr function;
+
+  DOCUMENT("The number of times the function was called during the sampled interval.");
+  uint64_t count = 0;
+
+  DOCUMENT(R"(The total time in seconds spent inside the function during the sampled interval.
+
+This includes the time spent in the driver's own implementation, not just RenderDoc's overhead.
+)");
+  double duration = 0.0;
+};
+
+DECLARE_REFLECTION_STRUCT(APICallTelemetry);
+
+DOCUMENT(R"(Statistics about the overhead RenderDoc is adding to the target while it runs.
+
+Unless noted otherwise values are averaged per frame over the interval since the previous update.
+)");
+struct CaptureTelemetryData
+{
+  DOCUMENT("");
+  CaptureTelemetryData() = default;
+  CaptureTelemetryData(const CaptureTelemetryData &) = default;
+
+  DOCUMENT("The number of frames presented during the sampled interval.");
+  uint32_t numFrames = 0;
+  DOCUMENT("The average time in seconds between presents.");
+  double frameTime = 0.0;
+  DOCUMENT(R"(The average time in seconds per frame spent inside hooked API functions.
+
+Only available on APIs that report per-function :data:`calls`, otherwise it will be 0.
+)");
+  double hookedTime = 0.0;
+  DOCUMENT("The average time in seconds per frame spent finding modified ranges in mapped memory.");
+  double mapTrackingTime = 0.0;
+  DOCUMENT("The average number of bytes serialised per frame.");
+  uint64_t serialisedBytes = 0;
+  DOCUMENT("The number of bytes currently held in captured chunks, at the time of sampling.");
+  uint64_t chunkMemory = 0;
+
+  DOCUMENT(R"(The per-function call statistics, sorted with the most expensive function first.
+
+:type: List[APICallTelemetry]
+)");
+  rdcarray<APICallTelemetry> calls;
+};
+
+DECLARE_REFLECTION_STRUCT(CaptureTelemetryData);
+
 DOCUMENT("A message from a target control connection.");
 struct TargetControlMessage
 {
@@ -563,6 +653,12 @@ or has finished, it will be -1.0
 
   DOCUMENT("The number of the capturable windows");
   uint32_t capturableWindowCount = 0;
+
+  DOCUMENT("The :class:`capture memory usage <CaptureMemoryData>`.");
+  CaptureMemoryData captureMemory;
+
+  DOCUMENT("The :class:`capture overhead telemetry <CaptureTelemetryData>`.");
+  CaptureTelemetryData telemetry;
 };
 
 DECLARE_REFLECTION_STRUCT(TargetControlMessage);
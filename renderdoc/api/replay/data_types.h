@@ -130,10 +130,83 @@ struct SectionProperties
 
   DOCUMENT("The number of bytes of data in this section when compressed on disk.");
   uint64_t compressedSize = 0;
+
+  DOCUMENT(R"(The ID of the built-in dictionary this section is compressed with, if it is
+:data:`SectionFlags.ZstdCompressed`, or 0 if no dictionary is used.
+
+When writing a frame capture section with Zstd compression and no dictionary specified, the
+dictionary for the capture's API is used if there is one.
+)");
+  uint32_t dictionaryID = 0;
 };
 
 DECLARE_REFLECTION_STRUCT(SectionProperties);
 
+DOCUMENT("Information about a single replay session being served by a remote server.");
+struct RemoteServerSession
+{
+  DOCUMENT("");
+  RemoteServerSession() = default;
+  RemoteServerSession(const RemoteServerSession &) = default;
+  bool operator==(const RemoteServerSession &o) const
+  {
+    return client == o.client && workerPID == o.workerPID && duration == o.duration;
+  }
+  bool operator<(const RemoteServerSession &o) const
+  {
+    if(!(client == o.client))
+      return client < o.client;
+    if(!(workerPID == o.workerPID))
+      return workerPID < o.workerPID;
+    if(!(duration == o.duration))
+      return duration < o.duration;
+    return false;
+  }
+  DOCUMENT("The IP address of the client that owns this session.");
+  rdcstr client;
+
+  DOCUMENT(R"(The PID of the worker process replaying for this session, or ``0`` if the session is
+being replayed inside the server process itself.
+)");
+  uint32_t workerPID = 0;
+
+  DOCUMENT("The number of seconds since this session began.");
+  uint64_t duration = 0;
+};
+
+DECLARE_REFLECTION_STRUCT(RemoteServerSession);
+
+DOCUMENT("The current load and health statistics of a remote server.");
+struct RemoteServerStats
+{
+  DOCUMENT("");
+  RemoteServerStats() = default;
+  RemoteServerStats(const RemoteServerStats &) = default;
+
+  DOCUMENT("The maximum number of replay sessions that can be active at once.");
+  uint32_t maxSessions = 0;
+
+  DOCUMENT("The maximum number of clients that can be waiting for a free session.");
+  uint32_t maxQueued = 0;
+
+  DOCUMENT("The number of clients currently waiting for a free session.");
+  uint32_t queuedClients = 0;
+
+  DOCUMENT("The total number of sessions that have been started since the server started.");
+  uint64_t totalSessions = 0;
+
+  DOCUMENT("The total number of clients that were turned away because the server was full.");
+  uint64_t rejectedClients = 0;
+
+  DOCUMENT("The number of seconds the server has been running for.");
+  uint64_t uptime = 0;
+
+  DOCUMENT("The currently active :class:`sessions <RemoteServerSession>`.");
+  rdcarray<RemoteServerSession> sessions;
+};
+
+DECLARE_REFLECTION_STRUCT(RemoteServerStats);
+
 struct ResourceFormat;
 
 DOCUMENT("Internal function for getting the name for a resource format.");
@@ -1515,6 +1588,178 @@ struct CounterResult
 
 DECLARE_REFLECTION_STRUCT(CounterResult);
 
+DOCUMENT("The time spent in one phase of loading or replaying a capture.");
+struct ReplayPhaseTiming
+{
+  DOCUMENT("");
+  ReplayPhaseTiming() = default;
+  ReplayPhaseTiming(const ReplayPhaseTiming &) = default;
+  bool operator==(const ReplayPhaseTiming &o) const
+  {
+    return name == o.name && startTime == o.startTime && duration == o.duration;
+  }
+  bool operator<(const ReplayPhaseTiming &o) const
+  {
+    if(!(startTime == o.startTime))
+      return startTime < o.startTime;
+    if(!(name == o.name))
+      return name < o.name;
+    if(!(duration == o.duration))
+      return duration < o.duration;
+    return false;
+  }
+  DOCUMENT("The name of the phase, e.g. ``ReadLogInitialisation`` or ``ApplyInitialContents``.");
+  rdcstr name;
+
+  DOCUMENT("The time in seconds at which this phase began, relative to the capture being opened.");
+  double startTime = 0.0;
+
+  DOCUMENT("The time in seconds that this phase took.");
+  double duration = 0.0;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayPhaseTiming);
+
+DOCUMENT("The CPU time spent processing one type of chunk, summed over every chunk of that type.");
+struct ReplayChunkTiming
+{
+  DOCUMENT("");
+  ReplayChunkTiming() = default;
+  ReplayChunkTiming(const ReplayChunkTiming &) = default;
+  bool operator==(const ReplayChunkTiming &o) const
+  {
+    return chunkID == o.chunkID && name == o.name && count == o.count &&
+           deserialiseTime == o.deserialiseTime && executeTime == o.executeTime;
+  }
+  bool operator<(const ReplayChunkTiming &o) const
+  {
+    if(!(chunkID == o.chunkID))
+      return chunkID < o.chunkID;
+    if(!(name == o.name))
+      return name < o.name;
+    if(!(count == o.count))
+      return count < o.count;
+    if(!(deserialiseTime == o.deserialiseTime))
+      return deserialiseTime < o.deserialiseTime;
+    if(!(executeTime == o.executeTime))
+      return executeTime < o.executeTime;
+    return false;
+  }
+  DOCUMENT("The name of the chunk type.");
+  rdcstr name;
+
+  DOCUMENT("The API-specific ID of the chunk type.");
+  uint32_t chunkID = 0;
+
+  DOCUMENT("The number of chunks of this type that were processed.");
+  uint32_t count = 0;
+
+  DOCUMENT("The total time in seconds spent reading these chunks' parameters from the capture.");
+  double deserialiseTime = 0.0;
+
+  DOCUMENT("The total time in seconds spent executing these chunks on the replay API.");
+  double executeTime = 0.0;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayChunkTiming);
+
+DOCUMENT("The time spent replaying a single chunk within the captured frame.");
+struct ReplayEventTiming
+{
+  DOCUMENT("");
+  ReplayEventTiming() = default;
+  ReplayEventTiming(const ReplayEventTiming &) = default;
+  bool operator==(const ReplayEventTiming &o) const
+  {
+    return eventId == o.eventId && chunkID == o.chunkID && fileOffset == o.fileOffset &&
+           startTime == o.startTime && deserialiseTime == o.deserialiseTime &&
+           executeTime == o.executeTime && gpuTime == o.gpuTime;
+  }
+  bool operator<(const ReplayEventTiming &o) const
+  {
+    if(!(fileOffset == o.fileOffset))
+      return fileOffset < o.fileOffset;
+    if(!(eventId == o.eventId))
+      return eventId < o.eventId;
+    if(!(chunkID == o.chunkID))
+      return chunkID < o.chunkID;
+    if(!(startTime == o.startTime))
+      return startTime < o.startTime;
+    return false;
+  }
+  DOCUMENT(R"(The :data:`eventId <APIEvent.eventId>` of the event this chunk replays, or ``0``
+if the chunk does not correspond to an event.
+)");
+  uint32_t eventId = 0;
+
+  DOCUMENT("The API-specific ID of the chunk type.");
+  uint32_t chunkID = 0;
+
+  DOCUMENT(R"(The byte offset of this chunk in the frame data, matching
+:data:`APIEvent.fileOffset`.
+)");
+  uint64_t fileOffset = 0;
+
+  DOCUMENT("The time in seconds at which this chunk began, relative to the capture being opened.");
+  double startTime = 0.0;
+
+  DOCUMENT("The time in seconds spent reading this chunk's parameters from the capture.");
+  double deserialiseTime = 0.0;
+
+  DOCUMENT("The time in seconds spent executing this chunk on the replay API.");
+  double executeTime = 0.0;
+
+  DOCUMENT(R"(The GPU time in seconds spent on this event, or a negative value if GPU timings were
+not requested or are not available for this event.
+)");
+  double gpuTime = -1.0;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayEventTiming);
+
+DOCUMENT(R"(A profile of where time is spent when loading and replaying a capture.
+
+Chunk timings are split between deserialising a chunk's parameters and executing the resulting
+call on the replay API. Execution time is measured on the CPU, so for asynchronous APIs it only
+includes the cost of recording or submitting the work. GPU time is measured separately per event
+where the replay API supports it.
+)");
+struct ReplayProfile
+{
+  DOCUMENT("");
+  ReplayProfile() = default;
+  ReplayProfile(const ReplayProfile &) = default;
+
+  DOCUMENT(R"(The phases of loading and replaying the capture, in the order they happened.
+
+:type: List[ReplayPhaseTiming]
+)");
+  rdcarray<ReplayPhaseTiming> phases;
+
+  DOCUMENT(R"(Per chunk type timings of the chunks processed while loading the capture, before the
+captured frame itself. This includes resource creation and initial contents.
+
+:type: List[ReplayChunkTiming]
+)");
+  rdcarray<ReplayChunkTiming> loadChunks;
+
+  DOCUMENT(R"(Per chunk type timings of the chunks processed in the most recent full replay of the
+captured frame.
+
+:type: List[ReplayChunkTiming]
+)");
+  rdcarray<ReplayChunkTiming> replayChunks;
+
+  DOCUMENT(R"(The timing of each chunk processed in the most recent full replay of the captured
+frame, in the order they were replayed.
+
+:type: List[ReplayEventTiming]
+)");
+  rdcarray<ReplayEventTiming> events;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayProfile);
+
 DOCUMENT("The contents of an RGBA pixel.");
 union PixelValue
 {
@@ -1675,6 +1920,45 @@ pixel.
 
 DECLARE_REFLECTION_STRUCT(PixelModification);
 
+DOCUMENT(R"(The history of modifications to every pixel in a rectangular region of a texture.
+
+The modifications for all pixels are stored together in :data:`modifications`, with each pixel's
+modifications contiguous and in event order. Pixels are ordered in rows from the top-left of the
+region, so the pixel at ``(x + col, y + row)`` has index ``row * width + col``, and its
+modifications are the range ``modifications[offsets[index]:offsets[index+1]]``.
+)");
+struct PixelRegionHistory
+{
+  DOCUMENT("");
+  PixelRegionHistory() = default;
+  PixelRegionHistory(const PixelRegionHistory &) = default;
+
+  DOCUMENT("The x co-ordinate of the top-left of the region.");
+  uint32_t x = 0;
+  DOCUMENT("The y co-ordinate of the top-left of the region.");
+  uint32_t y = 0;
+  DOCUMENT("The width of the region in pixels.");
+  uint32_t width = 0;
+  DOCUMENT("The height of the region in pixels.");
+  uint32_t height = 0;
+
+  DOCUMENT(R"(The index in :data:`modifications` of the first modification of each pixel, with one
+final entry past the last pixel. There are ``width * height + 1`` entries, or none if no history
+could be fetched.
+
+:type: List[int]
+)");
+  rdcarray<uint32_t> offsets;
+
+  DOCUMENT(R"(The modifications of all pixels, grouped by pixel.
+
+:type: List[PixelModification]
+)");
+  rdcarray<PixelModification> modifications;
+};
+
+DECLARE_REFLECTION_STRUCT(PixelRegionHistory);
+
 DOCUMENT("Contains the bytes and metadata describing a thumbnail.");
 struct Thumbnail
 {
@@ -707,7 +707,7 @@ which is useful for operations like picking vertices that depends on the output
 the output data is not displayed anywhere natively.
 
 :return: The output texture data as tightly packed RGB 3-byte data.
-:rtype: ``bytes``
+:rtype: ``memoryview``
 )");
   virtual bytebuf ReadbackOutputTexture() = 0;
 
@@ -793,8 +793,8 @@ Should only be called for texture outputs.
   not added to any bucket.
 :param list channels: A list of four ``bool`` values indicating whether each of RGBA should be
   included in the count.
-:return: A list of the unnormalised bucket values.
-:rtype: ``list`` of ``int``
+:return: The unnormalised bucket values, as a read-only ``memoryview`` of unsigned 32-bit integers.
+:rtype: ``memoryview``
 )");
   virtual rdcarray<uint32_t> GetHistogram(float minval, float maxval, bool channels[4]) = 0;
 
@@ -1168,6 +1168,19 @@ understanding as well as the type and unit of the resulting information.
 )");
   virtual CounterDescription DescribeCounter(GPUCounter counter) = 0;
 
+  DOCUMENT(R"(Replay the whole frame once while timing it, and return where the time was spent.
+
+The profile includes the phases of loading the capture, per chunk type CPU timings both for loading
+and for replaying the frame, and the timing of each chunk in the frame. CPU time for each chunk is
+split between deserialising its parameters and executing it on the replay API.
+
+:param bool gpuTimings: ``True`` if GPU timings should also be fetched for each event. This uses
+  :data:`GPUCounter.EventGPUDuration` and so is only available when that counter is supported.
+:return: The replay profile.
+:rtype: ReplayProfile
+)");
+  virtual ReplayProfile GetReplayProfile(bool gpuTimings) = 0;
+
   DOCUMENT(R"(Retrieve the list of all resources in the capture.
 
 This includes any object allocated a :class:`ResourceId`, that don't have any other state or
@@ -1247,6 +1260,40 @@ only ever have one result (only one entry point per shader).
                                                    uint32_t slice, uint32_t mip, uint32_t sampleIdx,
                                                    CompType typeHint) = 0;
 
+  DOCUMENT(R"(Retrieve the history of modifications to every pixel in a region of the selected
+texture.
+
+This is equivalent to calling :meth:`PixelHistory` for each pixel in the region, but where possible
+the history of the whole region is gathered at once, which is much faster than fetching each pixel
+separately.
+
+Where the history is gathered for the whole region, modifications from drawcalls and dispatches are
+found by comparing each pixel before and after the event, so an event that writes the value a pixel
+already had is not listed for it, and per-fragment information such as the shader output and the
+failed tests is not available. Events whose effect can't be isolated are conservatively listed for
+every pixel in the region.
+
+.. note::
+  X and Y co-ordinates are always considered to be top-left, even on GL, as with
+  :meth:`PixelHistory`.
+
+:param ResourceId texture: The texture to search for modifications.
+:param int x: The x co-ordinate of the top-left of the region.
+:param int y: The y co-ordinate of the top-left of the region.
+:param int width: The width of the region. The region will be clamped to the texture.
+:param int height: The height of the region. The region will be clamped to the texture.
+:param int slice: The slice of an array or 3D texture, or face of a cubemap texture.
+:param int mip: The mip level to pick from.
+:param int sampleIdx: The multi-sampled sample. Ignored if non-multisampled texture.
+:param CompType typeHint: A hint on how to interpret textures that are typeless.
+:return: The history of every pixel in the region.
+:rtype: PixelRegionHistory
+)");
+  virtual PixelRegionHistory PixelHistoryRegion(ResourceId texture, uint32_t x, uint32_t y,
+                                                uint32_t width, uint32_t height, uint32_t slice,
+                                                uint32_t mip, uint32_t sampleIdx,
+                                                CompType typeHint) = 0;
+
   DOCUMENT(R"(Retrieve a debugging trace from running a vertex shader.
 
 :param int vertid: The vertex ID as a 0-based index up to the number of vertices in the draw.
@@ -1344,17 +1391,23 @@ texture to something compatible with the target file format.
 )");
   virtual MeshFormat GetPostVSData(uint32_t instance, uint32_t view, MeshDataStage stage) = 0;
 
-  DOCUMENT(R"(Retrieve the contents of a range of a buffer as a ``bytes``.
+  DOCUMENT(R"(Retrieve the contents of a range of a buffer.
+
+The data is returned as a read-only ``memoryview`` of unsigned bytes without being copied, so it
+can be passed directly to ``struct`` or numpy. Use ``bytes()`` to take a copy if needed.
 
 :param ResourceId buff: The id of the buffer to retrieve data from.
 :param int offset: The byte offset to the start of the range.
 :param int len: The length of the range, or 0 to retrieve the rest of the bytes in the buffer.
 :return: The requested buffer contents.
-:rtype: ``bytes``
+:rtype: ``memoryview``
 )");
   virtual bytebuf GetBufferData(ResourceId buff, uint64_t offset, uint64_t len) = 0;
 
-  DOCUMENT(R"(Retrieve the contents of one subresource of a texture as a ``bytes``.
+  DOCUMENT(R"(Retrieve the contents of one subresource of a texture.
+
+As with :meth:`GetBufferData` the data is returned as a read-only ``memoryview`` without being
+copied.
 
 For multi-sampled images, they are treated as if they are an array that is Nx longer, with each
 array slice being expanded in-place so it would be slice 0: sample 0, slice 0: sample 1, slice 1:
@@ -1364,7 +1417,7 @@ sample 0, etc.
 :param int arrayIdx: The slice of an array or 3D texture, or face of a cubemap texture.
 :param int mip: The mip level to pick from.
 :return: The requested texture contents.
-:rtype: ``bytes``
+:rtype: ``memoryview``
 )");
   virtual bytebuf GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip) = 0;
 
@@ -1477,6 +1530,19 @@ The details of the types of messages that can be received are listed under
   DOCUMENT("Cycle the currently active window if there are more windows to capture.");
   virtual void CycleActiveWindow() = 0;
 
+  DOCUMENT(R"(Enable or disable periodic telemetry on the overhead of capturing in the target.
+
+While enabled the target will time its hooked API calls and send a
+:data:`TargetControlMessageType.CaptureTelemetry` message around once a second. Telemetry is
+disabled again when the connection closes.
+
+.. note:: Timing every hooked call adds some overhead of its own, so this should only be enabled
+  while the statistics are being viewed.
+
+:param bool enabled: ``True`` to start sending telemetry, ``False`` to stop.
+)");
+  virtual void SetTelemetryEnabled(bool enabled) = 0;
+
 protected:
   ITargetControl() = default;
   ~ITargetControl() = default;
@@ -1535,7 +1601,7 @@ This index should not be cached, as writing sections could re-order the indices.
 
 :param int index: The index of the section.
 :return: The raw contents of the section, if the index is valid.
-:rtype: ``bytes``.
+:rtype: ``memoryview``
 )");
   virtual bytebuf GetSectionContents(int index) = 0;
 
@@ -1827,6 +1893,28 @@ representation back to native RDC.
   virtual ReplayStatus Convert(const char *filename, const char *filetype, const SDFile *file,
                                RENDERDOC_ProgressCallback progress) = 0;
 
+  DOCUMENT(R"(Saves the currently loaded capture to a new file, with the contents of its sections
+stored as content-addressed blobs in a shared store directory instead of in the file itself.
+
+Captures of several frames from the same program usually repeat much of the same data, such as the
+initial contents of resources. Each unique blob is only stored once, so packing a sequence of
+captures into the same store keeps one copy of the repeated data. Packed captures open as normal
+while the store is available, and can be unpacked again with :meth:`Convert` to ``rdc``.
+
+It is invalid to call this function if :meth:`OpenFile` has not previously been called to open the
+file.
+
+:param str filename: The filename to save to.
+:param str blobStore: The store directory, which is created if it doesn't exist. A relative path is
+  relative to the directory of the new file, which keeps the captures and store movable together.
+:param ProgressCallback progress: A callback that will be repeatedly called with an updated progress
+  value. Can be ``None`` if no progress is desired.
+:return: The status of the operation, whether it succeeded or failed (and how it failed).
+:rtype: ReplayStatus
+)");
+  virtual ReplayStatus PackToBlobStore(const char *filename, const char *blobStore,
+                                       RENDERDOC_ProgressCallback progress) = 0;
+
   DOCUMENT(R"(Returns the human-readable error string for the last error received.
 
 The error string is not reset by calling this function so it's safe to call multiple times. However
@@ -2152,6 +2240,18 @@ DOCUMENT(R"(Create a connection to a remote server running on given hostname and
 extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
 RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend);
 
+DOCUMENT(R"(Query the current load and health of a remote server, without starting a session on
+it or waiting in its queue.
+
+:param str URL: The hostname to connect to, if blank then localhost is used. If no protocol is
+  specified then default TCP enumeration happens.
+:return: The status of the query, whether success or failure, and the server's statistics if it
+  were successful
+:rtype: ``pair`` of ReplayStatus and RemoteServerStats
+)");
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_GetRemoteServerStats(const char *URL, RemoteServerStats *stats);
+
 DOCUMENT(R"(This launches a remote server which will continually run in a loop to server requests
 from external sources.
 
@@ -2321,6 +2421,14 @@ extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_RegisterMemoryRegion(void *
 DOCUMENT("Internal function for unregistering a memory region to be saved with crash dumps.");
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_UnregisterMemoryRegion(void *base);
 
+DOCUMENT("Internal function for training a Zstd dictionary from the chunk streams of captures.");
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC RENDERDOC_TrainZstdDictionary(
+    const rdcarray<rdcstr> &captures, uint32_t maxSize, bytebuf &dictionary);
+
+DOCUMENT("Internal function for comparing compression of capture chunk streams with a dictionary.");
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC RENDERDOC_EvaluateZstdDictionary(
+    const rdcarray<rdcstr> &captures, const bytebuf &dictionary, rdcstr &report);
+
 DOCUMENT(R"(Sets the location for the diagnostic log output, shared by captured programs and the
 analysis program.
 
@@ -3352,6 +3352,15 @@ DOCUMENT(R"(The type of message received from or sent to an application target c
 .. data:: CaptureProgress
 
   Progress update on an on-going frame capture.
+
+.. data:: CaptureMemory
+
+  Update on how much memory captured data is using in the target.
+
+.. data:: CaptureTelemetry
+
+  Periodic statistics on the overhead of capturing in the target, sent while telemetry is enabled
+  with :meth:`TargetControl.SetTelemetryEnabled`.
 )");
 enum class TargetControlMessageType : uint32_t
 {
@@ -3364,7 +3373,9 @@ enum class TargetControlMessageType : uint32_t
   RegisterAPI,
   NewChild,
   CaptureProgress,
-  CapturableWindowCount
+  CapturableWindowCount,
+  CaptureMemory,
+  CaptureTelemetry
 };
 
 DECLARE_REFLECTION_ENUM(TargetControlMessageType);
@@ -3566,6 +3577,12 @@ DOCUMENT(R"(A set of flags describing the properties of a section in a renderdoc
 .. data:: ZstdCompressed
 
   This section is compressed with Zstd on disk.
+
+.. data:: BlobReferences
+
+  This section's contents are stored as content-addressed blobs in a shared store directory, and the
+  section on disk only references them. See :meth:`CaptureFile.PackToBlobStore`. Any other
+  compression flag describes how the section is compressed once it is unpacked.
 )");
 enum class SectionFlags : uint32_t
 {
@@ -3573,6 +3590,7 @@ enum class SectionFlags : uint32_t
   ASCIIStored = 0x1,
   LZ4Compressed = 0x2,
   ZstdCompressed = 0x4,
+  BlobReferences = 0x8,
 };
 
 BITMASK_OPERATORS(SectionFlags);
@@ -123,8 +123,26 @@ bool Vec16NotEqual(void *a, void *b)
 #endif
 }
 
+static int64_t diffRangeTicks = 0;
+
+uint64_t GetFindDiffRangeTicks()
+{
+  return (uint64_t)diffRangeTicks;
+}
+
+struct ScopedDiffRangeTimer
+{
+  uint64_t start = Timing::GetTick();
+  ~ScopedDiffRangeTimer()
+  {
+    Atomic::ExchAdd64(&diffRangeTicks, int64_t(Timing::GetTick() - start));
+  }
+};
+
 bool FindDiffRange(void *a, void *b, size_t bufSize, size_t &diffStart, size_t &diffEnd)
 {
+  ScopedDiffRangeTimer timer;
+
   RDCASSERT(uintptr_t(a) % 16 == 0);
   RDCASSERT(uintptr_t(b) % 16 == 0);
 
@@ -25,6 +25,7 @@
 #include "dds_readwrite.h"
 #include <stdint.h>
 #include "common/common.h"
+#include "common/texture_decode.h"
 
 static const uint32_t dds_fourcc = MAKE_FOURCC('D', 'D', 'S', ' ');
 
@@ -1143,3 +1144,62 @@ dds_data load_dds_from_file(FILE *f)
 
   return ret;
 }
+
+bool decode_dds_to_rgba(dds_data &data)
+{
+  if(!IsBlockDecodeSupported(data.format))
+    return false;
+
+  const bool hdr =
+      data.format.type == ResourceFormatType::BC6 || data.format.compType == CompType::SNorm;
+  const DecodedFormat decodedFormat = hdr ? DecodedFormat::RGBA32F : DecodedFormat::RGBA8;
+
+  const int numSubresources = data.slices * data.mips;
+
+  // check everything is present before modifying anything
+  for(int i = 0; i < numSubresources; i++)
+  {
+    const int mip = i % data.mips;
+    const uint32_t w = (uint32_t)RDCMAX(1, data.width >> mip);
+    const uint32_t h = (uint32_t)RDCMAX(1, data.height >> mip);
+    const uint32_t d = (uint32_t)RDCMAX(1, data.depth >> mip);
+
+    if(data.subsizes[i] < GetBlockCompressedSize(data.format, w, h) * d)
+    {
+      RDCERR("Subresource %d is too small to decode", i);
+      return false;
+    }
+  }
+
+  for(int i = 0; i < numSubresources; i++)
+  {
+    const int mip = i % data.mips;
+    const uint32_t w = (uint32_t)RDCMAX(1, data.width >> mip);
+    const uint32_t h = (uint32_t)RDCMAX(1, data.height >> mip);
+    const uint32_t d = (uint32_t)RDCMAX(1, data.depth >> mip);
+
+    const size_t srcSize = GetBlockCompressedSize(data.format, w, h);
+    const size_t dstSize = size_t(w) * h * GetDecodedTexelSize(decodedFormat);
+
+    byte *decoded = new byte[dstSize * d];
+
+    // 3D textures have each depth slice stored consecutively
+    for(uint32_t z = 0; z < d; z++)
+      DecodeBlockCompressed(data.format, w, h, data.subdata[i] + srcSize * z, srcSize,
+                            decodedFormat, decoded + dstSize * z);
+
+    delete[] data.subdata[i];
+    data.subdata[i] = decoded;
+    data.subsizes[i] = uint32_t(dstSize * d);
+  }
+
+  ResourceFormat fmt;
+  fmt.type = ResourceFormatType::Regular;
+  fmt.compCount = 4;
+  fmt.compByteWidth = hdr ? 4 : 1;
+  fmt.compType = hdr ? CompType::Float
+                     : (data.format.SRGBCorrected() ? CompType::UNormSRGB : CompType::UNorm);
+  data.format = fmt;
+
+  return true;
+}
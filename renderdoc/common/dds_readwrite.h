@@ -46,3 +46,7 @@ struct dds_data
 extern bool is_dds_file(FILE *f);
 extern dds_data load_dds_from_file(FILE *f);
 extern bool write_dds_to_file(FILE *f, const dds_data &data);
+
+// replaces block-compressed data with RGBA data decoded on the CPU, as RGBA32F for HDR and signed
+// formats or RGBA8 otherwise. Returns false and leaves the data untouched if it can't be decoded.
+extern bool decode_dds_to_rgba(dds_data &data);
@@ -0,0 +1,1515 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "texture_decode.h"
+#include <string.h>
+#include "common/common.h"
+#include "maths/formatpacking.h"
+#include "maths/half_convert.h"
+#include "os/os_specific.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_DECODE_SSE2 OPTION_ON
+#else
+#define TEXTURE_DECODE_SSE2 OPTION_OFF
+#endif
+
+// the largest block footprint we decode, ASTC 12x12
+static const uint32_t MaxBlockTexels = 12 * 12;
+
+// images are split into bands of block rows, each decoded on its own thread. Bands are never
+// smaller than this many blocks so that small images are decoded inline.
+static const uint32_t MinBlocksPerJob = 4096;
+static const uint32_t MaxDecodeThreads = 8;
+
+struct BlockFormat
+{
+  uint32_t blockWidth = 4;
+  uint32_t blockHeight = 4;
+  uint32_t blockBytes = 0;
+
+  bool srgb = false;
+  bool isSigned = false;
+  uint32_t compCount = 4;
+
+  // exactly one of these is set, depending on whether the format natively decodes to 8-bit unorm
+  // or to float data. Either way the block is written as blockWidth * blockHeight RGBA texels.
+  void (*decode8)(const BlockFormat &fmt, const byte *block, byte *rgba) = NULL;
+  void (*decodeFloat)(const BlockFormat &fmt, const byte *block, float *rgba) = NULL;
+};
+
+static inline byte ClampByte(int32_t v)
+{
+  return byte(RDCCLAMP(v, 0, 255));
+}
+
+static inline int32_t SignExtend(uint32_t v, uint32_t bits)
+{
+  return int32_t(v << (32 - bits)) >> (32 - bits);
+}
+
+// reads bits LSB-first from a 16-byte block
+struct BlockBits
+{
+  BlockBits(const byte *block)
+  {
+    memcpy(&lo, block, sizeof(lo));
+    memcpy(&hi, block + sizeof(lo), sizeof(hi));
+  }
+
+  uint32_t Read(uint32_t count)
+  {
+    uint64_t ret;
+    if(offset >= 64)
+      ret = hi >> (offset - 64);
+    else if(offset + count <= 64)
+      ret = lo >> offset;
+    else
+      ret = (lo >> offset) | (hi << (64 - offset));
+    offset += count;
+    return uint32_t(ret & ((1ULL << count) - 1));
+  }
+
+  void Skip(uint32_t count) { offset += count; }
+  uint64_t lo = 0, hi = 0;
+  uint32_t offset = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Conversion from the kernels' native output to the destination format
+
+static void ConvertUNorm8ToFloat(const byte *src, float *dst, size_t count, bool srgb)
+{
+  size_t i = 0;
+
+  if(srgb)
+  {
+    for(; i < count; i += 4)
+    {
+      dst[i + 0] = ConvertFromSRGB8(src[i + 0]);
+      dst[i + 1] = ConvertFromSRGB8(src[i + 1]);
+      dst[i + 2] = ConvertFromSRGB8(src[i + 2]);
+      dst[i + 3] = float(src[i + 3]) * (1.0f / 255.0f);
+    }
+    return;
+  }
+
+#if ENABLED(TEXTURE_DECODE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+  for(; i + 16 <= count; i += 16)
+  {
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i lo = _mm_unpacklo_epi8(v, zero);
+    __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+    _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+    _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+  }
+#endif
+
+  for(; i < count; i++)
+    dst[i] = float(src[i]) * (1.0f / 255.0f);
+}
+
+static void ConvertFloatToUNorm8(const float *src, byte *dst, size_t count)
+{
+  size_t i = 0;
+
+#if ENABLED(TEXTURE_DECODE_SSE2)
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(255.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  for(; i + 16 <= count; i += 16)
+  {
+    __m128i v[4];
+    for(int j = 0; j < 4; j++)
+    {
+      // max returns the second operand for NaNs, so they clamp to 0 as in the scalar path
+      __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + j * 4), zero), one);
+      v[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+    }
+
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+    _mm_storeu_si128((__m128i *)(dst + i), packed);
+  }
+#endif
+
+  for(; i < count; i++)
+  {
+    float f = src[i];
+    f = f > 0.0f ? (f < 1.0f ? f : 1.0f) : 0.0f;
+    dst[i] = byte(f * 255.0f + 0.5f);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC1-5
+
+static void Expand565(uint16_t c, byte *rgba)
+{
+  uint32_t r = (c >> 11) & 0x1f, g = (c >> 5) & 0x3f, b = c & 0x1f;
+  rgba[0] = byte((r << 3) | (r >> 2));
+  rgba[1] = byte((g << 2) | (g >> 4));
+  rgba[2] = byte((b << 3) | (b >> 2));
+  rgba[3] = 255;
+}
+
+static void DecodeBC1Colour(const byte *block, bool threeColour, bool alpha, byte *rgba)
+{
+  uint16_t c0 = uint16_t(block[0] | (block[1] << 8));
+  uint16_t c1 = uint16_t(block[2] | (block[3] << 8));
+
+  byte palette[4][4];
+  Expand565(c0, palette[0]);
+  Expand565(c1, palette[1]);
+
+  // BC1 switches to three colours and black when the endpoints are ordered c0 <= c1. The colour
+  // block in BC2 and BC3 is always four colours.
+  if(c0 > c1 || !threeColour)
+  {
+    for(int c = 0; c < 3; c++)
+    {
+      palette[2][c] = byte((2 * palette[0][c] + palette[1][c] + 1) / 3);
+      palette[3][c] = byte((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+    }
+    palette[2][3] = palette[3][3] = 255;
+  }
+  else
+  {
+    for(int c = 0; c < 3; c++)
+    {
+      palette[2][c] = byte((palette[0][c] + palette[1][c] + 1) / 2);
+      palette[3][c] = 0;
+    }
+    palette[2][3] = 255;
+    // the black is transparent, unless the format has no alpha channel
+    palette[3][3] = alpha ? 0 : 255;
+  }
+
+  uint32_t indices =
+      block[4] | (block[5] << 8) | (block[6] << 16) | (uint32_t(block[7]) << 24);
+
+  for(uint32_t i = 0; i < 16; i++)
+    memcpy(rgba + i * 4, palette[(indices >> (i * 2)) & 0x3], 4);
+}
+
+static uint64_t ReadIndices48(const byte *data)
+{
+  uint64_t ret = 0;
+  for(int i = 0; i < 6; i++)
+    ret |= uint64_t(data[i]) << (8 * i);
+  return ret;
+}
+
+static void DecodeBC3Alpha(const byte *block, byte *rgba)
+{
+  uint32_t a0 = block[0], a1 = block[1];
+
+  byte palette[8] = {byte(a0), byte(a1)};
+  if(a0 > a1)
+  {
+    for(uint32_t i = 1; i < 7; i++)
+      palette[i + 1] = byte(((7 - i) * a0 + i * a1 + 3) / 7);
+  }
+  else
+  {
+    for(uint32_t i = 1; i < 5; i++)
+      palette[i + 1] = byte(((5 - i) * a0 + i * a1 + 2) / 5);
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+
+  uint64_t indices = ReadIndices48(block + 2);
+
+  for(uint32_t i = 0; i < 16; i++)
+    rgba[i * 4 + 3] = palette[(indices >> (i * 3)) & 0x7];
+}
+
+// decodes a BC4 block into one channel of 16 RGBA float texels
+static void DecodeBC4Channel(const byte *block, bool isSigned, float *rgba)
+{
+  float palette[8];
+  bool sixValues;
+
+  if(isSigned)
+  {
+    // -128 and -127 both decode to -1.0
+    int32_t r0 = RDCMAX(-127, int32_t(int8_t(block[0])));
+    int32_t r1 = RDCMAX(-127, int32_t(int8_t(block[1])));
+    palette[0] = float(r0) / 127.0f;
+    palette[1] = float(r1) / 127.0f;
+    sixValues = r0 <= r1;
+  }
+  else
+  {
+    palette[0] = float(block[0]) / 255.0f;
+    palette[1] = float(block[1]) / 255.0f;
+    sixValues = block[0] <= block[1];
+  }
+
+  if(!sixValues)
+  {
+    for(uint32_t i = 1; i < 7; i++)
+      palette[i + 1] = (palette[0] * float(7 - i) + palette[1] * float(i)) / 7.0f;
+  }
+  else
+  {
+    for(uint32_t i = 1; i < 5; i++)
+      palette[i + 1] = (palette[0] * float(5 - i) + palette[1] * float(i)) / 5.0f;
+    palette[6] = isSigned ? -1.0f : 0.0f;
+    palette[7] = 1.0f;
+  }
+
+  uint64_t indices = ReadIndices48(block + 2);
+
+  for(uint32_t i = 0; i < 16; i++)
+    rgba[i * 4] = palette[(indices >> (i * 3)) & 0x7];
+}
+
+static void DecodeBC1(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeBC1Colour(block, true, fmt.compCount == 4, rgba);
+}
+
+static void DecodeBC2(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeBC1Colour(block + 8, false, true, rgba);
+
+  for(uint32_t i = 0; i < 16; i++)
+    rgba[i * 4 + 3] = byte(((block[i / 2] >> ((i & 1) * 4)) & 0xf) * 17);
+}
+
+static void DecodeBC3(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeBC1Colour(block + 8, false, true, rgba);
+  DecodeBC3Alpha(block, rgba);
+}
+
+static void DecodeBC4(const BlockFormat &fmt, const byte *block, float *rgba)
+{
+  DecodeBC4Channel(block, fmt.isSigned, rgba);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    rgba[i * 4 + 1] = rgba[i * 4 + 2] = 0.0f;
+    rgba[i * 4 + 3] = 1.0f;
+  }
+}
+
+static void DecodeBC5(const BlockFormat &fmt, const byte *block, float *rgba)
+{
+  DecodeBC4Channel(block, fmt.isSigned, rgba);
+  DecodeBC4Channel(block + 8, fmt.isSigned, rgba + 1);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    rgba[i * 4 + 2] = 0.0f;
+    rgba[i * 4 + 3] = 1.0f;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BC6H and BC7
+
+// two-subset partitions, with the bit for each texel set if it's in the second subset
+static const uint16_t bc7Partitions2[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+    0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+    0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+    0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+    0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+// the anchor texel of the second subset in each two-subset partition
+static const uint8_t bc7Anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+    6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+// three-subset partitions, with two bits per texel for the subset index
+static const uint32_t bc7Partitions3[64] = {
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050,
+    0x5555a0a0, 0x5a5a5050, 0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090,
+    0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250, 0xa5945040, 0x0a425054,
+    0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+    0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414,
+    0x50a4a450, 0x6a5a0200, 0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424,
+    0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50, 0x500aa550, 0xaaaa4444,
+    0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+    0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580,
+    0xaa141414, 0x96960000, 0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000,
+    0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+};
+
+// the anchor texels of the second and third subsets in each three-subset partition
+static const uint8_t bc7Anchors3[2][64] = {
+    {
+        3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+        3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+        8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+        3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+    },
+    {
+        15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+        15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+        15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+        15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+    },
+};
+
+static const uint8_t bc7Weights2[4] = {0, 21, 43, 64};
+static const uint8_t bc7Weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+static const uint8_t bc7Weights4[16] = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64,
+};
+
+static const uint8_t *GetBC7Weights(uint32_t indexBits)
+{
+  return indexBits == 2 ? bc7Weights2 : indexBits == 3 ? bc7Weights3 : bc7Weights4;
+}
+
+static uint32_t GetBC7Subset(uint32_t subsets, uint32_t partition, uint32_t texel)
+{
+  if(subsets == 2)
+    return (bc7Partitions2[partition] >> texel) & 0x1;
+  if(subsets == 3)
+    return (bc7Partitions3[partition] >> (texel * 2)) & 0x3;
+  return 0;
+}
+
+// anchor texels store their index with the top bit omitted, as it's always 0
+static bool IsBC7Anchor(uint32_t subsets, uint32_t partition, uint32_t texel)
+{
+  if(texel == 0)
+    return true;
+  if(subsets == 2)
+    return texel == bc7Anchors2[partition];
+  if(subsets == 3)
+    return texel == bc7Anchors3[0][partition] || texel == bc7Anchors3[1][partition];
+  return false;
+}
+
+// the fields in a BC6H block header: the endpoints W/X of region 0 and Y/Z of region 1, and the
+// partition index D
+enum BC6Field
+{
+  BC6_RW,
+  BC6_GW,
+  BC6_BW,
+  BC6_RX,
+  BC6_GX,
+  BC6_BX,
+  BC6_RY,
+  BC6_GY,
+  BC6_BY,
+  BC6_RZ,
+  BC6_GZ,
+  BC6_BZ,
+  BC6_D,
+  BC6_NumFields,
+};
+
+// a run of consecutive bits in the block header belonging to one field
+struct BC6Run
+{
+  uint8_t field;
+  uint8_t bit;
+  // the number of bits, negative if the bits are stored from the highest bit down
+  int8_t count;
+};
+
+struct BC6Mode
+{
+  bool transformed;
+  uint32_t endpointBits;
+  uint32_t deltaBits[3];
+  // the header bits following the mode bits, terminated by a 0-length run
+  BC6Run runs[24];
+};
+
+static const BC6Mode bc6Modes[14] = {
+    // mode 1
+    {
+        true, 10, {5, 5, 5},
+        {
+            {BC6_GY, 4, 1}, {BC6_BY, 4, 1}, {BC6_BZ, 4, 1}, {BC6_RW, 0, 10}, {BC6_GW, 0, 10},
+            {BC6_BW, 0, 10}, {BC6_RX, 0, 5}, {BC6_GZ, 4, 1}, {BC6_GY, 0, 4}, {BC6_GX, 0, 5},
+            {BC6_BZ, 0, 1}, {BC6_GZ, 0, 4}, {BC6_BX, 0, 5}, {BC6_BZ, 1, 1}, {BC6_BY, 0, 4},
+            {BC6_RY, 0, 5}, {BC6_BZ, 2, 1}, {BC6_RZ, 0, 5}, {BC6_BZ, 3, 1}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 2
+    {
+        true, 7, {6, 6, 6},
+        {
+            {BC6_GY, 5, 1}, {BC6_GZ, 4, 1}, {BC6_GZ, 5, 1}, {BC6_RW, 0, 7}, {BC6_BZ, 0, 1},
+            {BC6_BZ, 1, 1}, {BC6_BY, 4, 1}, {BC6_GW, 0, 7}, {BC6_BY, 5, 1}, {BC6_BZ, 2, 1},
+            {BC6_GY, 4, 1}, {BC6_BW, 0, 7}, {BC6_BZ, 3, 1}, {BC6_BZ, 5, 1}, {BC6_BZ, 4, 1},
+            {BC6_RX, 0, 6}, {BC6_GY, 0, 4}, {BC6_GX, 0, 6}, {BC6_GZ, 0, 4}, {BC6_BX, 0, 6},
+            {BC6_BY, 0, 4}, {BC6_RY, 0, 6}, {BC6_RZ, 0, 6}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 3
+    {
+        true, 11, {5, 4, 4},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 5}, {BC6_RW, 10, 1},
+            {BC6_GY, 0, 4}, {BC6_GX, 0, 4}, {BC6_GW, 10, 1}, {BC6_BZ, 0, 1}, {BC6_GZ, 0, 4},
+            {BC6_BX, 0, 4}, {BC6_BW, 10, 1}, {BC6_BZ, 1, 1}, {BC6_BY, 0, 4}, {BC6_RY, 0, 5},
+            {BC6_BZ, 2, 1}, {BC6_RZ, 0, 5}, {BC6_BZ, 3, 1}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 4
+    {
+        true, 11, {4, 5, 4},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 4}, {BC6_RW, 10, 1},
+            {BC6_GZ, 4, 1}, {BC6_GY, 0, 4}, {BC6_GX, 0, 5}, {BC6_GW, 10, 1}, {BC6_GZ, 0, 4},
+            {BC6_BX, 0, 4}, {BC6_BW, 10, 1}, {BC6_BZ, 1, 1}, {BC6_BY, 0, 4}, {BC6_RY, 0, 4},
+            {BC6_BZ, 0, 1}, {BC6_BZ, 2, 1}, {BC6_RZ, 0, 4}, {BC6_GY, 4, 1}, {BC6_BZ, 3, 1},
+            {BC6_D, 0, 5}
+        },
+    },
+    // mode 5
+    {
+        true, 11, {4, 4, 5},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 4}, {BC6_RW, 10, 1},
+            {BC6_BY, 4, 1}, {BC6_GY, 0, 4}, {BC6_GX, 0, 4}, {BC6_GW, 10, 1}, {BC6_BZ, 0, 1},
+            {BC6_GZ, 0, 4}, {BC6_BX, 0, 5}, {BC6_BW, 10, 1}, {BC6_BY, 0, 4}, {BC6_RY, 0, 4},
+            {BC6_BZ, 1, 1}, {BC6_BZ, 2, 1}, {BC6_RZ, 0, 4}, {BC6_BZ, 4, 1}, {BC6_BZ, 3, 1},
+            {BC6_D, 0, 5}
+        },
+    },
+    // mode 6
+    {
+        true, 9, {5, 5, 5},
+        {
+            {BC6_RW, 0, 9}, {BC6_BY, 4, 1}, {BC6_GW, 0, 9}, {BC6_GY, 4, 1}, {BC6_BW, 0, 9},
+            {BC6_BZ, 4, 1}, {BC6_RX, 0, 5}, {BC6_GZ, 4, 1}, {BC6_GY, 0, 4}, {BC6_GX, 0, 5},
+            {BC6_BZ, 0, 1}, {BC6_GZ, 0, 4}, {BC6_BX, 0, 5}, {BC6_BZ, 1, 1}, {BC6_BY, 0, 4},
+            {BC6_RY, 0, 5}, {BC6_BZ, 2, 1}, {BC6_RZ, 0, 5}, {BC6_BZ, 3, 1}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 7
+    {
+        true, 8, {6, 5, 5},
+        {
+            {BC6_RW, 0, 8}, {BC6_GZ, 4, 1}, {BC6_BY, 4, 1}, {BC6_GW, 0, 8}, {BC6_BZ, 2, 1},
+            {BC6_GY, 4, 1}, {BC6_BW, 0, 8}, {BC6_BZ, 3, 1}, {BC6_BZ, 4, 1}, {BC6_RX, 0, 6},
+            {BC6_GY, 0, 4}, {BC6_GX, 0, 5}, {BC6_BZ, 0, 1}, {BC6_GZ, 0, 4}, {BC6_BX, 0, 5},
+            {BC6_BZ, 1, 1}, {BC6_BY, 0, 4}, {BC6_RY, 0, 6}, {BC6_RZ, 0, 6}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 8
+    {
+        true, 8, {5, 6, 5},
+        {
+            {BC6_RW, 0, 8}, {BC6_BZ, 0, 1}, {BC6_BY, 4, 1}, {BC6_GW, 0, 8}, {BC6_GY, 5, 1},
+            {BC6_GY, 4, 1}, {BC6_BW, 0, 8}, {BC6_GZ, 5, 1}, {BC6_BZ, 4, 1}, {BC6_RX, 0, 5},
+            {BC6_GZ, 4, 1}, {BC6_GY, 0, 4}, {BC6_GX, 0, 6}, {BC6_GZ, 0, 4}, {BC6_BX, 0, 5},
+            {BC6_BZ, 1, 1}, {BC6_BY, 0, 4}, {BC6_RY, 0, 5}, {BC6_BZ, 2, 1}, {BC6_RZ, 0, 5},
+            {BC6_BZ, 3, 1}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 9
+    {
+        true, 8, {5, 5, 6},
+        {
+            {BC6_RW, 0, 8}, {BC6_BZ, 1, 1}, {BC6_BY, 4, 1}, {BC6_GW, 0, 8}, {BC6_BY, 5, 1},
+            {BC6_GY, 4, 1}, {BC6_BW, 0, 8}, {BC6_BZ, 5, 1}, {BC6_BZ, 4, 1}, {BC6_RX, 0, 5},
+            {BC6_GZ, 4, 1}, {BC6_GY, 0, 4}, {BC6_GX, 0, 5}, {BC6_BZ, 0, 1}, {BC6_GZ, 0, 4},
+            {BC6_BX, 0, 6}, {BC6_BY, 0, 4}, {BC6_RY, 0, 5}, {BC6_BZ, 2, 1}, {BC6_RZ, 0, 5},
+            {BC6_BZ, 3, 1}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 10
+    {
+        false, 6, {6, 6, 6},
+        {
+            {BC6_RW, 0, 6}, {BC6_GZ, 4, 1}, {BC6_BZ, 0, 1}, {BC6_BZ, 1, 1}, {BC6_BY, 4, 1},
+            {BC6_GW, 0, 6}, {BC6_GY, 5, 1}, {BC6_BY, 5, 1}, {BC6_BZ, 2, 1}, {BC6_GY, 4, 1},
+            {BC6_BW, 0, 6}, {BC6_GZ, 5, 1}, {BC6_BZ, 3, 1}, {BC6_BZ, 5, 1}, {BC6_BZ, 4, 1},
+            {BC6_RX, 0, 6}, {BC6_GY, 0, 4}, {BC6_GX, 0, 6}, {BC6_GZ, 0, 4}, {BC6_BX, 0, 6},
+            {BC6_BY, 0, 4}, {BC6_RY, 0, 6}, {BC6_RZ, 0, 6}, {BC6_D, 0, 5}
+        },
+    },
+    // mode 11
+    {
+        false, 10, {10, 10, 10},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 10}, {BC6_GX, 0, 10},
+            {BC6_BX, 0, 10}
+        },
+    },
+    // mode 12
+    {
+        true, 11, {9, 9, 9},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 9}, {BC6_RW, 10, 1},
+            {BC6_GX, 0, 9}, {BC6_GW, 10, 1}, {BC6_BX, 0, 9}, {BC6_BW, 10, 1}
+        },
+    },
+    // mode 13
+    {
+        true, 12, {8, 8, 8},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 8}, {BC6_RW, 11, -2},
+            {BC6_GX, 0, 8}, {BC6_GW, 11, -2}, {BC6_BX, 0, 8}, {BC6_BW, 11, -2}
+        },
+    },
+    // mode 14
+    {
+        true, 16, {4, 4, 4},
+        {
+            {BC6_RW, 0, 10}, {BC6_GW, 0, 10}, {BC6_BW, 0, 10}, {BC6_RX, 0, 4}, {BC6_RW, 15, -6},
+            {BC6_GX, 0, 4}, {BC6_GW, 15, -6}, {BC6_BX, 0, 4}, {BC6_BW, 15, -6}
+        },
+    },
+};
+
+// returns the index into bc6Modes for the block, or -1 for reserved modes
+static int GetBC6Mode(const byte *block, uint32_t &modeBits)
+{
+  if((block[0] & 0x2) == 0)
+  {
+    modeBits = 2;
+    return block[0] & 0x1;
+  }
+
+  modeBits = 5;
+  switch(block[0] & 0x1f)
+  {
+    case 0x02: return 2;
+    case 0x06: return 3;
+    case 0x0a: return 4;
+    case 0x0e: return 5;
+    case 0x12: return 6;
+    case 0x16: return 7;
+    case 0x1a: return 8;
+    case 0x1e: return 9;
+    case 0x03: return 10;
+    case 0x07: return 11;
+    case 0x0b: return 12;
+    case 0x0f: return 13;
+    default: break;
+  }
+
+  return -1;
+}
+
+static int32_t UnquantizeBC6(int32_t comp, uint32_t bits, bool isSigned)
+{
+  if(!isSigned)
+  {
+    if(bits >= 15 || comp == 0)
+      return comp;
+    if(comp == (1 << bits) - 1)
+      return 0xffff;
+    return ((comp << 16) + 0x8000) >> bits;
+  }
+
+  if(bits >= 16)
+    return comp;
+
+  bool negative = comp < 0;
+  if(negative)
+    comp = -comp;
+
+  int32_t ret;
+  if(comp == 0)
+    ret = 0;
+  else if(comp >= (1 << (bits - 1)) - 1)
+    ret = 0x7fff;
+  else
+    ret = ((comp << 15) + 0x4000) >> (bits - 1);
+
+  return negative ? -ret : ret;
+}
+
+static float FinishBC6(int32_t v, bool isSigned)
+{
+  uint16_t half;
+  if(!isSigned)
+    half = uint16_t((v * 31) >> 6);
+  else if(v < 0)
+    half = uint16_t(0x8000 | ((-v * 31) >> 5));
+  else
+    half = uint16_t((v * 31) >> 5);
+
+  return ConvertFromHalf(half);
+}
+
+static void DecodeBC6(const BlockFormat &fmt, const byte *block, float *rgba)
+{
+  uint32_t modeBits = 0;
+  int mode = GetBC6Mode(block, modeBits);
+
+  if(mode < 0)
+  {
+    for(uint32_t i = 0; i < 16; i++)
+    {
+      rgba[i * 4 + 0] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = 0.0f;
+      rgba[i * 4 + 3] = 1.0f;
+    }
+    return;
+  }
+
+  const BC6Mode &m = bc6Modes[mode];
+  const bool isSigned = fmt.isSigned;
+
+  BlockBits bits(block);
+  bits.Skip(modeBits);
+
+  uint32_t fields[BC6_NumFields] = {};
+  for(const BC6Run &run : m.runs)
+  {
+    if(run.count == 0)
+      break;
+
+    if(run.count > 0)
+    {
+      fields[run.field] |= bits.Read(run.count) << run.bit;
+    }
+    else
+    {
+      for(int b = 0; b < -run.count; b++)
+        fields[run.field] |= bits.Read(1) << (run.bit - b);
+    }
+  }
+
+  const uint32_t regions = mode < 10 ? 2 : 1;
+  const uint32_t numEndpoints = regions * 2;
+  const uint32_t partition = fields[BC6_D];
+  const uint32_t mask = (1U << m.endpointBits) - 1;
+
+  int32_t endpoints[4][3];
+  for(uint32_t c = 0; c < 3; c++)
+  {
+    int32_t base = int32_t(fields[BC6_RW + c]);
+    if(isSigned)
+      base = SignExtend(uint32_t(base), m.endpointBits);
+    endpoints[0][c] = base;
+
+    for(uint32_t e = 1; e < numEndpoints; e++)
+    {
+      uint32_t v = fields[BC6_RW + e * 3 + c];
+
+      // transformed modes store the other endpoints as deltas from the first
+      if(m.transformed)
+        v = uint32_t(base + SignExtend(v, m.deltaBits[c])) & mask;
+
+      endpoints[e][c] = isSigned ? SignExtend(v, m.endpointBits) : int32_t(v);
+    }
+
+    for(uint32_t e = 0; e < numEndpoints; e++)
+      endpoints[e][c] = UnquantizeBC6(endpoints[e][c], m.endpointBits, isSigned);
+  }
+
+  const uint32_t indexBits = regions == 2 ? 3 : 4;
+  const uint8_t *weights = GetBC7Weights(indexBits);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    uint32_t region = GetBC7Subset(regions, partition, i);
+    uint32_t index = bits.Read(IsBC7Anchor(regions, partition, i) ? indexBits - 1 : indexBits);
+
+    const int32_t w = weights[index];
+    const int32_t *e0 = endpoints[region * 2];
+    const int32_t *e1 = endpoints[region * 2 + 1];
+
+    for(uint32_t c = 0; c < 3; c++)
+      rgba[i * 4 + c] = FinishBC6(((64 - w) * e0[c] + w * e1[c] + 32) >> 6, isSigned);
+    rgba[i * 4 + 3] = 1.0f;
+  }
+}
+
+struct BC7Mode
+{
+  uint32_t subsets;
+  uint32_t partitionBits;
+  uint32_t rotationBits;
+  uint32_t indexSelectionBits;
+  uint32_t colourBits;
+  uint32_t alphaBits;
+  uint32_t endpointPBits;
+  uint32_t sharedPBits;
+  uint32_t indexBits;
+  uint32_t index2Bits;
+};
+
+static const BC7Mode bc7Modes[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+// fills count palette entries (always a multiple of 2) interpolated between two RGBA8 endpoints
+static void InterpolateBC7(const byte *e0, const byte *e1, const uint8_t *weights, uint32_t count,
+                           byte *palette)
+{
+#if ENABLED(TEXTURE_DECODE_SSE2)
+  uint32_t packed0, packed1;
+  memcpy(&packed0, e0, sizeof(packed0));
+  memcpy(&packed1, e1, sizeof(packed1));
+
+  // both endpoints widened to 16-bits and duplicated, to process two entries at a time
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i a = _mm_unpacklo_epi8(_mm_set1_epi32(int(packed0)), zero);
+  const __m128i b = _mm_unpacklo_epi8(_mm_set1_epi32(int(packed1)), zero);
+  const __m128i sixtyfour = _mm_set1_epi16(64);
+  const __m128i round = _mm_set1_epi16(32);
+
+  for(uint32_t i = 0; i < count; i += 2)
+  {
+    const short w0 = short(weights[i]), w1 = short(weights[i + 1]);
+    __m128i wb = _mm_set_epi16(w1, w1, w1, w1, w0, w0, w0, w0);
+    __m128i wa = _mm_sub_epi16(sixtyfour, wb);
+
+    __m128i v = _mm_add_epi16(_mm_mullo_epi16(a, wa), _mm_mullo_epi16(b, wb));
+    v = _mm_srli_epi16(_mm_add_epi16(v, round), 6);
+
+    _mm_storel_epi64((__m128i *)(palette + i * 4), _mm_packus_epi16(v, v));
+  }
+#else
+  for(uint32_t i = 0; i < count; i++)
+  {
+    const uint32_t w = weights[i];
+    for(uint32_t c = 0; c < 4; c++)
+      palette[i * 4 + c] = byte(((64 - w) * e0[c] + w * e1[c] + 32) >> 6);
+  }
+#endif
+}
+
+static void DecodeBC7(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  uint32_t mode = 0;
+  while(mode < 8 && (block[0] & (1 << mode)) == 0)
+    mode++;
+
+  // reserved mode
+  if(mode == 8)
+  {
+    memset(rgba, 0, 16 * 4);
+    return;
+  }
+
+  const BC7Mode &m = bc7Modes[mode];
+
+  BlockBits bits(block);
+  bits.Skip(mode + 1);
+
+  const uint32_t partition = bits.Read(m.partitionBits);
+  const uint32_t rotation = bits.Read(m.rotationBits);
+  const uint32_t indexSelection = bits.Read(m.indexSelectionBits);
+
+  const uint32_t numEndpoints = m.subsets * 2;
+  byte endpoints[6][4];
+
+  for(uint32_t c = 0; c < 3; c++)
+    for(uint32_t e = 0; e < numEndpoints; e++)
+      endpoints[e][c] = byte(bits.Read(m.colourBits));
+
+  for(uint32_t e = 0; e < numEndpoints; e++)
+    endpoints[e][3] = m.alphaBits ? byte(bits.Read(m.alphaBits)) : 255;
+
+  uint32_t colourBits = m.colourBits, alphaBits = m.alphaBits;
+
+  if(m.endpointPBits || m.sharedPBits)
+  {
+    // p-bits are either one per endpoint, or one shared by both endpoints in a subset
+    for(uint32_t e = 0; e < numEndpoints; e++)
+    {
+      if(m.sharedPBits && (e & 1))
+        continue;
+
+      const uint32_t p = bits.Read(1);
+      for(uint32_t shared = 0; shared < (m.sharedPBits ? 2U : 1U); shared++)
+      {
+        byte *endpoint = endpoints[e + shared];
+        for(uint32_t c = 0; c < 3; c++)
+          endpoint[c] = byte((endpoint[c] << 1) | p);
+        if(m.alphaBits)
+          endpoint[3] = byte((endpoint[3] << 1) | p);
+      }
+    }
+
+    colourBits++;
+    if(alphaBits)
+      alphaBits++;
+  }
+
+  // expand to 8 bits by replicating the top bits into the bottom
+  for(uint32_t e = 0; e < numEndpoints; e++)
+  {
+    for(uint32_t c = 0; c < 3; c++)
+      endpoints[e][c] =
+          byte((endpoints[e][c] << (8 - colourBits)) | (endpoints[e][c] >> (2 * colourBits - 8)));
+    if(alphaBits)
+      endpoints[e][3] =
+          byte((endpoints[e][3] << (8 - alphaBits)) | (endpoints[e][3] >> (2 * alphaBits - 8)));
+  }
+
+  byte indices[16], indices2[16];
+
+  for(uint32_t i = 0; i < 16; i++)
+    indices[i] = byte(
+        bits.Read(IsBC7Anchor(m.subsets, partition, i) ? m.indexBits - 1 : m.indexBits));
+
+  if(m.index2Bits)
+  {
+    for(uint32_t i = 0; i < 16; i++)
+      indices2[i] = byte(bits.Read(i == 0 ? m.index2Bits - 1 : m.index2Bits));
+  }
+
+  byte palette[3][16][4];
+  byte palette2[8][4];
+
+  for(uint32_t s = 0; s < m.subsets; s++)
+    InterpolateBC7(endpoints[s * 2], endpoints[s * 2 + 1], GetBC7Weights(m.indexBits),
+                   1U << m.indexBits, palette[s][0]);
+
+  if(m.index2Bits)
+    InterpolateBC7(endpoints[0], endpoints[1], GetBC7Weights(m.index2Bits), 1U << m.index2Bits,
+                   palette2[0]);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    byte *texel = rgba + i * 4;
+
+    if(m.index2Bits)
+    {
+      // the colour and alpha come from separate index sets, which the index selection bit swaps
+      const byte *colour = indexSelection ? palette2[indices2[i]] : palette[0][indices[i]];
+      const byte *alpha = indexSelection ? palette[0][indices[i]] : palette2[indices2[i]];
+      memcpy(texel, colour, 3);
+      texel[3] = alpha[3];
+    }
+    else
+    {
+      memcpy(texel, palette[GetBC7Subset(m.subsets, partition, i)][indices[i]], 4);
+    }
+
+    if(rotation)
+      std::swap(texel[3], texel[rotation - 1]);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ETC2 and EAC
+
+static const int32_t etc1Modifiers[8][2] = {
+    {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183},
+};
+
+static const int32_t etc2Distances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const int32_t eacModifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},     {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},     {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},     {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},      {-3, -5, -7, -9, 2, 4, 6, 8},
+};
+
+// ETC2 and EAC blocks are stored big-endian
+static uint64_t ReadBigEndian64(const byte *block)
+{
+  uint64_t ret = 0;
+  for(int i = 0; i < 8; i++)
+    ret = (ret << 8) | block[i];
+  return ret;
+}
+
+// the 2-bit index for a texel is split between the two 16-bit halves of the low word, and texels
+// are stored in column-major order
+static inline uint32_t GetETC2Index(uint32_t indices, uint32_t x, uint32_t y)
+{
+  const uint32_t p = x * 4 + y;
+  return (((indices >> (16 + p)) & 0x1) << 1) | ((indices >> p) & 0x1);
+}
+
+// writes the texels for the T and H modes, where each index selects one of four paint colours
+static void WriteETC2Paints(const int32_t paints[4][3], uint32_t indices, bool opaque, byte *rgba)
+{
+  for(uint32_t y = 0; y < 4; y++)
+  {
+    for(uint32_t x = 0; x < 4; x++)
+    {
+      const uint32_t idx = GetETC2Index(indices, x, y);
+      byte *texel = rgba + (y * 4 + x) * 4;
+
+      if(!opaque && idx == 2)
+      {
+        memset(texel, 0, 4);
+        continue;
+      }
+
+      for(uint32_t c = 0; c < 3; c++)
+        texel[c] = ClampByte(paints[idx][c]);
+      texel[3] = 255;
+    }
+  }
+}
+
+static void DecodeETC2T(uint32_t hi, uint32_t indices, bool opaque, byte *rgba)
+{
+  const int32_t c1[3] = {
+      int32_t((((hi >> 27) & 0x3) << 2) | ((hi >> 24) & 0x3)) * 17,
+      int32_t((hi >> 20) & 0xf) * 17,
+      int32_t((hi >> 16) & 0xf) * 17,
+  };
+  const int32_t c2[3] = {
+      int32_t((hi >> 12) & 0xf) * 17,
+      int32_t((hi >> 8) & 0xf) * 17,
+      int32_t((hi >> 4) & 0xf) * 17,
+  };
+  const int32_t d = etc2Distances[(((hi >> 2) & 0x3) << 1) | (hi & 0x1)];
+
+  int32_t paints[4][3];
+  for(uint32_t c = 0; c < 3; c++)
+  {
+    paints[0][c] = c1[c];
+    paints[1][c] = c2[c] + d;
+    paints[2][c] = c2[c];
+    paints[3][c] = c2[c] - d;
+  }
+
+  WriteETC2Paints(paints, indices, opaque, rgba);
+}
+
+static void DecodeETC2H(uint32_t hi, uint32_t indices, bool opaque, byte *rgba)
+{
+  const uint32_t r1 = (hi >> 27) & 0xf;
+  const uint32_t g1 = (((hi >> 24) & 0x7) << 1) | ((hi >> 20) & 0x1);
+  const uint32_t b1 = (((hi >> 19) & 0x1) << 3) | ((hi >> 15) & 0x7);
+  const uint32_t r2 = (hi >> 11) & 0xf;
+  const uint32_t g2 = (hi >> 7) & 0xf;
+  const uint32_t b2 = (hi >> 3) & 0xf;
+
+  // the lowest bit of the distance index is implied by the ordering of the two colours
+  const uint32_t order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+  const int32_t d = etc2Distances[(((hi >> 2) & 0x1) << 2) | ((hi & 0x1) << 1) | order];
+
+  const int32_t c1[3] = {int32_t(r1 * 17), int32_t(g1 * 17), int32_t(b1 * 17)};
+  const int32_t c2[3] = {int32_t(r2 * 17), int32_t(g2 * 17), int32_t(b2 * 17)};
+
+  int32_t paints[4][3];
+  for(uint32_t c = 0; c < 3; c++)
+  {
+    paints[0][c] = c1[c] + d;
+    paints[1][c] = c1[c] - d;
+    paints[2][c] = c2[c] + d;
+    paints[3][c] = c2[c] - d;
+  }
+
+  WriteETC2Paints(paints, indices, opaque, rgba);
+}
+
+static void DecodeETC2Planar(uint32_t hi, uint32_t lo, byte *rgba)
+{
+  const uint32_t ro = (hi >> 25) & 0x3f;
+  const uint32_t go = (((hi >> 24) & 0x1) << 6) | ((hi >> 17) & 0x3f);
+  const uint32_t bo = (((hi >> 16) & 0x1) << 5) | (((hi >> 11) & 0x3) << 3) | ((hi >> 7) & 0x7);
+  const uint32_t rh = (((hi >> 2) & 0x1f) << 1) | (hi & 0x1);
+  const uint32_t gh = (lo >> 25) & 0x7f;
+  const uint32_t bh = (lo >> 19) & 0x3f;
+  const uint32_t rv = (lo >> 13) & 0x3f;
+  const uint32_t gv = (lo >> 6) & 0x7f;
+  const uint32_t bv = lo & 0x3f;
+
+  auto expand6 = [](uint32_t c) { return int32_t((c << 2) | (c >> 4)); };
+  auto expand7 = [](uint32_t c) { return int32_t((c << 1) | (c >> 6)); };
+
+  const int32_t o[3] = {expand6(ro), expand7(go), expand6(bo)};
+  const int32_t h[3] = {expand6(rh), expand7(gh), expand6(bh)};
+  const int32_t v[3] = {expand6(rv), expand7(gv), expand6(bv)};
+
+  for(int32_t y = 0; y < 4; y++)
+  {
+    for(int32_t x = 0; x < 4; x++)
+    {
+      byte *texel = rgba + (y * 4 + x) * 4;
+      for(uint32_t c = 0; c < 3; c++)
+        texel[c] = ClampByte((x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2);
+      texel[3] = 255;
+    }
+  }
+}
+
+static void DecodeETC2Colour(const byte *block, bool punchthrough, byte *rgba)
+{
+  const uint64_t bits = ReadBigEndian64(block);
+  const uint32_t hi = uint32_t(bits >> 32);
+  const uint32_t indices = uint32_t(bits & 0xffffffff);
+
+  // with punch-through alpha the diff bit is instead the opaque flag, and the individual mode
+  // isn't available
+  const bool opaque = !punchthrough || (hi & 0x2) != 0;
+  const bool diff = punchthrough || (hi & 0x2) != 0;
+  const bool flip = (hi & 0x1) != 0;
+
+  int32_t base[2][3];
+
+  if(!diff)
+  {
+    for(uint32_t c = 0; c < 3; c++)
+    {
+      base[0][c] = int32_t((hi >> (28 - c * 8)) & 0xf) * 17;
+      base[1][c] = int32_t((hi >> (24 - c * 8)) & 0xf) * 17;
+    }
+  }
+  else
+  {
+    int32_t c1[3], c2[3];
+    for(uint32_t c = 0; c < 3; c++)
+    {
+      c1[c] = int32_t((hi >> (27 - c * 8)) & 0x1f);
+      c2[c] = c1[c] + SignExtend((hi >> (24 - c * 8)) & 0x7, 3);
+    }
+
+    // ETC2 uses the otherwise invalid overflowing differential colours to select its new modes
+    if(c2[0] < 0 || c2[0] > 31)
+    {
+      DecodeETC2T(hi, indices, opaque, rgba);
+      return;
+    }
+    if(c2[1] < 0 || c2[1] > 31)
+    {
+      DecodeETC2H(hi, indices, opaque, rgba);
+      return;
+    }
+    if(c2[2] < 0 || c2[2] > 31)
+    {
+      DecodeETC2Planar(hi, indices, rgba);
+      return;
+    }
+
+    for(uint32_t c = 0; c < 3; c++)
+    {
+      base[0][c] = (c1[c] << 3) | (c1[c] >> 2);
+      base[1][c] = (c2[c] << 3) | (c2[c] >> 2);
+    }
+  }
+
+  const uint32_t tables[2] = {(hi >> 5) & 0x7, (hi >> 2) & 0x7};
+
+  for(uint32_t y = 0; y < 4; y++)
+  {
+    for(uint32_t x = 0; x < 4; x++)
+    {
+      const uint32_t idx = GetETC2Index(indices, x, y);
+      const uint32_t sub = flip ? (y >= 2 ? 1 : 0) : (x >= 2 ? 1 : 0);
+      byte *texel = rgba + (y * 4 + x) * 4;
+
+      if(!opaque && idx == 2)
+      {
+        memset(texel, 0, 4);
+        continue;
+      }
+
+      int32_t mod = etc1Modifiers[tables[sub]][idx & 0x1];
+      if(idx & 0x2)
+        mod = -mod;
+      if(!opaque && idx == 0)
+        mod = 0;
+
+      for(uint32_t c = 0; c < 3; c++)
+        texel[c] = ClampByte(base[sub][c] + mod);
+      texel[3] = 255;
+    }
+  }
+}
+
+static void DecodeEACAlpha(const byte *block, byte *rgba)
+{
+  const uint64_t bits = ReadBigEndian64(block);
+  const int32_t base = int32_t(bits >> 56);
+  const int32_t mult = int32_t((bits >> 52) & 0xf);
+  const int32_t *mods = eacModifiers[(bits >> 48) & 0xf];
+
+  for(uint32_t y = 0; y < 4; y++)
+  {
+    for(uint32_t x = 0; x < 4; x++)
+    {
+      const uint32_t idx = uint32_t(bits >> (45 - (x * 4 + y) * 3)) & 0x7;
+      rgba[(y * 4 + x) * 4 + 3] = ClampByte(base + mods[idx] * mult);
+    }
+  }
+}
+
+// decodes an 11-bit EAC block into one channel of 16 RGBA float texels
+static void DecodeEAC11Channel(const byte *block, bool isSigned, float *rgba)
+{
+  const uint64_t bits = ReadBigEndian64(block);
+  const int32_t mult = int32_t((bits >> 52) & 0xf);
+  const int32_t *mods = eacModifiers[(bits >> 48) & 0xf];
+
+  int32_t base = 0;
+  if(isSigned)
+    base = RDCMAX(-127, int32_t(int8_t(bits >> 56))) * 8;
+  else
+    base = int32_t(bits >> 56) * 8 + 4;
+
+  for(uint32_t y = 0; y < 4; y++)
+  {
+    for(uint32_t x = 0; x < 4; x++)
+    {
+      const uint32_t idx = uint32_t(bits >> (45 - (x * 4 + y) * 3)) & 0x7;
+
+      // a multiplier of 0 uses the modifier unscaled
+      const int32_t v = base + (mult ? mods[idx] * mult * 8 : mods[idx]);
+
+      float &out = rgba[(y * 4 + x) * 4];
+      if(isSigned)
+        out = float(RDCCLAMP(v, -1023, 1023)) / 1023.0f;
+      else
+        out = float(RDCCLAMP(v, 0, 2047)) / 2047.0f;
+    }
+  }
+}
+
+static void DecodeETC2(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeETC2Colour(block, false, rgba);
+}
+
+static void DecodeETC2A1(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeETC2Colour(block, true, rgba);
+}
+
+static void DecodeETC2EAC(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeETC2Colour(block + 8, false, rgba);
+  DecodeEACAlpha(block, rgba);
+}
+
+static void DecodeEACR11(const BlockFormat &fmt, const byte *block, float *rgba)
+{
+  DecodeEAC11Channel(block, fmt.isSigned, rgba);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    rgba[i * 4 + 1] = rgba[i * 4 + 2] = 0.0f;
+    rgba[i * 4 + 3] = 1.0f;
+  }
+}
+
+static void DecodeEACRG11(const BlockFormat &fmt, const byte *block, float *rgba)
+{
+  DecodeEAC11Channel(block, fmt.isSigned, rgba);
+  DecodeEAC11Channel(block + 8, fmt.isSigned, rgba + 1);
+
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    rgba[i * 4 + 2] = 0.0f;
+    rgba[i * 4 + 3] = 1.0f;
+  }
+}
+
+static void DecodeASTCKernel(const BlockFormat &fmt, const byte *block, byte *rgba)
+{
+  DecodeASTCBlock(block, fmt.blockWidth, fmt.blockHeight, fmt.srgb, rgba);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Image decoding
+
+static bool GetBlockFormat(const ResourceFormat &fmt, BlockFormat &ret)
+{
+  ret.srgb = fmt.SRGBCorrected();
+  ret.isSigned = fmt.compType == CompType::SNorm;
+  ret.compCount = fmt.compCount;
+
+  switch(fmt.type)
+  {
+    case ResourceFormatType::BC1:
+      ret.blockBytes = 8;
+      ret.decode8 = &DecodeBC1;
+      return true;
+    case ResourceFormatType::BC2:
+      ret.blockBytes = 16;
+      ret.decode8 = &DecodeBC2;
+      return true;
+    case ResourceFormatType::BC3:
+      ret.blockBytes = 16;
+      ret.decode8 = &DecodeBC3;
+      return true;
+    case ResourceFormatType::BC4:
+      ret.blockBytes = 8;
+      ret.decodeFloat = &DecodeBC4;
+      return true;
+    case ResourceFormatType::BC5:
+      ret.blockBytes = 16;
+      ret.decodeFloat = &DecodeBC5;
+      return true;
+    case ResourceFormatType::BC6:
+      ret.blockBytes = 16;
+      ret.decodeFloat = &DecodeBC6;
+      return true;
+    case ResourceFormatType::BC7:
+      ret.blockBytes = 16;
+      ret.decode8 = &DecodeBC7;
+      return true;
+    case ResourceFormatType::ETC2:
+      ret.blockBytes = 8;
+      ret.decode8 = fmt.compCount == 4 ? &DecodeETC2A1 : &DecodeETC2;
+      return true;
+    case ResourceFormatType::EAC:
+      if(fmt.compCount == 1)
+      {
+        ret.blockBytes = 8;
+        ret.decodeFloat = &DecodeEACR11;
+      }
+      else if(fmt.compCount == 2)
+      {
+        ret.blockBytes = 16;
+        ret.decodeFloat = &DecodeEACRG11;
+      }
+      else
+      {
+        ret.blockBytes = 16;
+        ret.decode8 = &DecodeETC2EAC;
+      }
+      return true;
+    default: break;
+  }
+
+  return false;
+}
+
+// decodes the block rows [firstRow, lastRow) of an image
+static void DecodeBlockRows(const BlockFormat &fmt, uint32_t width, uint32_t height,
+                            const byte *src, DecodedFormat dstFormat, byte *dst, uint32_t firstRow,
+                            uint32_t lastRow)
+{
+  const uint32_t bw = fmt.blockWidth, bh = fmt.blockHeight;
+  const uint32_t blocksX = (width + bw - 1) / bw;
+  const uint32_t rowTexels = blocksX * bw;
+  const size_t texelSize = GetDecodedTexelSize(dstFormat);
+
+  // each row of blocks is decoded into this scratch buffer in the kernel's native format, then
+  // converted a whole image row at a time
+  std::vector<byte> rows8;
+  std::vector<float> rowsFloat;
+  if(fmt.decode8)
+    rows8.resize(rowTexels * bh * 4);
+  else
+    rowsFloat.resize(rowTexels * bh * 4);
+
+  byte block8[MaxBlockTexels * 4];
+  float blockFloat[MaxBlockTexels * 4];
+
+  for(uint32_t by = firstRow; by < lastRow; by++)
+  {
+    const byte *blockSrc = src + size_t(by) * blocksX * fmt.blockBytes;
+
+    for(uint32_t bx = 0; bx < blocksX; bx++, blockSrc += fmt.blockBytes)
+    {
+      if(fmt.decode8)
+      {
+        fmt.decode8(fmt, blockSrc, block8);
+        for(uint32_t y = 0; y < bh; y++)
+          memcpy(&rows8[(y * rowTexels + bx * bw) * 4], block8 + y * bw * 4, bw * 4);
+      }
+      else
+      {
+        fmt.decodeFloat(fmt, blockSrc, blockFloat);
+        for(uint32_t y = 0; y < bh; y++)
+          memcpy(&rowsFloat[(y * rowTexels + bx * bw) * 4], blockFloat + y * bw * 4,
+                 bw * 4 * sizeof(float));
+      }
+    }
+
+    // blocks past the right and bottom edges of the image are clipped here
+    const uint32_t y0 = by * bh;
+    const uint32_t numRows = RDCMIN(bh, height - y0);
+
+    for(uint32_t y = 0; y < numRows; y++)
+    {
+      byte *dstRow = dst + size_t(y0 + y) * width * texelSize;
+
+      if(fmt.decode8)
+      {
+        const byte *srcRow = &rows8[y * rowTexels * 4];
+        if(dstFormat == DecodedFormat::RGBA8)
+          memcpy(dstRow, srcRow, width * 4);
+        else
+          ConvertUNorm8ToFloat(srcRow, (float *)dstRow, width * 4, fmt.srgb);
+      }
+      else
+      {
+        const float *srcRow = &rowsFloat[y * rowTexels * 4];
+        if(dstFormat == DecodedFormat::RGBA32F)
+          memcpy(dstRow, srcRow, width * 4 * sizeof(float));
+        else
+          ConvertFloatToUNorm8(srcRow, dstRow, width * 4);
+      }
+    }
+  }
+}
+
+static void DecodeImage(const BlockFormat &fmt, uint32_t width, uint32_t height, const byte *src,
+                        DecodedFormat dstFormat, byte *dst)
+{
+  const uint32_t blocksX = (width + fmt.blockWidth - 1) / fmt.blockWidth;
+  const uint32_t blocksY = (height + fmt.blockHeight - 1) / fmt.blockHeight;
+
+  uint32_t rowsPerJob = RDCMAX(1U, MinBlocksPerJob / blocksX);
+  const uint32_t numJobs = RDCMIN(MaxDecodeThreads, (blocksY + rowsPerJob - 1) / rowsPerJob);
+
+  if(numJobs <= 1)
+  {
+    DecodeBlockRows(fmt, width, height, src, dstFormat, dst, 0, blocksY);
+    return;
+  }
+
+  // spread the rows evenly over the jobs, and decode the first band on this thread
+  rowsPerJob = (blocksY + numJobs - 1) / numJobs;
+
+  std::vector<Threading::ThreadHandle> threads;
+  for(uint32_t j = 1; j < numJobs; j++)
+  {
+    const uint32_t first = j * rowsPerJob;
+    const uint32_t last = RDCMIN(blocksY, first + rowsPerJob);
+    if(first >= last)
+      break;
+
+    threads.push_back(
+        Threading::CreateThread([&fmt, width, height, src, dstFormat, dst, first, last]() {
+          DecodeBlockRows(fmt, width, height, src, dstFormat, dst, first, last);
+        }));
+  }
+
+  DecodeBlockRows(fmt, width, height, src, dstFormat, dst, 0, RDCMIN(blocksY, rowsPerJob));
+
+  for(Threading::ThreadHandle t : threads)
+  {
+    Threading::JoinThread(t);
+    Threading::CloseThread(t);
+  }
+}
+
+bool IsBlockDecodeSupported(const ResourceFormat &fmt)
+{
+  BlockFormat blockFmt;
+  return GetBlockFormat(fmt, blockFmt);
+}
+
+size_t GetBlockCompressedSize(const ResourceFormat &fmt, uint32_t width, uint32_t height)
+{
+  BlockFormat blockFmt;
+  if(!GetBlockFormat(fmt, blockFmt))
+    return 0;
+
+  return size_t((width + 3) / 4) * size_t((height + 3) / 4) * blockFmt.blockBytes;
+}
+
+bool DecodeBlockCompressed(const ResourceFormat &fmt, uint32_t width, uint32_t height,
+                           const byte *src, size_t srcSize, DecodedFormat dstFormat, byte *dst)
+{
+  BlockFormat blockFmt;
+  if(!GetBlockFormat(fmt, blockFmt))
+  {
+    RDCERR("Can't decode %s on the CPU", fmt.Name().c_str());
+    return false;
+  }
+
+  size_t expectedSize = GetBlockCompressedSize(fmt, width, height);
+  if(srcSize < expectedSize)
+  {
+    RDCERR("Not enough data to decode %ux%u %s image: %zu bytes, expected %zu", width, height,
+           fmt.Name().c_str(), srcSize, expectedSize);
+    return false;
+  }
+
+  if(width == 0 || height == 0)
+    return true;
+
+  DecodeImage(blockFmt, width, height, src, dstFormat, dst);
+  return true;
+}
+
+bool DecodeASTC(uint32_t blockWidth, uint32_t blockHeight, bool srgb, uint32_t width,
+                uint32_t height, const byte *src, size_t srcSize, DecodedFormat dstFormat,
+                byte *dst)
+{
+  static const uint32_t footprints[][2] = {
+      {4, 4}, {5, 4},  {5, 5},  {6, 5},  {6, 6},   {8, 5},   {8, 6},
+      {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12},
+  };
+
+  bool valid = false;
+  for(const uint32_t *f : footprints)
+    valid |= (f[0] == blockWidth && f[1] == blockHeight);
+
+  if(!valid)
+  {
+    RDCERR("Invalid ASTC block footprint %ux%u", blockWidth, blockHeight);
+    return false;
+  }
+
+  BlockFormat blockFmt;
+  blockFmt.blockWidth = blockWidth;
+  blockFmt.blockHeight = blockHeight;
+  blockFmt.blockBytes = 16;
+  blockFmt.srgb = srgb;
+  blockFmt.decode8 = &DecodeASTCKernel;
+
+  size_t expectedSize = size_t((width + blockWidth - 1) / blockWidth) *
+                        size_t((height + blockHeight - 1) / blockHeight) * 16;
+  if(srcSize < expectedSize)
+  {
+    RDCERR("Not enough data to decode %ux%u ASTC image: %zu bytes, expected %zu", width, height,
+           srcSize, expectedSize);
+    return false;
+  }
+
+  if(width == 0 || height == 0)
+    return true;
+
+  DecodeImage(blockFmt, width, height, src, dstFormat, dst);
+  return true;
+}
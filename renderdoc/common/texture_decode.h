@@ -0,0 +1,71 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include "api/replay/renderdoc_replay.h"
+
+// CPU decoders for block-compressed texture formats. These are used where there's no replay device
+// to decompress on the GPU, or the device can't use the format itself.
+//
+// Decoded images are tightly packed 2D images of RGBA texels, decoded block-row by block-row with
+// large images split across several threads.
+
+enum class DecodedFormat
+{
+  // 8-bit unsigned normalised. sRGB formats keep their sRGB encoding, signed formats are clamped
+  RGBA8,
+  // 32-bit float. sRGB formats are converted to linear, signed and HDR formats keep their range
+  RGBA32F,
+};
+
+// returns the size in bytes of each texel in the given decoded format
+inline uint32_t GetDecodedTexelSize(DecodedFormat fmt)
+{
+  return fmt == DecodedFormat::RGBA8 ? 4 : 16;
+}
+
+// returns true if DecodeBlockCompressed can decode this format. ASTC isn't included since the block
+// footprint isn't part of ResourceFormat, see DecodeASTC
+bool IsBlockDecodeSupported(const ResourceFormat &fmt);
+
+// returns the number of bytes a width x height image in this format takes up, or 0 if the format
+// isn't supported
+size_t GetBlockCompressedSize(const ResourceFormat &fmt, uint32_t width, uint32_t height);
+
+// decodes a single width x height image (one mip of one slice) in fmt into dst, which must be
+// width * height * GetDecodedTexelSize(dstFormat) bytes. Returns false if the format isn't
+// supported or srcSize is too small.
+bool DecodeBlockCompressed(const ResourceFormat &fmt, uint32_t width, uint32_t height,
+                           const byte *src, size_t srcSize, DecodedFormat dstFormat, byte *dst);
+
+// as DecodeBlockCompressed, for 2D LDR ASTC with the given block footprint. HDR blocks decode to
+// the error colour (opaque magenta), as they would on an LDR-only implementation.
+bool DecodeASTC(uint32_t blockWidth, uint32_t blockHeight, bool srgb, uint32_t width,
+                uint32_t height, const byte *src, size_t srcSize, DecodedFormat dstFormat,
+                byte *dst);
+
+// decodes a single 16-byte ASTC block to blockWidth * blockHeight RGBA8 texels, in rows
+void DecodeASTCBlock(const byte *block, uint32_t blockWidth, uint32_t blockHeight, bool srgb,
+                     byte *rgba);
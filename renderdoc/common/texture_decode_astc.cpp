@@ -0,0 +1,866 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <string.h>
+#include "common/common.h"
+#include "texture_decode.h"
+
+// LDR ASTC decoding, following the Khronos data format specification. Anything that's an error
+// or unsupported in the LDR profile - including HDR endpoint modes - decodes to opaque magenta.
+
+struct ISERange
+{
+  uint32_t bits;
+  uint32_t trits;
+  uint32_t quints;
+};
+
+// the integer sequence encoding for each quantisation range, from 0..1 up to 0..255. Weights only
+// use the first 12
+static const ISERange iseRanges[] = {
+    {1, 0, 0}, {0, 1, 0}, {2, 0, 0}, {0, 0, 1}, {1, 1, 0}, {3, 0, 0}, {1, 0, 1},
+    {2, 1, 0}, {4, 0, 0}, {2, 0, 1}, {3, 1, 0}, {5, 0, 0}, {3, 0, 1}, {4, 1, 0},
+    {6, 0, 0}, {4, 0, 1}, {5, 1, 0}, {7, 0, 0}, {5, 0, 1}, {6, 1, 0}, {8, 0, 0},
+};
+
+static const uint32_t NumISERanges = ARRAY_COUNT(iseRanges);
+
+// the lowest range colour endpoints can use, 0..5
+static const uint32_t MinColourRange = 4;
+
+static const uint32_t MaxWeights = 64;
+static const uint32_t MaxBlockTexels = 12 * 12;
+static const uint32_t MaxColourValues = 18;
+
+struct ASTCBlockMode
+{
+  uint32_t weightsX;
+  uint32_t weightsY;
+  bool dualPlane;
+  uint32_t weightRange;
+};
+
+static uint32_t ReadBits(const uint64_t words[2], uint32_t bit, uint32_t count)
+{
+  if(count == 0 || bit >= 128)
+    return 0;
+
+  uint64_t v;
+  if(bit >= 64)
+    v = words[1] >> (bit - 64);
+  else if(bit == 0)
+    v = words[0];
+  else
+    v = (words[0] >> bit) | (words[1] << (64 - bit));
+
+  return uint32_t(v & ((1ULL << count) - 1));
+}
+
+static uint64_t ReverseBits(uint64_t v)
+{
+  v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+  v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+  v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+  v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+  return (v >> 32) | (v << 32);
+}
+
+static uint32_t GetISEBitCount(uint32_t count, uint32_t range)
+{
+  const ISERange &r = iseRanges[range];
+  return count * r.bits + (r.trits ? (count * 8 + 4) / 5 : 0) +
+         (r.quints ? (count * 7 + 2) / 3 : 0);
+}
+
+static bool DecodeBlockMode(uint32_t blockMode, ASTCBlockMode &mode)
+{
+  uint32_t range = (blockMode >> 4) & 0x1;
+  uint32_t high = (blockMode >> 9) & 0x1;
+  uint32_t dual = (blockMode >> 10) & 0x1;
+  const uint32_t a = (blockMode >> 5) & 0x3;
+
+  if(blockMode & 0x3)
+  {
+    range |= (blockMode & 0x3) << 1;
+    uint32_t b = (blockMode >> 7) & 0x3;
+
+    switch((blockMode >> 2) & 0x3)
+    {
+      case 0:
+        mode.weightsX = b + 4;
+        mode.weightsY = a + 2;
+        break;
+      case 1:
+        mode.weightsX = b + 8;
+        mode.weightsY = a + 2;
+        break;
+      case 2:
+        mode.weightsX = a + 2;
+        mode.weightsY = b + 8;
+        break;
+      default:
+        b &= 0x1;
+        if(blockMode & 0x100)
+        {
+          mode.weightsX = b + 2;
+          mode.weightsY = a + 2;
+        }
+        else
+        {
+          mode.weightsX = a + 2;
+          mode.weightsY = b + 6;
+        }
+        break;
+    }
+  }
+  else
+  {
+    range |= ((blockMode >> 2) & 0x3) << 1;
+    if(((blockMode >> 2) & 0x3) == 0)
+      return false;
+
+    const uint32_t b = (blockMode >> 9) & 0x3;
+
+    switch((blockMode >> 7) & 0x3)
+    {
+      case 0:
+        mode.weightsX = 12;
+        mode.weightsY = a + 2;
+        break;
+      case 1:
+        mode.weightsX = a + 2;
+        mode.weightsY = 12;
+        break;
+      case 2:
+        mode.weightsX = a + 6;
+        mode.weightsY = b + 6;
+        dual = high = 0;
+        break;
+      default:
+        if(a == 0)
+        {
+          mode.weightsX = 6;
+          mode.weightsY = 10;
+        }
+        else if(a == 1)
+        {
+          mode.weightsX = 10;
+          mode.weightsY = 6;
+        }
+        else
+        {
+          return false;
+        }
+        break;
+    }
+  }
+
+  mode.dualPlane = dual != 0;
+  mode.weightRange = range - 2 + 6 * high;
+
+  const uint32_t weightCount = mode.weightsX * mode.weightsY * (mode.dualPlane ? 2 : 1);
+  const uint32_t weightBits = GetISEBitCount(weightCount, mode.weightRange);
+
+  return weightCount <= MaxWeights && weightBits >= 24 && weightBits <= 96;
+}
+
+static void DecodeTrits(uint32_t t, uint32_t *out)
+{
+  uint32_t c;
+  if(((t >> 2) & 0x7) == 0x7)
+  {
+    c = (((t >> 5) & 0x7) << 2) | (t & 0x3);
+    out[4] = out[3] = 2;
+  }
+  else
+  {
+    c = t & 0x1f;
+    if(((t >> 5) & 0x3) == 0x3)
+    {
+      out[4] = 2;
+      out[3] = (t >> 7) & 0x1;
+    }
+    else
+    {
+      out[4] = (t >> 7) & 0x1;
+      out[3] = (t >> 5) & 0x3;
+    }
+  }
+
+  if((c & 0x3) == 0x3)
+  {
+    out[2] = 2;
+    out[1] = (c >> 4) & 0x1;
+    out[0] = (((c >> 3) & 0x1) << 1) | ((c >> 2) & 0x1 & ~(c >> 3));
+  }
+  else if(((c >> 2) & 0x3) == 0x3)
+  {
+    out[2] = 2;
+    out[1] = 2;
+    out[0] = c & 0x3;
+  }
+  else
+  {
+    out[2] = (c >> 4) & 0x1;
+    out[1] = (c >> 2) & 0x3;
+    out[0] = (((c >> 1) & 0x1) << 1) | (c & 0x1 & ~(c >> 1));
+  }
+}
+
+static void DecodeQuints(uint32_t q, uint32_t *out)
+{
+  if(((q >> 1) & 0x3) == 0x3 && ((q >> 5) & 0x3) == 0)
+  {
+    const uint32_t q0 = q & 0x1;
+    out[2] = (q0 << 2) | ((((q >> 4) & 0x1) & ~q0) << 1) | (((q >> 3) & 0x1) & ~q0);
+    out[1] = out[0] = 4;
+    return;
+  }
+
+  uint32_t c;
+  if(((q >> 1) & 0x3) == 0x3)
+  {
+    out[2] = 4;
+    c = (((q >> 3) & 0x3) << 3) | ((~(q >> 5) & 0x3) << 1) | (q & 0x1);
+  }
+  else
+  {
+    out[2] = (q >> 5) & 0x3;
+    c = q & 0x1f;
+  }
+
+  if((c & 0x7) == 0x5)
+  {
+    out[1] = 4;
+    out[0] = (c >> 3) & 0x3;
+  }
+  else
+  {
+    out[1] = (c >> 3) & 0x3;
+    out[0] = c & 0x7;
+  }
+}
+
+// decodes count integers in the given range starting at bit, reading 0s past the end of the data
+static void DecodeISE(const uint64_t words[2], uint32_t bit, uint32_t count, uint32_t range,
+                      uint32_t *out)
+{
+  const ISERange &r = iseRanges[range];
+  const uint32_t end = bit + GetISEBitCount(count, range);
+
+  auto read = [&](uint32_t n) {
+    uint32_t ret = bit < end ? ReadBits(words, bit, RDCMIN(n, end - bit)) : 0;
+    bit += n;
+    return ret;
+  };
+
+  if(r.trits)
+  {
+    // five values are packed in 8 bits of trits interleaved with the values' low bits
+    static const uint32_t tritBits[5] = {2, 2, 1, 2, 1};
+    for(uint32_t i = 0; i < count; i += 5)
+    {
+      uint32_t m[5], t = 0, shift = 0, trits[5];
+      for(uint32_t j = 0; j < 5; j++)
+      {
+        m[j] = read(r.bits);
+        t |= read(tritBits[j]) << shift;
+        shift += tritBits[j];
+      }
+
+      DecodeTrits(t, trits);
+      for(uint32_t j = 0; j < 5 && i + j < count; j++)
+        out[i + j] = (trits[j] << r.bits) | m[j];
+    }
+  }
+  else if(r.quints)
+  {
+    // three values are packed in 7 bits of quints
+    static const uint32_t quintBits[3] = {3, 2, 2};
+    for(uint32_t i = 0; i < count; i += 3)
+    {
+      uint32_t m[3], q = 0, shift = 0, quints[3];
+      for(uint32_t j = 0; j < 3; j++)
+      {
+        m[j] = read(r.bits);
+        q |= read(quintBits[j]) << shift;
+        shift += quintBits[j];
+      }
+
+      DecodeQuints(q, quints);
+      for(uint32_t j = 0; j < 3 && i + j < count; j++)
+        out[i + j] = (quints[j] << r.bits) | m[j];
+    }
+  }
+  else
+  {
+    for(uint32_t i = 0; i < count; i++)
+      out[i] = read(r.bits);
+  }
+}
+
+// repeats the low bits of v to fill the top 'to' bits
+static uint32_t ReplicateBits(uint32_t v, uint32_t bits, uint32_t to)
+{
+  uint32_t ret = 0;
+  int32_t shift = int32_t(to) - int32_t(bits);
+  for(; shift > -int32_t(bits); shift -= int32_t(bits))
+    ret |= shift >= 0 ? (v << shift) : (v >> -shift);
+  return ret & ((1U << to) - 1);
+}
+
+static uint32_t UnquantizeColour(uint32_t range, uint32_t v)
+{
+  const ISERange &r = iseRanges[range];
+
+  if(!r.trits && !r.quints)
+    return ReplicateBits(v, r.bits, 8);
+
+  const uint32_t m = v & ((1U << r.bits) - 1);
+  const uint32_t d = v >> r.bits;
+  const uint32_t a = (m & 0x1) ? 0x1ff : 0;
+  const uint32_t b = m >> 1;
+
+  uint32_t B = 0, C = 0;
+  if(r.trits)
+  {
+    switch(r.bits)
+    {
+      case 1: C = 204; break;
+      case 2:
+        B = (b << 8) | (b << 4) | (b << 2) | (b << 1);
+        C = 93;
+        break;
+      case 3:
+        B = (b << 7) | (b << 2) | b;
+        C = 44;
+        break;
+      case 4:
+        B = (b << 6) | b;
+        C = 22;
+        break;
+      case 5:
+        B = (b << 5) | (b >> 2);
+        C = 11;
+        break;
+      default:
+        B = (b << 4) | (b >> 4);
+        C = 5;
+        break;
+    }
+  }
+  else
+  {
+    switch(r.bits)
+    {
+      case 1: C = 113; break;
+      case 2:
+        B = (b << 8) | (b << 3) | (b << 2);
+        C = 54;
+        break;
+      case 3:
+        B = (b << 7) | (b << 1) | (b >> 1);
+        C = 26;
+        break;
+      case 4:
+        B = (b << 6) | (b >> 1);
+        C = 13;
+        break;
+      default:
+        B = (b << 5) | (b >> 3);
+        C = 6;
+        break;
+    }
+  }
+
+  uint32_t t = (d * C + B) ^ a;
+  return (a & 0x80) | (t >> 2);
+}
+
+static uint32_t UnquantizeWeight(uint32_t range, uint32_t v)
+{
+  const ISERange &r = iseRanges[range];
+
+  uint32_t ret;
+  if(!r.trits && !r.quints)
+  {
+    ret = ReplicateBits(v, r.bits, 6);
+  }
+  else if(r.bits == 0)
+  {
+    static const uint32_t trits[3] = {0, 32, 63};
+    static const uint32_t quints[5] = {0, 16, 32, 47, 63};
+    ret = r.trits ? trits[v] : quints[v];
+  }
+  else
+  {
+    const uint32_t m = v & ((1U << r.bits) - 1);
+    const uint32_t d = v >> r.bits;
+    const uint32_t a = (m & 0x1) ? 0x7f : 0;
+    const uint32_t b = m >> 1;
+
+    uint32_t B = 0, C = 0;
+    if(r.trits)
+    {
+      if(r.bits == 1)
+      {
+        C = 50;
+      }
+      else if(r.bits == 2)
+      {
+        B = (b << 6) | (b << 2) | b;
+        C = 23;
+      }
+      else
+      {
+        B = (b << 5) | b;
+        C = 11;
+      }
+    }
+    else
+    {
+      if(r.bits == 1)
+      {
+        C = 28;
+      }
+      else
+      {
+        B = (b << 6) | (b << 1);
+        C = 13;
+      }
+    }
+
+    uint32_t t = (d * C + B) ^ a;
+    ret = (a & 0x20) | (t >> 2);
+  }
+
+  // expand from 0..63 to 0..64
+  return ret > 32 ? ret + 1 : ret;
+}
+
+static uint32_t Hash52(uint32_t v)
+{
+  v ^= v >> 15;
+  v *= 0xEEDE0891;
+  v ^= v >> 5;
+  v += v << 16;
+  v ^= v >> 7;
+  v ^= v >> 3;
+  v ^= v << 6;
+  v ^= v >> 17;
+  return v;
+}
+
+static uint32_t SelectPartition(uint32_t seed, uint32_t x, uint32_t y, uint32_t partitions,
+                                bool smallBlock)
+{
+  if(smallBlock)
+  {
+    x <<= 1;
+    y <<= 1;
+  }
+
+  seed += (partitions - 1) * 1024;
+
+  const uint32_t rnum = Hash52(seed);
+
+  uint32_t seeds[8];
+  for(uint32_t i = 0; i < 8; i++)
+  {
+    seeds[i] = (rnum >> (i * 4)) & 0xF;
+    seeds[i] *= seeds[i];
+  }
+
+  uint32_t sh1, sh2;
+  if(seed & 1)
+  {
+    sh1 = (seed & 2) ? 4 : 5;
+    sh2 = partitions == 3 ? 6 : 5;
+  }
+  else
+  {
+    sh1 = partitions == 3 ? 6 : 5;
+    sh2 = (seed & 2) ? 4 : 5;
+  }
+
+  for(uint32_t i = 0; i < 8; i++)
+    seeds[i] >>= (i & 1) ? sh2 : sh1;
+
+  // the z terms are omitted since we only decode 2D blocks
+  uint32_t a = (seeds[0] * x + seeds[1] * y + (rnum >> 14)) & 0x3F;
+  uint32_t b = (seeds[2] * x + seeds[3] * y + (rnum >> 10)) & 0x3F;
+  uint32_t c = (seeds[4] * x + seeds[5] * y + (rnum >> 6)) & 0x3F;
+  uint32_t d = (seeds[6] * x + seeds[7] * y + (rnum >> 2)) & 0x3F;
+
+  if(partitions <= 3)
+    d = 0;
+  if(partitions <= 2)
+    c = 0;
+
+  if(a >= b && a >= c && a >= d)
+    return 0;
+  if(b >= c && b >= d)
+    return 1;
+  if(c >= d)
+    return 2;
+  return 3;
+}
+
+static void BitTransferSigned(int32_t &a, int32_t &b)
+{
+  b >>= 1;
+  b |= a & 0x80;
+  a >>= 1;
+  a &= 0x3F;
+  if(a & 0x20)
+    a -= 0x40;
+}
+
+static void BlueContract(int32_t *e)
+{
+  e[0] = (e[0] + e[2]) >> 1;
+  e[1] = (e[1] + e[2]) >> 1;
+}
+
+// decodes the two RGBA8 endpoints for an LDR endpoint mode. Returns false for HDR modes
+static bool DecodeEndpoints(uint32_t cem, const uint32_t *values, int32_t e0[4], int32_t e1[4])
+{
+  int32_t v[8];
+  for(uint32_t i = 0; i < ((cem >> 2) + 1) * 2; i++)
+    v[i] = int32_t(values[i]);
+
+  auto set = [](int32_t *e, int32_t r, int32_t g, int32_t b, int32_t a) {
+    e[0] = r;
+    e[1] = g;
+    e[2] = b;
+    e[3] = a;
+  };
+
+  switch(cem)
+  {
+    // luminance, direct
+    case 0:
+      set(e0, v[0], v[0], v[0], 255);
+      set(e1, v[1], v[1], v[1], 255);
+      break;
+    // luminance, base+offset
+    case 1:
+    {
+      int32_t l0 = (v[0] >> 2) | (v[1] & 0xC0);
+      int32_t l1 = RDCMIN(l0 + (v[1] & 0x3F), 255);
+      set(e0, l0, l0, l0, 255);
+      set(e1, l1, l1, l1, 255);
+      break;
+    }
+    // luminance+alpha, direct
+    case 4:
+      set(e0, v[0], v[0], v[0], v[2]);
+      set(e1, v[1], v[1], v[1], v[3]);
+      break;
+    // luminance+alpha, base+offset
+    case 5:
+      BitTransferSigned(v[1], v[0]);
+      BitTransferSigned(v[3], v[2]);
+      set(e0, v[0], v[0], v[0], v[2]);
+      set(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+      break;
+    // RGB, base+scale
+    case 6:
+      set(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255);
+      set(e1, v[0], v[1], v[2], 255);
+      break;
+    // RGB and RGBA, direct
+    case 8:
+    case 12:
+    {
+      const int32_t a0 = cem == 12 ? v[6] : 255;
+      const int32_t a1 = cem == 12 ? v[7] : 255;
+      if(v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+      {
+        set(e0, v[0], v[2], v[4], a0);
+        set(e1, v[1], v[3], v[5], a1);
+      }
+      else
+      {
+        set(e0, v[1], v[3], v[5], a1);
+        set(e1, v[0], v[2], v[4], a0);
+        BlueContract(e0);
+        BlueContract(e1);
+      }
+      break;
+    }
+    // RGB and RGBA, base+offset
+    case 9:
+    case 13:
+    {
+      BitTransferSigned(v[1], v[0]);
+      BitTransferSigned(v[3], v[2]);
+      BitTransferSigned(v[5], v[4]);
+      if(cem == 13)
+      {
+        BitTransferSigned(v[7], v[6]);
+      }
+      else
+      {
+        v[6] = 255;
+        v[7] = 0;
+      }
+
+      if(v[1] + v[3] + v[5] >= 0)
+      {
+        set(e0, v[0], v[2], v[4], v[6]);
+        set(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]);
+      }
+      else
+      {
+        set(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]);
+        set(e1, v[0], v[2], v[4], v[6]);
+        BlueContract(e0);
+        BlueContract(e1);
+      }
+      break;
+    }
+    // RGB base+scale, plus two alpha values
+    case 10:
+      set(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+      set(e1, v[0], v[1], v[2], v[5]);
+      break;
+    // HDR modes
+    default: return false;
+  }
+
+  for(uint32_t c = 0; c < 4; c++)
+  {
+    e0[c] = RDCCLAMP(e0[c], 0, 255);
+    e1[c] = RDCCLAMP(e1[c], 0, 255);
+  }
+
+  return true;
+}
+
+// interpolates a weight grid smaller than the block up to one weight per texel
+static void InfillWeights(const uint32_t *grid, uint32_t gridX, uint32_t gridY, uint32_t stride,
+                          uint32_t blockWidth, uint32_t blockHeight, uint32_t *weights)
+{
+  const uint32_t ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+  const uint32_t dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+
+  for(uint32_t t = 0; t < blockHeight; t++)
+  {
+    for(uint32_t s = 0; s < blockWidth; s++)
+    {
+      const uint32_t gs = (ds * s * (gridX - 1) + 32) >> 6;
+      const uint32_t gt = (dt * t * (gridY - 1) + 32) >> 6;
+      const uint32_t js = gs >> 4, fs = gs & 0xF;
+      const uint32_t jt = gt >> 4, ft = gt & 0xF;
+
+      const uint32_t w11 = (fs * ft + 8) >> 4;
+      const uint32_t w10 = ft - w11;
+      const uint32_t w01 = fs - w11;
+      const uint32_t w00 = 16 - fs - ft + w11;
+
+      // neighbours past the edge of the grid always have zero weight, so clamp to stay in bounds
+      const uint32_t x1 = RDCMIN(js + 1, gridX - 1);
+      const uint32_t y1 = RDCMIN(jt + 1, gridY - 1);
+
+      const uint32_t p00 = grid[(jt * gridX + js) * stride];
+      const uint32_t p01 = grid[(jt * gridX + x1) * stride];
+      const uint32_t p10 = grid[(y1 * gridX + js) * stride];
+      const uint32_t p11 = grid[(y1 * gridX + x1) * stride];
+
+      weights[t * blockWidth + s] = (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
+    }
+  }
+}
+
+static void WriteErrorColour(uint32_t texels, byte *rgba)
+{
+  for(uint32_t i = 0; i < texels; i++)
+  {
+    rgba[i * 4 + 0] = 255;
+    rgba[i * 4 + 1] = 0;
+    rgba[i * 4 + 2] = 255;
+    rgba[i * 4 + 3] = 255;
+  }
+}
+
+void DecodeASTCBlock(const byte *block, uint32_t blockWidth, uint32_t blockHeight, bool srgb,
+                     byte *rgba)
+{
+  const uint32_t texels = blockWidth * blockHeight;
+
+  uint64_t words[2];
+  memcpy(words, block, sizeof(words));
+
+  const uint32_t blockMode = ReadBits(words, 0, 11);
+
+  // void-extent blocks are a single constant colour
+  if((blockMode & 0x1FF) == 0x1FC)
+  {
+    if(blockMode & 0x200)
+      return WriteErrorColour(texels, rgba);
+
+    byte colour[4];
+    for(uint32_t c = 0; c < 4; c++)
+      colour[c] = byte(ReadBits(words, 64 + c * 16, 16) >> 8);
+
+    for(uint32_t i = 0; i < texels; i++)
+      memcpy(rgba + i * 4, colour, 4);
+    return;
+  }
+
+  ASTCBlockMode mode;
+  if(!DecodeBlockMode(blockMode, mode) || mode.weightsX > blockWidth ||
+     mode.weightsY > blockHeight)
+    return WriteErrorColour(texels, rgba);
+
+  const uint32_t partitions = ReadBits(words, 11, 2) + 1;
+  if(partitions == 4 && mode.dualPlane)
+    return WriteErrorColour(texels, rgba);
+
+  const uint32_t planes = mode.dualPlane ? 2 : 1;
+  const uint32_t weightCount = mode.weightsX * mode.weightsY * planes;
+
+  // everything after the fixed fields is packed in from both ends: colour endpoint data from the
+  // bottom, weights from the top, and any extra fields just below the weights
+  uint32_t belowWeights = 128 - GetISEBitCount(weightCount, mode.weightRange);
+
+  uint32_t cems[4] = {};
+  uint32_t partitionIndex = 0;
+  uint32_t colourStart = 17;
+
+  if(partitions == 1)
+  {
+    cems[0] = ReadBits(words, 13, 4);
+  }
+  else
+  {
+    partitionIndex = ReadBits(words, 13, 10);
+    colourStart = 29;
+
+    uint32_t cem = ReadBits(words, 23, 6);
+    if((cem & 0x3) == 0)
+    {
+      // all partitions share one endpoint mode
+      for(uint32_t p = 0; p < partitions; p++)
+        cems[p] = cem >> 2;
+    }
+    else
+    {
+      // each partition selects its mode class relative to a base, with its own 2-bit mode
+      const uint32_t extraBits = 3 * partitions - 4;
+      belowWeights -= extraBits;
+      cem |= ReadBits(words, belowWeights, extraBits) << 6;
+
+      const uint32_t baseClass = (cem & 0x3) - 1;
+      cem >>= 2;
+
+      for(uint32_t p = 0; p < partitions; p++)
+        cems[p] = ((baseClass + ((cem >> p) & 0x1)) << 2) | ((cem >> (partitions + p * 2)) & 0x3);
+    }
+  }
+
+  uint32_t planeComponent = ~0U;
+  if(mode.dualPlane)
+  {
+    belowWeights -= 2;
+    planeComponent = ReadBits(words, belowWeights, 2);
+  }
+
+  uint32_t numValues = 0;
+  for(uint32_t p = 0; p < partitions; p++)
+    numValues += ((cems[p] >> 2) + 1) * 2;
+
+  if(numValues > MaxColourValues || belowWeights <= colourStart)
+    return WriteErrorColour(texels, rgba);
+
+  // the colour endpoints use the largest range that fits in the remaining space
+  const uint32_t colourBits = belowWeights - colourStart;
+  uint32_t colourRange = NumISERanges;
+  for(uint32_t r = NumISERanges; r-- > 0;)
+  {
+    if(GetISEBitCount(numValues, r) <= colourBits)
+    {
+      colourRange = r;
+      break;
+    }
+  }
+
+  if(colourRange == NumISERanges || colourRange < MinColourRange)
+    return WriteErrorColour(texels, rgba);
+
+  uint32_t values[MaxColourValues];
+  DecodeISE(words, colourStart, numValues, colourRange, values);
+  for(uint32_t i = 0; i < numValues; i++)
+    values[i] = UnquantizeColour(colourRange, values[i]);
+
+  int32_t endpoints[4][2][4];
+  const uint32_t *partitionValues = values;
+  for(uint32_t p = 0; p < partitions; p++)
+  {
+    if(!DecodeEndpoints(cems[p], partitionValues, endpoints[p][0], endpoints[p][1]))
+      return WriteErrorColour(texels, rgba);
+
+    partitionValues += ((cems[p] >> 2) + 1) * 2;
+
+    // expand to 16-bit for interpolation. sRGB is expanded so that the top 8 bits of the result
+    // are the nearest sRGB value, as the conversion to linear happens afterwards
+    for(uint32_t e = 0; e < 2; e++)
+      for(uint32_t c = 0; c < 4; c++)
+        endpoints[p][e][c] = srgb ? (endpoints[p][e][c] << 8) | 0x80 : endpoints[p][e][c] * 257;
+  }
+
+  // the weights are stored bit-reversed down from the top of the block
+  const uint64_t reversed[2] = {ReverseBits(words[1]), ReverseBits(words[0])};
+
+  uint32_t grid[MaxWeights];
+  DecodeISE(reversed, 0, weightCount, mode.weightRange, grid);
+  for(uint32_t i = 0; i < weightCount; i++)
+    grid[i] = UnquantizeWeight(mode.weightRange, grid[i]);
+
+  uint32_t weights[2][MaxBlockTexels];
+  for(uint32_t p = 0; p < planes; p++)
+    InfillWeights(grid + p, mode.weightsX, mode.weightsY, planes, blockWidth, blockHeight,
+                  weights[p]);
+
+  const bool smallBlock = texels < 31;
+
+  for(uint32_t y = 0; y < blockHeight; y++)
+  {
+    for(uint32_t x = 0; x < blockWidth; x++)
+    {
+      const uint32_t i = y * blockWidth + x;
+      const uint32_t p =
+          partitions > 1 ? SelectPartition(partitionIndex, x, y, partitions, smallBlock) : 0;
+
+      for(uint32_t c = 0; c < 4; c++)
+      {
+        const int32_t w = int32_t(weights[c == planeComponent ? 1 : 0][i]);
+        const int32_t e0 = endpoints[p][0][c], e1 = endpoints[p][1][c];
+        rgba[i * 4 + c] = byte(((e0 * (64 - w) + e1 * w + 32) >> 6) >> 8);
+      }
+    }
+  }
+}
@@ -0,0 +1,465 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "common/texture_decode.h"
+#include "common/common.h"
+#include "maths/formatpacking.h"
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+// builds blocks that are packed LSB-first
+struct BlockWriter
+{
+  byte data[16] = {};
+  uint32_t offset = 0;
+
+  void Write(uint32_t value, uint32_t count)
+  {
+    for(uint32_t i = 0; i < count; i++, offset++)
+      if((value >> i) & 0x1)
+        data[offset / 8] |= byte(1 << (offset % 8));
+  }
+};
+
+static void WriteBigEndian(byte *data, uint32_t hi, uint32_t lo)
+{
+  for(int i = 0; i < 4; i++)
+  {
+    data[i] = byte(hi >> (24 - i * 8));
+    data[4 + i] = byte(lo >> (24 - i * 8));
+  }
+}
+
+static ResourceFormat MakeFormat(ResourceFormatType type, uint32_t compCount,
+                                 CompType compType = CompType::UNorm)
+{
+  ResourceFormat fmt;
+  fmt.type = type;
+  fmt.compCount = uint8_t(compCount);
+  fmt.compByteWidth = 1;
+  fmt.compType = compType;
+  return fmt;
+}
+
+static std::vector<byte> Decode8(const ResourceFormat &fmt, const byte *data, size_t size,
+                                 uint32_t width = 4, uint32_t height = 4)
+{
+  std::vector<byte> ret(width * height * 4);
+  CHECK(DecodeBlockCompressed(fmt, width, height, data, size, DecodedFormat::RGBA8, ret.data()));
+  return ret;
+}
+
+static std::vector<float> DecodeFloat(const ResourceFormat &fmt, const byte *data, size_t size,
+                                      uint32_t width = 4, uint32_t height = 4)
+{
+  std::vector<float> ret(width * height * 4);
+  CHECK(DecodeBlockCompressed(fmt, width, height, data, size, DecodedFormat::RGBA32F,
+                              (byte *)ret.data()));
+  return ret;
+}
+
+static std::vector<byte> Texel(const std::vector<byte> &data, uint32_t i)
+{
+  return std::vector<byte>(data.begin() + i * 4, data.begin() + i * 4 + 4);
+}
+
+static std::vector<byte> RGBA(byte r, byte g, byte b, byte a)
+{
+  return {r, g, b, a};
+}
+
+TEST_CASE("Decode BC1-5 blocks", "[texture_decode]")
+{
+  SECTION("BC1 four colour")
+  {
+    // red and blue endpoints, with texels 0-3 using indices 0-3
+    const byte block[8] = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00};
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC1, 4), block, 8);
+
+    CHECK(Texel(out, 0) == RGBA(255, 0, 0, 255));
+    CHECK(Texel(out, 1) == RGBA(0, 0, 255, 255));
+    CHECK(Texel(out, 2) == RGBA(170, 0, 85, 255));
+    CHECK(Texel(out, 3) == RGBA(85, 0, 170, 255));
+    CHECK(Texel(out, 15) == RGBA(255, 0, 0, 255));
+  };
+
+  SECTION("BC1 three colour")
+  {
+    // endpoints swapped to select the three colour mode
+    const byte block[8] = {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0x00, 0x00, 0x00};
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC1, 4), block, 8);
+    CHECK(Texel(out, 2) == RGBA(128, 0, 128, 255));
+    CHECK(Texel(out, 3) == RGBA(0, 0, 0, 0));
+
+    // without an alpha channel the black is opaque
+    out = Decode8(MakeFormat(ResourceFormatType::BC1, 3), block, 8);
+    CHECK(Texel(out, 3) == RGBA(0, 0, 0, 255));
+  };
+
+  SECTION("BC2 and BC3 alpha")
+  {
+    byte block[16] = {};
+    // white colour block
+    block[8] = block[9] = block[10] = block[11] = 0xFF;
+
+    // explicit 4-bit alpha: texel 0 = 0x3, texel 1 = 0xF
+    block[0] = 0xF3;
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC2, 4), block, 16);
+    CHECK(Texel(out, 0) == RGBA(255, 255, 255, 51));
+    CHECK(Texel(out, 1) == RGBA(255, 255, 255, 255));
+    CHECK(Texel(out, 2) == RGBA(255, 255, 255, 0));
+
+    // interpolated alpha between 255 and 0: texel 0 = index 1, texel 1 = index 2
+    block[0] = 255;
+    block[1] = 0;
+    block[2] = 0x11;
+    out = Decode8(MakeFormat(ResourceFormatType::BC3, 4), block, 16);
+    CHECK(Texel(out, 0)[3] == 0);
+    CHECK(Texel(out, 1)[3] == 219);
+    CHECK(Texel(out, 2)[3] == 255);
+
+    // six value mode with explicit 0 and 255: texel 0 = index 6, texel 1 = index 7
+    block[0] = 0;
+    block[1] = 255;
+    block[2] = 0x3E;
+    out = Decode8(MakeFormat(ResourceFormatType::BC3, 4), block, 16);
+    CHECK(Texel(out, 0)[3] == 0);
+    CHECK(Texel(out, 1)[3] == 255);
+    CHECK(Texel(out, 2)[3] == 0);
+  };
+
+  SECTION("BC4 and BC5")
+  {
+    // texel 0 = index 0, texel 1 = index 7
+    byte block[16] = {255, 0, 0x38, 0, 0, 0, 0, 0, 0x80, 0x7F, 0x38, 0, 0, 0, 0, 0};
+
+    std::vector<float> out = DecodeFloat(MakeFormat(ResourceFormatType::BC4, 1), block, 8);
+    CHECK(out[0] == 1.0f);
+    CHECK(out[4] == Approx(1.0f / 7.0f));
+    CHECK(out[5] == 0.0f);
+    CHECK(out[7] == 1.0f);
+
+    std::vector<byte> out8 = Decode8(MakeFormat(ResourceFormatType::BC4, 1), block, 8);
+    CHECK(Texel(out8, 1) == RGBA(36, 0, 0, 255));
+
+    // the second channel is signed, with -128 clamped to -1.0
+    out = DecodeFloat(MakeFormat(ResourceFormatType::BC5, 2, CompType::SNorm), block, 16);
+    CHECK(out[0] == Approx(-1.0f / 127.0f));
+    CHECK(out[1] == -1.0f);
+    CHECK(out[5] == 1.0f);
+    CHECK(out[6] == 0.0f);
+  };
+}
+
+TEST_CASE("Decode BC6H and BC7 blocks", "[texture_decode]")
+{
+  SECTION("BC6H one region")
+  {
+    // mode 11: 10-bit endpoints, no transform
+    BlockWriter w;
+    w.Write(0x03, 5);
+    w.Write(512, 10);
+    w.Write(0, 10);
+    w.Write(0, 10);
+    w.Write(1023, 10);
+    w.Write(1023, 10);
+    w.Write(1023, 10);
+    // texel 0 uses the first endpoint, texel 1 the second
+    w.Write(0, 3);
+    w.Write(15, 4);
+
+    std::vector<float> out = DecodeFloat(MakeFormat(ResourceFormatType::BC6, 3, CompType::Float),
+                                         w.data, 16);
+    CHECK(out[0] == 1.5146484375f);
+    CHECK(out[1] == 0.0f);
+    CHECK(out[3] == 1.0f);
+    CHECK(out[4] == 65504.0f);
+    CHECK(out[5] == 65504.0f);
+    CHECK(out[6] == 65504.0f);
+  };
+
+  SECTION("BC6H reserved mode")
+  {
+    byte block[16] = {0x13};
+    std::vector<float> out =
+        DecodeFloat(MakeFormat(ResourceFormatType::BC6, 3, CompType::Float), block, 16);
+    CHECK(out[0] == 0.0f);
+    CHECK(out[3] == 1.0f);
+  };
+
+  SECTION("BC7 mode 6")
+  {
+    BlockWriter w;
+    w.Write(0x40, 7);
+    // R, G, B and A for both endpoints
+    w.Write(0x7f, 7);
+    w.Write(0x00, 7);
+    w.Write(0x40, 7);
+    w.Write(0x00, 7);
+    w.Write(0x00, 7);
+    w.Write(0x7f, 7);
+    w.Write(0x7f, 7);
+    w.Write(0x7f, 7);
+    // p-bits
+    w.Write(1, 1);
+    w.Write(0, 1);
+    // texel 0 is the first endpoint, texel 1 the second, texel 2 halfway between
+    w.Write(0, 3);
+    w.Write(15, 4);
+    w.Write(8, 4);
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC7, 4), w.data, 16);
+    CHECK(Texel(out, 0) == RGBA(255, 129, 1, 255));
+    CHECK(Texel(out, 1) == RGBA(0, 0, 254, 254));
+    CHECK(Texel(out, 2) == RGBA(120, 60, 135, 254));
+    CHECK(Texel(out, 3) == RGBA(255, 129, 1, 255));
+  };
+
+  SECTION("BC7 mode 5 with rotation")
+  {
+    BlockWriter w;
+    w.Write(0x20, 6);
+    // swap alpha and red
+    w.Write(1, 2);
+    // 7-bit colour endpoints then 8-bit alpha endpoints
+    w.Write(0x7f, 7);
+    w.Write(0x00, 7);
+    w.Write(0x00, 7);
+    w.Write(0x00, 7);
+    w.Write(0x00, 7);
+    w.Write(0x00, 7);
+    w.Write(0x10, 8);
+    w.Write(0x10, 8);
+    // colour indices then alpha indices, all 0
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC7, 4), w.data, 16);
+    CHECK(Texel(out, 0) == RGBA(0x10, 0, 0, 255));
+  };
+
+  SECTION("BC7 reserved mode")
+  {
+    byte block[16] = {};
+    memset(block + 1, 0xff, 15);
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC7, 4), block, 16);
+    CHECK(Texel(out, 0) == RGBA(0, 0, 0, 0));
+  };
+}
+
+TEST_CASE("Decode ETC2 and EAC blocks", "[texture_decode]")
+{
+  SECTION("ETC2 individual mode")
+  {
+    byte block[8];
+    // both sub-blocks (255, 136, 0) with modifier table 0. Texel (1,0) uses index 3
+    WriteBigEndian(block, 0xFF880000, (1U << 20) | (1U << 4));
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::ETC2, 3), block, 8);
+    CHECK(Texel(out, 0) == RGBA(255, 138, 2, 255));
+    CHECK(Texel(out, 1) == RGBA(247, 128, 0, 255));
+  };
+
+  SECTION("ETC2 planar mode")
+  {
+    byte block[8];
+    // origin colour (255, 129, 0), vertical the same, and horizontal red of 0. Blue's base and
+    // delta overflow to select the planar mode
+    WriteBigEndian(block, (0x3fU << 25) | (1U << 24) | (1U << 10) | (1U << 1),
+                   (64U << 25) | (63U << 13) | (64U << 6));
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::ETC2, 3), block, 8);
+    CHECK(Texel(out, 0) == RGBA(255, 129, 0, 255));
+    CHECK(Texel(out, 1) == RGBA(191, 129, 0, 255));
+    CHECK(Texel(out, 2) == RGBA(128, 129, 0, 255));
+    CHECK(Texel(out, 3) == RGBA(64, 129, 0, 255));
+    CHECK(Texel(out, 12) == RGBA(255, 129, 0, 255));
+  };
+
+  SECTION("ETC2 punch-through alpha")
+  {
+    byte block[8];
+    // differential mode with a base of 16 and the opaque bit clear. Texel (0,1) uses index 1
+    // and texel (0,2) uses index 2
+    WriteBigEndian(block, (16U << 27) | (16U << 19) | (16U << 11), (1U << 1) | (1U << 18));
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::ETC2, 4), block, 8);
+    CHECK(Texel(out, 0) == RGBA(132, 132, 132, 255));
+    CHECK(Texel(out, 4) == RGBA(140, 140, 140, 255));
+    CHECK(Texel(out, 8) == RGBA(0, 0, 0, 0));
+  };
+
+  SECTION("EAC")
+  {
+    byte block[16];
+    // base 200, multiplier 2, table 0. Texel (0,0) uses index 7, texel (0,1) index 3
+    const uint32_t indices = (7U << 13) | (3U << 10);
+    WriteBigEndian(block, (200U << 24) | (2U << 20) | indices, 0);
+    WriteBigEndian(block + 8, 0xFF880000, 0);
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::EAC, 4), block, 16);
+    CHECK(Texel(out, 0) == RGBA(255, 138, 2, 228));
+    CHECK(Texel(out, 4) == RGBA(255, 138, 2, 170));
+
+    // R11 with base 128 and multiplier 1
+    WriteBigEndian(block, (128U << 24) | (1U << 20) | indices, 0);
+    std::vector<float> outf = DecodeFloat(MakeFormat(ResourceFormatType::EAC, 1), block, 8);
+    CHECK(outf[0] == Approx(1140.0f / 2047.0f));
+    CHECK(outf[16] == Approx(908.0f / 2047.0f));
+    CHECK(outf[1] == 0.0f);
+    CHECK(outf[3] == 1.0f);
+  };
+}
+
+TEST_CASE("Decode ASTC blocks", "[texture_decode]")
+{
+  std::vector<byte> out(4 * 4 * 4);
+
+  SECTION("Void extent")
+  {
+    BlockWriter w;
+    w.Write(0xDFC, 12);
+    w.Write(0xFFFFFFFF, 26);
+    w.Write(0xFFFFFFFF, 26);
+    w.Write(0xFFFF, 16);
+    w.Write(0x8000, 16);
+    w.Write(0x0000, 16);
+    w.Write(0xFFFF, 16);
+
+    CHECK(DecodeASTC(4, 4, false, 4, 4, w.data, 16, DecodedFormat::RGBA8, out.data()));
+    CHECK(Texel(out, 0) == RGBA(255, 128, 0, 255));
+    CHECK(Texel(out, 15) == RGBA(255, 128, 0, 255));
+
+    // HDR void extent is an error in LDR
+    w.data[1] |= 0x2;
+    CHECK(DecodeASTC(4, 4, false, 4, 4, w.data, 16, DecodedFormat::RGBA8, out.data()));
+    CHECK(Texel(out, 0) == RGBA(255, 0, 255, 255));
+  };
+
+  SECTION("Single partition RGB")
+  {
+    BlockWriter w;
+    // 4x4 weight grid in the 0..3 range, one partition of RGB direct endpoints
+    w.Write(0x042, 11);
+    w.Write(0, 2);
+    w.Write(8, 4);
+    // 8-bit endpoint values, black to white
+    for(uint32_t i = 0; i < 3; i++)
+    {
+      w.Write(0, 8);
+      w.Write(255, 8);
+    }
+
+    // the weights are stored in reverse from the top of the block: texels 0-3 use weights 0-3
+    for(uint32_t i = 0; i < 4; i++)
+    {
+      for(uint32_t b = 0; b < 2; b++)
+      {
+        const uint32_t bit = 127 - (i * 2 + b);
+        if((i >> b) & 0x1)
+          w.data[bit / 8] |= byte(1 << (bit % 8));
+      }
+    }
+
+    CHECK(DecodeASTC(4, 4, false, 4, 4, w.data, 16, DecodedFormat::RGBA8, out.data()));
+    CHECK(Texel(out, 0) == RGBA(0, 0, 0, 255));
+    CHECK(Texel(out, 1) == RGBA(84, 84, 84, 255));
+    CHECK(Texel(out, 2) == RGBA(171, 171, 171, 255));
+    CHECK(Texel(out, 3) == RGBA(255, 255, 255, 255));
+    CHECK(Texel(out, 4) == RGBA(0, 0, 0, 255));
+  };
+
+  SECTION("Invalid footprint")
+  {
+    byte block[16] = {};
+    CHECK_FALSE(DecodeASTC(7, 7, false, 4, 4, block, 16, DecodedFormat::RGBA8, out.data()));
+  };
+}
+
+TEST_CASE("Decode block-compressed images", "[texture_decode]")
+{
+  SECTION("Partial blocks are clipped")
+  {
+    // two BC1 blocks, red then blue, decoded as a 5x3 image
+    const byte blocks[16] = {
+        0x00, 0xF8, 0x00, 0xF8, 0, 0, 0, 0, 0x1F, 0x00, 0x1F, 0x00, 0, 0, 0, 0,
+    };
+
+    std::vector<byte> out = Decode8(MakeFormat(ResourceFormatType::BC1, 4), blocks, 16, 5, 3);
+    CHECK(out.size() == 5 * 3 * 4);
+    CHECK(Texel(out, 3) == RGBA(255, 0, 0, 255));
+    CHECK(Texel(out, 4) == RGBA(0, 0, 255, 255));
+    CHECK(Texel(out, 14) == RGBA(0, 0, 255, 255));
+
+    CHECK(GetBlockCompressedSize(MakeFormat(ResourceFormatType::BC1, 4), 5, 3) == 16);
+
+    // not enough data
+    CHECK_FALSE(DecodeBlockCompressed(MakeFormat(ResourceFormatType::BC1, 4), 5, 3, blocks, 8,
+                                      DecodedFormat::RGBA8, out.data()));
+  };
+
+  SECTION("Float output")
+  {
+    const byte block[8] = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00};
+
+    std::vector<float> out = DecodeFloat(MakeFormat(ResourceFormatType::BC1, 4), block, 8);
+    CHECK(out[8] == Approx(170.0f / 255.0f));
+    CHECK(out[10] == Approx(85.0f / 255.0f));
+
+    // sRGB is converted to linear, except for alpha
+    out = DecodeFloat(MakeFormat(ResourceFormatType::BC1, 4, CompType::UNormSRGB), block, 8);
+    CHECK(out[8] == ConvertFromSRGB8(170));
+    CHECK(out[10] == ConvertFromSRGB8(85));
+    CHECK(out[11] == 1.0f);
+  };
+
+  SECTION("Threaded decode matches decoding in strips")
+  {
+    const uint32_t width = 1024, height = 256;
+    const ResourceFormat fmt = MakeFormat(ResourceFormatType::BC7, 4);
+
+    const size_t size = GetBlockCompressedSize(fmt, width, height);
+    std::vector<byte> data(size);
+
+    uint32_t seed = 0x1234567;
+    for(byte &b : data)
+    {
+      seed = seed * 1103515245 + 12345;
+      b = byte(seed >> 16);
+    }
+
+    std::vector<byte> whole = Decode8(fmt, data.data(), size, width, height);
+
+    // each row of blocks decoded as its own image is too small to be split up
+    const size_t stripSize = size / (height / 4);
+    for(uint32_t y = 0; y < height; y += 4)
+    {
+      std::vector<byte> strip = Decode8(fmt, data.data() + stripSize * (y / 4), stripSize, width, 4);
+      CHECK(memcmp(strip.data(), whole.data() + y * width * 4, strip.size()) == 0);
+    }
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
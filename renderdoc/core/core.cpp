@@ -439,6 +439,8 @@ RenderDoc::~RenderDoc()
   for(auto it = m_ShutdownFunctions.begin(); it != m_ShutdownFunctions.end(); ++it)
     (*it)();
 
+  TrimRetroactiveFrames(0, 0);
+
   for(size_t i = 0; i < m_Captures.size(); i++)
   {
     if(m_Captures[i].retrieved)
@@ -509,6 +511,13 @@ void RenderDoc::ProcessGlobalEnvironment(GlobalEnvironment env, const std::vecto
       RDCDEBUG("[%u]: %s", (uint32_t)i, args[i].c_str());
   }
 
+  // a multi-session remote server launches its workers with the session to serve
+  for(size_t i = 0; i + 1 < args.size(); i++)
+  {
+    if(args[i] == "--remote-session")
+      SetConfigSetting("remoteSessionPort", args[i + 1]);
+  }
+
   m_AvailableGPUThread = Threading::CreateThread([this]() {
     for(GraphicsAPI api : {GraphicsAPI::D3D11, GraphicsAPI::D3D12, GraphicsAPI::Vulkan})
     {
@@ -691,8 +700,18 @@ void RenderDoc::StartFrameCapture(void *dev, void *wnd)
   IFrameCapturer *frameCap = MatchFrameCapturer(dev, wnd);
   if(frameCap)
   {
+    // only a start directly following ShouldTriggerCapture's request captures into the ring
+    if(m_CapturesActive == 0)
+      m_RetroCapturing = m_RetroCaptureRequested;
+    m_RetroCaptureRequested = false;
+
+    double start = m_RetroTimer.GetMilliseconds();
+
     frameCap->StartFrameCapture(dev, wnd);
     m_CapturesActive++;
+
+    if(m_RetroCapturing)
+      m_RetroStartCost = m_RetroTimer.GetMilliseconds() - start;
   }
 }
 
@@ -715,8 +734,24 @@ bool RenderDoc::EndFrameCapture(void *dev, void *wnd)
   IFrameCapturer *frameCap = MatchFrameCapturer(dev, wnd);
   if(frameCap)
   {
+    m_RetroCaptureRequested = false;
+
+    const bool retro = m_RetroCapturing;
+    double start = m_RetroTimer.GetMilliseconds();
+
     bool ret = frameCap->EndFrameCapture(dev, wnd);
     m_CapturesActive--;
+
+    if(retro && ret)
+    {
+      // hold off the next ring capture long enough that the time spent starting and ending this one
+      // stays within the CPU budget as a share of the total.
+      double now = m_RetroTimer.GetMilliseconds();
+      double cost = m_RetroStartCost + (now - start);
+      double budget = double(RDCCLAMP(m_Options.retroactiveCPUBudget, 1U, 100U));
+      m_RetroNextCapture = now + cost * (100.0 - budget) / budget;
+    }
+
     return ret;
   }
   return false;
@@ -727,6 +762,8 @@ bool RenderDoc::DiscardFrameCapture(void *dev, void *wnd)
   IFrameCapturer *frameCap = MatchFrameCapturer(dev, wnd);
   if(frameCap)
   {
+    m_RetroCaptureRequested = false;
+
     bool ret = frameCap->DiscardFrameCapture(dev, wnd);
     m_CapturesActive--;
     return ret;
@@ -761,6 +798,9 @@ void RenderDoc::Tick()
 
   m_FrameTimer.UpdateTimers();
 
+  if(m_TelemetryEnabled)
+    Atomic::Inc32(&m_TelemetryFrames);
+
   if(!prev_focus && cur_focus)
   {
     CycleActiveWindow();
@@ -774,6 +814,83 @@ void RenderDoc::Tick()
   prev_cap = cur_cap;
 }
 
+void RenderDoc::SetTelemetryEnabled(bool enabled)
+{
+  SCOPED_LOCK(m_TelemetryLock);
+
+  if(m_TelemetryEnabled == enabled)
+    return;
+
+  RDCLOG("%s capture telemetry", enabled ? "Enabling" : "Disabling");
+
+  ResetTelemetry();
+  m_TelemetryEnabled = enabled;
+}
+
+void RenderDoc::ResetTelemetry()
+{
+  m_TelemetryCalls.clear();
+  m_TelemetryFrames = 0;
+  m_TelemetryTimer.Restart();
+  m_TelemetrySerialised = Chunk::TotalSerialised();
+  m_TelemetryDiffTicks = GetFindDiffRangeTicks();
+}
+
+void RenderDoc::AddCallTelemetry(const rdcarray<APICallTelemetry> &calls)
+{
+  SCOPED_LOCK(m_TelemetryLock);
+
+  if(!m_TelemetryEnabled)
+    return;
+
+  for(const APICallTelemetry &call : calls)
+  {
+    APICallTelemetry &total = m_TelemetryCalls[call.function];
+    total.function = call.function;
+    total.count += call.count;
+    total.duration += call.duration;
+  }
+}
+
+bool RenderDoc::FetchTelemetry(CaptureTelemetryData &telemetry)
+{
+  SCOPED_LOCK(m_TelemetryLock);
+
+  if(!m_TelemetryEnabled || m_TelemetryFrames == 0)
+    return false;
+
+  uint32_t numFrames = (uint32_t)m_TelemetryFrames;
+
+  // tick frequency is in ticks per millisecond
+  double diffTime = double(GetFindDiffRangeTicks() - m_TelemetryDiffTicks) /
+                    Timing::GetTickFrequency() / 1000.0;
+
+  telemetry = CaptureTelemetryData();
+  telemetry.numFrames = numFrames;
+  telemetry.frameTime = m_TelemetryTimer.GetMilliseconds() / 1000.0 / numFrames;
+  telemetry.mapTrackingTime = diffTime / numFrames;
+  telemetry.serialisedBytes = (Chunk::TotalSerialised() - m_TelemetrySerialised) / numFrames;
+  telemetry.chunkMemory = Chunk::TotalMem();
+
+  double hookedTime = 0.0;
+  telemetry.calls.reserve(m_TelemetryCalls.size());
+  for(auto it = m_TelemetryCalls.begin(); it != m_TelemetryCalls.end(); ++it)
+  {
+    telemetry.calls.push_back(it->second);
+    hookedTime += it->second.duration;
+  }
+  telemetry.hookedTime = hookedTime / numFrames;
+
+  std::sort(telemetry.calls.begin(), telemetry.calls.end(),
+            [](const APICallTelemetry &a, const APICallTelemetry &b) {
+              return a.duration > b.duration;
+            });
+
+  ResetTelemetry();
+
+  return true;
+}
+
 void RenderDoc::CycleActiveWindow()
 {
   m_Cap = 0;
@@ -866,11 +983,21 @@ std::string RenderDoc::GetOverlayText(RDCDriver driver, uint32_t frameNumber, in
             overlayText += StringFormat::Fmt("Captured frame %d.\n", m_Captures[i].frameNumber);
         }
       }
+
+      if(m_Options.retroactiveFrames > 0)
+      {
+        SCOPED_LOCK(m_RetroLock);
+        overlayText += StringFormat::Fmt("%u frames held for retroactive capture (%.2f MB).\n",
+                                         (uint32_t)m_RetroFrames.size(),
+                                         float(m_RetroMemory) / 1024.0f / 1024.0f);
+      }
     }
 
 #if ENABLED(RDOC_DEVEL)
-    overlayText += StringFormat::Fmt("%llu chunks - %.2f MB\n", Chunk::NumLiveChunks(),
-                                     float(Chunk::TotalMem()) / 1024.0f / 1024.0f);
+    overlayText += StringFormat::Fmt("%llu chunks - %.2f MB (%.2f MB on disk)\n",
+                                     Chunk::NumLiveChunks(),
+                                     float(Chunk::TotalMem()) / 1024.0f / 1024.0f,
+                                     float(Chunk::SpilledMem()) / 1024.0f / 1024.0f);
 #endif
   }
   else if(capturesEnabled)
@@ -925,9 +1052,37 @@ bool RenderDoc::ShouldTriggerCapture(uint32_t frameNumber)
     }
   }
 
+  // when nothing has been explicitly requested, capture this frame into the retroactive ring if
+  // we're within the CPU budget.
+  m_RetroCaptureRequested = false;
+  if(!ret && m_Options.retroactiveFrames > 0 && m_CapturesActive == 0 &&
+     m_RetroTimer.GetMilliseconds() >= m_RetroNextCapture)
+  {
+    m_RetroCaptureRequested = true;
+    ret = true;
+  }
+
   return ret;
 }
 
+void RenderDoc::TriggerCapture(uint32_t numFrames)
+{
+  // with retroactive capture the frames just presented are saved rather than capturing more. If
+  // nothing is held yet, fall back to capturing the next frames as normal.
+  if(m_Options.retroactiveFrames > 0 && SaveRecentRetroactiveFrames(numFrames) > 0)
+    return;
+
+  m_Cap = numFrames;
+}
+
+void RenderDoc::QueueCapture(uint32_t frameNumber)
+{
+  if(m_Options.retroactiveFrames > 0 && SaveRetroactiveFrame(frameNumber))
+    return;
+
+  m_QueuedFrameCaptures.insert(frameNumber);
+}
+
 void RenderDoc::ResamplePixels(const FramePixels &in, RDCThumb &out)
 {
   // code below assumes pitch_requirement is a power of 2 number
@@ -1063,31 +1218,34 @@ void RenderDoc::EncodePixelsPNG(const RDCThumb &in, RDCThumb &out)
   out.format = FileType::PNG;
 }
 
-RDCFile *RenderDoc::CreateRDC(RDCDriver driver, uint32_t frameNum, const FramePixels &fp)
+std::string RenderDoc::GetCaptureFilename(uint32_t frameNum)
 {
-  RDCFile *ret = new RDCFile;
-
   std::string suffix = StringFormat::Fmt("_frame%u", frameNum);
 
   if(frameNum == ~0U)
     suffix = "_capture";
 
-  m_CurrentLogFile = StringFormat::Fmt("%s%s.rdc", m_CaptureFileTemplate.c_str(), suffix.c_str());
+  std::string ret = StringFormat::Fmt("%s%s.rdc", m_CaptureFileTemplate.c_str(), suffix.c_str());
 
   // make sure we don't stomp another capture if we make multiple captures in the same frame.
   {
     SCOPED_LOCK(m_CaptureLock);
     int altnum = 2;
-    while(std::find_if(m_Captures.begin(), m_Captures.end(), [this](const CaptureData &o) {
-            return o.path == m_CurrentLogFile;
-          }) != m_Captures.end())
+    while(std::find_if(m_Captures.begin(), m_Captures.end(),
+                       [&ret](const CaptureData &o) { return o.path == ret; }) != m_Captures.end())
     {
-      m_CurrentLogFile =
-          StringFormat::Fmt("%s%s_%d.rdc", m_CaptureFileTemplate.c_str(), suffix.c_str(), altnum);
+      ret = StringFormat::Fmt("%s%s_%d.rdc", m_CaptureFileTemplate.c_str(), suffix.c_str(), altnum);
       altnum++;
     }
   }
 
+  return ret;
+}
+
+RDCFile *RenderDoc::CreateRDC(RDCDriver driver, uint32_t frameNum, const FramePixels &fp)
+{
+  RDCFile *ret = new RDCFile;
+
   RDCThumb outRaw, outPng;
   if(fp.data)
   {
@@ -1098,14 +1256,21 @@ RDCFile *RenderDoc::CreateRDC(RDCDriver driver, uint32_t frameNum, const FramePi
 
   ret->SetData(driver, ToStr(driver).c_str(), OSUtility::GetMachineIdent(), &outPng);
 
-  FileIO::CreateParentDirectory(m_CurrentLogFile);
+  // frames for the retroactive ring are never given a file, so their sections stay in memory until
+  // the frame is saved.
+  if(!m_RetroCapturing)
+  {
+    m_CurrentLogFile = GetCaptureFilename(frameNum);
 
-  ret->Create(m_CurrentLogFile.c_str());
+    FileIO::CreateParentDirectory(m_CurrentLogFile);
 
-  if(ret->ErrorCode() != ContainerError::NoError)
-  {
-    RDCERR("Error creating RDC at '%s'", m_CurrentLogFile.c_str());
-    SAFE_DELETE(ret);
+    ret->Create(m_CurrentLogFile.c_str());
+
+    if(ret->ErrorCode() != ContainerError::NoError)
+    {
+      RDCERR("Error creating RDC at '%s'", m_CurrentLogFile.c_str());
+      SAFE_DELETE(ret);
+    }
   }
 
   SAFE_DELETE_ARRAY(outRaw.pixels);
@@ -1519,6 +1684,11 @@ void RenderDoc::SetCaptureOptions(const CaptureOptions &opts)
 {
   m_Options = opts;
 
+  Chunk::SetMemoryBudget(uint64_t(opts.captureMemoryBudgetMB) * 1024 * 1024);
+
+  TrimRetroactiveFrames(opts.retroactiveFrames,
+                        uint64_t(opts.retroactiveMemoryBudgetMB) * 1024 * 1024);
+
   LibraryHooks::OptionsUpdated();
 }
 
@@ -1538,71 +1708,221 @@ void RenderDoc::SetCaptureFileTemplate(const char *pathtemplate)
 
 void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
 {
+  if(m_RetroCapturing)
+  {
+    m_RetroCapturing = false;
+
+    if(rdc)
+      HoldRetroactiveFrame(rdc, frameNumber);
+
+    return;
+  }
+
   RenderDoc::Inst().SetProgress(CaptureProgress::FileWriting, 0.0f);
 
   if(rdc)
   {
-    // add the resolve database if we were capturing callstacks.
-    if(m_Options.captureCallstacks)
-    {
-      SectionProperties props = {};
-      props.type = SectionType::ResolveDatabase;
-      props.version = 1;
-      StreamWriter *w = rdc->WriteSection(props);
+    FinishCaptureFile(rdc, m_CurrentLogFile, frameNumber);
+  }
+  else
+  {
+    RDCLOG("Discarded capture, Frame %u", frameNumber);
+  }
 
-      size_t sz = 0;
-      Callstack::GetLoadedModules(NULL, sz);
+  RenderDoc::Inst().SetProgress(CaptureProgress::FileWriting, 1.0f);
+}
 
-      byte *buf = new byte[sz];
-      Callstack::GetLoadedModules(buf, sz);
+void RenderDoc::FinishCaptureFile(RDCFile *rdc, const std::string &path, uint32_t frameNumber)
+{
+  // add the resolve database if we were capturing callstacks.
+  if(m_Options.captureCallstacks)
+  {
+    SectionProperties props = {};
+    props.type = SectionType::ResolveDatabase;
+    props.version = 1;
+    StreamWriter *w = rdc->WriteSection(props);
 
-      w->Write(buf, sz);
+    size_t sz = 0;
+    Callstack::GetLoadedModules(NULL, sz);
 
-      w->Finish();
+    byte *buf = new byte[sz];
+    Callstack::GetLoadedModules(buf, sz);
 
-      delete w;
-    }
+    w->Write(buf, sz);
 
-    const RDCThumb &thumb = rdc->GetThumbnail();
-    if(thumb.format != FileType::JPG && thumb.width > 0 && thumb.height > 0)
-    {
-      SectionProperties props = {};
-      props.type = SectionType::ExtendedThumbnail;
-      props.version = 1;
-      StreamWriter *w = rdc->WriteSection(props);
+    w->Finish();
 
-      // if this file format ever changes, be sure to update the XML export which has a special
-      // handling for this case.
+    delete w;
+  }
 
-      ExtThumbnailHeader header;
-      header.width = thumb.width;
-      header.height = thumb.height;
-      header.len = thumb.len;
-      header.format = thumb.format;
-      w->Write(header);
-      w->Write(thumb.pixels, thumb.len);
+  const RDCThumb &thumb = rdc->GetThumbnail();
+  if(thumb.format != FileType::JPG && thumb.width > 0 && thumb.height > 0)
+  {
+    SectionProperties props = {};
+    props.type = SectionType::ExtendedThumbnail;
+    props.version = 1;
+    StreamWriter *w = rdc->WriteSection(props);
 
-      w->Finish();
+    // if this file format ever changes, be sure to update the XML export which has a special
+    // handling for this case.
 
-      delete w;
-    }
+    ExtThumbnailHeader header;
+    header.width = thumb.width;
+    header.height = thumb.height;
+    header.len = thumb.len;
+    header.format = thumb.format;
+    w->Write(header);
+    w->Write(thumb.pixels, thumb.len);
+
+    w->Finish();
+
+    delete w;
+  }
+
+  RDCLOG("Written to disk: %s", path.c_str());
+
+  CaptureData cap(path, Timing::GetUnixTimestamp(), rdc->GetDriver(), frameNumber);
+  {
+    SCOPED_LOCK(m_CaptureLock);
+    m_Captures.push_back(cap);
+  }
 
-    RDCLOG("Written to disk: %s", m_CurrentLogFile.c_str());
+  delete rdc;
+}
+
+void RenderDoc::HoldRetroactiveFrame(RDCFile *rdc, uint32_t frameNumber)
+{
+  RetroactiveFrame frame;
+  frame.frameNumber = frameNumber;
+  frame.size = 0;
+  frame.rdc = rdc;
 
-    CaptureData cap(m_CurrentLogFile, Timing::GetUnixTimestamp(), rdc->GetDriver(), frameNumber);
+  for(int i = 0; i < rdc->NumSections(); i++)
+    frame.size += rdc->GetSectionProperties(i).uncompressedSize;
+
+  const uint64_t budget = uint64_t(m_Options.retroactiveMemoryBudgetMB) * 1024 * 1024;
+
+  // a frame that can never fit is dropped straight away, rather than evicting everything older
+  if(budget > 0 && frame.size > budget)
+  {
+    static bool warned = false;
+    if(!warned)
     {
-      SCOPED_LOCK(m_CaptureLock);
-      m_Captures.push_back(cap);
+      warned = true;
+      RDCWARN("Frame %u needs %llu bytes, more than the retroactive capture memory budget",
+              frameNumber, frame.size);
     }
 
     delete rdc;
+    return;
   }
-  else
+
   {
-    RDCLOG("Discarded capture, Frame %u", frameNumber);
+    SCOPED_LOCK(m_RetroLock);
+    m_RetroFrames.push_back(frame);
+    m_RetroMemory += frame.size;
   }
 
-  RenderDoc::Inst().SetProgress(CaptureProgress::FileWriting, 1.0f);
+  TrimRetroactiveFrames(m_Options.retroactiveFrames, budget);
+}
+
+void RenderDoc::TrimRetroactiveFrames(uint32_t maxFrames, uint64_t maxMemory)
+{
+  SCOPED_LOCK(m_RetroLock);
+
+  // a memory budget of 0 means no limit, but with no frames allowed everything is dropped
+  while(!m_RetroFrames.empty() && (m_RetroFrames.size() > maxFrames ||
+                                   (maxMemory > 0 && m_RetroMemory > maxMemory)))
+  {
+    const RetroactiveFrame &frame = m_RetroFrames.front();
+
+    m_RetroMemory -= frame.size;
+    delete frame.rdc;
+    m_RetroFrames.pop_front();
+  }
+}
+
+uint32_t RenderDoc::SaveRecentRetroactiveFrames(uint32_t numFrames)
+{
+  std::vector<uint32_t> frames;
+
+  {
+    SCOPED_LOCK(m_RetroLock);
+    for(size_t i = m_RetroFrames.size(); i > 0 && frames.size() < numFrames; i--)
+      frames.push_back(m_RetroFrames[i - 1].frameNumber);
+  }
+
+  uint32_t ret = 0;
+
+  // save oldest first so the captures are listed in frame order
+  for(size_t i = frames.size(); i > 0; i--)
+  {
+    if(SaveRetroactiveFrame(frames[i - 1]))
+      ret++;
+  }
+
+  return ret;
+}
+
+bool RenderDoc::SaveRetroactiveFrame(uint32_t frameNumber)
+{
+  RDCFile *held = NULL;
+
+  // take ownership of the held frame, so the ring isn't locked while it's written out
+  {
+    SCOPED_LOCK(m_RetroLock);
+    for(auto it = m_RetroFrames.begin(); it != m_RetroFrames.end(); ++it)
+    {
+      if(it->frameNumber == frameNumber)
+      {
+        held = it->rdc;
+        m_RetroMemory -= it->size;
+        m_RetroFrames.erase(it);
+        break;
+      }
+    }
+  }
+
+  if(!held)
+    return false;
+
+  std::string path = GetCaptureFilename(frameNumber);
+
+  RDCFile *rdc = new RDCFile;
+  rdc->SetData(held->GetDriver(), held->GetDriverName().c_str(), held->GetMachineIdent(),
+               &held->GetThumbnail());
+
+  FileIO::CreateParentDirectory(path);
+
+  rdc->Create(path.c_str());
+
+  for(int i = 0; rdc->ErrorCode() == ContainerError::NoError && i < held->NumSections(); i++)
+  {
+    StreamWriter *writer = rdc->WriteSection(held->GetSectionProperties(i));
+    StreamReader *reader = held->ReadSection(i);
+
+    StreamTransfer(writer, reader, NULL);
+
+    writer->Finish();
+
+    delete reader;
+    delete writer;
+  }
+
+  delete held;
+
+  if(rdc->ErrorCode() != ContainerError::NoError)
+  {
+    RDCERR("Error saving retroactive capture of frame %u to '%s'", frameNumber, path.c_str());
+    delete rdc;
+    return false;
+  }
+
+  RDCLOG("Saving retroactive capture of frame %u", frameNumber);
+
+  FinishCaptureFile(rdc, path, frameNumber);
+
+  return true;
 }
 
 void RenderDoc::AddDeviceFrameCapturer(void *dev, IFrameCapturer *cap)
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
@@ -571,10 +572,10 @@ public:
     wnd = m_ActiveWindow.wnd;
   }
 
-  void TriggerCapture(uint32_t numFrames) { m_Cap = numFrames; }
+  void TriggerCapture(uint32_t numFrames);
   uint32_t GetOverlayBits() { return m_Overlay; }
   void MaskOverlayBits(uint32_t And, uint32_t Or) { m_Overlay = (m_Overlay & And) | Or; }
-  void QueueCapture(uint32_t frameNumber) { m_QueuedFrameCaptures.insert(frameNumber); }
+  void QueueCapture(uint32_t frameNumber);
   void SetFocusKeys(RENDERDOC_InputButton *keys, int num)
   {
     m_FocusKeys.resize(num);
@@ -602,6 +603,15 @@ public:
 
   void CycleActiveWindow();
   uint32_t GetCapturableWindowCount() { return (uint32_t)m_WindowFrameCapturers.size(); }
+
+  // capture overhead telemetry, enabled by a target control client. Drivers that time their hooked
+  // calls check IsTelemetryEnabled() and report them with AddCallTelemetry, and the target control
+  // thread periodically fetches the accumulated statistics which resets them for the next interval.
+  void SetTelemetryEnabled(bool enabled);
+  bool IsTelemetryEnabled() const { return m_TelemetryEnabled; }
+  void AddCallTelemetry(const rdcarray<APICallTelemetry> &calls);
+  bool FetchTelemetry(CaptureTelemetryData &telemetry);
+
 private:
   RenderDoc();
   ~RenderDoc();
@@ -633,6 +643,49 @@ private:
 
   std::set<uint32_t> m_QueuedFrameCaptures;
 
+  // retroactive capture. Frames are captured in the background into in-memory RDCFiles and held in
+  // a ring, oldest first, until a trigger saves them to disk or they're evicted by the frame count
+  // or memory budget.
+  struct RetroactiveFrame
+  {
+    uint32_t frameNumber;
+    uint64_t size;
+    RDCFile *rdc;
+  };
+
+  Threading::CriticalSection m_RetroLock;
+  std::deque<RetroactiveFrame> m_RetroFrames;
+  uint64_t m_RetroMemory = 0;
+
+  // set by ShouldTriggerCapture when the next capture started is only for the ring, and latched
+  // for the lifetime of that capture when it starts.
+  bool m_RetroCaptureRequested = false;
+  bool m_RetroCapturing = false;
+
+  // used to keep the time spent capturing for the ring within the CPU budget
+  PerformanceTimer m_RetroTimer;
+  double m_RetroStartCost = 0.0;
+  double m_RetroNextCapture = 0.0;
+
+  void HoldRetroactiveFrame(RDCFile *rdc, uint32_t frameNumber);
+  void TrimRetroactiveFrames(uint32_t maxFrames, uint64_t maxMemory);
+  bool SaveRetroactiveFrame(uint32_t frameNumber);
+  uint32_t SaveRecentRetroactiveFrames(uint32_t numFrames);
+
+  std::string GetCaptureFilename(uint32_t frameNum);
+  void FinishCaptureFile(RDCFile *rdc, const std::string &path, uint32_t frameNumber);
+
+  volatile bool m_TelemetryEnabled = false;
+  Threading::CriticalSection m_TelemetryLock;
+  std::map<rdcstr, APICallTelemetry> m_TelemetryCalls;
+  volatile int32_t m_TelemetryFrames = 0;
+  // the time and counter values at the start of the current interval
+  PerformanceTimer m_TelemetryTimer;
+  uint64_t m_TelemetrySerialised = 0;
+  uint64_t m_TelemetryDiffTicks = 0;
+
+  void ResetTelemetry();
+
   uint32_t m_RemoteIdent;
   Threading::ThreadHandle m_RemoteThread;
 
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "common/dds_readwrite.h"
+#include "common/texture_decode.h"
 #include "core/core.h"
 #include "replay/replay_driver.h"
 #include "serialise/rdcfile.h"
@@ -202,6 +203,7 @@ public:
   const GLPipe::State *GetGLPipelineState() { return NULL; }
   const VKPipe::State *GetVulkanPipelineState() { return NULL; }
   void ReplayLog(uint32_t endEventID, ReplayLogType replayType) {}
+  ReplayProfile ProfileReplay() { return ReplayProfile(); }
   std::vector<uint32_t> GetPassEvents(uint32_t eventId) { return std::vector<uint32_t>(); }
   std::vector<EventUsage> GetUsage(ResourceId id) { return std::vector<EventUsage>(); }
   bool IsRenderOutput(ResourceId id) { return false; }
@@ -254,6 +256,13 @@ public:
   {
     return std::vector<PixelModification>();
   }
+  PixelRegionHistory PixelHistoryRegion(std::vector<EventUsage> events, ResourceId target,
+                                        uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                        uint32_t slice, uint32_t mip, uint32_t sampleIdx,
+                                        CompType typeHint)
+  {
+    return PixelRegionHistory();
+  }
   ShaderDebugTrace DebugVertex(uint32_t eventId, uint32_t vertid, uint32_t instid, uint32_t idx,
                                uint32_t instOffset, uint32_t vertOffset)
   {
@@ -679,6 +688,13 @@ void ImageViewer::RefreshFile()
       return;
     }
 
+    // if the replay device can't display this format, decode it on the CPU instead
+    if(!m_Proxy->IsTextureSupported(read_data.format) && IsBlockDecodeSupported(read_data.format))
+    {
+      RDCLOG("Decoding %s image on the CPU", read_data.format.Name().c_str());
+      decode_dds_to_rgba(read_data);
+    }
+
     texDetails.cubemap = read_data.cubemap;
     texDetails.arraysize = read_data.slices;
     texDetails.width = read_data.width;
@@ -30,6 +30,9 @@
 template <typename T>
 struct Intervals;
 
+template <typename T>
+struct FlatIntervals;
+
 template <typename T, typename Map, typename Iter, typename Interval>
 class IntervalsIter;
 
@@ -108,6 +111,7 @@ template <typename T, typename Map, typename Iter, typename Interval>
 class IntervalsIter
 {
   friend struct Intervals<T>;
+  friend struct FlatIntervals<T>;
 
 protected:
   Interval ref;
@@ -289,3 +293,312 @@ public:
     }
   }
 };
+
+// Sorted contiguous storage for the start points of intervals, exposing the subset of the
+// `std::map` interface that the interval references above use. Up to `InlineCount` start points are
+// stored inline, so the common case of only a handful of intervals never allocates.
+// Unlike `std::map`, inserting or erasing invalidates all other iterators.
+template <typename T, size_t InlineCount>
+class FlatIntervalStorage
+{
+public:
+  typedef std::pair<uint64_t, T> value_type;
+  typedef value_type *iterator;
+  typedef const value_type *const_iterator;
+  typedef size_t size_type;
+
+  FlatIntervalStorage() : elems(inlineElems), count(0), capacity(InlineCount) {}
+  FlatIntervalStorage(const FlatIntervalStorage &o) : FlatIntervalStorage()
+  {
+    assign(o.elems, o.count);
+  }
+  FlatIntervalStorage(FlatIntervalStorage &&o) : FlatIntervalStorage() { take(o); }
+  ~FlatIntervalStorage()
+  {
+    if(elems != inlineElems)
+      delete[] elems;
+  }
+  FlatIntervalStorage &operator=(const FlatIntervalStorage &o)
+  {
+    if(this != &o)
+      assign(o.elems, o.count);
+    return *this;
+  }
+  FlatIntervalStorage &operator=(FlatIntervalStorage &&o)
+  {
+    if(this != &o)
+      take(o);
+    return *this;
+  }
+
+  inline iterator begin() { return elems; }
+  inline iterator end() { return elems + count; }
+  inline const_iterator begin() const { return elems; }
+  inline const_iterator end() const { return elems + count; }
+  inline size_type size() const { return count; }
+  inline value_type &back() { return elems[count - 1]; }
+  // Whether the start points are currently stored inline, without any heap allocation.
+  inline bool isInline() const { return elems == inlineElems; }
+  inline iterator upper_bound(uint64_t x)
+  {
+    return std::upper_bound(begin(), end(), x,
+                            [](uint64_t a, const value_type &b) { return a < b.first; });
+  }
+  inline const_iterator upper_bound(uint64_t x) const
+  {
+    return std::upper_bound(begin(), end(), x,
+                            [](uint64_t a, const value_type &b) { return a < b.first; });
+  }
+  inline iterator lower_bound(uint64_t x)
+  {
+    return std::lower_bound(begin(), end(), x,
+                            [](const value_type &a, uint64_t b) { return a.first < b; });
+  }
+
+  std::pair<iterator, bool> insert(const value_type &val)
+  {
+    size_t idx = size_t(lower_bound(val.first) - begin());
+    if(idx < count && elems[idx].first == val.first)
+      return std::make_pair(elems + idx, false);
+
+    // take a copy first, since `val` may refer into our own storage
+    value_type v = val;
+    reserve(count + 1);
+    std::move_backward(elems + idx, elems + count, elems + count + 1);
+    elems[idx] = v;
+    count++;
+    return std::make_pair(elems + idx, true);
+  }
+
+  iterator erase(iterator it)
+  {
+    std::move(it + 1, end(), it);
+    count--;
+    return it;
+  }
+
+  void push_back(const value_type &val)
+  {
+    value_type v = val;
+    reserve(count + 1);
+    elems[count++] = v;
+  }
+
+  // Replace the start points in [first, last) with the `n` start points in `src`, moving the
+  // following start points at most once. `src` must not point into this storage.
+  void replace(size_t first, size_t last, const value_type *src, size_t n)
+  {
+    size_t newCount = count - (last - first) + n;
+    reserve(newCount);
+    if(first + n > last)
+      std::move_backward(elems + last, elems + count, elems + newCount);
+    else if(first + n < last)
+      std::move(elems + last, elems + count, elems + first + n);
+    std::copy(src, src + n, elems + first);
+    count = newCount;
+  }
+
+  void reserve(size_t n)
+  {
+    if(n <= capacity)
+      return;
+    size_t newCapacity = RDCMAX(n, capacity * 2);
+    value_type *newElems = new value_type[newCapacity];
+    std::move(elems, elems + count, newElems);
+    if(elems != inlineElems)
+      delete[] elems;
+    elems = newElems;
+    capacity = newCapacity;
+  }
+
+  void swap(FlatIntervalStorage &o)
+  {
+    FlatIntervalStorage tmp(std::move(o));
+    o = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+private:
+  void assign(const value_type *src, size_t n)
+  {
+    count = 0;
+    reserve(n);
+    std::copy(src, src + n, elems);
+    count = n;
+  }
+
+  void take(FlatIntervalStorage &o)
+  {
+    if(o.elems == o.inlineElems)
+    {
+      assign(o.elems, o.count);
+    }
+    else
+    {
+      if(elems != inlineElems)
+        delete[] elems;
+      elems = o.elems;
+      capacity = o.capacity;
+      count = o.count;
+      o.elems = o.inlineElems;
+      o.capacity = InlineCount;
+    }
+    o.count = 0;
+  }
+
+  value_type inlineElems[InlineCount];
+  value_type *elems;
+  size_t count;
+  size_t capacity;
+};
+
+// Drop-in alternative to `Intervals<T>` which keeps the intervals in a sorted array instead of a
+// `std::map`. Lookups are a binary search over contiguous memory, and `update` and `merge` rebuild
+// the affected range in a single pass instead of splitting and merging one node at a time.
+// This is better suited to containers that are updated very frequently and usually only hold a few
+// intervals, but since any split or merge moves the following intervals it will be slower than
+// `Intervals<T>` for very large numbers of intervals that are updated at random.
+template <typename T>
+struct FlatIntervals
+{
+public:
+  typedef FlatIntervalStorage<T, 4> storage;
+  typedef typename storage::value_type value_type;
+
+  typedef IntervalRef<T, storage, typename storage::iterator> interval;
+  typedef IntervalsIter<T, storage, typename storage::iterator, interval> iterator;
+
+  typedef ConstIntervalRef<T, const storage, typename storage::const_iterator> const_interval;
+  typedef IntervalsIter<T, const storage, typename storage::const_iterator, const_interval>
+      const_iterator;
+
+private:
+  storage StartPoints;
+
+  iterator Wrap(typename storage::iterator iter) { return iterator(&StartPoints, iter); }
+  const_iterator Wrap(typename storage::const_iterator iter) const
+  {
+    return const_iterator(&StartPoints, iter);
+  }
+
+public:
+  FlatIntervals() { StartPoints.push_back(value_type(0, T())); }
+  inline iterator end() { return Wrap(StartPoints.end()); }
+  inline iterator begin() { return Wrap(StartPoints.begin()); }
+  inline const_iterator begin() const { return Wrap(StartPoints.begin()); }
+  inline const_iterator end() const { return Wrap(StartPoints.end()); }
+  typedef typename storage::size_type size_type;
+  inline size_type size() const { return StartPoints.size(); }
+  // Whether the intervals are currently stored without any heap allocation.
+  inline bool isInline() const { return StartPoints.isInline(); }
+  // Find the interval containing `x`.
+  iterator find(uint64_t x)
+  {
+    auto it = StartPoints.upper_bound(x);
+    it--;
+    return Wrap(it);
+  }
+
+  // Find the interval containing `x`.
+  const_iterator find(uint64_t x) const
+  {
+    auto it = StartPoints.upper_bound(x);
+    it--;
+    return Wrap(it);
+  }
+
+  // Same semantics as `Intervals<T>::update`.
+  template <typename Compose>
+  void update(uint64_t start, uint64_t finish, T val, Compose comp)
+  {
+    if(finish <= start)
+      return;
+
+    value_type *elems = StartPoints.begin();
+    const size_t count = StartPoints.size();
+
+    // [lo, hi) are the intervals that intersect [start, finish)
+    const size_t lo = size_t(StartPoints.upper_bound(start) - elems) - 1;
+    const size_t hi = size_t(StartPoints.lower_bound(finish) - elems);
+
+    // build the replacement for [lo, hi) separately, then splice it in with a single move of the
+    // following intervals.
+    storage segment;
+    segment.reserve(hi - lo + 2);
+
+    // append an interval, merging it with the previous interval if the values match
+    auto append = [&](uint64_t s, const T &v) {
+      if(segment.size() > 0)
+      {
+        if(v == segment.back().second)
+          return;
+      }
+      else if(lo > 0 && v == elems[lo - 1].second)
+      {
+        return;
+      }
+      segment.push_back(value_type(s, v));
+    };
+
+    // the part of the first interval before `start` keeps its value
+    if(elems[lo].first < start)
+      segment.push_back(elems[lo]);
+
+    for(size_t k = lo; k < hi; k++)
+      append(RDCMAX(elems[k].first, start), comp(elems[k].second, val));
+
+    size_t last = hi;
+
+    const uint64_t lastFinish = hi < count ? elems[hi].first : UINT64_MAX;
+    if(lastFinish > finish)
+    {
+      // the part of the last interval after `finish` keeps its value
+      append(finish, elems[hi - 1].second);
+    }
+    else if(hi < count)
+    {
+      // the following interval is untouched, but it might now have the same value as the last
+      // updated interval
+      const T &lastValue = segment.size() > 0 ? segment.back().second : elems[lo - 1].second;
+      if(elems[hi].second == lastValue)
+        last++;
+    }
+
+    StartPoints.replace(lo, last, segment.begin(), segment.size());
+  }
+
+  // Same semantics as `Intervals<T>::merge`.
+  template <typename Compose>
+  void merge(const FlatIntervals &other, Compose comp)
+  {
+    storage result;
+    result.reserve(StartPoints.size() + other.StartPoints.size());
+
+    const value_type *i = StartPoints.begin(), *iEnd = StartPoints.end();
+    const value_type *j = other.StartPoints.begin(), *jEnd = other.StartPoints.end();
+
+    // walk both sets of intervals together, composing the values over each intersection of an
+    // interval in `this` with an interval in `other`.
+    uint64_t cur = 0;
+    while(true)
+    {
+      const uint64_t iFinish = i + 1 < iEnd ? i[1].first : UINT64_MAX;
+      const uint64_t jFinish = j + 1 < jEnd ? j[1].first : UINT64_MAX;
+
+      T v = comp(i->second, j->second);
+      if(result.size() == 0 || !(v == result.back().second))
+        result.push_back(value_type(cur, v));
+
+      cur = RDCMIN(iFinish, jFinish);
+      if(cur == UINT64_MAX)
+        break;
+
+      if(iFinish == cur)
+        i++;
+      if(jFinish == cur)
+        j++;
+    }
+
+    StartPoints.swap(result);
+  }
+};
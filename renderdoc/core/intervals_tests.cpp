@@ -39,7 +39,8 @@ struct Interval
   uint64_t end;
 };
 
-void check_intervals(Intervals<uint64_t> &value, const std::vector<Interval> &expected)
+template <typename IntervalsType>
+void check_intervals(IntervalsType &value, const std::vector<Interval> &expected)
 {
   auto i = value.begin();
   auto j = expected.begin();
@@ -53,95 +54,110 @@ void check_intervals(Intervals<uint64_t> &value, const std::vector<Interval> &ex
   CHECK((j == expected.end()));
 }
 
-Intervals<uint64_t> make_intervals(const std::vector<Interval> &intervals)
+// converts to whichever interval container it's assigned to, so the same tests can construct any
+// of them
+struct IntervalsBuilder
 {
-  Intervals<uint64_t> res;
-  for(auto i = intervals.begin(); i != intervals.end(); i++)
+  const std::vector<Interval> &intervals;
+
+  template <typename IntervalsType>
+  operator IntervalsType() const
   {
-    auto j = res.end();
-    j--;
-    if(i->start > j->start())
-      j->split(i->start);
-    if(i->end < j->finish())
+    IntervalsType res;
+    for(auto i = intervals.begin(); i != intervals.end(); i++)
     {
-      j->split(i->end);
+      auto j = res.end();
       j--;
+      if(i->start > j->start())
+        j->split(i->start);
+      if(i->end < j->finish())
+      {
+        j->split(i->end);
+        j--;
+      }
+      j->setValue(i->value);
     }
-    j->setValue(i->value);
+    check_intervals(res, intervals);
+    return res;
   }
-  check_intervals(res, intervals);
-  return res;
+};
+
+IntervalsBuilder make_intervals(const std::vector<Interval> &intervals)
+{
+  return IntervalsBuilder{intervals};
 }
 
-TEST_CASE("Test Intervals type", "[intervals]")
+// the same tests are run against each interval container, since they must all behave identically
+template <template <typename> class Container>
+void test_intervals()
 {
   SECTION("update tests")
   {
     SECTION("empty Intervals")
     {
-      Intervals<uint64_t> test;
+      Container<uint64_t> test;
       check_intervals(test, {{0, 0, UINT64_MAX}});
     };
 
     SECTION("update a sub-interval")
     {
-      Intervals<uint64_t> test;
+      Container<uint64_t> test;
       test.update(5, 10, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update a sub-interval matching on the left")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(5, 7, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 2, 7}, {7, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update a sub-interval matching on the right")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(7, 10, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 7}, {7, 2, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update an interval that exactly matches an existing interval")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(5, 10, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 2, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update a properly overlapping interval")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(7, 15, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 7}, {7, 2, 10}, {10, 1, 15}, {15, 0, UINT64_MAX}});
     };
 
     SECTION("update a super-interval")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(2, 15, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 2}, {2, 1, 5}, {5, 2, 10}, {10, 1, 15}, {15, 0, UINT64_MAX}});
     };
 
     SECTION("update a super-interval matching on the left")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(5, 15, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 2, 10}, {10, 1, 15}, {15, 0, UINT64_MAX}});
     };
 
     SECTION("update a super-interval matching on the right")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(2, 10, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 2}, {2, 1, 5}, {5, 2, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update overlapping 2 intervals")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, 20}, {20, 10, 30}, {30, 0, UINT64_MAX}});
       test.update(7, 25, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5},
@@ -155,7 +171,7 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("update overlapping 2 intervals matching on start of leftmost interval")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, 20}, {20, 10, 30}, {30, 0, UINT64_MAX}});
       test.update(5, 25, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(
@@ -165,7 +181,7 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("update overlapping 2 intervals matching on end of leftmost interval")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 5, 10}, {10, 0, 20}, {20, 10, 30}, {30, 0, UINT64_MAX}});
       test.update(10, 25, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(
@@ -175,7 +191,7 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("update overlapping 2 intervals matching on start of rightmost interval")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, 20}, {20, 10, 30}, {30, 0, UINT64_MAX}});
       test.update(7, 20, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(
@@ -184,7 +200,7 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("update overlapping 2 intervals matching on end of rightmost interval")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, 20}, {20, 10, 30}, {30, 0, UINT64_MAX}});
       test.update(7, 30, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(
@@ -193,35 +209,35 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("update triggering merge on left")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(10, 20, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 20}, {20, 0, UINT64_MAX}});
     };
 
     SECTION("update triggering merge on right")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(2, 5, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 2}, {2, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("overlapping update triggering merge on left")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(7, 20, 1, [](uint64_t, uint64_t) -> uint64_t { return 1; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 20}, {20, 0, UINT64_MAX}});
     };
 
     SECTION("overlapping update triggering merge on right")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(2, 7, 1, [](uint64_t, uint64_t) -> uint64_t { return 1; });
       check_intervals(test, {{0, 0, 2}, {2, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update triggering multiple merges")
     {
-      Intervals<uint64_t> test = make_intervals(
+      Container<uint64_t> test = make_intervals(
           {{0, 0, 5}, {5, 1, 10}, {10, 0, 12}, {12, 5, 18}, {18, 0, 20}, {20, 1, 30}, {30, 0, UINT64_MAX}});
       test.update(7, 25, 1, [](uint64_t, uint64_t) -> uint64_t { return 1; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 30}, {30, 0, UINT64_MAX}});
@@ -230,7 +246,7 @@ TEST_CASE("Test Intervals type", "[intervals]")
     SECTION(
         "update triggering multiple merges, including merge with non-overlapping interval on left")
     {
-      Intervals<uint64_t> test = make_intervals(
+      Container<uint64_t> test = make_intervals(
           {{0, 0, 5}, {5, 1, 10}, {10, 0, 12}, {12, 5, 18}, {18, 0, 20}, {20, 1, 30}, {30, 0, UINT64_MAX}});
       test.update(10, 25, 1, [](uint64_t, uint64_t) -> uint64_t { return 1; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 30}, {30, 0, UINT64_MAX}});
@@ -239,7 +255,7 @@ TEST_CASE("Test Intervals type", "[intervals]")
     SECTION(
         "update triggering multiple merges, including merge with non-overlapping interval on right")
     {
-      Intervals<uint64_t> test = make_intervals(
+      Container<uint64_t> test = make_intervals(
           {{0, 0, 5}, {5, 1, 10}, {10, 0, 12}, {12, 5, 18}, {18, 0, 20}, {20, 1, 30}, {30, 0, UINT64_MAX}});
       test.update(7, 20, 1, [](uint64_t, uint64_t) -> uint64_t { return 1; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 30}, {30, 0, UINT64_MAX}});
@@ -247,49 +263,49 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("update a interval starting at 0")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(0, 10, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 1, 5}, {5, 2, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update a interval finishing at UINT64_MAX")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(5, UINT64_MAX, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 2, 10}, {10, 1, UINT64_MAX}});
     };
 
     SECTION("update entire range")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(0, UINT64_MAX, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 1, 5}, {5, 2, 10}, {10, 1, UINT64_MAX}});
     };
 
     SECTION("update an empty interval in the interior of an interval")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(2, 2, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update an empty interval on a boundary")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(5, 5, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update an empty interval at 0")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(0, 0, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
     };
 
     SECTION("update an empty interval at UINT64_MAX")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+      Container<uint64_t> test = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
       test.update(UINT64_MAX, UINT64_MAX, 1,
                   [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
@@ -300,9 +316,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
   {
     SECTION("merge matching intervals")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 30}, {30, 1, 40}, {40, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> other =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 30}, {30, 1, 40}, {40, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 10}, {10, 2, 20}, {20, 0, 30}, {30, 2, 40}, {40, 0, UINT64_MAX}});
@@ -310,9 +326,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge shifted intervals")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 30}, {30, 1, 40}, {40, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> other =
           make_intervals({{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5},
@@ -328,8 +344,8 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge into empty intervals")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> test = make_intervals({{0, 0, UINT64_MAX}});
+      Container<uint64_t> other =
           make_intervals({{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
@@ -337,17 +353,17 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge with empty intervals")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
-      Intervals<uint64_t> other = make_intervals({{0, 0, UINT64_MAX}});
+      Container<uint64_t> other = make_intervals({{0, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
     };
 
     SECTION("merge into single interval")
     {
-      Intervals<uint64_t> test = make_intervals({{0, 0, 10}, {10, 1, 30}, {30, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> test = make_intervals({{0, 0, 10}, {10, 1, 30}, {30, 0, UINT64_MAX}});
+      Container<uint64_t> other =
           make_intervals({{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5},
@@ -361,9 +377,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge with single interval")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 5}, {5, 1, 15}, {15, 0, 25}, {25, 1, 35}, {35, 0, UINT64_MAX}});
-      Intervals<uint64_t> other = make_intervals({{0, 0, 10}, {10, 1, 30}, {30, 0, UINT64_MAX}});
+      Container<uint64_t> other = make_intervals({{0, 0, 10}, {10, 1, 30}, {30, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 5},
                              {5, 1, 10},
@@ -376,9 +392,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge disjoint before")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 50}, {50, 1, 60}, {60, 0, 70}, {70, 1, 80}, {80, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> other =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 30}, {30, 1, 40}, {40, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 10},
@@ -394,9 +410,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge disjoint after")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 30}, {30, 1, 40}, {40, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> other =
           make_intervals({{0, 0, 50}, {50, 1, 60}, {60, 0, 70}, {70, 1, 80}, {80, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 10},
@@ -412,9 +428,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge disjoint interleaved")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 50}, {50, 1, 60}, {60, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> other =
           make_intervals({{0, 0, 30}, {30, 1, 40}, {40, 0, 70}, {70, 1, 80}, {80, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 10},
@@ -430,9 +446,9 @@ TEST_CASE("Test Intervals type", "[intervals]")
 
     SECTION("merge disjoint interleaved touching")
     {
-      Intervals<uint64_t> test =
+      Container<uint64_t> test =
           make_intervals({{0, 0, 10}, {10, 1, 20}, {20, 0, 30}, {30, 1, 40}, {40, 0, UINT64_MAX}});
-      Intervals<uint64_t> other =
+      Container<uint64_t> other =
           make_intervals({{0, 0, 20}, {20, 1, 30}, {30, 0, 40}, {40, 1, 50}, {50, 0, UINT64_MAX}});
       test.merge(other, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
       check_intervals(test, {{0, 0, 10}, {10, 1, 50}, {50, 0, UINT64_MAX}});
@@ -440,4 +456,142 @@ TEST_CASE("Test Intervals type", "[intervals]")
   };
 };
 
+TEST_CASE("Test Intervals type", "[intervals]")
+{
+  test_intervals<Intervals>();
+};
+
+TEST_CASE("Test FlatIntervals type", "[intervals]")
+{
+  test_intervals<FlatIntervals>();
+
+  SECTION("inline storage")
+  {
+    FlatIntervals<uint64_t> test;
+    CHECK(test.isInline());
+
+    test.update(5, 10, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
+    test.update(20, 30, 1, [](uint64_t x, uint64_t y) -> uint64_t { return x + y; });
+    CHECK(test.size() == 5);
+    CHECK(!test.isInline());
+
+    // merging intervals back together doesn't shrink the storage
+    test.update(0, UINT64_MAX, 1, [](uint64_t, uint64_t) -> uint64_t { return 1; });
+    check_intervals(test, {{0, 1, UINT64_MAX}});
+  };
+
+  SECTION("copying and moving")
+  {
+    std::vector<Interval> expected;
+    for(uint64_t i = 0; i < 16; i++)
+      expected.push_back({i * 10, i & 1, i == 15 ? UINT64_MAX : (i + 1) * 10});
+
+    FlatIntervals<uint64_t> small = make_intervals({{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+    FlatIntervals<uint64_t> large = make_intervals(expected);
+
+    FlatIntervals<uint64_t> copy = large;
+    check_intervals(copy, expected);
+    check_intervals(large, expected);
+
+    copy = small;
+    check_intervals(copy, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+
+    FlatIntervals<uint64_t> moved = std::move(large);
+    check_intervals(moved, expected);
+
+    moved = std::move(small);
+    check_intervals(moved, {{0, 0, 5}, {5, 1, 10}, {10, 0, UINT64_MAX}});
+  };
+
+  SECTION("random updates and merges match Intervals")
+  {
+    auto compose = [](uint64_t x, uint64_t y) -> uint64_t { return (x + y) % 3; };
+
+    uint32_t seed = 0x12345678;
+    auto rand = [&seed]() -> uint64_t {
+      seed = seed * 1103515245 + 12345;
+      return (seed >> 16) & 0x7fff;
+    };
+
+    Intervals<uint64_t> expected, expectedOther;
+    FlatIntervals<uint64_t> test, testOther;
+
+    for(int i = 0; i < 1000; i++)
+    {
+      uint64_t start = rand() % 500;
+      uint64_t finish = start + rand() % 50;
+      uint64_t val = rand() % 3;
+
+      if(i % 2)
+      {
+        expected.update(start, finish, val, compose);
+        test.update(start, finish, val, compose);
+      }
+      else
+      {
+        expectedOther.update(start, finish, val, compose);
+        testOther.update(start, finish, val, compose);
+      }
+
+      if(i % 100 == 99)
+      {
+        expected.merge(expectedOther, compose);
+        test.merge(testOther, compose);
+      }
+    }
+
+    std::vector<Interval> intervals;
+    for(auto it = expected.begin(); it != expected.end(); it++)
+      intervals.push_back({it->start(), it->value(), it->finish()});
+
+    CHECK(intervals.size() > 10);
+    check_intervals(test, intervals);
+  };
+};
+
+template <typename IntervalsType>
+uint64_t intervals_workload(uint32_t objects, uint32_t iterations)
+{
+  auto compose = [](uint64_t x, uint64_t y) -> uint64_t { return RDCMAX(x, y); };
+
+  std::vector<IntervalsType> refs(objects);
+  IntervalsType submitted;
+
+  uint32_t seed = 0x12345678;
+  auto rand = [&seed]() -> uint64_t {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+  };
+
+  // mimic memory reference tracking - most references are to a handful of ranges per object, and
+  // the references are periodically merged together as they would be on submit.
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    IntervalsType &ref = refs[rand() % objects];
+    uint64_t start = (rand() % 4) * 0x10000;
+    ref.update(start, start + 0x10000, rand() % 4, compose);
+
+    if(i % 64 == 63)
+      submitted.merge(ref, compose);
+  }
+
+  uint64_t ret = submitted.size();
+  for(const IntervalsType &ref : refs)
+    ret += ref.size();
+  return ret;
+}
+
+TEST_CASE("Benchmark Intervals types", "[intervals][.benchmark]")
+{
+  uint64_t mapResult = 0, flatResult = 0;
+
+  BENCHMARK("Intervals") { mapResult = intervals_workload<Intervals<uint64_t>>(256, 1000000); }
+  BENCHMARK("FlatIntervals")
+  {
+    flatResult = intervals_workload<FlatIntervals<uint64_t>>(256, 1000000);
+  }
+
+  CHECK(mapResult == flatResult);
+};
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
\ No newline at end of file
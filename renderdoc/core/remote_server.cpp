@@ -24,11 +24,13 @@
  ******************************************************************************/
 
 #include "remote_server.h"
+#include <algorithm>
 #include <sstream>
 #include <utility>
 #include "android/android.h"
 #include "api/replay/renderdoc_replay.h"
 #include "api/replay/version.h"
+#include "common/timing.h"
 #include "core/core.h"
 #include "os/os_specific.h"
 #include "replay/replay_controller.h"
@@ -78,6 +80,8 @@ enum RemoteServerPacket
   eRemoteServer_GetSectionContents,
   eRemoteServer_WriteSection,
   eRemoteServer_GetAvailableGPUs,
+  eRemoteServer_Queued,
+  eRemoteServer_GetServerStats,
   eRemoteServer_RemoteServerCount,
 };
 
@@ -121,6 +125,8 @@ rdcstr DoStringise(const RemoteServerPacket &el)
     STRINGISE_ENUM_NAMED(eRemoteServer_GetSectionContents, "GetSectionContents");
     STRINGISE_ENUM_NAMED(eRemoteServer_WriteSection, "WriteSection");
     STRINGISE_ENUM_NAMED(eRemoteServer_GetAvailableGPUs, "GetAvailableGPUs");
+    STRINGISE_ENUM_NAMED(eRemoteServer_Queued, "Queued");
+    STRINGISE_ENUM_NAMED(eRemoteServer_GetServerStats, "GetServerStats");
     STRINGISE_ENUM_NAMED(eRemoteServer_RemoteServerCount, "RemoteServerCount");
   }
   END_ENUM_STRINGISE();
@@ -137,14 +143,22 @@ std::string GetRemoteServerChunkName(uint32_t idx)
 #define WRITE_DATA_SCOPE() WriteSerialiser &ser = writer;
 #define READ_DATA_SCOPE() ReadSerialiser &ser = reader;
 
+struct RemoteServerState;
+
 struct ClientThread
 {
   ClientThread()
-      : socket(NULL), allowExecution(false), killThread(false), killServer(false), thread(0)
+      : socket(NULL),
+        state(NULL),
+        allowExecution(false),
+        killThread(false),
+        killServer(false),
+        thread(0)
   {
   }
 
   Network::Socket *socket;
+  RemoteServerState *state;
 
   bool allowExecution;
   bool killThread;
@@ -153,113 +167,471 @@ struct ClientThread
   Threading::ThreadHandle thread;
 };
 
-static void InactiveRemoteClientThread(ClientThread *threadData)
+// how often a client waiting for a session is told where it is in the queue. This also keeps the
+// connection alive so the client doesn't time out while waiting.
+static const uint32_t QueuedKeepaliveMS = 1000;
+
+// how long to wait for a session worker process to start listening, before giving up on it
+static const uint32_t WorkerStartTimeoutMS = 30000;
+
+struct RemoteServerState
 {
-  uint32_t ip = threadData->socket->GetRemoteIP();
+  struct Session
+  {
+    bool active = false;
+    uint32_t ip = 0;
+    uint32_t workerPID = 0;
+    uint64_t startTime = 0;
+  };
+
+  Threading::CriticalSection lock;
+
+  uint32_t maxSessions = 1;
+  uint32_t maxQueued = 0;
+  uint32_t sessionMemoryMB = 0;
+  uint16_t workerPortBase = 0;
+
+  uint64_t startTime = 0;
+  uint64_t totalSessions = 0;
+  uint64_t rejectedClients = 0;
+
+  std::vector<Session> sessions;
+  std::vector<ClientThread *> queue;
+
+  // these must be called with the lock held
+  int32_t FindFreeSession() const
+  {
+    for(size_t i = 0; i < sessions.size(); i++)
+      if(!sessions[i].active)
+        return (int32_t)i;
 
+    return -1;
+  }
+
+  void BeginSession(int32_t slot, uint32_t ip)
+  {
+    sessions[slot].active = true;
+    sessions[slot].ip = ip;
+    sessions[slot].workerPID = 0;
+    sessions[slot].startTime = Timing::GetUnixTimestamp();
+    totalSessions++;
+  }
+
+  RemoteServerStats GetStats()
   {
-    uint32_t version = 0;
+    RemoteServerStats ret;
 
+    uint64_t now = Timing::GetUnixTimestamp();
+
+    SCOPED_LOCK(lock);
+
+    ret.maxSessions = maxSessions;
+    ret.maxQueued = maxQueued;
+    ret.queuedClients = (uint32_t)queue.size();
+    ret.totalSessions = totalSessions;
+    ret.rejectedClients = rejectedClients;
+    ret.uptime = now - startTime;
+
+    for(const Session &s : sessions)
     {
-      ReadSerialiser ser(new StreamReader(threadData->socket, Ownership::Nothing), Ownership::Stream);
+      if(!s.active)
+        continue;
 
-      // this thread just handles receiving the handshake and sending a busy signal without blocking
-      // the server thread
-      RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+      RemoteServerSession session;
+      session.client = StringFormat::Fmt("%u.%u.%u.%u", Network::GetIPOctet(s.ip, 0),
+                                         Network::GetIPOctet(s.ip, 1), Network::GetIPOctet(s.ip, 2),
+                                         Network::GetIPOctet(s.ip, 3));
+      session.workerPID = s.workerPID;
+      session.duration = now - s.startTime;
+      ret.sessions.push_back(session);
+    }
 
-      if(ser.IsErrored() || type != eRemoteServer_Handshake)
-      {
-        RDCWARN("Didn't receive proper handshake");
-        SAFE_DELETE(threadData->socket);
-        return;
-      }
+    return ret;
+  }
+};
+
+// reads the first packet on a new connection. This is either a handshake to begin a session, or a
+// request for the server's statistics - both carry the client's protocol version.
+static RemoteServerPacket ReadClientHello(Network::Socket *sock, uint32_t &version)
+{
+  ReadSerialiser ser(new StreamReader(sock, Ownership::Nothing), Ownership::Stream);
 
-      SERIALISE_ELEMENT(version);
+  RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
 
-      ser.EndChunk();
+  if(ser.IsErrored() || (type != eRemoteServer_Handshake && type != eRemoteServer_GetServerStats))
+  {
+    RDCWARN("Didn't receive proper handshake");
+    return eRemoteServer_Noop;
+  }
+
+  SERIALISE_ELEMENT(version);
+
+  ser.EndChunk();
+
+  return type;
+}
+
+// replies to any first packet that doesn't go on to start a session. Returns true if a reply was
+// sent and the connection should be closed.
+static bool ReplyToClientHello(Network::Socket *sock, RemoteServerPacket type, uint32_t version,
+                               RemoteServerState *state)
+{
+  WriteSerialiser ser(new StreamWriter(sock, Ownership::Nothing), Ownership::Stream);
+
+  ser.SetStreamingMode(true);
+
+  if(version != RemoteServerProtocolVersion)
+  {
+    RDCLOG("Connection using protocol %u, but we are running %u", version,
+           RemoteServerProtocolVersion);
+
+    {
+      SCOPED_SERIALISE_CHUNK(eRemoteServer_VersionMismatch);
     }
 
+    return true;
+  }
+
+  if(type == eRemoteServer_GetServerStats)
+  {
+    RemoteServerStats stats;
+    if(state)
+      stats = state->GetStats();
+
     {
-      WriteSerialiser ser(new StreamWriter(threadData->socket, Ownership::Nothing),
-                          Ownership::Stream);
+      SCOPED_SERIALISE_CHUNK(eRemoteServer_GetServerStats);
+      SERIALISE_ELEMENT(stats);
+    }
 
-      ser.SetStreamingMode(true);
+    return true;
+  }
 
-      if(version != RemoteServerProtocolVersion)
-      {
-        RDCLOG("Connection using protocol %u, but we are running %u", version,
-               RemoteServerProtocolVersion);
+  return false;
+}
 
-        {
-          SCOPED_SERIALISE_CHUNK(eRemoteServer_VersionMismatch);
-        }
-      }
-      else
+static void SendSimplePacket(Network::Socket *sock, RemoteServerPacket type)
+{
+  WriteSerialiser ser(new StreamWriter(sock, Ownership::Nothing), Ownership::Stream);
+
+  ser.SetStreamingMode(true);
+
+  SCOPED_SERIALISE_CHUNK(type);
+}
+
+static void SendQueuedPosition(Network::Socket *sock, uint32_t position)
+{
+  WriteSerialiser ser(new StreamWriter(sock, Ownership::Nothing), Ownership::Stream);
+
+  ser.SetStreamingMode(true);
+
+  SCOPED_SERIALISE_CHUNK(eRemoteServer_Queued);
+  SERIALISE_ELEMENT(position);
+}
+
+static void InactiveRemoteClientThread(ClientThread *threadData)
+{
+  uint32_t ip = threadData->socket->GetRemoteIP();
+
+  uint32_t version = 0;
+
+  // this thread just handles receiving the handshake and sending a busy signal without blocking
+  // the server thread
+  RemoteServerPacket type = ReadClientHello(threadData->socket, version);
+
+  if(type == eRemoteServer_Noop)
+  {
+    SAFE_DELETE(threadData->socket);
+    return;
+  }
+
+  if(!ReplyToClientHello(threadData->socket, type, version, threadData->state))
+  {
+    SendSimplePacket(threadData->socket, eRemoteServer_Busy);
+
+    SCOPED_LOCK(threadData->state->lock);
+    threadData->state->rejectedClients++;
+  }
+
+  SAFE_DELETE(threadData->socket);
+
+  RDCLOG("Closed inactive connection from %u.%u.%u.%u.", Network::GetIPOctet(ip, 0),
+         Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
+}
+
+// launches a worker process to replay a session, and connects to it once it's listening.
+static Network::Socket *StartSessionWorker(ClientThread *threadData, int32_t slot)
+{
+  RemoteServerState *state = threadData->state;
+
+  uint16_t port = uint16_t(state->workerPortBase + slot);
+
+  std::string exe;
+  FileIO::GetExecutableFilename(exe);
+
+  std::string args = StringFormat::Fmt("remoteserver --host 127.0.0.1 --remote-session %u", port);
+
+  uint32_t pid = Process::LaunchProcess(exe.c_str(), get_dirname(exe).c_str(), args.c_str(), true);
+
+  if(pid == 0)
+  {
+    RDCERR("Couldn't launch session worker '%s'", exe.c_str());
+    return NULL;
+  }
+
+  {
+    SCOPED_LOCK(state->lock);
+    state->sessions[slot].workerPID = pid;
+  }
+
+  Network::Socket *worker = NULL;
+
+  PerformanceTimer timer, keepalive;
+
+  while(worker == NULL && !threadData->killThread &&
+        timer.GetMilliseconds() < WorkerStartTimeoutMS)
+  {
+    worker = Network::CreateClientSocket("127.0.0.1", port, 250);
+
+    if(worker == NULL)
+    {
+      // keep the client informed while the worker starts up, so it doesn't time out
+      if(keepalive.GetMilliseconds() >= QueuedKeepaliveMS)
       {
-        SCOPED_SERIALISE_CHUNK(eRemoteServer_Busy);
+        SendQueuedPosition(threadData->socket, 0);
+        keepalive.Restart();
       }
+
+      Threading::Sleep(50);
     }
+  }
 
-    SAFE_DELETE(threadData->socket);
+  if(worker == NULL)
+  {
+    RDCERR("Session worker %u never started listening on port %u", pid, port);
+    return NULL;
+  }
 
-    RDCLOG("Closed inactive connection from %u.%u.%u.%u.", Network::GetIPOctet(ip, 0),
-           Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
+  // the client's version has already been checked, so the worker handshake should always succeed
+  uint32_t version = RemoteServerProtocolVersion;
+
+  {
+    WriteSerialiser ser(new StreamWriter(worker, Ownership::Nothing), Ownership::Stream);
+
+    ser.SetStreamingMode(true);
+
+    SCOPED_SERIALISE_CHUNK(eRemoteServer_Handshake);
+    SERIALISE_ELEMENT(version);
   }
+
+  {
+    ReadSerialiser ser(new StreamReader(worker, Ownership::Nothing), Ownership::Stream);
+
+    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+    ser.EndChunk();
+
+    if(ser.IsErrored() || type != eRemoteServer_Handshake)
+    {
+      RDCERR("Didn't get proper handshake from session worker %u", pid);
+      SAFE_DELETE(worker);
+    }
+  }
+
+  return worker;
 }
 
-static void ActiveRemoteClientThread(ClientThread *threadData,
-                                     RENDERDOC_PreviewWindowCallback previewWindow)
+// forwards data in both directions between a client and its session worker, until either side
+// disconnects or the server shuts down.
+static void ProxyRemoteSession(ClientThread *threadData, Network::Socket *worker)
 {
-  Network::Socket *&client = threadData->socket;
+  Network::Socket *client = threadData->socket;
 
-#if ENABLED(RDOC_DEVEL)
-  client->SetTimeout(RemoteServerTimeoutMS);
-#endif
+  Network::Socket *src[2] = {client, worker};
+  Network::Socket *dst[2] = {worker, client};
+
+  std::vector<byte> buf(64 * 1024);
+
+  while(!threadData->killThread && client->Connected() && worker->Connected())
+  {
+    bool idle = true;
+
+    for(int i = 0; i < 2; i++)
+    {
+      if(!src[i]->IsRecvDataWaiting())
+        continue;
+
+      uint32_t length = (uint32_t)buf.size();
+
+      if(!src[i]->RecvDataNonBlocking(buf.data(), length))
+        break;
+
+      if(length > 0 && !dst[i]->SendDataBlocking(buf.data(), length))
+        break;
+
+      idle = false;
+    }
+
+    if(idle)
+      Threading::Sleep(1);
+  }
+}
+
+static void QueuedRemoteClientThread(ClientThread *threadData)
+{
+  Network::Socket *&client = threadData->socket;
+  RemoteServerState *state = threadData->state;
 
   uint32_t ip = client->GetRemoteIP();
 
   uint32_t version = 0;
 
+  RemoteServerPacket type = ReadClientHello(client, version);
+
+  if(type == eRemoteServer_Noop || ReplyToClientHello(client, type, version, state))
   {
-    ReadSerialiser ser(new StreamReader(client, Ownership::Nothing), Ownership::Stream);
+    SAFE_DELETE(client);
+    return;
+  }
 
-    // this thread just handles receiving the handshake and sending a busy signal without blocking
-    // the server thread
-    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+  int32_t slot = -1;
+  bool rejected = false;
 
-    if(ser.IsErrored() || type != eRemoteServer_Handshake)
+  {
+    SCOPED_LOCK(state->lock);
+
+    // only take a session straight away if nobody else is waiting for one
+    if(state->queue.empty())
+      slot = state->FindFreeSession();
+
+    if(slot >= 0)
     {
-      RDCWARN("Didn't receive proper handshake");
-      SAFE_DELETE(client);
-      return;
+      state->BeginSession(slot, ip);
     }
+    else if(state->queue.size() < state->maxQueued)
+    {
+      state->queue.push_back(threadData);
+    }
+    else
+    {
+      state->rejectedClients++;
+      rejected = true;
+    }
+  }
 
-    SERIALISE_ELEMENT(version);
-
-    ser.EndChunk();
+  if(rejected)
+  {
+    RDCLOG("All sessions are in use and the queue is full, refusing connection");
+    SendSimplePacket(client, eRemoteServer_Busy);
+    SAFE_DELETE(client);
+    return;
   }
 
+  PerformanceTimer keepalive;
+  bool sendPosition = true;
+
+  while(slot < 0)
   {
-    WriteSerialiser ser(new StreamWriter(client, Ownership::Nothing), Ownership::Stream);
+    // the client doesn't send anything while queued, this is only to notice if it disconnects
+    client->IsRecvDataWaiting();
 
-    ser.SetStreamingMode(true);
+    bool abandon = threadData->killThread || !client->Connected();
+
+    uint32_t position = 0;
 
-    if(version != RemoteServerProtocolVersion)
     {
-      RDCLOG("Connection using protocol %u, but we are running %u", version,
-             RemoteServerProtocolVersion);
+      SCOPED_LOCK(state->lock);
 
-      {
-        SCOPED_SERIALISE_CHUNK(eRemoteServer_VersionMismatch);
-      }
+      auto it = std::find(state->queue.begin(), state->queue.end(), threadData);
+      position = uint32_t(it - state->queue.begin());
+
+      if(!abandon && position == 0)
+        slot = state->FindFreeSession();
+
+      if(slot >= 0)
+        state->BeginSession(slot, ip);
+
+      if(slot >= 0 || abandon)
+        state->queue.erase(it);
+    }
+
+    if(abandon)
+    {
+      RDCLOG("Queued connection from %u.%u.%u.%u closed while waiting.", Network::GetIPOctet(ip, 0),
+             Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
       SAFE_DELETE(client);
       return;
     }
-    else
+
+    if(slot >= 0)
+      break;
+
+    if(sendPosition || keepalive.GetMilliseconds() >= QueuedKeepaliveMS)
     {
-      // handshake and continue
-      SCOPED_SERIALISE_CHUNK(eRemoteServer_Handshake);
+      SendQueuedPosition(client, position);
+      keepalive.Restart();
+      sendPosition = false;
     }
+
+    Threading::Sleep(10);
+  }
+
+  RDCLOG("Starting session %d for %u.%u.%u.%u.", slot, Network::GetIPOctet(ip, 0),
+         Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
+
+  Network::Socket *worker = StartSessionWorker(threadData, slot);
+
+  if(worker)
+  {
+    SendSimplePacket(client, eRemoteServer_Handshake);
+
+    ProxyRemoteSession(threadData, worker);
+
+    SAFE_DELETE(worker);
+  }
+  else
+  {
+    SendSimplePacket(client, eRemoteServer_Busy);
+  }
+
+  {
+    SCOPED_LOCK(state->lock);
+    state->sessions[slot].active = false;
+  }
+
+  RDCLOG("Closing session %d for %u.%u.%u.%u.", slot, Network::GetIPOctet(ip, 0),
+         Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
+
+  SAFE_DELETE(client);
+}
+
+static void ActiveRemoteClientThread(ClientThread *threadData,
+                                     RENDERDOC_PreviewWindowCallback previewWindow)
+{
+  Network::Socket *&client = threadData->socket;
+
+#if ENABLED(RDOC_DEVEL)
+  client->SetTimeout(RemoteServerTimeoutMS);
+#endif
+
+  uint32_t ip = client->GetRemoteIP();
+
+  uint32_t version = 0;
+
+  RemoteServerPacket type = ReadClientHello(client, version);
+
+  if(type == eRemoteServer_Noop || ReplyToClientHello(client, type, version, threadData->state))
+  {
+    SAFE_DELETE(client);
+    return;
+  }
+
+  // handshake and continue
+  SendSimplePacket(client, eRemoteServer_Handshake);
+
+  if(threadData->state)
+  {
+    SCOPED_LOCK(threadData->state->lock);
+    threadData->state->BeginSession(0, ip);
   }
 
   std::vector<std::string> tempFiles;
@@ -883,6 +1255,12 @@ static void ActiveRemoteClientThread(ClientThread *threadData,
     FileIO::Delete(tempFiles[i].c_str());
   }
 
+  if(threadData->state)
+  {
+    SCOPED_LOCK(threadData->state->lock);
+    threadData->state->sessions[0].active = false;
+  }
+
   RDCLOG("Closing active connection from %u.%u.%u.%u.", Network::GetIPOctet(ip, 0),
          Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
 
@@ -891,18 +1269,71 @@ static void ActiveRemoteClientThread(ClientThread *threadData,
   SAFE_DELETE(client);
 }
 
-void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
-                                   RENDERDOC_KillCallback killReplay,
-                                   RENDERDOC_PreviewWindowCallback previewWindow)
+// serves a single session, in a worker process launched by a multi-session server.
+static void ServeRemoteSession(uint16_t port, uint32_t sessionMemoryMB, bool allowExecution,
+                               RENDERDOC_KillCallback killReplay,
+                               RENDERDOC_PreviewWindowCallback previewWindow)
 {
-  Network::Socket *sock = Network::CreateServerSocket(listenhost, port, 1);
+  if(sessionMemoryMB > 0)
+    Process::LimitMemoryUsage(uint64_t(sessionMemoryMB) * 1024 * 1024);
+
+  Network::Socket *sock = Network::CreateServerSocket("127.0.0.1", port, 1);
 
   if(sock == NULL)
     return;
 
+  Network::Socket *client = NULL;
+
+  PerformanceTimer timer;
+
+  while(client == NULL && !killReplay() && timer.GetMilliseconds() < WorkerStartTimeoutMS)
+  {
+    client = sock->AcceptClient(0);
+
+    if(client == NULL)
+      Threading::Sleep(5);
+  }
+
+  // stop listening immediately, so the port is free for the next worker to serve this slot
+  SAFE_DELETE(sock);
+
+  if(client == NULL)
+  {
+    RDCERR("Session worker on port %u was never connected to", port);
+    return;
+  }
+
+  RDCLOG("Session worker on port %u serving connection", port);
+
+  ClientThread threadData;
+  threadData.socket = client;
+  threadData.allowExecution = allowExecution;
+
+  threadData.thread = Threading::CreateThread([&threadData, previewWindow]() {
+    ActiveRemoteClientThread(&threadData, previewWindow);
+  });
+
+  while(threadData.socket != NULL && !killReplay())
+    Threading::Sleep(5);
+
+  threadData.killThread = true;
+
+  Threading::JoinThread(threadData.thread);
+  Threading::CloseThread(threadData.thread);
+}
+
+void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
+                                   RENDERDOC_KillCallback killReplay,
+                                   RENDERDOC_PreviewWindowCallback previewWindow)
+{
   std::vector<rdcpair<uint32_t, uint32_t> > listenRanges;
   bool allowExecution = true;
 
+  RemoteServerState state;
+  state.workerPortBase = uint16_t(port + 1);
+
+  bool queueConfigured = false;
+
   FILE *f = FileIO::fopen(FileIO::GetAppFolderFilename("remoteserver.conf").c_str(), "r");
 
   while(f && !FileIO::feof(f))
@@ -941,6 +1372,31 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
 
       continue;
     }
+    else if(line.substr(0, sizeof("sessions") - 1) == "sessions")
+    {
+      state.maxSessions = RDCMAX(1, atoi(line.c_str() + sizeof("sessions")));
+
+      continue;
+    }
+    else if(line.substr(0, sizeof("queue") - 1) == "queue")
+    {
+      state.maxQueued = (uint32_t)RDCMAX(0, atoi(line.c_str() + sizeof("queue")));
+      queueConfigured = true;
+
+      continue;
+    }
+    else if(line.substr(0, sizeof("sessionmemory") - 1) == "sessionmemory")
+    {
+      state.sessionMemoryMB = (uint32_t)RDCMAX(0, atoi(line.c_str() + sizeof("sessionmemory")));
+
+      continue;
+    }
+    else if(line.substr(0, sizeof("sessionport") - 1) == "sessionport")
+    {
+      state.workerPortBase = (uint16_t)atoi(line.c_str() + sizeof("sessionport"));
+
+      continue;
+    }
 
     RDCLOG("Malformed line '%s'. See documentation for file format.", line.c_str());
   }
@@ -948,6 +1404,41 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
   if(f)
     FileIO::fclose(f);
 
+  // if we were launched as a session worker, serve only that session and ignore the rest of the
+  // configuration which the server that launched us has already applied.
+  const std::string &sessionPort = GetConfigSetting("remoteSessionPort");
+
+  if(!sessionPort.empty())
+  {
+    ServeRemoteSession((uint16_t)atoi(sessionPort.c_str()), state.sessionMemoryMB, allowExecution,
+                       killReplay, previewWindow);
+    return;
+  }
+
+#if ENABLED(RDOC_ANDROID)
+  if(state.maxSessions > 1 || state.maxQueued > 0)
+  {
+    RDCWARN("Multiple sessions are not supported on Android, serving one session at a time.");
+    state.maxSessions = 1;
+    state.maxQueued = 0;
+  }
+#endif
+
+  if(state.maxSessions > 1 && !queueConfigured)
+    state.maxQueued = 16;
+
+  // with more than one session, or a queue to wait for one, each session runs in its own worker
+  // process. Otherwise sessions are replayed in this process as they always have been.
+  const bool useWorkers = state.maxSessions > 1 || state.maxQueued > 0;
+
+  state.sessions.resize(state.maxSessions);
+  state.startTime = Timing::GetUnixTimestamp();
+
+  Network::Socket *sock = Network::CreateServerSocket(listenhost, port, useWorkers ? 8 : 1);
+
+  if(sock == NULL)
+    return;
+
   if(listenRanges.empty())
   {
     RDCLOG("No whitelist IP ranges configured - using default private IP ranges.");
@@ -978,10 +1469,16 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
   else
     RDCLOG("Blocking execution commands");
 
+  if(useWorkers)
+    RDCLOG("Serving up to %u sessions in worker processes on ports %u-%u, with %u queued",
+           state.maxSessions, state.workerPortBase, state.workerPortBase + state.maxSessions - 1,
+           state.maxQueued);
+
   RDCLOG("Replay host ready for requests...");
 
   ClientThread *activeClientData = NULL;
 
+  // with worker processes, every connection is handled on its own thread in this list
   std::vector<ClientThread *> inactives;
 
   while(!killReplay())
@@ -1055,10 +1552,21 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
       continue;
     }
 
-    if(activeClientData == NULL)
+    if(useWorkers)
+    {
+      ClientThread *session = new ClientThread();
+      session->socket = client;
+      session->state = &state;
+
+      session->thread = Threading::CreateThread([session]() { QueuedRemoteClientThread(session); });
+
+      inactives.push_back(session);
+    }
+    else if(activeClientData == NULL)
     {
       activeClientData = new ClientThread();
       activeClientData->socket = client;
+      activeClientData->state = &state;
       activeClientData->allowExecution = allowExecution;
 
       activeClientData->thread = Threading::CreateThread([activeClientData, previewWindow]() {
@@ -1071,6 +1579,7 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
     {
       ClientThread *inactive = new ClientThread();
       inactive->socket = client;
+      inactive->state = &state;
       inactive->allowExecution = false;
 
       inactive->thread =
@@ -1095,6 +1604,8 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
   // shut down client threads
   for(size_t i = 0; i < inactives.size(); i++)
   {
+    inactives[i]->killThread = true;
+
     Threading::JoinThread(inactives[i]->thread);
     Threading::CloseThread(inactives[i]->thread);
     delete inactives[i];
@@ -1103,19 +1614,16 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
   SAFE_DELETE(sock);
 }
 
-extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
-RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend)
+static Network::Socket *ConnectToRemoteServer(const char *URL, rdcstr &deviceID,
+                                              IDeviceProtocolHandler *&protocol)
 {
-  if(rend == NULL)
-    return ReplayStatus::InternalError;
-
   rdcstr host = "localhost";
   if(URL != NULL && URL[0] != '\0')
     host = URL;
 
-  rdcstr deviceID = host;
+  deviceID = host;
 
-  IDeviceProtocolHandler *protocol = RenderDoc::Inst().GetDeviceProtocol(deviceID);
+  protocol = RenderDoc::Inst().GetDeviceProtocol(deviceID);
 
   uint16_t port = RenderDoc_RemoteServerPort;
 
@@ -1124,7 +1632,7 @@ RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend)
     deviceID = protocol->GetDeviceID(deviceID);
     host = protocol->RemapHostname(deviceID);
     if(host.empty())
-      return ReplayStatus::NetworkIOFailed;
+      return NULL;
 
     port = protocol->RemapPort(deviceID, port);
   }
@@ -1132,14 +1640,31 @@ RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend)
   Network::Socket *sock = Network::CreateClientSocket(host.c_str(), port, 750);
 
   if(sock == NULL)
-    return ReplayStatus::NetworkIOFailed;
-
-  uint32_t version = RemoteServerProtocolVersion;
+    return NULL;
 
 #if ENABLED(RDOC_DEVEL)
   sock->SetTimeout(RemoteServerTimeoutMS);
 #endif
 
+  return sock;
+}
+
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend)
+{
+  if(rend == NULL)
+    return ReplayStatus::InternalError;
+
+  rdcstr deviceID;
+  IDeviceProtocolHandler *protocol = NULL;
+
+  Network::Socket *sock = ConnectToRemoteServer(URL, deviceID, protocol);
+
+  if(sock == NULL)
+    return ReplayStatus::NetworkIOFailed;
+
+  uint32_t version = RemoteServerProtocolVersion;
+
   {
     WriteSerialiser ser(new StreamWriter(sock, Ownership::Nothing), Ownership::Stream);
 
@@ -1157,6 +1682,24 @@ RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend)
 
     RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
 
+    // a multi-session server keeps us updated on our place in the queue until a session is free
+    uint32_t lastPosition = ~0U;
+
+    while(!ser.IsErrored() && type == eRemoteServer_Queued)
+    {
+      uint32_t position = 0;
+      SERIALISE_ELEMENT(position);
+
+      ser.EndChunk();
+
+      if(position != lastPosition)
+        RDCLOG("Waiting for a free session on remote server, %u clients ahead", position);
+
+      lastPosition = position;
+
+      type = ser.ReadChunk<RemoteServerPacket>();
+    }
+
     ser.EndChunk();
 
     if(type == eRemoteServer_Busy)
@@ -1187,6 +1730,57 @@ RENDERDOC_CreateRemoteServerConnection(const char *URL, IRemoteServer **rend)
   return ReplayStatus::Succeeded;
 }
 
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_GetRemoteServerStats(const char *URL, RemoteServerStats *stats)
+{
+  if(stats == NULL)
+    return ReplayStatus::InternalError;
+
+  rdcstr deviceID;
+  IDeviceProtocolHandler *protocol = NULL;
+
+  Network::Socket *sock = ConnectToRemoteServer(URL, deviceID, protocol);
+
+  if(sock == NULL)
+    return ReplayStatus::NetworkIOFailed;
+
+  uint32_t version = RemoteServerProtocolVersion;
+
+  {
+    WriteSerialiser ser(new StreamWriter(sock, Ownership::Nothing), Ownership::Stream);
+
+    ser.SetStreamingMode(true);
+
+    SCOPED_SERIALISE_CHUNK(eRemoteServer_GetServerStats);
+    SERIALISE_ELEMENT(version);
+  }
+
+  ReplayStatus status = ReplayStatus::NetworkIOFailed;
+
+  if(sock->Connected())
+  {
+    ReadSerialiser ser(new StreamReader(sock, Ownership::Nothing), Ownership::Stream);
+
+    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+    if(type == eRemoteServer_GetServerStats)
+    {
+      SERIALISE_ELEMENT(*stats);
+    }
+
+    ser.EndChunk();
+
+    if(type == eRemoteServer_VersionMismatch)
+      status = ReplayStatus::NetworkVersionMismatch;
+    else if(!ser.IsErrored() && type == eRemoteServer_GetServerStats)
+      status = ReplayStatus::Succeeded;
+  }
+
+  SAFE_DELETE(sock);
+
+  return status;
+}
+
 #undef WRITE_DATA_SCOPE
 #undef READ_DATA_SCOPE
 #define WRITE_DATA_SCOPE() WriteSerialiser &ser = *writer;
@@ -0,0 +1,192 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "replay_profiler.h"
+
+ReplayProfiler::ReplayProfiler()
+{
+  m_Origin = Timing::GetTick();
+  m_TickFrequency = Timing::GetTickFrequency();
+}
+
+void ReplayProfiler::RequestProfile()
+{
+  m_ProfileRequested = true;
+
+  m_ReplayPhases.clear();
+  m_ReplayChunks.clear();
+  m_Events.clear();
+}
+
+rdcarray<ReplayPhaseTiming> *ReplayProfiler::CurrentPhases()
+{
+  if(m_Loading)
+    return &m_LoadPhases;
+
+  if(m_ProfileRequested || m_ProfilingFrame)
+    return &m_ReplayPhases;
+
+  return NULL;
+}
+
+void ReplayProfiler::BeginChunk(ReadSerialiser &ser)
+{
+  if(!m_Loading && !m_ProfilingFrame)
+    return;
+
+  ser.SetDeserialiseTiming(true);
+  m_ChunkStart = Timing::GetTick();
+}
+
+void ReplayProfiler::EndChunk(ReadSerialiser &ser, uint32_t chunkID, uint64_t fileOffset)
+{
+  if(!m_Loading && !m_ProfilingFrame)
+    return;
+
+  uint64_t end = Timing::GetTick();
+  uint64_t deserialised = ser.GetDeserialisedTick();
+
+  ser.SetDeserialiseTiming(false);
+
+  if(deserialised < m_ChunkStart || deserialised > end)
+    deserialised = end;
+
+  double deserialiseTime = ToSeconds(deserialised - m_ChunkStart);
+  double executeTime = ToSeconds(end - deserialised);
+
+  ReplayChunkTiming &chunk = m_Loading ? m_LoadChunks[chunkID] : m_ReplayChunks[chunkID];
+  chunk.chunkID = chunkID;
+  chunk.count++;
+  chunk.deserialiseTime += deserialiseTime;
+  chunk.executeTime += executeTime;
+
+  if(m_ProfilingFrame)
+  {
+    ReplayEventTiming ev;
+    ev.chunkID = chunkID;
+    ev.fileOffset = fileOffset;
+    ev.startTime = ToSeconds(m_ChunkStart - m_Origin);
+    ev.deserialiseTime = deserialiseTime;
+    ev.executeTime = executeTime;
+    m_Events.push_back(ev);
+  }
+}
+
+ReplayProfile ReplayProfiler::GetProfile(ChunkLookup lookup) const
+{
+  ReplayProfile ret;
+
+  ret.phases = m_LoadPhases;
+  ret.phases.append(m_ReplayPhases.data(), m_ReplayPhases.size());
+
+  for(auto it = m_LoadChunks.begin(); it != m_LoadChunks.end(); ++it)
+    ret.loadChunks.push_back(it->second);
+  for(auto it = m_ReplayChunks.begin(); it != m_ReplayChunks.end(); ++it)
+    ret.replayChunks.push_back(it->second);
+
+  if(lookup)
+  {
+    for(ReplayChunkTiming &chunk : ret.loadChunks)
+      chunk.name = lookup(chunk.chunkID);
+    for(ReplayChunkTiming &chunk : ret.replayChunks)
+      chunk.name = lookup(chunk.chunkID);
+  }
+
+  ret.events = m_Events;
+
+  return ret;
+}
+
+ReplayProfiler::ScopedPhase::ScopedPhase(ReplayProfiler &profiler, const char *name)
+    : m_Profiler(profiler)
+{
+  if(name == NULL)
+    return;
+
+  m_Phases = m_Profiler.CurrentPhases();
+
+  if(m_Phases)
+  {
+    ReplayPhaseTiming phase;
+    phase.name = name;
+    phase.startTime = m_Profiler.ToSeconds(Timing::GetTick() - m_Profiler.m_Origin);
+
+    m_Index = m_Phases->size();
+    m_Phases->push_back(phase);
+  }
+}
+
+ReplayProfiler::ScopedPhase::~ScopedPhase()
+{
+  if(m_Phases)
+  {
+    ReplayPhaseTiming &phase = (*m_Phases)[m_Index];
+    phase.duration =
+        m_Profiler.ToSeconds(Timing::GetTick() - m_Profiler.m_Origin) - phase.startTime;
+  }
+}
+
+ReplayProfiler::ScopedLoad::ScopedLoad(ReplayProfiler &profiler) : m_Profiler(profiler)
+{
+  m_Profiler.m_Loading = true;
+
+  ReplayPhaseTiming phase;
+  phase.name = "ReadLogInitialisation";
+  phase.startTime = m_Profiler.ToSeconds(Timing::GetTick() - m_Profiler.m_Origin);
+
+  m_Index = m_Profiler.m_LoadPhases.size();
+  m_Profiler.m_LoadPhases.push_back(phase);
+}
+
+ReplayProfiler::ScopedLoad::~ScopedLoad()
+{
+  ReplayPhaseTiming &phase = m_Profiler.m_LoadPhases[m_Index];
+  phase.duration = m_Profiler.ToSeconds(Timing::GetTick() - m_Profiler.m_Origin) - phase.startTime;
+
+  m_Profiler.m_Loading = false;
+}
+
+ReplayProfiler::ScopedFrame::ScopedFrame(ReplayProfiler &profiler, bool fullReplay)
+    : m_Profiler(profiler),
+      m_PrevLoading(profiler.m_Loading),
+      m_Phase(profiler, profiler.m_Loading
+                            ? "Frame load"
+                            : (fullReplay && profiler.m_ProfileRequested ? "Frame replay" : NULL))
+{
+  // chunks in the frame are never counted as load chunks, even in the pass that loads the frame.
+  if(fullReplay && m_Profiler.m_ProfileRequested && !m_Profiler.m_Loading)
+  {
+    m_Profiler.m_ProfilingFrame = true;
+    m_Profiler.m_ProfileRequested = false;
+  }
+
+  m_Profiler.m_Loading = false;
+}
+
+ReplayProfiler::ScopedFrame::~ScopedFrame()
+{
+  m_Profiler.m_Loading = m_PrevLoading;
+  m_Profiler.m_ProfilingFrame = false;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <map>
+#include "api/replay/renderdoc_replay.h"
+#include "serialise/serialiser.h"
+
+// Records where time goes while a driver loads and replays a capture. Load phases and the chunks
+// before the frame are always timed since that only happens once. Frame replays are only timed
+// when a profile has been requested, and then only the next full (non-partial) replay is recorded.
+class ReplayProfiler
+{
+public:
+  ReplayProfiler();
+
+  // starts recording the next full frame replay, discarding any previous replay timings
+  void RequestProfile();
+
+  // marks the start and end of a chunk, around reading and processing it. Any chunk that doesn't
+  // mark when it finished deserialising is counted entirely as deserialise time.
+  void BeginChunk(ReadSerialiser &ser);
+  void EndChunk(ReadSerialiser &ser, uint32_t chunkID, uint64_t fileOffset);
+
+  ReplayProfile GetProfile(ChunkLookup lookup) const;
+
+  // times a named phase, if we're loading or about to profile a frame replay.
+  class ScopedPhase
+  {
+  public:
+    ScopedPhase(ReplayProfiler &profiler, const char *name);
+    ~ScopedPhase();
+
+  private:
+    ReplayProfiler &m_Profiler;
+    rdcarray<ReplayPhaseTiming> *m_Phases = NULL;
+    size_t m_Index = 0;
+  };
+
+  // covers the whole of ReadLogInitialisation, so that the chunks before the frame are timed.
+  class ScopedLoad
+  {
+  public:
+    ScopedLoad(ReplayProfiler &profiler);
+    ~ScopedLoad();
+
+  private:
+    ReplayProfiler &m_Profiler;
+    size_t m_Index;
+  };
+
+  // covers one pass over the frame's chunks. The frame is timed if it's the pass that loads the
+  // capture, or if it's a full replay and a profile was requested.
+  class ScopedFrame
+  {
+  public:
+    ScopedFrame(ReplayProfiler &profiler, bool fullReplay);
+    ~ScopedFrame();
+
+  private:
+    ReplayProfiler &m_Profiler;
+    bool m_PrevLoading;
+    ScopedPhase m_Phase;
+  };
+
+private:
+  double ToSeconds(uint64_t ticks) const { return double(ticks) / (m_TickFrequency * 1000.0); }
+  rdcarray<ReplayPhaseTiming> *CurrentPhases();
+
+  uint64_t m_Origin;
+  double m_TickFrequency;
+
+  bool m_Loading = false;
+  bool m_ProfileRequested = false;
+  bool m_ProfilingFrame = false;
+
+  uint64_t m_ChunkStart = 0;
+
+  rdcarray<ReplayPhaseTiming> m_LoadPhases, m_ReplayPhases;
+  std::map<uint32_t, ReplayChunkTiming> m_LoadChunks, m_ReplayChunks;
+  rdcarray<ReplayEventTiming> m_Events;
+};
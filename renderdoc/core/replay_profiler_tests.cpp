@@ -0,0 +1,211 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "replay_profiler.h"
+#include "common/globalconfig.h"
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+// writes chunks 5, 6 and 5 again, each with a single value
+static StreamWriter *WriteTestChunks()
+{
+  StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+  WriteSerialiser ser(buf, Ownership::Nothing);
+
+  for(uint32_t chunkID : {5U, 6U, 5U})
+  {
+    ser.WriteChunk(chunkID);
+    uint32_t value = chunkID * 10;
+    ser.Serialise("value"_lit, value);
+    ser.EndChunk();
+  }
+
+  return buf;
+}
+
+static void ProcessTestChunks(ReplayProfiler &profiler, StreamWriter *buf)
+{
+  ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+
+  for(int i = 0; i < 3; i++)
+  {
+    uint64_t offset = ser.GetReader()->GetOffset();
+
+    profiler.BeginChunk(ser);
+
+    uint32_t chunkID = ser.ReadChunk<uint32_t>();
+
+    uint32_t value = 0;
+    ser.Serialise("value"_lit, value);
+
+    ser.MarkDeserialised();
+
+    CHECK(value == chunkID * 10);
+
+    ser.EndChunk();
+
+    profiler.EndChunk(ser, chunkID, offset);
+  }
+}
+
+TEST_CASE("Test replay profiler", "[replayprofiler]")
+{
+  StreamWriter *buf = WriteTestChunks();
+
+  ReplayProfiler profiler;
+
+  {
+    ReplayProfiler::ScopedLoad load(profiler);
+
+    ProcessTestChunks(profiler, buf);
+
+    // the pass over the frame while loading only counts as a phase, not as load chunks
+    ReplayProfiler::ScopedFrame frame(profiler, true);
+
+    ProcessTestChunks(profiler, buf);
+  }
+
+  ChunkLookup lookup = [](uint32_t chunkID) -> std::string {
+    return chunkID == 5 ? "Five" : "Six";
+  };
+
+  SECTION("Load timings")
+  {
+    ReplayProfile profile = profiler.GetProfile(lookup);
+
+    REQUIRE(profile.phases.size() == 2);
+    CHECK(profile.phases[0].name == "ReadLogInitialisation");
+    CHECK(profile.phases[1].name == "Frame load");
+    CHECK(profile.phases[1].startTime >= profile.phases[0].startTime);
+    CHECK(profile.phases[0].duration >= profile.phases[1].duration);
+
+    REQUIRE(profile.loadChunks.size() == 2);
+    CHECK(profile.loadChunks[0].chunkID == 5);
+    CHECK(profile.loadChunks[0].name == "Five");
+    CHECK(profile.loadChunks[0].count == 2);
+    CHECK(profile.loadChunks[0].deserialiseTime >= 0.0);
+    CHECK(profile.loadChunks[0].executeTime >= 0.0);
+    CHECK(profile.loadChunks[1].chunkID == 6);
+    CHECK(profile.loadChunks[1].name == "Six");
+    CHECK(profile.loadChunks[1].count == 1);
+
+    CHECK(profile.replayChunks.empty());
+    CHECK(profile.events.empty());
+  }
+
+  SECTION("Replays are only timed when requested")
+  {
+    {
+      ReplayProfiler::ScopedPhase phase(profiler, "ApplyInitialContents");
+      ReplayProfiler::ScopedFrame frame(profiler, true);
+
+      ProcessTestChunks(profiler, buf);
+    }
+
+    ReplayProfile profile = profiler.GetProfile(lookup);
+
+    CHECK(profile.phases.size() == 2);
+    CHECK(profile.replayChunks.empty());
+    CHECK(profile.events.empty());
+  }
+
+  SECTION("Requested full replay")
+  {
+    profiler.RequestProfile();
+
+    // partial replays are not recorded, and don't use up the request
+    {
+      ReplayProfiler::ScopedFrame frame(profiler, false);
+
+      ProcessTestChunks(profiler, buf);
+    }
+
+    {
+      ReplayProfiler::ScopedPhase phase(profiler, "ApplyInitialContents");
+    }
+
+    {
+      ReplayProfiler::ScopedFrame frame(profiler, true);
+
+      ProcessTestChunks(profiler, buf);
+    }
+
+    // only the first full replay after a request is recorded
+    {
+      ReplayProfiler::ScopedFrame frame(profiler, true);
+
+      ProcessTestChunks(profiler, buf);
+    }
+
+    ReplayProfile profile = profiler.GetProfile(lookup);
+
+    REQUIRE(profile.phases.size() == 4);
+    CHECK(profile.phases[2].name == "ApplyInitialContents");
+    CHECK(profile.phases[3].name == "Frame replay");
+
+    REQUIRE(profile.loadChunks.size() == 2);
+    CHECK(profile.loadChunks[0].count == 2);
+
+    REQUIRE(profile.replayChunks.size() == 2);
+    CHECK(profile.replayChunks[0].name == "Five");
+    CHECK(profile.replayChunks[0].count == 2);
+    CHECK(profile.replayChunks[1].name == "Six");
+    CHECK(profile.replayChunks[1].count == 1);
+
+    REQUIRE(profile.events.size() == 3);
+    CHECK(profile.events[0].chunkID == 5);
+    CHECK(profile.events[1].chunkID == 6);
+    CHECK(profile.events[2].chunkID == 5);
+    CHECK(profile.events[0].fileOffset == 0);
+    CHECK(profile.events[1].fileOffset > profile.events[0].fileOffset);
+    CHECK(profile.events[2].fileOffset > profile.events[1].fileOffset);
+
+    for(const ReplayEventTiming &ev : profile.events)
+    {
+      CHECK(ev.eventId == 0);
+      CHECK(ev.startTime >= profile.phases[3].startTime);
+      CHECK(ev.deserialiseTime >= 0.0);
+      CHECK(ev.executeTime >= 0.0);
+      CHECK(ev.gpuTime < 0.0);
+    }
+
+    // a new request discards the previous replay timings but keeps the load timings
+    profiler.RequestProfile();
+
+    profile = profiler.GetProfile(lookup);
+
+    CHECK(profile.phases.size() == 2);
+    CHECK(profile.loadChunks.size() == 2);
+    CHECK(profile.replayChunks.empty());
+    CHECK(profile.events.empty());
+  }
+
+  delete buf;
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
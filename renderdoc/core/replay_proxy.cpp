@@ -92,6 +92,9 @@ rdcstr DoStringise(const ReplayProxyPacket &el)
     STRINGISE_ENUM_NAMED(eReplayProxy_GetTargetShaderEncodings, "GetTargetShaderEncodings");
 
     STRINGISE_ENUM_NAMED(eReplayProxy_GetDriverInfo, "GetDriverInfo");
+
+    STRINGISE_ENUM_NAMED(eReplayProxy_ProfileReplay, "ProfileReplay");
+    STRINGISE_ENUM_NAMED(eReplayProxy_PixelHistoryRegion, "PixelHistoryRegion");
   }
   END_ENUM_STRINGISE();
 }
@@ -108,19 +111,29 @@ rdcstr DoStringise(const ReplayProxyPacket &el)
 // begins the set of parameters. Note that we only begin a chunk when writing (sending a request to
 // the remote server), since on reading the chunk has already been begun to read the type to
 // dispatch to the correct function.
-#define BEGIN_PARAMS()             \
-  ParamSerialiser &ser = paramser; \
-  if(ser.IsWriting())              \
+// When receiving the reply to a pipelined request the parameters were already sent, so they are
+// serialised to a discarding writer instead.
+#define BEGIN_PARAMS()                               \
+  ParamSerialiser &ser = ParamsSerialiser(paramser); \
+  if(ser.IsWriting())                                \
     ser.BeginChunk(packet, 0);
 
-// end the set of parameters, and that chunk.
-#define END_PARAMS()                                \
-  {                                                 \
-    GET_SERIALISER.Serialise("packet"_lit, packet); \
-    ser.EndChunk();                                 \
-    CheckError(packet, expectedPacket);             \
+// end the set of parameters, and that chunk. The request's tag is sent along with the parameters so
+// the remote server can echo it back once the request has executed.
+#define END_PARAMS()                                   \
+  {                                                    \
+    GET_SERIALISER.Serialise("tag"_lit, m_RequestTag); \
+    GET_SERIALISER.Serialise("packet"_lit, packet);    \
+    ser.EndChunk();                                    \
+    CheckError(packet, expectedPacket);                \
   }
 
+// when a pipelined request is only being sent, return before the reply. It's read separately later
+// by calling the function again, with the parameters going to a discarding writer.
+#define RETURN_IF_ONLY_SENDING(...)       \
+  if(m_RequestPhase == ProxyRequest_Send) \
+    return __VA_ARGS__;
+
 // begin serialising a return value. We begin a chunk here in either the writing or reading case
 // since this chunk is used purely to send/receive the return value and is fully handled within the
 // function.
@@ -177,16 +190,20 @@ struct RemoteExecution
 #endif
 
 // dispatches to the right implementation of the Proxied_ function, depending on whether we're on
-// the remote server or not.
+// the remote server, or not. On the host any outstanding pipelined requests are completed first
+// so that replies are read in the order the requests were sent.
 #define PROXY_FUNCTION(name, ...)                                     \
   PROXY_DEBUG("Proxying out %s", #name);                              \
   if(m_RemoteServer)                                                  \
     return CONCAT(Proxied_, name)(m_Reader, m_Writer, ##__VA_ARGS__); \
-  else                                                                \
-    return CONCAT(Proxied_, name)(m_Writer, m_Reader, ##__VA_ARGS__);
+  CompletePendingRequests();                                          \
+  return CONCAT(Proxied_, name)(m_Writer, m_Reader, ##__VA_ARGS__);
 
 ReplayProxy::~ReplayProxy()
 {
+  if(!m_RemoteServer)
+    CompletePendingRequests();
+
   ShutdownRemoteExecutionThread();
 
   ShutdownPreviewWindow();
@@ -282,7 +299,7 @@ APIProperties ReplayProxy::Proxied_GetAPIProperties(ParamSerialiser &paramser,
 
   SERIALISE_RETURN(ret);
 
-  if(!m_RemoteServer)
+  if(m_Proxy)
     ret.localRenderer = m_Proxy->GetAPIProperties().localRenderer;
 
   m_APIProps = ret;
@@ -403,6 +420,15 @@ std::vector<ResourceId> ReplayProxy::Proxied_GetTextures(ParamSerialiser &params
 
   SERIALISE_RETURN(ret);
 
+  // the descriptions are almost always fetched one by one straight after, so request them all now
+  // to avoid a round trip each.
+  if(retser.IsReading())
+  {
+    m_PrefetchedTextures.clear();
+    for(ResourceId id : ret)
+      m_PrefetchedTextures[id] = GetTextureAsync(id);
+  }
+
   return ret;
 }
 
@@ -431,6 +457,8 @@ TextureDescription ReplayProxy::Proxied_GetTexture(ParamSerialiser &paramser,
       ret = m_Remote->GetTexture(id);
   }
 
+  RETURN_IF_ONLY_SENDING(ret);
+
   SERIALISE_RETURN(ret);
 
   if(retser.IsReading())
@@ -441,6 +469,14 @@ TextureDescription ReplayProxy::Proxied_GetTexture(ParamSerialiser &paramser,
 
 TextureDescription ReplayProxy::GetTexture(ResourceId id)
 {
+  auto it = m_PrefetchedTextures.find(id);
+  if(it != m_PrefetchedTextures.end())
+  {
+    TextureDescription ret = it->second.Get();
+    m_PrefetchedTextures.erase(it);
+    return ret;
+  }
+
   PROXY_FUNCTION(GetTexture, id);
 }
 
@@ -465,6 +501,15 @@ std::vector<ResourceId> ReplayProxy::Proxied_GetBuffers(ParamSerialiser &paramse
 
   SERIALISE_RETURN(ret);
 
+  // the descriptions are almost always fetched one by one straight after, so request them all now
+  // to avoid a round trip each.
+  if(retser.IsReading())
+  {
+    m_PrefetchedBuffers.clear();
+    for(ResourceId id : ret)
+      m_PrefetchedBuffers[id] = GetBufferAsync(id);
+  }
+
   return ret;
 }
 
@@ -521,6 +566,8 @@ BufferDescription ReplayProxy::Proxied_GetBuffer(ParamSerialiser &paramser,
       ret = m_Remote->GetBuffer(id);
   }
 
+  RETURN_IF_ONLY_SENDING(ret);
+
   SERIALISE_RETURN(ret);
 
   return ret;
@@ -528,6 +575,14 @@ BufferDescription ReplayProxy::Proxied_GetBuffer(ParamSerialiser &paramser,
 
 BufferDescription ReplayProxy::GetBuffer(ResourceId id)
 {
+  auto it = m_PrefetchedBuffers.find(id);
+  if(it != m_PrefetchedBuffers.end())
+  {
+    BufferDescription ret = it->second.Get();
+    m_PrefetchedBuffers.erase(it);
+    return ret;
+  }
+
   PROXY_FUNCTION(GetBuffer, id);
 }
 
@@ -581,6 +636,8 @@ std::vector<EventUsage> ReplayProxy::Proxied_GetUsage(ParamSerialiser &paramser,
       ret = m_Remote->GetUsage(id);
   }
 
+  RETURN_IF_ONLY_SENDING(ret);
+
   SERIALISE_RETURN(ret);
 
   return ret;
@@ -818,6 +875,8 @@ void ReplayProxy::Proxied_GetBufferData(ParamSerialiser &paramser, ReturnSeriali
       m_Remote->GetBufferData(buff, offset, len, retData);
   }
 
+  RETURN_IF_ONLY_SENDING();
+
   // over-estimate of total uncompressed data written. Since the decompression chain needs to know
   // the exact uncompressed size, we over-estimate (to allow for length/padding/etc) and then pad
   // to this amount.
@@ -897,6 +956,8 @@ void ReplayProxy::Proxied_GetTextureData(ParamSerialiser &paramser, ReturnSerial
       m_Remote->GetTextureData(tex, arrayIdx, mip, params, data);
   }
 
+  RETURN_IF_ONLY_SENDING();
+
   // over-estimate of total uncompressed data written. Since the decompression chain needs to know
   // the exact uncompressed size, we over-estimate (to allow for length/padding/etc) and then pad
   // to this amount.
@@ -1450,6 +1511,53 @@ std::vector<PixelModification> ReplayProxy::PixelHistory(std::vector<EventUsage>
   PROXY_FUNCTION(PixelHistory, events, target, x, y, slice, mip, sampleIdx, typeHint);
 }
 
+template <typename ParamSerialiser, typename ReturnSerialiser>
+PixelRegionHistory ReplayProxy::Proxied_PixelHistoryRegion(
+    ParamSerialiser &paramser, ReturnSerialiser &retser, std::vector<EventUsage> events,
+    ResourceId target, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t slice,
+    uint32_t mip, uint32_t sampleIdx, CompType typeHint)
+{
+  const ReplayProxyPacket expectedPacket = eReplayProxy_PixelHistoryRegion;
+  ReplayProxyPacket packet = eReplayProxy_PixelHistoryRegion;
+  PixelRegionHistory ret;
+
+  {
+    BEGIN_PARAMS();
+    SERIALISE_ELEMENT(events);
+    SERIALISE_ELEMENT(target);
+    SERIALISE_ELEMENT(x);
+    SERIALISE_ELEMENT(y);
+    SERIALISE_ELEMENT(width);
+    SERIALISE_ELEMENT(height);
+    SERIALISE_ELEMENT(slice);
+    SERIALISE_ELEMENT(mip);
+    SERIALISE_ELEMENT(sampleIdx);
+    SERIALISE_ELEMENT(typeHint);
+    END_PARAMS();
+  }
+
+  {
+    REMOTE_EXECUTION();
+    if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
+      ret = m_Remote->PixelHistoryRegion(events, target, x, y, width, height, slice, mip,
+                                         sampleIdx, typeHint);
+  }
+
+  SERIALISE_RETURN(ret);
+
+  return ret;
+}
+
+PixelRegionHistory ReplayProxy::PixelHistoryRegion(std::vector<EventUsage> events,
+                                                   ResourceId target, uint32_t x, uint32_t y,
+                                                   uint32_t width, uint32_t height, uint32_t slice,
+                                                   uint32_t mip, uint32_t sampleIdx,
+                                                   CompType typeHint)
+{
+  PROXY_FUNCTION(PixelHistoryRegion, events, target, x, y, width, height, slice, mip, sampleIdx,
+                 typeHint);
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 ShaderDebugTrace ReplayProxy::Proxied_DebugVertex(ParamSerialiser &paramser,
                                                   ReturnSerialiser &retser, uint32_t eventId,
@@ -1729,6 +1837,42 @@ void ReplayProxy::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
   PROXY_FUNCTION(ReplayLog, endEventID, replayType);
 }
 
+template <typename ParamSerialiser, typename ReturnSerialiser>
+ReplayProfile ReplayProxy::Proxied_ProfileReplay(ParamSerialiser &paramser,
+                                                 ReturnSerialiser &retser)
+{
+  const ReplayProxyPacket expectedPacket = eReplayProxy_ProfileReplay;
+  ReplayProxyPacket packet = eReplayProxy_ProfileReplay;
+  ReplayProfile ret;
+
+  {
+    BEGIN_PARAMS();
+    END_PARAMS();
+  }
+
+  {
+    REMOTE_EXECUTION();
+    if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
+      ret = m_Remote->ProfileReplay();
+  }
+
+  // profiling replays the whole frame, so anything cached is now stale
+  if(retser.IsReading())
+  {
+    m_TextureProxyCache.clear();
+    m_BufferProxyCache.clear();
+  }
+
+  SERIALISE_RETURN(ret);
+
+  return ret;
+}
+
+ReplayProfile ReplayProxy::ProfileReplay()
+{
+  PROXY_FUNCTION(ProfileReplay);
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 void ReplayProxy::Proxied_FetchStructuredFile(ParamSerialiser &paramser, ReturnSerialiser &retser)
 {
@@ -2132,6 +2276,112 @@ void ReplayProxy::CacheTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t m
 
 #pragma endregion Proxied Functions
 
+#pragma region Pipelined Requests
+
+WriteSerialiser &ReplayProxy::ParamsSerialiser(WriteSerialiser &ser)
+{
+  // the parameters were sent already, throw them away
+  if(m_RequestPhase == ProxyRequest_Receive)
+  {
+    m_DiscardWriter.GetWriter()->Rewind();
+    return m_DiscardWriter;
+  }
+
+  m_RequestTag = ++m_SentTag;
+  return ser;
+}
+
+template <typename T, typename RequestFunc>
+ReplayProxyFuture<T> ReplayProxy::PipelineRequest(RequestFunc request)
+{
+  std::shared_ptr<T> result = std::make_shared<T>();
+
+  // nothing to pipeline on the remote server, just execute the request
+  if(m_RemoteServer)
+  {
+    request(*result);
+    return ReplayProxyFuture<T>(NULL, 0, result);
+  }
+
+  if(m_PendingRequests.size() >= MaxPendingRequests)
+    CompleteRequest(m_PendingRequests.front().tag);
+
+  // don't send anything until we need to wait for a reply, so that requests are batched together
+  m_Writer.GetWriter()->DeferFlush(true);
+
+  m_RequestPhase = ProxyRequest_Send;
+  request(*result);
+  m_RequestPhase = ProxyRequest_Full;
+
+  PendingRequest pending;
+  pending.tag = m_RequestTag;
+  pending.receive = [request, result]() { request(*result); };
+  m_PendingRequests.push_back(pending);
+
+  return ReplayProxyFuture<T>(this, pending.tag, result);
+}
+
+void ReplayProxy::CompleteRequest(uint32_t tag)
+{
+  // tags are compared with wrapping, pending requests are always a small window of tags
+  while(!m_PendingRequests.empty() && int32_t(m_PendingRequests.front().tag - tag) <= 0)
+  {
+    m_Writer.GetWriter()->DeferFlush(false);
+
+    PendingRequest pending = m_PendingRequests.front();
+    m_PendingRequests.pop_front();
+
+    m_RequestPhase = ProxyRequest_Receive;
+    m_RequestTag = pending.tag;
+    pending.receive();
+    m_RequestPhase = ProxyRequest_Full;
+  }
+}
+
+void ReplayProxy::CompletePendingRequests()
+{
+  if(!m_PendingRequests.empty())
+    CompleteRequest(m_PendingRequests.back().tag);
+}
+
+ReplayProxyFuture<TextureDescription> ReplayProxy::GetTextureAsync(ResourceId id)
+{
+  return PipelineRequest<TextureDescription>(
+      [this, id](TextureDescription &ret) { ret = Proxied_GetTexture(m_Writer, m_Reader, id); });
+}
+
+ReplayProxyFuture<BufferDescription> ReplayProxy::GetBufferAsync(ResourceId id)
+{
+  return PipelineRequest<BufferDescription>(
+      [this, id](BufferDescription &ret) { ret = Proxied_GetBuffer(m_Writer, m_Reader, id); });
+}
+
+ReplayProxyFuture<std::vector<EventUsage>> ReplayProxy::GetUsageAsync(ResourceId id)
+{
+  return PipelineRequest<std::vector<EventUsage>>([this, id](std::vector<EventUsage> &ret) {
+    ret = Proxied_GetUsage(m_Writer, m_Reader, id);
+  });
+}
+
+ReplayProxyFuture<bytebuf> ReplayProxy::GetBufferDataAsync(ResourceId buff, uint64_t offset,
+                                                           uint64_t len)
+{
+  return PipelineRequest<bytebuf>([this, buff, offset, len](bytebuf &ret) {
+    Proxied_GetBufferData(m_Writer, m_Reader, buff, offset, len, ret);
+  });
+}
+
+ReplayProxyFuture<bytebuf> ReplayProxy::GetTextureDataAsync(ResourceId tex, uint32_t arrayIdx,
+                                                            uint32_t mip,
+                                                            const GetTextureDataParams &params)
+{
+  return PipelineRequest<bytebuf>([this, tex, arrayIdx, mip, params](bytebuf &ret) {
+    Proxied_GetTextureData(m_Writer, m_Reader, tex, arrayIdx, mip, params, ret);
+  });
+}
+
+#pragma endregion Pipelined Requests
+
 // If a remap is required, modify the params that are used when getting the proxy texture data
 // for replay on the current driver.
 void ReplayProxy::RemapProxyTextureIfNeeded(TextureDescription &tex, GetTextureDataParams &params)
@@ -2489,15 +2739,23 @@ void ReplayProxy::EndRemoteExecution()
                             RemoteExecution_Inactive) == RemoteExecution_ThreadIdle)
       Threading::Sleep(0);
 
-    // send the finished packet
+    // send the finished packet, identifying which request finished
     m_Writer.BeginChunk(eReplayProxy_RemoteExecutionFinished, 0);
+    m_Writer.Serialise("tag"_lit, m_RequestTag);
     m_Writer.EndChunk();
   }
   else
   {
+    // if we're only sending a pipelined request, nothing will be read until later
+    if(m_RequestPhase == ProxyRequest_Send)
+      return;
+
     while(!m_Writer.IsErrored() && !m_Reader.IsErrored() && !m_IsErrored)
     {
       ReplayProxyPacket packet = m_Reader.ReadChunk<ReplayProxyPacket>();
+      uint32_t tag = 0;
+      if(packet == eReplayProxy_RemoteExecutionFinished)
+        m_Reader.Serialise("tag"_lit, tag);
       m_Reader.EndChunk();
 
       if(packet == eReplayProxy_RemoteExecutionKeepAlive)
@@ -2512,6 +2770,13 @@ void ReplayProxy::EndRemoteExecution()
         return;
       }
 
+      if(tag != m_RequestTag)
+      {
+        RDCERR("Expected reply to request %u, received reply to %u", m_RequestTag, tag);
+        m_IsErrored = true;
+        return;
+      }
+
       break;
     }
 
@@ -2697,6 +2962,11 @@ bool ReplayProxy::Tick(int type)
     case eReplayProxy_GetTargetShaderEncodings: GetTargetShaderEncodings(); break;
     case eReplayProxy_GetDriverInfo: GetDriverInfo(); break;
     case eReplayProxy_GetAvailableGPUs: GetAvailableGPUs(); break;
+    case eReplayProxy_ProfileReplay: ProfileReplay(); break;
+    case eReplayProxy_PixelHistoryRegion:
+      PixelHistoryRegion(std::vector<EventUsage>(), ResourceId(), 0, 0, 0, 0, 0, 0, 0,
+                         CompType::Typeless);
+      break;
     default: RDCERR("Unexpected command %u", type); return false;
   }
 
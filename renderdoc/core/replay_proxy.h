@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
+#include <memory>
 #include "os/os_specific.h"
 #include "replay/replay_driver.h"
 #include "serialise/serialiser.h"
@@ -100,6 +103,9 @@ enum ReplayProxyPacket
 
   eReplayProxy_GetDriverInfo,
   eReplayProxy_GetAvailableGPUs,
+
+  eReplayProxy_ProfileReplay,
+  eReplayProxy_PixelHistoryRegion,
 };
 
 DECLARE_REFLECTION_ENUM(ReplayProxyPacket);
@@ -110,6 +116,30 @@ DECLARE_REFLECTION_ENUM(ReplayProxyPacket);
   rettype CONCAT(Proxied_, name)(ParamSerialiser & paramser, ReturnSerialiser & retser, \
                                  ##__VA_ARGS__);
 
+class ReplayProxy;
+
+// the result of a pipelined request to the remote server. The request has already been sent, and
+// Get() reads the reply (and the replies to any earlier requests) if it hasn't been read already.
+// Futures must not be resolved after the proxy that created them has been shut down.
+template <typename T>
+class ReplayProxyFuture
+{
+public:
+  ReplayProxyFuture() : m_Proxy(NULL), m_Tag(0) {}
+  ReplayProxyFuture(ReplayProxy *proxy, uint32_t tag, std::shared_ptr<T> result)
+      : m_Proxy(proxy), m_Tag(tag), m_Result(result)
+  {
+  }
+
+  bool IsValid() const { return m_Result != NULL; }
+  const T &Get();
+
+private:
+  ReplayProxy *m_Proxy;
+  uint32_t m_Tag;
+  std::shared_ptr<T> m_Result;
+};
+
 // This class implements IReplayDriver. On the local machine where the UI is, this can then act like
 // a full local replay by farming out over the network to a remote replay where necessary to
 // implement some functions, and using a local proxy where necessary.
@@ -161,6 +191,22 @@ public:
   void EndRemoteExecution();
   void RemoteExecutionThreadEntry();
 
+  // pipelined versions of some proxied functions, only valid on the host side. The request is sent
+  // straight away, batched together with any other outstanding requests, and the reply is only
+  // read when the future is resolved. This lets independent requests share a single round trip.
+  // Any synchronous proxied call first completes all outstanding requests in order.
+  ReplayProxyFuture<TextureDescription> GetTextureAsync(ResourceId id);
+  ReplayProxyFuture<BufferDescription> GetBufferAsync(ResourceId id);
+  ReplayProxyFuture<std::vector<EventUsage>> GetUsageAsync(ResourceId id);
+  ReplayProxyFuture<bytebuf> GetBufferDataAsync(ResourceId buff, uint64_t offset, uint64_t len);
+  ReplayProxyFuture<bytebuf> GetTextureDataAsync(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                                                 const GetTextureDataParams &params);
+
+  // read replies for all outstanding requests up to and including the given one.
+  void CompleteRequest(uint32_t tag);
+  void CompletePendingRequests();
+  size_t GetPendingRequestCount() { return m_PendingRequests.size(); }
+
   bool IsRemoteProxy() { return !m_RemoteServer; }
   void Shutdown() { delete this; }
   ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
@@ -477,6 +523,7 @@ public:
 
   IMPLEMENT_FUNCTION_PROXIED(void, SavePipelineState, uint32_t eventId);
   IMPLEMENT_FUNCTION_PROXIED(void, ReplayLog, uint32_t endEventID, ReplayLogType replayType);
+  IMPLEMENT_FUNCTION_PROXIED(ReplayProfile, ProfileReplay);
 
   IMPLEMENT_FUNCTION_PROXIED(std::vector<uint32_t>, GetPassEvents, uint32_t eventId);
 
@@ -524,6 +571,10 @@ public:
                              std::vector<EventUsage> events, ResourceId target, uint32_t x,
                              uint32_t y, uint32_t slice, uint32_t mip, uint32_t sampleIdx,
                              CompType typeHint);
+  IMPLEMENT_FUNCTION_PROXIED(PixelRegionHistory, PixelHistoryRegion, std::vector<EventUsage> events,
+                             ResourceId target, uint32_t x, uint32_t y, uint32_t width,
+                             uint32_t height, uint32_t slice, uint32_t mip, uint32_t sampleIdx,
+                             CompType typeHint);
   IMPLEMENT_FUNCTION_PROXIED(ShaderDebugTrace, DebugVertex, uint32_t eventId, uint32_t vertid,
                              uint32_t instid, uint32_t idx, uint32_t instOffset, uint32_t vertOffset);
   IMPLEMENT_FUNCTION_PROXIED(ShaderDebugTrace, DebugPixel, uint32_t eventId, uint32_t x, uint32_t y,
@@ -587,6 +638,11 @@ private:
 
   bool CheckError(ReplayProxyPacket receivedPacket, ReplayProxyPacket expectedPacket);
 
+  WriteSerialiser &ParamsSerialiser(WriteSerialiser &ser);
+  ReadSerialiser &ParamsSerialiser(ReadSerialiser &ser) { return ser; }
+  template <typename T, typename RequestFunc>
+  ReplayProxyFuture<T> PipelineRequest(RequestFunc request);
+
   struct TextureCacheEntry
   {
     ResourceId replayid;
@@ -683,7 +739,7 @@ private:
 
   // The callback (if provided) that handles creating and ticking a preview window on the remote
   // host.
-  RENDERDOC_PreviewWindowCallback m_PreviewWindow;
+  RENDERDOC_PreviewWindowCallback m_PreviewWindow = NULL;
   // the ID of the output window to use for previewing on the remote host. Only valid/useful if
   // m_Replay is set
   uint64_t m_PreviewOutput = 0;
@@ -712,6 +768,43 @@ private:
 
   bool m_IsErrored = false;
 
+  // requests are pipelined by running a proxied function twice on the host side - once to send the
+  // parameters, and later once to read the reply. A full call does both back to back.
+  enum ProxyRequestPhase
+  {
+    ProxyRequest_Full,
+    ProxyRequest_Send,
+    ProxyRequest_Receive,
+  };
+
+  ProxyRequestPhase m_RequestPhase = ProxyRequest_Full;
+
+  // every request carries a tag which the remote server echoes back once it has executed it, so we
+  // can verify that replies are matched up with the requests that caused them.
+  uint32_t m_RequestTag = 0;
+  uint32_t m_SentTag = 0;
+
+  // the upper limit of requests in flight, so that the replies can't fill up the socket buffers
+  // and stall the remote server before we start reading them.
+  static const size_t MaxPendingRequests = 64;
+
+  struct PendingRequest
+  {
+    uint32_t tag;
+    std::function<void()> receive;
+  };
+
+  std::deque<PendingRequest> m_PendingRequests;
+
+  // parameters are serialised again when receiving the reply, so they go here to be discarded.
+  WriteSerialiser m_DiscardWriter{new StreamWriter(StreamWriter::DefaultScratchSize),
+                                  Ownership::Stream};
+
+  // descriptions requested ahead of time when the list of buffers/textures is fetched, since
+  // they're almost always requested individually right afterwards.
+  std::map<ResourceId, ReplayProxyFuture<BufferDescription>> m_PrefetchedBuffers;
+  std::map<ResourceId, ReplayProxyFuture<TextureDescription>> m_PrefetchedTextures;
+
   FrameRecord m_FrameRecord;
   APIProperties m_APIProps;
   std::map<ResourceId, TextureDescription> m_TextureInfo;
@@ -727,3 +820,15 @@ private:
   GLPipe::State m_GLPipelineState;
   VKPipe::State m_VulkanPipelineState;
 };
+
+template <typename T>
+const T &ReplayProxyFuture<T>::Get()
+{
+  if(m_Proxy)
+  {
+    m_Proxy->CompleteRequest(m_Tag);
+    m_Proxy = NULL;
+  }
+
+  return *m_Result;
+}
@@ -0,0 +1,432 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "replay_proxy.h"
+#include "common/globalconfig.h"
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "common/timing.h"
+#include "core/resource_manager.h"
+
+// a minimal remote driver that only knows about a list of textures and buffers. Everything else
+// returns empty data.
+class FakeRemoteDriver : public IRemoteDriver
+{
+public:
+  std::vector<ResourceId> textures;
+  std::vector<ResourceId> buffers;
+
+  void Shutdown() {}
+  APIProperties GetAPIProperties()
+  {
+    APIProperties ret = {};
+    ret.pipelineType = GraphicsAPI::Vulkan;
+    return ret;
+  }
+
+  const std::vector<ResourceDescription> &GetResources() { return resources; }
+  std::vector<ResourceId> GetBuffers() { return buffers; }
+  BufferDescription GetBuffer(ResourceId id)
+  {
+    BufferDescription ret = {};
+    ret.resourceId = id;
+    ret.length = Index(buffers, id) * 256;
+    return ret;
+  }
+
+  std::vector<ResourceId> GetTextures() { return textures; }
+  TextureDescription GetTexture(ResourceId id)
+  {
+    TextureDescription ret = {};
+    ret.resourceId = id;
+    ret.width = Index(textures, id) + 1;
+    ret.height = 1;
+    return ret;
+  }
+
+  std::vector<DebugMessage> GetDebugMessages() { return {}; }
+  rdcarray<ShaderEntryPoint> GetShaderEntryPoints(ResourceId shader) { return {}; }
+  ShaderReflection *GetShader(ResourceId pipeline, ResourceId shader, ShaderEntryPoint entry)
+  {
+    return NULL;
+  }
+
+  std::vector<std::string> GetDisassemblyTargets() { return {}; }
+  std::string DisassembleShader(ResourceId pipeline, const ShaderReflection *refl,
+                                const std::string &target)
+  {
+    return "";
+  }
+
+  std::vector<EventUsage> GetUsage(ResourceId id)
+  {
+    return {EventUsage(Index(textures, id), ResourceUsage::PS_Resource)};
+  }
+
+  void SavePipelineState(uint32_t eventId) {}
+  const D3D11Pipe::State *GetD3D11PipelineState() { return NULL; }
+  const D3D12Pipe::State *GetD3D12PipelineState() { return NULL; }
+  const GLPipe::State *GetGLPipelineState() { return NULL; }
+  const VKPipe::State *GetVulkanPipelineState() { return NULL; }
+  FrameRecord GetFrameRecord() { return {}; }
+  ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
+  {
+    return ReplayStatus::Succeeded;
+  }
+  void ReplayLog(uint32_t endEventID, ReplayLogType replayType) {}
+  ReplayProfile ProfileReplay() { return {}; }
+  const SDFile &GetStructuredFile() { return structuredFile; }
+  std::vector<uint32_t> GetPassEvents(uint32_t eventId) { return {}; }
+  void InitPostVSBuffers(uint32_t eventId) {}
+  void InitPostVSBuffers(const std::vector<uint32_t> &passEvents) {}
+  ResourceId GetLiveID(ResourceId id) { return id; }
+  MeshFormat GetPostVSBuffers(uint32_t eventId, uint32_t instID, uint32_t viewID,
+                              MeshDataStage stage)
+  {
+    return {};
+  }
+
+  void GetBufferData(ResourceId buff, uint64_t offset, uint64_t len, bytebuf &retData)
+  {
+    retData.resize((size_t)len);
+    for(size_t i = 0; i < retData.size(); i++)
+      retData[i] = byte((offset + i) & 0xff);
+  }
+  void GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                      const GetTextureDataParams &params, bytebuf &data)
+  {
+    data.resize((size_t)Index(textures, tex) + 1);
+    for(size_t i = 0; i < data.size(); i++)
+      data[i] = byte(mip);
+  }
+
+  void BuildTargetShader(ShaderEncoding sourceEncoding, bytebuf source, const std::string &entry,
+                         const ShaderCompileFlags &compileFlags, ShaderStage type, ResourceId *id,
+                         std::string *errors)
+  {
+  }
+  rdcarray<ShaderEncoding> GetTargetShaderEncodings() { return {}; }
+  void ReplaceResource(ResourceId from, ResourceId to) {}
+  void RemoveReplacement(ResourceId id) {}
+  void FreeTargetResource(ResourceId id) {}
+  std::vector<GPUCounter> EnumerateCounters() { return {}; }
+  CounterDescription DescribeCounter(GPUCounter counterID) { return {}; }
+  std::vector<CounterResult> FetchCounters(const std::vector<GPUCounter> &counterID) { return {}; }
+  void FillCBufferVariables(ResourceId pipeline, ResourceId shader, std::string entryPoint,
+                            uint32_t cbufSlot, rdcarray<ShaderVariable> &outvars,
+                            const bytebuf &data)
+  {
+  }
+  std::vector<PixelModification> PixelHistory(std::vector<EventUsage> events, ResourceId target,
+                                              uint32_t x, uint32_t y, uint32_t slice, uint32_t mip,
+                                              uint32_t sampleIdx, CompType typeHint)
+  {
+    return {};
+  }
+  PixelRegionHistory PixelHistoryRegion(std::vector<EventUsage> events, ResourceId target,
+                                        uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                        uint32_t slice, uint32_t mip, uint32_t sampleIdx,
+                                        CompType typeHint)
+  {
+    return {};
+  }
+  ShaderDebugTrace DebugVertex(uint32_t eventId, uint32_t vertid, uint32_t instid, uint32_t idx,
+                               uint32_t instOffset, uint32_t vertOffset)
+  {
+    return {};
+  }
+  ShaderDebugTrace DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
+                              uint32_t primitive)
+  {
+    return {};
+  }
+  ShaderDebugTrace DebugThread(uint32_t eventId, const uint32_t groupid[3],
+                               const uint32_t threadid[3])
+  {
+    return {};
+  }
+  ResourceId RenderOverlay(ResourceId texid, CompType typeHint, FloatVector clearCol,
+                           DebugOverlay overlay, uint32_t eventId,
+                           const std::vector<uint32_t> &passEvents)
+  {
+    return ResourceId();
+  }
+  bool IsRenderOutput(ResourceId id) { return false; }
+  void FileChanged() {}
+  bool NeedRemapForFetch(const ResourceFormat &format) { return false; }
+  DriverInformation GetDriverInfo() { return {}; }
+  rdcarray<GPUDevice> GetAvailableGPUs() { return {}; }
+
+private:
+  static uint32_t Index(const std::vector<ResourceId> &list, ResourceId id)
+  {
+    for(size_t i = 0; i < list.size(); i++)
+      if(list[i] == id)
+        return (uint32_t)i;
+    return ~0U;
+  }
+
+  std::vector<ResourceDescription> resources;
+  SDFile structuredFile;
+};
+
+// forwards data between two sockets, holding on to it for a fixed time in each direction to
+// simulate a high-latency network connection.
+struct LatencyRelay
+{
+  struct Packet
+  {
+    double arrival;
+    bytebuf data;
+  };
+
+  static void Forward(Network::Socket *from, Network::Socket *to, std::vector<Packet> &queue,
+                      PerformanceTimer &timer, double latencyMS)
+  {
+    byte buf[4096];
+    while(from->IsRecvDataWaiting())
+    {
+      uint32_t len = sizeof(buf);
+      if(!from->RecvDataNonBlocking(buf, len) || len == 0)
+        break;
+      Packet p;
+      p.arrival = timer.GetMilliseconds();
+      p.data.assign(buf, len);
+      queue.push_back(p);
+    }
+
+    size_t sent = 0;
+    while(sent < queue.size() && timer.GetMilliseconds() >= queue[sent].arrival + latencyMS)
+    {
+      to->SendDataBlocking(queue[sent].data.data(), (uint32_t)queue[sent].data.size());
+      sent++;
+    }
+    queue.erase(queue.begin(), queue.begin() + sent);
+  }
+
+  void Run(Network::Socket *host, Network::Socket *remote, double latencyMS)
+  {
+    PerformanceTimer timer;
+    std::vector<Packet> upstream, downstream;
+
+    while(Atomic::CmpExch32(&kill, 0, 0) == 0)
+    {
+      Forward(host, remote, upstream, timer, latencyMS);
+      Forward(remote, host, downstream, timer, latencyMS);
+      Threading::Sleep(0);
+    }
+  }
+
+  volatile int32_t kill = 0;
+};
+
+static Network::Socket *CreateTestServer(uint16_t &port)
+{
+  for(uint16_t probe = 0; probe < 20; probe++, port++)
+  {
+    Network::Socket *server = Network::CreateServerSocket("localhost", port, 2);
+
+    if(server)
+      return server;
+  }
+
+  return NULL;
+}
+
+TEST_CASE("Test pipelined replay proxy requests", "[replayproxy][network]")
+{
+  const double latencyMS = 10.0;
+  const size_t numTextures = 32;
+
+  FakeRemoteDriver driver;
+  for(size_t i = 0; i < numTextures; i++)
+  {
+    driver.textures.push_back(ResourceIDGen::GetNewUniqueID());
+    driver.buffers.push_back(ResourceIDGen::GetNewUniqueID());
+  }
+
+  // host <-> relay <-> remote
+  uint16_t remotePort = 8335;
+  Network::Socket *remoteServer = CreateTestServer(remotePort);
+  REQUIRE(remoteServer);
+
+  uint16_t relayPort = remotePort + 1;
+  Network::Socket *relayServer = CreateTestServer(relayPort);
+  REQUIRE(relayServer);
+
+  Network::Socket *host = Network::CreateClientSocket("localhost", relayPort, 10);
+  REQUIRE(host);
+  Network::Socket *relayHost = relayServer->AcceptClient(250);
+  REQUIRE(relayHost);
+  Network::Socket *relayRemote = Network::CreateClientSocket("localhost", remotePort, 10);
+  REQUIRE(relayRemote);
+  Network::Socket *remote = remoteServer->AcceptClient(250);
+  REQUIRE(remote);
+
+  LatencyRelay relay;
+  Threading::ThreadHandle relayThread =
+      Threading::CreateThread([&relay, relayHost, relayRemote, latencyMS]() {
+        relay.Run(relayHost, relayRemote, latencyMS);
+      });
+
+  Threading::ThreadHandle remoteThread = Threading::CreateThread([remote, &driver]() {
+    WriteSerialiser writer(new StreamWriter(remote, Ownership::Nothing), Ownership::Stream);
+    ReadSerialiser reader(new StreamReader(remote, Ownership::Nothing), Ownership::Stream);
+
+    writer.SetStreamingMode(true);
+    reader.SetStreamingMode(true);
+
+    ReplayProxy *proxy = new ReplayProxy(reader, writer, &driver, NULL, NULL);
+
+    while(!reader.IsErrored() && !writer.IsErrored())
+    {
+      int type = (int)reader.ReadChunk<uint32_t>();
+
+      if(reader.IsErrored() || !proxy->Tick(type))
+        break;
+    }
+
+    proxy->Shutdown();
+  });
+
+  {
+    WriteSerialiser writer(new StreamWriter(host, Ownership::Nothing), Ownership::Stream);
+    ReadSerialiser reader(new StreamReader(host, Ownership::Nothing), Ownership::Stream);
+
+    writer.SetStreamingMode(true);
+    reader.SetStreamingMode(true);
+
+    ReplayProxy *proxy = new ReplayProxy(reader, writer, NULL);
+
+    SECTION("Synchronous and pipelined requests return the same results")
+    {
+      PerformanceTimer timer;
+
+      std::vector<TextureDescription> sync;
+      for(ResourceId id : driver.textures)
+        sync.push_back(proxy->GetTexture(id));
+
+      double syncTime = timer.GetMilliseconds();
+
+      timer.Restart();
+
+      std::vector<ReplayProxyFuture<TextureDescription>> futures;
+      for(ResourceId id : driver.textures)
+        futures.push_back(proxy->GetTextureAsync(id));
+
+      CHECK(proxy->GetPendingRequestCount() == numTextures);
+
+      std::vector<TextureDescription> pipelined;
+      for(ReplayProxyFuture<TextureDescription> &f : futures)
+        pipelined.push_back(f.Get());
+
+      double pipelinedTime = timer.GetMilliseconds();
+
+      CHECK(proxy->GetPendingRequestCount() == 0);
+
+      REQUIRE(sync.size() == numTextures);
+      REQUIRE(pipelined.size() == numTextures);
+      for(size_t i = 0; i < numTextures; i++)
+      {
+        CHECK(sync[i].resourceId == driver.textures[i]);
+        CHECK(sync[i].width == i + 1);
+        CHECK(pipelined[i].resourceId == driver.textures[i]);
+        CHECK(pipelined[i].width == i + 1);
+      }
+
+      // each synchronous request costs at least one round trip, the pipelined requests should all
+      // share only a few.
+      CHECK(syncTime >= numTextures * latencyMS * 2);
+      CHECK(pipelinedTime < syncTime / 4);
+    };
+
+    SECTION("Synchronous calls complete outstanding requests in order")
+    {
+      ReplayProxyFuture<std::vector<EventUsage>> usage = proxy->GetUsageAsync(driver.textures[3]);
+      ReplayProxyFuture<bytebuf> bufData = proxy->GetBufferDataAsync(driver.buffers[0], 10, 20);
+      ReplayProxyFuture<bytebuf> texData =
+          proxy->GetTextureDataAsync(driver.textures[4], 0, 7, GetTextureDataParams());
+
+      BufferDescription buf = proxy->GetBuffer(driver.buffers[5]);
+      CHECK(buf.resourceId == driver.buffers[5]);
+      CHECK(buf.length == 5 * 256);
+
+      CHECK(proxy->GetPendingRequestCount() == 0);
+
+      REQUIRE(usage.Get().size() == 1);
+      CHECK(usage.Get()[0].eventId == 3);
+
+      REQUIRE(bufData.Get().size() == 20);
+      CHECK(bufData.Get()[0] == 10);
+      CHECK(bufData.Get()[19] == 29);
+
+      REQUIRE(texData.Get().size() == 5);
+      CHECK(texData.Get()[0] == 7);
+      CHECK(texData.Get()[4] == 7);
+    };
+
+    SECTION("Listing textures and buffers prefetches their descriptions")
+    {
+      std::vector<ResourceId> buffers = proxy->GetBuffers();
+      REQUIRE(buffers == driver.buffers);
+
+      CHECK(proxy->GetPendingRequestCount() == numTextures);
+
+      for(size_t i = 0; i < buffers.size(); i++)
+        CHECK(proxy->GetBuffer(buffers[i]).length == i * 256);
+
+      CHECK(proxy->GetPendingRequestCount() == 0);
+
+      std::vector<ResourceId> textures = proxy->GetTextures();
+      REQUIRE(textures == driver.textures);
+
+      for(size_t i = 0; i < textures.size(); i++)
+        CHECK(proxy->GetTexture(textures[i]).width == i + 1);
+
+      CHECK(proxy->GetPendingRequestCount() == 0);
+    };
+
+    proxy->Shutdown();
+  }
+
+  Atomic::Inc32(&relay.kill);
+  Threading::JoinThread(relayThread);
+  Threading::CloseThread(relayThread);
+
+  // closing the relay's sockets disconnects both ends
+  delete relayHost;
+  delete relayRemote;
+
+  Threading::JoinThread(remoteThread);
+  Threading::CloseThread(remoteThread);
+
+  delete remote;
+  delete host;
+  delete relayServer;
+  delete remoteServer;
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
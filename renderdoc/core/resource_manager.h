@@ -381,6 +381,9 @@ struct ResourceRecord
     UnlockChunks();
   }
 
+  // reserves the ordering ID for a chunk that will only be added later with AddChunk, so that it
+  // is ordered as if it were added now
+  int32_t ReserveChunkID() { return GetID(); }
   void AddChunk(Chunk *chunk, int32_t ID = 0)
   {
     if(ID == 0)
@@ -466,6 +469,7 @@ struct ResourceRecord
     for(auto it = m_FrameRefs.begin(); it != m_FrameRefs.end(); ++it)
       ids.insert(it->first);
   }
+  bool IsFrameReferenced(ResourceId id) const { return m_FrameRefs.find(id) != m_FrameRefs.end(); }
 
   uint64_t Length;
 
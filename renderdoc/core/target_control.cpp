@@ -30,7 +30,7 @@
 #include "os/os_specific.h"
 #include "serialise/serialiser.h"
 
-static const uint32_t TargetControlProtocolVersion = 5;
+static const uint32_t TargetControlProtocolVersion = 7;
 
 static bool IsProtocolVersionSupported(const uint32_t protocolVersion)
 {
@@ -46,6 +46,14 @@ static bool IsProtocolVersionSupported(const uint32_t protocolVersion)
   if(protocolVersion == 4)
     return true;
 
+  // 5 -> 6 added capture memory usage packet
+  if(protocolVersion == 5)
+    return true;
+
+  // 6 -> 7 added capture telemetry packets
+  if(protocolVersion == 6)
+    return true;
+
   if(protocolVersion == TargetControlProtocolVersion)
     return true;
 
@@ -66,7 +74,10 @@ enum PacketType : uint32_t
   ePacket_NewChild,
   ePacket_CaptureProgress,
   ePacket_CycleActiveWindow,
-  ePacket_CapturableWindowCount
+  ePacket_CapturableWindowCount,
+  ePacket_CaptureMemory,
+  ePacket_SetTelemetry,
+  ePacket_Telemetry,
 };
 
 DECLARE_REFLECTION_ENUM(PacketType);
@@ -89,6 +100,9 @@ rdcstr DoStringise(const PacketType &el)
     STRINGISE_ENUM_NAMED(ePacket_CaptureProgress, "Capture Progress");
     STRINGISE_ENUM_NAMED(ePacket_CycleActiveWindow, "Cycle Active Window");
     STRINGISE_ENUM_NAMED(ePacket_CapturableWindowCount, "Capturable Window Count");
+    STRINGISE_ENUM_NAMED(ePacket_CaptureMemory, "Capture Memory");
+    STRINGISE_ENUM_NAMED(ePacket_SetTelemetry, "Set Telemetry");
+    STRINGISE_ENUM_NAMED(ePacket_Telemetry, "Telemetry");
   }
   END_ENUM_STRINGISE();
 }
@@ -137,6 +151,8 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
   const int pingtime = 1000;       // ping every 1000ms
   const int ticktime = 10;         // tick every 10ms
   const int progresstime = 100;    // update capture progress every 100ms
+  const int memorytime = 1000;     // update capture memory usage at most every 1000ms
+  const int telemetrytime = 1000;  // send capture telemetry at most every 1000ms
   int curtime = 0;
 
   std::vector<CaptureData> captures;
@@ -144,6 +160,9 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
   std::map<RDCDriver, bool> drivers;
   float prevCaptureProgress = captureProgress;
   uint32_t prevWindows = 0;
+  uint64_t prevResident = 0, prevSpilled = 0;
+  int memtime = memorytime;
+  int teltime = 0;
 
   while(client)
   {
@@ -155,6 +174,8 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
     Threading::Sleep(ticktime);
     curtime += ticktime;
+    memtime += ticktime;
+    teltime += ticktime;
 
     std::map<RDCDriver, bool> curdrivers = RenderDoc::Inst().GetActiveDrivers();
 
@@ -163,6 +184,9 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
     uint32_t curWindows = RenderDoc::Inst().GetCapturableWindowCount();
 
+    uint64_t curSpilled = Chunk::SpilledMem();
+    uint64_t curResident = Chunk::TotalMem() - curSpilled;
+
     if(curdrivers != drivers)
     {
       // find the first difference, either a new key or a key with a different value, and send it.
@@ -269,6 +293,38 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
         SERIALISE_ELEMENT(curWindows);
       }
     }
+    else if(version >= 6 && memtime > memorytime &&
+            (prevResident != curResident || prevSpilled != curSpilled))
+    {
+      memtime = 0;
+
+      prevResident = curResident;
+      prevSpilled = curSpilled;
+
+      uint64_t budget = Chunk::GetMemoryBudget();
+
+      WRITE_DATA_SCOPE();
+      {
+        SCOPED_SERIALISE_CHUNK(ePacket_CaptureMemory);
+        SERIALISE_ELEMENT(curResident);
+        SERIALISE_ELEMENT(curSpilled);
+        SERIALISE_ELEMENT(budget);
+      }
+    }
+    else if(version >= 7 && teltime > telemetrytime && RenderDoc::Inst().IsTelemetryEnabled())
+    {
+      teltime = 0;
+
+      CaptureTelemetryData telemetry;
+      if(RenderDoc::Inst().FetchTelemetry(telemetry))
+      {
+        WRITE_DATA_SCOPE();
+        {
+          SCOPED_SERIALISE_CHUNK(ePacket_Telemetry);
+          SERIALISE_ELEMENT(telemetry);
+        }
+      }
+    }
 
     if(curtime > pingtime)
     {
@@ -352,6 +408,16 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
       {
         RenderDoc::Inst().CycleActiveWindow();
       }
+      else if(type == ePacket_SetTelemetry)
+      {
+        bool enabled = false;
+
+        READ_DATA_SCOPE();
+        SERIALISE_ELEMENT(enabled);
+
+        RenderDoc::Inst().SetTelemetryEnabled(enabled);
+        teltime = 0;
+      }
 
       reader.EndChunk();
 
@@ -362,6 +428,9 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
   RenderDoc::Inst().SetProgressCallback<CaptureProgress>(RENDERDOC_ProgressCallback());
 
+  // telemetry only has a cost while someone is listening to it
+  RenderDoc::Inst().SetTelemetryEnabled(false);
+
   // give up our connection
   {
     SCOPED_LOCK(RenderDoc::Inst().m_SingleClientLock);
@@ -645,6 +714,20 @@ public:
       SAFE_DELETE(m_Socket);
   }
 
+  void SetTelemetryEnabled(bool enabled)
+  {
+    if(m_Version < 7)
+      return;
+
+    WRITE_DATA_SCOPE();
+    SCOPED_SERIALISE_CHUNK(ePacket_SetTelemetry);
+
+    SERIALISE_ELEMENT(enabled);
+
+    if(ser.IsErrored())
+      SAFE_DELETE(m_Socket);
+  }
+
   TargetControlMessage ReceiveMessage(RENDERDOC_ProgressCallback progress)
   {
     TargetControlMessage msg;
@@ -840,6 +923,28 @@ public:
       reader.EndChunk();
       return msg;
     }
+    else if(type == ePacket_CaptureMemory)
+    {
+      msg.type = TargetControlMessageType::CaptureMemory;
+
+      READ_DATA_SCOPE();
+      SERIALISE_ELEMENT(msg.captureMemory.resident).Named("Resident"_lit);
+      SERIALISE_ELEMENT(msg.captureMemory.spilled).Named("Spilled"_lit);
+      SERIALISE_ELEMENT(msg.captureMemory.budget).Named("Budget"_lit);
+
+      reader.EndChunk();
+      return msg;
+    }
+    else if(type == ePacket_Telemetry)
+    {
+      msg.type = TargetControlMessageType::CaptureTelemetry;
+
+      READ_DATA_SCOPE();
+      SERIALISE_ELEMENT(msg.telemetry).Named("Telemetry"_lit);
+
+      reader.EndChunk();
+      return msg;
+    }
     else
     {
       RDCERR("Unexpected packed received: %d", type);
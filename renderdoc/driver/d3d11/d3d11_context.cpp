@@ -1122,6 +1122,9 @@ ReplayStatus WrappedID3D11DeviceContext::ReplayLog(CaptureState readType, uint32
 
   m_FrameReader->SetOffset(0);
 
+  ReplayProfiler &profiler = m_pDevice->GetReplayProfiler();
+  ReplayProfiler::ScopedFrame profileFrame(profiler, !partial);
+
   ReadSerialiser ser(m_FrameReader, Ownership::Nothing);
 
   ser.SetStringDatabase(&m_StringDB);
@@ -1187,6 +1190,8 @@ ReplayStatus WrappedID3D11DeviceContext::ReplayLog(CaptureState readType, uint32
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    profiler.BeginChunk(ser);
+
     D3D11Chunk chunktype = ser.ReadChunk<D3D11Chunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -1198,6 +1203,8 @@ ReplayStatus WrappedID3D11DeviceContext::ReplayLog(CaptureState readType, uint32
 
     ser.EndChunk();
 
+    profiler.EndChunk(ser, (uint32_t)chunktype, m_CurChunkOffset);
+
     if(ser.GetReader()->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
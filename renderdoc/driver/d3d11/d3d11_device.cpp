@@ -1045,6 +1045,8 @@ bool WrappedID3D11Device::ProcessChunk(ReadSerialiser &ser, D3D11Chunk context)
       }
       else if(system == SystemChunk::InitialContentsList)
       {
+        ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "CreateInitialContents");
+
         GetResourceManager()->CreateInitialContents(ser);
 
         SERIALISE_CHECK_READ_ERRORS();
@@ -1123,6 +1125,8 @@ bool WrappedID3D11Device::Serialise_CaptureScope(SerialiserType &ser)
 
 ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
 {
+  ReplayProfiler::ScopedLoad profileLoad(m_ReplayProfiler);
+
   int sectionIdx = rdc->SectionIndex(SectionType::FrameCapture);
 
   if(sectionIdx < 0)
@@ -1171,6 +1175,8 @@ ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool store
 
     uint64_t offsetStart = reader->GetOffset();
 
+    m_ReplayProfiler.BeginChunk(ser);
+
     D3D11Chunk context = ser.ReadChunk<D3D11Chunk>();
 
     chunkIdx++;
@@ -1182,6 +1188,8 @@ ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool store
 
     ser.EndChunk();
 
+    m_ReplayProfiler.EndChunk(ser, (uint32_t)context, offsetStart);
+
     if(reader->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -1211,7 +1219,10 @@ ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool store
         // save any debug messages we built up
         savedDebugMessages.swap(m_DebugMessages);
 
-        GetResourceManager()->ApplyInitialContents();
+        {
+          ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "ApplyInitialContents");
+          GetResourceManager()->ApplyInitialContents();
+        }
 
         // restore saved messages - which implicitly discards any generated while applying initial
         // contents
@@ -1284,6 +1295,7 @@ void WrappedID3D11Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
   if(!partial)
   {
     D3D11MarkerRegion apply("!!!!RenderDoc Internal: ApplyInitialContents");
+    ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "ApplyInitialContents");
     GetResourceManager()->ApplyInitialContents();
   }
 
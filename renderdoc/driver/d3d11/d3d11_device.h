@@ -31,6 +31,7 @@
 #include "common/threading.h"
 #include "common/timing.h"
 #include "core/core.h"
+#include "core/replay_profiler.h"
 #include "driver/dxgi/dxgi_wrapped.h"
 #include "d3d11_common.h"
 #include "d3d11_manager.h"
@@ -388,6 +389,7 @@ private:
 
   std::vector<FrameDescription> m_CapturedFrames;
   FrameRecord m_FrameRecord;
+  ReplayProfiler m_ReplayProfiler;
   std::vector<DrawcallDescription *> m_Drawcalls;
 
 public:
@@ -434,6 +436,7 @@ public:
 
   ResourceId GetResourceID() { return m_ResourceID; }
   FrameRecord &GetFrameRecord() { return m_FrameRecord; }
+  ReplayProfiler &GetReplayProfiler() { return m_ReplayProfiler; }
   FrameStatistics &GetFrameStats() { return m_FrameRecord.frameInfo.stats; }
   const DrawcallDescription *GetDrawcall(uint32_t eventId);
 
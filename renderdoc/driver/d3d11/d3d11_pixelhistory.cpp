@@ -2719,3 +2719,13 @@ std::vector<PixelModification> D3D11Replay::PixelHistory(std::vector<EventUsage>
 
   return history;
 }
+
+PixelRegionHistory D3D11Replay::PixelHistoryRegion(std::vector<EventUsage> events,
+                                                   ResourceId target, uint32_t x, uint32_t y,
+                                                   uint32_t width, uint32_t height, uint32_t slice,
+                                                   uint32_t mip, uint32_t sampleIdx,
+                                                   CompType typeHint)
+{
+  return PixelHistoryRegionPerPixel(this, events, target, x, y, width, height, slice, mip,
+                                    sampleIdx, typeHint);
+}
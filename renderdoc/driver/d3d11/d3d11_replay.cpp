@@ -1546,6 +1546,15 @@ void D3D11Replay::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
   m_pDevice->ReplayLog(0, endEventID, replayType);
 }
 
+ReplayProfile D3D11Replay::ProfileReplay()
+{
+  m_pDevice->GetReplayProfiler().RequestProfile();
+
+  ReplayLog(~0U, eReplay_Full);
+
+  return m_pDevice->GetReplayProfiler().GetProfile(&WrappedID3D11Device::GetChunkName);
+}
+
 const SDFile &D3D11Replay::GetStructuredFile()
 {
   return m_pDevice->GetStructuredFile();
@@ -3012,9 +3021,10 @@ uint32_t D3D11Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
+    if(minIndex <= maxIndex)
+      HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1,
+                                        cfg.position.vertexByteStride, cfg.position.format,
+                                        dataEnd, &vbData[minIndex], valid);
 
     D3D11_BOX box;
     box.top = 0;
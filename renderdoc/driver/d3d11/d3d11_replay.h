@@ -140,6 +140,7 @@ public:
 
   ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers);
   void ReplayLog(uint32_t endEventID, ReplayLogType replayType);
+  ReplayProfile ProfileReplay();
   const SDFile &GetStructuredFile();
 
   std::vector<uint32_t> GetPassEvents(uint32_t eventId);
@@ -225,6 +226,10 @@ public:
   std::vector<PixelModification> PixelHistory(std::vector<EventUsage> events, ResourceId target,
                                               uint32_t x, uint32_t y, uint32_t slice, uint32_t mip,
                                               uint32_t sampleIdx, CompType typeHint);
+  PixelRegionHistory PixelHistoryRegion(std::vector<EventUsage> events, ResourceId target,
+                                        uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                        uint32_t slice, uint32_t mip, uint32_t sampleIdx,
+                                        CompType typeHint);
   ShaderDebugTrace DebugVertex(uint32_t eventId, uint32_t vertid, uint32_t instid, uint32_t idx,
                                uint32_t instOffset, uint32_t vertOffset);
   ShaderDebugTrace DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
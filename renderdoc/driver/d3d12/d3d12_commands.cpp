@@ -779,6 +779,9 @@ ReplayStatus WrappedID3D12CommandQueue::ReplayLog(CaptureState readType, uint32_
 
   m_FrameReader->SetOffset(0);
 
+  ReplayProfiler &profiler = m_pDevice->GetReplayProfiler();
+  ReplayProfiler::ScopedFrame profileFrame(profiler, !partial);
+
   ReadSerialiser ser(m_FrameReader, Ownership::Nothing);
 
   ser.SetStringDatabase(&m_StringDB);
@@ -866,6 +869,8 @@ ReplayStatus WrappedID3D12CommandQueue::ReplayLog(CaptureState readType, uint32_
 
     m_Cmd.m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    profiler.BeginChunk(ser);
+
     D3D12Chunk context = ser.ReadChunk<D3D12Chunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -879,6 +884,8 @@ ReplayStatus WrappedID3D12CommandQueue::ReplayLog(CaptureState readType, uint32_
 
     ser.EndChunk();
 
+    profiler.EndChunk(ser, (uint32_t)context, m_Cmd.m_CurChunkOffset);
+
     if(ser.GetReader()->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -888,6 +888,8 @@ ID3D12Resource *WrappedID3D12Device::GetUploadBuffer(uint64_t chunkOffset, uint6
 
 void WrappedID3D12Device::ApplyInitialContents()
 {
+  ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "ApplyInitialContents");
+
   initStateCurBatch = 0;
   initStateCurList = NULL;
 
@@ -3028,6 +3030,8 @@ bool WrappedID3D12Device::ProcessChunk(ReadSerialiser &ser, D3D12Chunk context)
       }
       else if(system == SystemChunk::InitialContentsList)
       {
+        ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "CreateInitialContents");
+
         GetResourceManager()->CreateInitialContents(ser);
 
         SERIALISE_CHECK_READ_ERRORS();
@@ -3096,6 +3100,8 @@ void WrappedID3D12Device::AddResourceCurChunk(ResourceId id)
 
 ReplayStatus WrappedID3D12Device::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
 {
+  ReplayProfiler::ScopedLoad profileLoad(m_ReplayProfiler);
+
   int sectionIdx = rdc->SectionIndex(SectionType::FrameCapture);
 
   if(sectionIdx < 0)
@@ -3144,6 +3150,8 @@ ReplayStatus WrappedID3D12Device::ReadLogInitialisation(RDCFile *rdc, bool store
 
     uint64_t offsetStart = reader->GetOffset();
 
+    m_ReplayProfiler.BeginChunk(ser);
+
     D3D12Chunk context = ser.ReadChunk<D3D12Chunk>();
 
     chunkIdx++;
@@ -3155,6 +3163,8 @@ ReplayStatus WrappedID3D12Device::ReadLogInitialisation(RDCFile *rdc, bool store
 
     ser.EndChunk();
 
+    m_ReplayProfiler.EndChunk(ser, (uint32_t)context, offsetStart);
+
     if(reader->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
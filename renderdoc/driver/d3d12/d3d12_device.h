@@ -31,6 +31,7 @@
 #include "common/timing.h"
 #include "common/wrapped_pool.h"
 #include "core/core.h"
+#include "core/replay_profiler.h"
 #include "driver/dxgi/dxgi_wrapped.h"
 #include "replay/replay_driver.h"
 #include "d3d12_common.h"
@@ -434,6 +435,7 @@ private:
   uint32_t m_FrameCounter = 0;
   std::vector<FrameDescription> m_CapturedFrames;
   FrameRecord m_FrameRecord;
+  ReplayProfiler m_ReplayProfiler;
   std::vector<DrawcallDescription *> m_Drawcalls;
 
   ReplayStatus m_FailedReplayStatus = ReplayStatus::APIReplayFailed;
@@ -551,6 +553,7 @@ public:
   void ReleaseSwapchainResources(IDXGISwapChain *swap, IUnknown **backbuffers, int numBackbuffers);
   void FirstFrame(IDXGISwapper *swapper);
   FrameRecord &GetFrameRecord() { return m_FrameRecord; }
+  ReplayProfiler &GetReplayProfiler() { return m_ReplayProfiler; }
   const DrawcallDescription *GetDrawcall(uint32_t eventId);
 
   ResourceId GetFrameCaptureResourceId() { return m_FrameCaptureRecord->GetResourceID(); }
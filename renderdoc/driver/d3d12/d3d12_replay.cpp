@@ -282,6 +282,15 @@ void D3D12Replay::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
   m_pDevice->ReplayLog(0, endEventID, replayType);
 }
 
+ReplayProfile D3D12Replay::ProfileReplay()
+{
+  m_pDevice->GetReplayProfiler().RequestProfile();
+
+  ReplayLog(~0U, eReplay_Full);
+
+  return m_pDevice->GetReplayProfiler().GetProfile(&WrappedID3D12Device::GetChunkName);
+}
+
 const SDFile &D3D12Replay::GetStructuredFile()
 {
   return m_pDevice->GetStructuredFile();
@@ -2144,9 +2153,10 @@ uint32_t D3D12Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
+    if(minIndex <= maxIndex)
+      HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1,
+                                        cfg.position.vertexByteStride, cfg.position.format,
+                                        dataEnd, &vbData[minIndex], valid);
 
     GetDebugManager()->FillBuffer(m_VertexPick.VB, 0, vbData.data(), sizeof(Vec4f) * (maxIndex + 1));
   }
@@ -3674,6 +3684,15 @@ std::vector<PixelModification> D3D12Replay::PixelHistory(std::vector<EventUsage>
   return std::vector<PixelModification>();
 }
 
+PixelRegionHistory D3D12Replay::PixelHistoryRegion(std::vector<EventUsage> events,
+                                                   ResourceId target, uint32_t x, uint32_t y,
+                                                   uint32_t width, uint32_t height, uint32_t slice,
+                                                   uint32_t mip, uint32_t sampleIdx,
+                                                   CompType typeHint)
+{
+  return PixelRegionHistory();
+}
+
 ResourceId D3D12Replay::CreateProxyTexture(const TextureDescription &templateTex)
 {
   return ResourceId();
@@ -722,6 +722,126 @@ void WrappedOpenGL::MarkReferencedWhileCapturing(GLResourceRecord *record, Frame
   GetResourceManager()->MarkResourceFrameReferenced(record->GetResourceID(), refType);
 }
 
+void WrappedOpenGL::MarkBoundResources()
+{
+  // called before every draw and dispatch while capturing. Everything we can is taken from the
+  // bindings we track in the context data as they change, the same set of resources that
+  // GLRenderState::MarkReferenced and MarkDirty would find by fetching the whole state back.
+  if(!IsCaptureMode(m_State))
+    return;
+
+  GLResourceManager *rm = GetResourceManager();
+  ContextData &cd = GetCtxData();
+  ContextPair &ctx = GetCtx();
+
+  if(IsActiveCapturing(m_State))
+  {
+    cd.MarkBoundTextures(rm, eFrameRef_Read);
+
+    for(size_t i = 0; i < ARRAY_COUNT(cd.m_ImageBinding); i++)
+      if(cd.m_ImageBinding[i])
+        rm->MarkResourceFrameReferenced(TextureRes(ctx, cd.m_ImageBinding[i]),
+                                        eFrameRef_ReadBeforeWrite);
+
+    rm->MarkVAOReferenced(cd.m_VertexArrayRecord ? cd.m_VertexArrayRecord->Resource
+                                                 : VertexArrayRes(ctx, 0),
+                          eFrameRef_Read, true);
+
+    if(cd.m_FeedbackRecord)
+      rm->MarkResourceFrameReferenced(cd.m_FeedbackRecord->GetResourceID(), eFrameRef_Read);
+
+    if(cd.m_Program)
+      rm->MarkResourceFrameReferenced(ProgramRes(ctx, cd.m_Program), eFrameRef_Read);
+
+    if(cd.m_ProgramPipeline)
+    {
+      rm->MarkResourceFrameReferenced(ProgramPipeRes(ctx, cd.m_ProgramPipeline), eFrameRef_Read);
+
+      // the stage programs live in the pipeline object, not the context
+      GLenum programBinds[] = {
+          eGL_VERTEX_SHADER,       eGL_FRAGMENT_SHADER,        eGL_GEOMETRY_SHADER,
+          eGL_TESS_CONTROL_SHADER, eGL_TESS_EVALUATION_SHADER, eGL_COMPUTE_SHADER,
+      };
+
+      for(GLenum progbind : programBinds)
+      {
+        GLuint prog = 0;
+        GL.glGetProgramPipelineiv(cd.m_ProgramPipeline, progbind, (GLint *)&prog);
+        if(prog)
+          rm->MarkResourceFrameReferenced(ProgramRes(ctx, prog), eFrameRef_Read);
+      }
+    }
+
+    // the non-indexed targets a draw or dispatch could source from
+    GLenum bufferTargets[] = {
+        eGL_ARRAY_BUFFER,         eGL_COPY_READ_BUFFER,         eGL_COPY_WRITE_BUFFER,
+        eGL_DRAW_INDIRECT_BUFFER, eGL_DISPATCH_INDIRECT_BUFFER, eGL_PIXEL_PACK_BUFFER,
+        eGL_PIXEL_UNPACK_BUFFER,  eGL_QUERY_BUFFER,             eGL_TEXTURE_BUFFER,
+        eGL_PARAMETER_BUFFER_ARB,
+    };
+
+    for(GLenum target : bufferTargets)
+    {
+      GLResourceRecord *record = cd.m_BufferRecord[BufferIdx(target)];
+      if(record)
+        rm->MarkResourceFrameReferenced(record->GetResourceID(), eFrameRef_Read);
+    }
+
+    for(size_t i = 0; i < ARRAY_COUNT(cd.m_UniformBinding); i++)
+      if(cd.m_UniformBinding[i])
+        rm->MarkResourceFrameReferenced(BufferRes(ctx, cd.m_UniformBinding[i]), eFrameRef_Read);
+
+    if(cd.m_DrawFramebufferRecord)
+      rm->MarkFBOReferenced(cd.m_DrawFramebufferRecord->Resource, eFrameRef_ReadBeforeWrite);
+
+    // if same FBO is bound to both targets, treat it as draw only
+    if(cd.m_ReadFramebufferRecord && cd.m_ReadFramebufferRecord != cd.m_DrawFramebufferRecord)
+      rm->MarkFBOReferenced(cd.m_ReadFramebufferRecord->Resource, eFrameRef_Read);
+  }
+
+  // everything a draw can write to. MarkDirtyWithWriteReference also references the resources as
+  // read-before-write, which covers active capture
+
+  // feedback buffer bindings belong to the feedback object, so they aren't tracked per-context
+  if(HasExt[ARB_transform_feedback2])
+  {
+    GLint maxCount = 0;
+    GL.glGetIntegerv(eGL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS, &maxCount);
+
+    for(GLint i = 0; i < maxCount; i++)
+    {
+      GLuint name = 0;
+      GL.glGetIntegeri_v(eGL_TRANSFORM_FEEDBACK_BUFFER_BINDING, i, (GLint *)&name);
+
+      if(name)
+        rm->MarkDirtyWithWriteReference(BufferRes(ctx, name));
+    }
+  }
+
+  for(size_t i = 0; i < ARRAY_COUNT(cd.m_ImageBinding); i++)
+    if(cd.m_ImageBinding[i])
+      rm->MarkDirtyWithWriteReference(TextureRes(ctx, cd.m_ImageBinding[i]));
+
+  for(size_t i = 0; i < ARRAY_COUNT(cd.m_AtomicCounterBinding); i++)
+    if(cd.m_AtomicCounterBinding[i])
+      rm->MarkDirtyWithWriteReference(BufferRes(ctx, cd.m_AtomicCounterBinding[i]));
+
+  for(size_t i = 0; i < ARRAY_COUNT(cd.m_ShaderStorageBinding); i++)
+    if(cd.m_ShaderStorageBinding[i])
+      rm->MarkDirtyWithWriteReference(BufferRes(ctx, cd.m_ShaderStorageBinding[i]));
+
+  if(cd.m_DrawFramebufferRecord)
+    rm->MarkFBODirtyWithWriteReference(cd.m_DrawFramebufferRecord->Resource);
+}
+
+void WrappedOpenGL::ClearDeletedBindings(GLResourceRecord *record)
+{
+  // the record is about to be freed, so make sure no context is left pointing at it. Objects can
+  // be shared so this has to check every context, not just the current one.
+  for(auto it = m_ContextData.begin(); it != m_ContextData.end(); ++it)
+    it->second.ClearDeletedBindings(record);
+}
+
 void WrappedOpenGL::CreateReplayBackbuffer(const GLInitParams &params, ResourceId fboOrigId,
                                            GLuint &fbo, std::string bbname)
 {
@@ -920,6 +1040,50 @@ std::string WrappedOpenGL::GetChunkName(uint32_t idx)
   return ToStr((GLChunk)idx);
 }
 
+void WrappedOpenGL::RecordCallTelemetry(GLChunk chunk, uint64_t ticks)
+{
+  if(m_CallTelemetry.empty())
+    m_CallTelemetry.resize((size_t)GLChunk::Max);
+
+  CallTelemetry &call = m_CallTelemetry[(size_t)chunk];
+  call.count++;
+  call.ticks += ticks;
+}
+
+void WrappedOpenGL::FlushCallTelemetry()
+{
+  if(m_CallTelemetry.empty())
+    return;
+
+  // if telemetry was disabled since the last frame, free the storage until it's enabled again
+  if(!RenderDoc::Inst().IsTelemetryEnabled())
+  {
+    m_CallTelemetry.clear();
+    return;
+  }
+
+  // tick frequency is in ticks per millisecond
+  double tickFreq = Timing::GetTickFrequency() * 1000.0;
+
+  rdcarray<APICallTelemetry> calls;
+
+  for(size_t i = 0; i < m_CallTelemetry.size(); i++)
+  {
+    if(m_CallTelemetry[i].count == 0)
+      continue;
+
+    APICallTelemetry call;
+    call.function = GetChunkName((uint32_t)i);
+    call.count = m_CallTelemetry[i].count;
+    call.duration = double(m_CallTelemetry[i].ticks) / tickFreq;
+    calls.push_back(call);
+
+    m_CallTelemetry[i] = CallTelemetry();
+  }
+
+  RenderDoc::Inst().AddCallTelemetry(calls);
+}
+
 WrappedOpenGL::~WrappedOpenGL()
 {
   if(m_IndirectBuffer)
@@ -1109,6 +1273,99 @@ void WrappedOpenGL::ContextData::CreateResourceRecord(WrappedOpenGL *driver, voi
   }
 }
 
+void WrappedOpenGL::ContextData::SetIndexedBufferBinding(GLenum target, GLuint index, GLuint buffer)
+{
+  GLuint *bindings = NULL;
+  size_t count = 0;
+
+  switch(target)
+  {
+    case eGL_ATOMIC_COUNTER_BUFFER:
+      bindings = m_AtomicCounterBinding;
+      count = ARRAY_COUNT(m_AtomicCounterBinding);
+      break;
+    case eGL_SHADER_STORAGE_BUFFER:
+      bindings = m_ShaderStorageBinding;
+      count = ARRAY_COUNT(m_ShaderStorageBinding);
+      break;
+    case eGL_UNIFORM_BUFFER:
+      bindings = m_UniformBinding;
+      count = ARRAY_COUNT(m_UniformBinding);
+      break;
+    // transform feedback bindings are part of the feedback object, not the context
+    default: return;
+  }
+
+  if(index < count)
+    bindings[index] = buffer;
+}
+
+void WrappedOpenGL::ContextData::ClearDeletedBindings(GLResourceRecord *record)
+{
+  for(size_t t = 0; t < ARRAY_COUNT(m_TextureRecord); t++)
+    for(uint32_t u = 0; u < m_TexUnitsUsed; u++)
+      if(m_TextureRecord[t][u] == record)
+        m_TextureRecord[t][u] = NULL;
+
+  for(size_t i = 0; i < ARRAY_COUNT(m_BufferRecord); i++)
+    if(m_BufferRecord[i] == record)
+      m_BufferRecord[i] = NULL;
+
+  if(m_VertexArrayRecord == record)
+    m_VertexArrayRecord = NULL;
+  if(m_FeedbackRecord == record)
+    m_FeedbackRecord = NULL;
+  if(m_DrawFramebufferRecord == record)
+    m_DrawFramebufferRecord = NULL;
+  if(m_ReadFramebufferRecord == record)
+    m_ReadFramebufferRecord = NULL;
+}
+
+void WrappedOpenGL::ContextData::ClearDeletedNames(GLNamespace type, GLuint name)
+{
+  // deleting an object unbinds it from the current context, mirror that so we don't reference
+  // whatever object ends up re-using the name
+  if(type == eResSampler)
+  {
+    for(uint32_t u = 0; u < m_TexUnitsUsed; u++)
+      if(m_SamplerBinding[u] == name)
+        m_SamplerBinding[u] = 0;
+  }
+  else if(type == eResTexture)
+  {
+    for(size_t i = 0; i < ARRAY_COUNT(m_ImageBinding); i++)
+      if(m_ImageBinding[i] == name)
+        m_ImageBinding[i] = 0;
+  }
+  else if(type == eResBuffer)
+  {
+    for(size_t i = 0; i < ARRAY_COUNT(m_AtomicCounterBinding); i++)
+      if(m_AtomicCounterBinding[i] == name)
+        m_AtomicCounterBinding[i] = 0;
+    for(size_t i = 0; i < ARRAY_COUNT(m_ShaderStorageBinding); i++)
+      if(m_ShaderStorageBinding[i] == name)
+        m_ShaderStorageBinding[i] = 0;
+    for(size_t i = 0; i < ARRAY_COUNT(m_UniformBinding); i++)
+      if(m_UniformBinding[i] == name)
+        m_UniformBinding[i] = 0;
+  }
+}
+
+void WrappedOpenGL::ContextData::MarkBoundTextures(GLResourceManager *manager, FrameRefType refType)
+{
+  ContextPair c = {ctx, shareGroup};
+
+  for(uint32_t u = 0; u < m_TexUnitsUsed; u++)
+  {
+    for(size_t t = 0; t < ARRAY_COUNT(m_TextureRecord); t++)
+      if(m_TextureRecord[t][u])
+        manager->MarkResourceFrameReferenced(m_TextureRecord[t][u]->GetResourceID(), refType);
+
+    if(m_SamplerBinding[u])
+      manager->MarkResourceFrameReferenced(SamplerRes(c, m_SamplerBinding[u]), refType);
+  }
+}
+
 void WrappedOpenGL::CreateContext(GLWindowingData winData, void *shareContext,
                                   GLInitParams initParams, bool core, bool attribsCreate)
 {
@@ -1927,6 +2184,8 @@ void WrappedOpenGL::SwapBuffers(WindowingSystem winSystem, void *windowHandle)
   if(IsBackgroundCapturing(m_State))
     RenderDoc::Inst().Tick();
 
+  FlushCallTelemetry();
+
   // don't do anything if no context is active.
   if(m_ActiveContexts[Threading::GetCurrentID()].ctx == NULL)
   {
@@ -2292,6 +2551,8 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
 
       GetResourceManager()->InsertInitialContentsChunks(ser);
 
+      GetResourceManager()->FreeTextureReadbackRing();
+
       RDCDEBUG("Creating Capture Scope");
 
       GetResourceManager()->Serialise_InitialContentsNeeded(ser);
@@ -3050,6 +3311,8 @@ bool WrappedOpenGL::HasNonDebugMarkers()
 
 ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
 {
+  ReplayProfiler::ScopedLoad profileLoad(m_ReplayProfiler);
+
   int sectionIdx = rdc->SectionIndex(SectionType::FrameCapture);
 
   if(sectionIdx < 0)
@@ -3098,6 +3361,8 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
     uint64_t offsetStart = reader->GetOffset();
 
+    m_ReplayProfiler.BeginChunk(ser);
+
     GLChunk context = ser.ReadChunk<GLChunk>();
 
     chunkIdx++;
@@ -3109,6 +3374,8 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
     ser.EndChunk();
 
+    m_ReplayProfiler.EndChunk(ser, (uint32_t)context, offsetStart);
+
     if(reader->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -3136,7 +3403,10 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
       // save any debug messages we built up
       savedDebugMessages.swap(m_DebugMessages);
 
-      GetResourceManager()->ApplyInitialContents();
+      {
+        ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "ApplyInitialContents");
+        GetResourceManager()->ApplyInitialContents();
+      }
 
       // restore saved messages - which implicitly discards any generated while applying initial
       // contents
@@ -3215,6 +3485,8 @@ bool WrappedOpenGL::ProcessChunk(ReadSerialiser &ser, GLChunk chunk)
     }
     else if(system == SystemChunk::InitialContentsList)
     {
+      ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "CreateInitialContents");
+
       GetResourceManager()->CreateInitialContents(ser);
 
       SERIALISE_CHECK_READ_ERRORS();
@@ -4793,6 +5065,8 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 {
   m_FrameReader->SetOffset(0);
 
+  ReplayProfiler::ScopedFrame profileFrame(m_ReplayProfiler, !partial);
+
   ReadSerialiser ser(m_FrameReader, Ownership::Nothing);
 
   ser.SetStringDatabase(&m_StringDB);
@@ -4886,6 +5160,8 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    m_ReplayProfiler.BeginChunk(ser);
+
     GLChunk chunktype = ser.ReadChunk<GLChunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -4897,6 +5173,8 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
     ser.EndChunk();
 
+    m_ReplayProfiler.EndChunk(ser, (uint32_t)chunktype, m_CurChunkOffset);
+
     if(ser.GetReader()->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -5364,6 +5642,7 @@ void WrappedOpenGL::ReplayLog(uint32_t startEventID, uint32_t endEventID, Replay
   if(!partial)
   {
     GLMarkerRegion apply("!!!!RenderDoc Internal: ApplyInitialContents");
+    ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "ApplyInitialContents");
     GetResourceManager()->ApplyInitialContents();
 
     m_WasActiveFeedback = false;
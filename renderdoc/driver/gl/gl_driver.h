@@ -29,6 +29,7 @@
 #include "common/common.h"
 #include "common/timing.h"
 #include "core/core.h"
+#include "core/replay_profiler.h"
 #include "driver/shaders/spirv/spirv_reflect.h"
 #include "replay/replay_driver.h"
 #include "gl_common.h"
@@ -184,6 +185,16 @@ private:
 
   uint32_t m_FrameCounter = 0;
   uint32_t m_NoCtxFrames;
+
+  // per-function call counts and time for capture overhead telemetry, indexed by GLChunk. Only
+  // populated while telemetry is enabled, and flushed to the core once a frame.
+  struct CallTelemetry
+  {
+    uint64_t count = 0;
+    uint64_t ticks = 0;
+  };
+  std::vector<CallTelemetry> m_CallTelemetry;
+  void FlushCallTelemetry();
   uint32_t m_FailedFrame;
   CaptureFailReason m_FailedReason;
   uint32_t m_Failures;
@@ -224,6 +235,7 @@ private:
 
   std::vector<FrameDescription> m_CapturedFrames;
   FrameRecord m_FrameRecord;
+  ReplayProfiler m_ReplayProfiler;
   std::vector<DrawcallDescription *> m_Drawcalls;
 
   // replay
@@ -335,6 +347,12 @@ private:
       CharSize = CharAspect = 0.0f;
       RDCEraseEl(m_TextureRecord);
       RDCEraseEl(m_BufferRecord);
+      RDCEraseEl(m_SamplerBinding);
+      RDCEraseEl(m_ImageBinding);
+      RDCEraseEl(m_AtomicCounterBinding);
+      RDCEraseEl(m_ShaderStorageBinding);
+      RDCEraseEl(m_UniformBinding);
+      m_TexUnitsUsed = 0;
       m_VertexArrayRecord = m_FeedbackRecord = m_DrawFramebufferRecord = m_ContextDataRecord = NULL;
       m_ReadFramebufferRecord = NULL;
       m_Renderbuffer = ResourceId();
@@ -405,15 +423,39 @@ private:
     GLuint m_ProgramPipeline;
     GLuint m_Program;
 
+    // indexed bindings that draws read or write through. These are tracked by name as they're
+    // bound, so that draws while capturing can mark them without querying every binding from GL.
+    GLuint m_SamplerBinding[256];
+    GLuint m_ImageBinding[8];
+    GLuint m_AtomicCounterBinding[8];
+    GLuint m_ShaderStorageBinding[96];
+    GLuint m_UniformBinding[84];
+
+    void SetSamplerBinding(GLuint unit, GLuint sampler)
+    {
+      if(unit >= ARRAY_COUNT(m_SamplerBinding))
+        return;
+      m_SamplerBinding[unit] = sampler;
+      if(sampler)
+        m_TexUnitsUsed = RDCMAX(m_TexUnitsUsed, unit + 1);
+    }
+    void SetImageBinding(GLuint unit, GLuint texture)
+    {
+      if(unit < ARRAY_COUNT(m_ImageBinding))
+        m_ImageBinding[unit] = texture;
+    }
+    void SetIndexedBufferBinding(GLenum target, GLuint index, GLuint buffer);
+    void ClearDeletedBindings(GLResourceRecord *record);
+    void ClearDeletedNames(GLNamespace type, GLuint name);
+    void MarkBoundTextures(GLResourceManager *manager, FrameRefType refType);
+
     GLResourceRecord *GetActiveTexRecord(GLenum target)
     {
       return m_TextureRecord[TextureIdx(target)][m_TextureUnit];
     }
     void SetActiveTexRecord(GLenum target, GLResourceRecord *record)
     {
-      if(IsProxyTarget(target))
-        return;
-      m_TextureRecord[TextureIdx(target)][m_TextureUnit] = record;
+      SetTexUnitRecordIndexed(target, (uint32_t)m_TextureUnit, record);
     }
     GLResourceRecord *GetTexUnitRecord(GLenum target, GLenum texunit)
     {
@@ -434,6 +476,8 @@ private:
       if(IsProxyTarget(target))
         return;
       m_TextureRecord[TextureIdx(target)][unitidx] = record;
+      if(record)
+        m_TexUnitsUsed = RDCMAX(m_TexUnitsUsed, unitidx + 1);
     }
 
     // GLES allows drawing from client memory, in which case we will copy to
@@ -449,6 +493,8 @@ private:
   private:
     // kept private to force everyone through accessors above
     GLResourceRecord *m_TextureRecord[11][256];
+    // one past the highest texture or sampler unit that's ever had something bound
+    uint32_t m_TexUnitsUsed;
   };
 
   struct ClientMemoryData
@@ -540,6 +586,7 @@ public:
 
   uint64_t GetLogVersion() { return m_SectionVersion; }
   static std::string GetChunkName(uint32_t idx);
+  void RecordCallTelemetry(GLChunk chunk, uint64_t ticks);
   GLResourceManager *GetResourceManager() { return m_ResourceManager; }
   CaptureState GetState() { return m_State; }
   GLReplay *GetReplay() { return &m_Replay; }
@@ -580,6 +627,7 @@ public:
   GLuint GetFakeVAO0() { return m_Global_VAO0; }
   GLuint GetCurrentDefaultFBO() { return m_CurrentDefaultFBO; }
   FrameRecord &GetFrameRecord() { return m_FrameRecord; }
+  ReplayProfiler &GetReplayProfiler() { return m_ReplayProfiler; }
   const APIEvent &GetEvent(uint32_t eventId);
 
   const DrawcallDescription &GetRootDraw() { return m_ParentDrawcall; }
@@ -1915,6 +1963,8 @@ public:
                                       GLbitfield flags);
 
   void MarkReferencedWhileCapturing(GLResourceRecord *record, FrameRefType refType);
+  void MarkBoundResources();
+  void ClearDeletedBindings(GLResourceRecord *record);
 
   IMPLEMENT_FUNCTION_SERIALISED(GLenum, glCheckNamedFramebufferStatusEXT, GLuint framebuffer,
                                 GLenum target);
@@ -62,6 +62,24 @@ public:
   bool enabled = false;
 } glhook;
 
+// times a hooked call for capture overhead telemetry. This includes the time spent in the real
+// driver function, as well as our own work around it.
+struct ScopedCallTelemetry
+{
+  ScopedCallTelemetry(GLChunk c) : chunk(c)
+  {
+    if(RenderDoc::Inst().IsTelemetryEnabled())
+      start = Timing::GetTick();
+  }
+  ~ScopedCallTelemetry()
+  {
+    if(start && glhook.driver)
+      glhook.driver->RecordCallTelemetry(chunk, Timing::GetTick() - start);
+  }
+  GLChunk chunk;
+  uint64_t start = 0;
+};
+
 #if ENABLED(RDOC_DEVEL)
 
 struct ScopedPrinter
@@ -87,16 +105,18 @@ int ScopedPrinter::depth = 0;
 // This checks that we're not infinite looping by calling our own hooks from ourselves. Mostly
 // useful on android where you can only debug by printf and the stack dumps are often corrupted when
 // the callstack overflows.
-#define SCOPED_GLCALL(funcname)    \
-  SCOPED_LOCK(glLock);             \
-  gl_CurChunk = GLChunk::funcname; \
+#define SCOPED_GLCALL(funcname)                                             \
+  SCOPED_LOCK(glLock);                                                      \
+  gl_CurChunk = GLChunk::funcname;                                          \
+  ScopedCallTelemetry CONCAT(scopedtelemetry, __LINE__)(GLChunk::funcname); \
   ScopedPrinter CONCAT(scopedprint, __LINE__)(STRINGIZE(funcname));
 
 #else
 
-#define SCOPED_GLCALL(funcname) \
-  SCOPED_LOCK(glLock);          \
-  gl_CurChunk = GLChunk::funcname;
+#define SCOPED_GLCALL(funcname)    \
+  SCOPED_LOCK(glLock);             \
+  gl_CurChunk = GLChunk::funcname; \
+  ScopedCallTelemetry CONCAT(scopedtelemetry, __LINE__)(GLChunk::funcname);
 
 #endif
 
@@ -1148,6 +1148,28 @@ uint64_t GLResourceManager::GetSize_InitialState(ResourceId resid, const GLIniti
   return 16;
 }
 
+void GLResourceManager::FreeTextureReadbackRing()
+{
+  for(size_t s = 0; s < TextureReadbackRingSize; s++)
+  {
+    TextureReadbackSlot &slot = m_TextureReadbackRing[s];
+
+    if(slot.fence)
+      GL.glDeleteSync(slot.fence);
+    if(slot.buffer)
+      GL.glDeleteBuffers(1, &slot.buffer);
+
+    slot = TextureReadbackSlot();
+  }
+
+  if(m_TextureReadbackBytes > 0)
+    RDCLOG("Read back %.2f MB of texture contents asynchronously, %.2f ms spent waiting on the GPU",
+           double(m_TextureReadbackBytes) / (1024.0 * 1024.0), m_TextureReadbackWaitTime);
+
+  m_TextureReadbackBytes = 0;
+  m_TextureReadbackWaitTime = 0.0;
+}
+
 template <typename SerialiserType>
 bool GLResourceManager::Serialise_InitialState(SerialiserType &ser, ResourceId id,
                                                GLResourceRecord *record,
@@ -1607,16 +1629,11 @@ bool GLResourceManager::Serialise_InitialState(SerialiserType &ser, ResourceId i
                                          TextureState.depth, fmt, type);
           }
 
-          // on read and write, we allocate a single buffer big enough for all mips and re-use it
-          // to avoid repeated new/free.
-          byte *scratchBuf = AllocAlignedBuffer(size);
-
-          // loop over all the available mips
-          for(int i = 0; i < TextureState.mips; i++)
-          {
-            uint32_t w = RDCMAX(TextureState.width >> i, 1U);
-            uint32_t h = RDCMAX(TextureState.height >> i, 1U);
-            uint32_t d = RDCMAX(TextureState.depth >> i, 1U);
+          // calculate the dimensions and byte size of a given mip
+          auto getMipSize = [&](int mip, uint32_t &w, uint32_t &h, uint32_t &d) -> uint32_t {
+            w = RDCMAX(TextureState.width >> mip, 1U);
+            h = RDCMAX(TextureState.height >> mip, 1U);
+            d = RDCMAX(TextureState.depth >> mip, 1U);
 
             if(TextureState.type == eGL_TEXTURE_CUBE_MAP_ARRAY ||
                TextureState.type == eGL_TEXTURE_2D_ARRAY)
@@ -1625,34 +1642,186 @@ bool GLResourceManager::Serialise_InitialState(SerialiserType &ser, ResourceId i
             if(TextureState.type == eGL_TEXTURE_1D_ARRAY)
               h = TextureState.height;
 
-            // calculate the actual byte size of this mip
             if(isCompressed)
-              size = (uint32_t)GetCompressedByteSize(w, h, d, TextureState.internalformat);
+              return (uint32_t)GetCompressedByteSize(w, h, d, TextureState.internalformat);
+
+            return (uint32_t)GetByteSize(w, h, d, fmt, type);
+          };
+
+          const uint32_t maxSize = size;
+          const int numSubresources = TextureState.mips * targetcount;
+
+          // when writing, we read back through the ring of pixel pack buffers if we can, so that
+          // the GPU can be copying out the next subresources while we serialise the current one.
+          // Each slot holds one subresource of any size, so only as many slots are used as fit in
+          // the budget.
+          uint32_t ringDepth = 0;
+          if(ser.IsWriting() && maxSize <= TextureReadbackBudget)
+          {
+            bool canReadAsync = true;
+
+            // on GLES compressed data comes from our CPU-side shadow copy, and glGetTexImage is
+            // emulated with glReadPixels which can only write directly into a buffer for the
+            // guaranteed RGBA8 format/type pair. Anything else needs a CPU fixup of the data.
+            if(IsGLES)
+              canReadAsync = !isCompressed && fmt == eGL_RGBA && type == eGL_UNSIGNED_BYTE;
+
+            if(canReadAsync)
+              ringDepth = (uint32_t)RDCMIN(TextureReadbackBudget / RDCMAX(maxSize, 1U),
+                                           (uint64_t)TextureReadbackRingSize);
+
+            ringDepth = RDCMIN(ringDepth, (uint32_t)numSubresources);
+
+            // with only one slot there's nothing to overlap, so just read back directly
+            if(ringDepth < 2)
+              ringDepth = 0;
+          }
+
+          if(ringDepth > 0 && m_TextureReadbackRing[0].size < (GLsizeiptr)maxSize)
+          {
+            // the slots in use are about to grow, so free any that won't be used to keep the total
+            // memory within the budget
+            for(size_t s = ringDepth; s < TextureReadbackRingSize; s++)
+            {
+              if(m_TextureReadbackRing[s].buffer)
+                GL.glDeleteBuffers(1, &m_TextureReadbackRing[s].buffer);
+              m_TextureReadbackRing[s] = TextureReadbackSlot();
+            }
+          }
+
+          // start copying a subresource into its slot in the ring
+          auto issueReadback = [&](int sub) {
+            int mip = sub / targetcount;
+            int trg = sub % targetcount;
+
+            TextureReadbackSlot &slot = m_TextureReadbackRing[sub % ringDepth];
+
+            if(slot.buffer == 0)
+              GL.glGenBuffers(1, &slot.buffer);
+
+            GL.glBindBuffer(eGL_PIXEL_PACK_BUFFER, slot.buffer);
+
+            if(slot.size < (GLsizeiptr)maxSize)
+            {
+              GL.glBufferData(eGL_PIXEL_PACK_BUFFER, (GLsizeiptr)maxSize, NULL, eGL_STREAM_READ);
+              slot.size = (GLsizeiptr)maxSize;
+            }
+
+            if(isCompressed)
+              GL.glGetCompressedTextureImageEXT(tex, targets[trg], mip, NULL);
             else
-              size = (uint32_t)GetByteSize(w, h, d, fmt, type);
+              GL.glGetTexImage(targets[trg], mip, fmt, type, NULL);
+
+            slot.fence = GL.glFenceSync(eGL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            GL.glBindBuffer(eGL_PIXEL_PACK_BUFFER, 0);
+          };
+
+          // wait for a subresource's copy to finish and map it. Leaves the slot's buffer bound
+          auto mapReadback = [&](int sub, uint32_t subSize) -> byte * {
+            TextureReadbackSlot &slot = m_TextureReadbackRing[sub % ringDepth];
+
+            PerformanceTimer timer;
+
+            if(slot.fence)
+            {
+              // flush on the first wait so that the copy is guaranteed to be submitted
+              GLenum status =
+                  GL.glClientWaitSync(slot.fence, eGL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ULL);
+              while(status == eGL_TIMEOUT_EXPIRED)
+                status = GL.glClientWaitSync(slot.fence, 0, 1000000000ULL);
+
+              if(status == eGL_WAIT_FAILED)
+                RDCWARN("Waiting for texture readback failed, mapping will synchronise instead");
+
+              GL.glDeleteSync(slot.fence);
+              slot.fence = NULL;
+            }
+
+            m_TextureReadbackWaitTime += timer.GetMilliseconds();
+
+            GL.glBindBuffer(eGL_PIXEL_PACK_BUFFER, slot.buffer);
+            return (byte *)GL.glMapBufferRange(eGL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)subSize,
+                                               eGL_MAP_READ_BIT);
+          };
+
+          // on read, and on write when not using the ring, we allocate a single buffer big enough
+          // for all mips and re-use it to avoid repeated new/free.
+          byte *scratchBuf = NULL;
+          if(ringDepth == 0)
+            scratchBuf = AllocAlignedBuffer(maxSize);
+
+          // fill the ring before serialising anything
+          for(int sub = 0; sub < (int)ringDepth; sub++)
+            issueReadback(sub);
+
+          // loop over all the available mips
+          for(int i = 0; i < TextureState.mips; i++)
+          {
+            uint32_t w = 0, h = 0, d = 0;
+
+            // calculate the actual byte size of this mip
+            size = getMipSize(i, w, h, d);
 
             // loop over the number of targets (this will only ever be >1 for cubemaps)
             for(int trg = 0; trg < targetcount; trg++)
             {
+              const int sub = i * targetcount + trg;
+
+              byte *contents = scratchBuf;
+              bool mapped = false;
+
               // when writing, fetch the source data out of the texture
               if(ser.IsWriting())
               {
-                if(isCompressed)
+                if(ringDepth > 0)
                 {
-                  if(IsGLES)
-                    details.GetCompressedImageDataGLES(i, targets[trg], size, scratchBuf);
-                  else
-                    GL.glGetCompressedTextureImageEXT(tex, targets[trg], i, scratchBuf);
+                  contents = mapReadback(sub, size);
+                  mapped = (contents != NULL);
+
+                  if(!mapped)
+                  {
+                    RDCERR("Couldn't map texture readback buffer, reading back directly");
+
+                    GL.glBindBuffer(eGL_PIXEL_PACK_BUFFER, 0);
+
+                    if(scratchBuf == NULL)
+                      scratchBuf = AllocAlignedBuffer(maxSize);
+                    contents = scratchBuf;
+                  }
                 }
-                else
+
+                if(!mapped)
                 {
-                  // we avoid glGetTextureImageEXT as it seems buggy for cubemap faces
-                  GL.glGetTexImage(targets[trg], i, fmt, type, scratchBuf);
+                  if(isCompressed)
+                  {
+                    if(IsGLES)
+                      details.GetCompressedImageDataGLES(i, targets[trg], size, contents);
+                    else
+                      GL.glGetCompressedTextureImageEXT(tex, targets[trg], i, contents);
+                  }
+                  else
+                  {
+                    // we avoid glGetTextureImageEXT as it seems buggy for cubemap faces
+                    GL.glGetTexImage(targets[trg], i, fmt, type, contents);
+                  }
                 }
               }
 
               // serialise without allocating memory as we already have our scratch buf sized.
-              ser.Serialise("SubresourceContents"_lit, scratchBuf, size, SerialiserFlags::NoFlags);
+              ser.Serialise("SubresourceContents"_lit, contents, size, SerialiserFlags::NoFlags);
+
+              if(mapped)
+              {
+                m_TextureReadbackBytes += size;
+
+                GL.glUnmapBuffer(eGL_PIXEL_PACK_BUFFER);
+                GL.glBindBuffer(eGL_PIXEL_PACK_BUFFER, 0);
+              }
+
+              // the slot is free now, so start the next subresource copying into it
+              if(ringDepth > 0 && sub + (int)ringDepth < numSubresources)
+                issueReadback(sub + (int)ringDepth);
 
               // on replay, restore the data into the initial contents texture
               if(IsReplayingAndReading() && !ser.IsErrored())
@@ -1698,6 +1867,14 @@ bool GLResourceManager::Serialise_InitialState(SerialiserType &ser, ResourceId i
 
           // free our scratch buffer
           FreeAlignedBuffer(scratchBuf);
+
+          // if anything went wrong we might still have copies in flight, don't leave them around
+          for(size_t s = 0; s < TextureReadbackRingSize; s++)
+          {
+            if(m_TextureReadbackRing[s].fence)
+              GL.glDeleteSync(m_TextureReadbackRing[s].fence);
+            m_TextureReadbackRing[s].fence = NULL;
+          }
         }
 
         // restore the previous texture binding
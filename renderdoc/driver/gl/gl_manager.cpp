@@ -119,6 +119,42 @@ void GLResourceManager::MarkFBOReferenced(GLResource res, FrameRefType ref)
   }
 }
 
+void GLResourceManager::MarkFBODirtyWithWriteReference(GLResource res)
+{
+  if(res.name == 0)
+    return;
+
+  ContextPair &ctx = m_Driver->GetCtx();
+
+  auto markAttachment = [this, &ctx, &res](GLenum attachment) {
+    GLenum type = eGL_TEXTURE;
+    GLuint name = 0;
+
+    GL.glGetNamedFramebufferAttachmentParameterivEXT(
+        res.name, attachment, eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, (GLint *)&name);
+
+    if(name == 0)
+      return;
+
+    GL.glGetNamedFramebufferAttachmentParameterivEXT(
+        res.name, attachment, eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, (GLint *)&type);
+
+    if(type == eGL_RENDERBUFFER)
+      MarkDirtyResource(RenderbufferRes(ctx, name));
+    else
+      MarkDirtyWithWriteReference(TextureRes(ctx, name));
+  };
+
+  GLint numCols = 8;
+  GL.glGetIntegerv(eGL_MAX_COLOR_ATTACHMENTS, &numCols);
+
+  for(int c = 0; c < numCols; c++)
+    markAttachment(GLenum(eGL_COLOR_ATTACHMENT0 + c));
+
+  markAttachment(eGL_DEPTH_ATTACHMENT);
+  markAttachment(eGL_STENCIL_ATTACHMENT);
+}
+
 void GLResourceManager::SetInternalResource(GLResource res)
 {
   if(!RenderDoc::Inst().IsReplayApp())
@@ -264,6 +264,8 @@ public:
   // this would be handled by record parenting, but that would be a nightmare to track.
   void MarkVAOReferenced(GLResource res, FrameRefType ref, bool allowFake0 = false);
   void MarkFBOReferenced(GLResource res, FrameRefType ref);
+  // mark everything attached to an FBO as dirty and written, as when it's rendered to
+  void MarkFBODirtyWithWriteReference(GLResource res);
 
   bool IsResourceTrackedForPersistency(const GLResource &res);
 
@@ -280,6 +282,10 @@ public:
 
   void SetInternalResource(GLResource res);
 
+  // release the pixel pack buffers used to read back texture contents during initial state
+  // serialisation. Must be called on the context that serialised the initial states.
+  void FreeTextureReadbackRing();
+
 private:
   bool ResourceTypeRelease(GLResource res);
   bool Prepare_InitialState(GLResource res);
@@ -290,6 +296,24 @@ private:
                           GLint samples, int mips);
   void PrepareTextureInitialContents(ResourceId liveid, ResourceId origid, GLResource res);
 
+  // texture contents are read back through a small ring of pixel pack buffers, so that the copy
+  // of the next subresources can proceed on the GPU while the current one is being serialised.
+  struct TextureReadbackSlot
+  {
+    GLuint buffer = 0;
+    GLsizeiptr size = 0;
+    GLsync fence = NULL;
+  };
+
+  static const size_t TextureReadbackRingSize = 4;
+  // the most memory that can be in flight in the ring at once. Any subresource bigger than this is
+  // read back synchronously instead
+  static const uint64_t TextureReadbackBudget = 256 * 1024 * 1024;
+
+  TextureReadbackSlot m_TextureReadbackRing[TextureReadbackRingSize];
+  uint64_t m_TextureReadbackBytes = 0;
+  double m_TextureReadbackWaitTime = 0.0;
+
   void Create_InitialState(ResourceId id, GLResource live, bool hasData);
   void Apply_InitialState(GLResource live, const GLInitialContents &initial);
 
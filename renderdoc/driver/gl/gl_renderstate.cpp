@@ -596,57 +596,10 @@ void GLRenderState::MarkDirty(WrappedOpenGL *driver) const
     }
   }
 
-  GL.glGetIntegerv(eGL_MAX_COLOR_ATTACHMENTS, &maxCount);
-
+  name = 0;
   GL.glGetIntegerv(eGL_DRAW_FRAMEBUFFER_BINDING, (GLint *)&name);
 
-  if(name)
-  {
-    GLenum type = eGL_TEXTURE;
-    for(GLint i = 0; i < maxCount; i++)
-    {
-      GL.glGetFramebufferAttachmentParameteriv(
-          eGL_DRAW_FRAMEBUFFER, GLenum(eGL_COLOR_ATTACHMENT0 + i),
-          eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, (GLint *)&name);
-      GL.glGetFramebufferAttachmentParameteriv(
-          eGL_DRAW_FRAMEBUFFER, GLenum(eGL_COLOR_ATTACHMENT0 + i),
-          eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, (GLint *)&type);
-
-      if(name)
-      {
-        if(type == eGL_RENDERBUFFER)
-          manager->MarkDirtyResource(RenderbufferRes(ctx, name));
-        else
-          manager->MarkDirtyWithWriteReference(TextureRes(ctx, name));
-      }
-    }
-
-    GL.glGetFramebufferAttachmentParameteriv(eGL_DRAW_FRAMEBUFFER, eGL_DEPTH_ATTACHMENT,
-                                             eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, (GLint *)&name);
-    GL.glGetFramebufferAttachmentParameteriv(eGL_DRAW_FRAMEBUFFER, eGL_DEPTH_ATTACHMENT,
-                                             eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, (GLint *)&type);
-
-    if(name)
-    {
-      if(type == eGL_RENDERBUFFER)
-        manager->MarkDirtyResource(RenderbufferRes(ctx, name));
-      else
-        manager->MarkDirtyWithWriteReference(TextureRes(ctx, name));
-    }
-
-    GL.glGetFramebufferAttachmentParameteriv(eGL_DRAW_FRAMEBUFFER, eGL_STENCIL_ATTACHMENT,
-                                             eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, (GLint *)&name);
-    GL.glGetFramebufferAttachmentParameteriv(eGL_DRAW_FRAMEBUFFER, eGL_STENCIL_ATTACHMENT,
-                                             eGL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, (GLint *)&type);
-
-    if(name)
-    {
-      if(type == eGL_RENDERBUFFER)
-        manager->MarkDirtyResource(RenderbufferRes(ctx, name));
-      else
-        manager->MarkDirtyWithWriteReference(TextureRes(ctx, name));
-    }
-  }
+  manager->MarkFBODirtyWithWriteReference(FramebufferRes(ctx, name));
 }
 
 bool GLRenderState::CheckEnableDisableParam(GLenum pname)
@@ -98,6 +98,15 @@ void GLReplay::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
   }
 }
 
+ReplayProfile GLReplay::ProfileReplay()
+{
+  m_pDriver->GetReplayProfiler().RequestProfile();
+
+  ReplayLog(~0U, eReplay_Full);
+
+  return m_pDriver->GetReplayProfiler().GetProfile(&WrappedOpenGL::GetChunkName);
+}
+
 const SDFile &GLReplay::GetStructuredFile()
 {
   return m_pDriver->GetStructuredFile();
@@ -3368,6 +3377,15 @@ std::vector<PixelModification> GLReplay::PixelHistory(std::vector<EventUsage> ev
   return std::vector<PixelModification>();
 }
 
+PixelRegionHistory GLReplay::PixelHistoryRegion(std::vector<EventUsage> events, ResourceId target,
+                                                uint32_t x, uint32_t y, uint32_t width,
+                                                uint32_t height, uint32_t slice, uint32_t mip,
+                                                uint32_t sampleIdx, CompType typeHint)
+{
+  GLNOTIMP("GLReplay::PixelHistoryRegion");
+  return PixelRegionHistory();
+}
+
 ShaderDebugTrace GLReplay::DebugVertex(uint32_t eventId, uint32_t vertid, uint32_t instid,
                                        uint32_t idx, uint32_t instOffset, uint32_t vertOffset)
 {
@@ -403,7 +403,8 @@ bool WrappedOpenGL::Serialise_glNamedBufferStorageEXT(SerialiserType &ser, GLuin
   SERIALISE_ELEMENT_LOCAL(buffer, BufferRes(GetCtx(), bufferHandle));
 
   SERIALISE_ELEMENT_LOCAL(bytesize, (uint64_t)size);
-  SERIALISE_ELEMENT_ARRAY(data, bytesize);
+  // not using SERIALISE_ELEMENT_ARRAY since the data is only uploaded, so it can be read in-place
+  ser.Serialise("data"_lit, data, bytesize, SerialiserFlags::ReadDirect);
 
   if(ser.IsWriting())
   {
@@ -548,7 +549,8 @@ bool WrappedOpenGL::Serialise_glNamedBufferDataEXT(SerialiserType &ser, GLuint b
   SERIALISE_ELEMENT_LOCAL(buffer, BufferRes(GetCtx(), bufferHandle));
 
   SERIALISE_ELEMENT_LOCAL(bytesize, (uint64_t)size);
-  SERIALISE_ELEMENT_ARRAY(data, bytesize);
+  // not using SERIALISE_ELEMENT_ARRAY since the data is only uploaded, so it can be read in-place
+  ser.Serialise("data"_lit, data, bytesize, SerialiserFlags::ReadDirect);
 
   if(ser.IsWriting())
   {
@@ -903,7 +905,8 @@ bool WrappedOpenGL::Serialise_glNamedBufferSubDataEXT(SerialiserType &ser, GLuin
   SERIALISE_ELEMENT_LOCAL(offset, (uint64_t)offsetPtr);
 
   SERIALISE_ELEMENT_LOCAL(bytesize, (uint64_t)size);
-  SERIALISE_ELEMENT_ARRAY(data, bytesize);
+  // not using SERIALISE_ELEMENT_ARRAY since the data is only uploaded, so it can be read in-place
+  ser.Serialise("data"_lit, data, bytesize, SerialiserFlags::ReadDirect);
 
   SERIALISE_CHECK_READ_ERRORS();
 
@@ -1217,6 +1220,8 @@ void WrappedOpenGL::glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
 
   SERIALISE_TIME_CALL(GL.glBindBufferBase(target, index, buffer));
 
+  cd.SetIndexedBufferBinding(target, index, buffer);
+
   if(IsCaptureMode(m_State))
   {
     size_t idx = BufferIdx(target);
@@ -1346,6 +1351,8 @@ void WrappedOpenGL::glBindBufferRange(GLenum target, GLuint index, GLuint buffer
 
   SERIALISE_TIME_CALL(GL.glBindBufferRange(target, index, buffer, offset, size));
 
+  cd.SetIndexedBufferBinding(target, index, buffer);
+
   if(IsCaptureMode(m_State))
   {
     size_t idx = BufferIdx(target);
@@ -1489,6 +1496,9 @@ void WrappedOpenGL::glBindBuffersBase(GLenum target, GLuint first, GLsizei count
 {
   SERIALISE_TIME_CALL(GL.glBindBuffersBase(target, first, count, buffers));
 
+  for(GLsizei i = 0; i < count; i++)
+    GetCtxData().SetIndexedBufferBinding(target, first + i, buffers ? buffers[i] : 0);
+
   if(IsCaptureMode(m_State) && count > 0)
   {
     ContextData &cd = GetCtxData();
@@ -1701,6 +1711,9 @@ void WrappedOpenGL::glBindBuffersRange(GLenum target, GLuint first, GLsizei coun
 
   SERIALISE_TIME_CALL(GL.glBindBuffersRange(target, first, count, buffers, offsets, sizes));
 
+  for(GLsizei i = 0; i < count; i++)
+    cd.SetIndexedBufferBinding(target, first + i, buffers ? buffers[i] : 0);
+
   if(IsCaptureMode(m_State) && count > 0)
   {
     size_t idx = BufferIdx(target);
@@ -2889,7 +2902,11 @@ void WrappedOpenGL::glDeleteTransformFeedbacks(GLsizei n, const GLuint *ids)
     if(GetResourceManager()->HasCurrentResource(res))
     {
       if(GetResourceManager()->HasResourceRecord(res))
-        GetResourceManager()->GetResourceRecord(res)->Delete(GetResourceManager());
+      {
+        GLResourceRecord *record = GetResourceManager()->GetResourceRecord(res);
+        ClearDeletedBindings(record);
+        record->Delete(GetResourceManager());
+      }
       GetResourceManager()->UnregisterResource(res);
     }
   }
@@ -4801,6 +4818,7 @@ void WrappedOpenGL::glDeleteBuffers(GLsizei n, const GLuint *buffers)
   for(GLsizei i = 0; i < n; i++)
   {
     GLResource res = BufferRes(GetCtx(), buffers[i]);
+    GetCtxData().ClearDeletedNames(eResBuffer, buffers[i]);
     if(GetResourceManager()->HasCurrentResource(res))
     {
       GLResourceRecord *record = GetResourceManager()->GetResourceRecord(res);
@@ -4815,6 +4833,8 @@ void WrappedOpenGL::glDeleteBuffers(GLsizei n, const GLuint *buffers)
 
         // free any shadow storage
         record->FreeShadowStorage();
+
+        ClearDeletedBindings(record);
       }
 
       if(GetResourceManager()->HasResourceRecord(res))
@@ -4834,7 +4854,11 @@ void WrappedOpenGL::glDeleteVertexArrays(GLsizei n, const GLuint *arrays)
     if(GetResourceManager()->HasCurrentResource(res))
     {
       if(GetResourceManager()->HasResourceRecord(res))
-        GetResourceManager()->GetResourceRecord(res)->Delete(GetResourceManager());
+      {
+        GLResourceRecord *record = GetResourceManager()->GetResourceRecord(res);
+        ClearDeletedBindings(record);
+        record->Delete(GetResourceManager());
+      }
       GetResourceManager()->UnregisterResource(res);
     }
   }
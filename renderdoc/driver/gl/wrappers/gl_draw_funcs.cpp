@@ -311,17 +311,7 @@ void WrappedOpenGL::glDispatchCompute(GLuint num_groups_x, GLuint num_groups_y,
 {
   CoherentMapImplicitBarrier();
 
-  if(IsCaptureMode(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDispatchCompute(num_groups_x, num_groups_y, num_groups_z));
 
@@ -422,17 +412,7 @@ void WrappedOpenGL::glDispatchComputeGroupSizeARB(GLuint num_groups_x, GLuint nu
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDispatchComputeGroupSizeARB(num_groups_x, num_groups_y, num_groups_z,
                                                        group_size_x, group_size_y, group_size_z));
@@ -498,17 +478,7 @@ void WrappedOpenGL::glDispatchComputeIndirect(GLintptr indirect)
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDispatchComputeIndirect(indirect));
 
@@ -667,17 +637,7 @@ void WrappedOpenGL::glDrawTransformFeedback(GLenum mode, GLuint id)
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawTransformFeedback(mode, id));
 
@@ -740,17 +700,7 @@ void WrappedOpenGL::glDrawTransformFeedbackInstanced(GLenum mode, GLuint id, GLs
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawTransformFeedbackInstanced(mode, id, instancecount));
 
@@ -812,17 +762,7 @@ void WrappedOpenGL::glDrawTransformFeedbackStream(GLenum mode, GLuint id, GLuint
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawTransformFeedbackStream(mode, id, stream));
 
@@ -889,17 +829,7 @@ void WrappedOpenGL::glDrawTransformFeedbackStreamInstanced(GLenum mode, GLuint i
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawTransformFeedbackStreamInstanced(mode, id, stream, instancecount));
 
@@ -1122,17 +1052,7 @@ void WrappedOpenGL::glDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawArrays(mode, first, count));
 
@@ -1207,17 +1127,7 @@ void WrappedOpenGL::glDrawArraysIndirect(GLenum mode, const void *indirect)
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawArraysIndirect(mode, indirect));
 
@@ -1279,17 +1189,7 @@ void WrappedOpenGL::glDrawArraysInstanced(GLenum mode, GLint first, GLsizei coun
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawArraysInstanced(mode, first, count, instancecount));
 
@@ -1359,17 +1259,7 @@ void WrappedOpenGL::glDrawArraysInstancedBaseInstance(GLenum mode, GLint first,
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(
       GL.glDrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance));
@@ -1439,17 +1329,7 @@ void WrappedOpenGL::glDrawElements(GLenum mode, GLsizei count, GLenum type, cons
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawElements(mode, count, type, indices));
 
@@ -1529,17 +1409,7 @@ void WrappedOpenGL::glDrawElementsIndirect(GLenum mode, GLenum type, const void
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawElementsIndirect(mode, type, indirect));
 
@@ -1607,17 +1477,7 @@ void WrappedOpenGL::glDrawRangeElements(GLenum mode, GLuint start, GLuint end, G
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawRangeElements(mode, start, end, count, type, indices));
 
@@ -1693,17 +1553,7 @@ void WrappedOpenGL::glDrawRangeElementsBaseVertex(GLenum mode, GLuint start, GLu
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(
       GL.glDrawRangeElementsBaseVertex(mode, start, end, count, type, indices, basevertex));
@@ -1775,17 +1625,7 @@ void WrappedOpenGL::glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawElementsBaseVertex(mode, count, type, indices, basevertex));
 
@@ -1856,17 +1696,7 @@ void WrappedOpenGL::glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum t
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawElementsInstanced(mode, count, type, indices, instancecount));
 
@@ -1942,17 +1772,7 @@ void WrappedOpenGL::glDrawElementsInstancedBaseInstance(GLenum mode, GLsizei cou
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawElementsInstancedBaseInstance(mode, count, type, indices,
                                                              instancecount, baseinstance));
@@ -2030,17 +1850,7 @@ void WrappedOpenGL::glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(
       GL.glDrawElementsInstancedBaseVertex(mode, count, type, indices, instancecount, basevertex));
@@ -2119,17 +1929,7 @@ void WrappedOpenGL::glDrawElementsInstancedBaseVertexBaseInstance(GLenum mode, G
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glDrawElementsInstancedBaseVertexBaseInstance(
       mode, count, type, indices, instancecount, basevertex, baseinstance));
@@ -2266,17 +2066,7 @@ void WrappedOpenGL::glMultiDrawArrays(GLenum mode, const GLint *first, const GLs
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glMultiDrawArrays(mode, first, count, drawcount));
 
@@ -2433,17 +2223,7 @@ void WrappedOpenGL::glMultiDrawElements(GLenum mode, const GLsizei *count, GLenu
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glMultiDrawElements(mode, count, type, indices, drawcount));
 
@@ -2605,17 +2385,7 @@ void WrappedOpenGL::glMultiDrawElementsBaseVertex(GLenum mode, const GLsizei *co
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(
       GL.glMultiDrawElementsBaseVertex(mode, count, type, indices, drawcount, basevertex));
@@ -2822,17 +2592,7 @@ void WrappedOpenGL::glMultiDrawArraysIndirect(GLenum mode, const void *indirect,
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glMultiDrawArraysIndirect(mode, indirect, drawcount, stride));
 
@@ -3048,17 +2808,7 @@ void WrappedOpenGL::glMultiDrawElementsIndirect(GLenum mode, GLenum type, const
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride));
 
@@ -3275,17 +3025,7 @@ void WrappedOpenGL::glMultiDrawArraysIndirectCount(GLenum mode, const void *indi
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(
       GL.glMultiDrawArraysIndirectCount(mode, indirect, drawcount, maxdrawcount, stride));
@@ -3510,17 +3250,7 @@ void WrappedOpenGL::glMultiDrawElementsIndirectCount(GLenum mode, GLenum type, c
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(
       GL.glMultiDrawElementsIndirectCount(mode, type, indirect, drawcount, maxdrawcount, stride));
@@ -3619,21 +3349,11 @@ void WrappedOpenGL::glClearNamedFramebufferfv(GLuint framebuffer, GLenum buffer,
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-    GetResourceManager()->MarkFBOReferenced(FramebufferRes(GetCtx(), framebuffer),
-                                            eFrameRef_ReadBeforeWrite);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
+  MarkBoundResources();
+
+  if(IsCaptureMode(m_State))
     GetResourceManager()->MarkFBOReferenced(FramebufferRes(GetCtx(), framebuffer),
                                             eFrameRef_ReadBeforeWrite);
-  }
 
   SERIALISE_TIME_CALL(GL.glClearNamedFramebufferfv(framebuffer, buffer, drawbuffer, value));
 
@@ -3653,17 +3373,7 @@ void WrappedOpenGL::glClearBufferfv(GLenum buffer, GLint drawbuffer, const GLflo
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glClearBufferfv(buffer, drawbuffer, value));
 
@@ -3782,17 +3492,7 @@ void WrappedOpenGL::glClearBufferiv(GLenum buffer, GLint drawbuffer, const GLint
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glClearBufferiv(buffer, drawbuffer, value));
 
@@ -3899,17 +3599,7 @@ void WrappedOpenGL::glClearBufferuiv(GLenum buffer, GLint drawbuffer, const GLui
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glClearBufferuiv(buffer, drawbuffer, value));
 
@@ -4034,17 +3724,7 @@ void WrappedOpenGL::glClearBufferfi(GLenum buffer, GLint drawbuffer, GLfloat dep
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glClearBufferfi(buffer, drawbuffer, depth, stencil));
 
@@ -4174,17 +3854,7 @@ void WrappedOpenGL::glClearBufferData(GLenum target, GLenum internalformat, GLen
 {
   CoherentMapImplicitBarrier();
 
-  if(IsBackgroundCapturing(m_State))
-  {
-    GLRenderState state;
-    state.MarkDirty(this);
-  }
-  else if(IsActiveCapturing(m_State))
-  {
-    GLRenderState state;
-    state.FetchState(this);
-    state.MarkReferenced(this, false);
-  }
+  MarkBoundResources();
 
   SERIALISE_TIME_CALL(GL.glClearBufferData(target, internalformat, format, type, data));
 
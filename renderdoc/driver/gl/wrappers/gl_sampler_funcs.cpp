@@ -168,6 +168,8 @@ void WrappedOpenGL::glBindSampler(GLuint unit, GLuint sampler)
 {
   SERIALISE_TIME_CALL(GL.glBindSampler(unit, sampler));
 
+  GetCtxData().SetSamplerBinding(unit, sampler);
+
   if(IsActiveCapturing(m_State))
   {
     USE_SCRATCH_SERIALISER();
@@ -216,6 +218,9 @@ void WrappedOpenGL::glBindSamplers(GLuint first, GLsizei count, const GLuint *sa
 {
   SERIALISE_TIME_CALL(GL.glBindSamplers(first, count, samplers));
 
+  for(GLsizei i = 0; i < count; i++)
+    GetCtxData().SetSamplerBinding(first + i, samplers ? samplers[i] : 0);
+
   if(IsActiveCapturing(m_State))
   {
     USE_SCRATCH_SERIALISER();
@@ -630,6 +635,7 @@ void WrappedOpenGL::glDeleteSamplers(GLsizei n, const GLuint *ids)
   for(GLsizei i = 0; i < n; i++)
   {
     GLResource res = SamplerRes(GetCtx(), ids[i]);
+    GetCtxData().ClearDeletedNames(eResSampler, ids[i]);
     if(GetResourceManager()->HasCurrentResource(res))
     {
       if(GetResourceManager()->HasResourceRecord(res))
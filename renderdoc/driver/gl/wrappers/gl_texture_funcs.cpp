@@ -224,10 +224,15 @@ void WrappedOpenGL::glDeleteTextures(GLsizei n, const GLuint *textures)
   for(GLsizei i = 0; i < n; i++)
   {
     GLResource res = TextureRes(GetCtx(), textures[i]);
+    GetCtxData().ClearDeletedNames(eResTexture, textures[i]);
     if(GetResourceManager()->HasCurrentResource(res))
     {
       if(GetResourceManager()->HasResourceRecord(res))
-        GetResourceManager()->GetResourceRecord(res)->Delete(GetResourceManager());
+      {
+        GLResourceRecord *record = GetResourceManager()->GetResourceRecord(res);
+        ClearDeletedBindings(record);
+        record->Delete(GetResourceManager());
+      }
       GetResourceManager()->UnregisterResource(res);
     }
   }
@@ -592,6 +597,8 @@ void WrappedOpenGL::glBindImageTexture(GLuint unit, GLuint texture, GLint level,
 
   SERIALISE_TIME_CALL(GL.glBindImageTexture(unit, texture, level, layered, layer, access, format));
 
+  GetCtxData().SetImageBinding(unit, texture);
+
   if(IsActiveCapturing(m_State))
   {
     Chunk *chunk = NULL;
@@ -661,6 +668,9 @@ void WrappedOpenGL::glBindImageTextures(GLuint first, GLsizei count, const GLuin
 
   SERIALISE_TIME_CALL(GL.glBindImageTextures(first, count, textures));
 
+  for(GLsizei i = 0; i < count; i++)
+    GetCtxData().SetImageBinding(first + i, textures ? textures[i] : 0);
+
   if(IsActiveCapturing(m_State))
   {
     USE_SCRATCH_SERIALISER();
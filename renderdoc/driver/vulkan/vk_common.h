@@ -71,6 +71,10 @@
 // happening
 #define VERBOSE_PARTIAL_REPLAY OPTION_OFF
 
+// disable this to track device memory references with the std::map based Intervals instead of the
+// flat sorted array in FlatIntervals
+#define FLAT_MEMORY_REFS OPTION_ON
+
 ResourceFormat MakeResourceFormat(VkFormat fmt);
 VkFormat MakeVkFormat(ResourceFormat fmt);
 Topology MakePrimitiveTopology(VkPrimitiveTopology Topo, uint32_t patchControlPoints);
@@ -545,6 +545,83 @@ WriteSerialiser &WrappedVulkan::GetThreadSerialiser()
   return *ser;
 }
 
+bool WrappedVulkan::CanDeferCmd()
+{
+  // anything recorded while capturing is likely to be submitted, so serialise it straight away
+  if(!IsBackgroundCapturing(m_State))
+    return false;
+
+  // callstacks and debug messages are gathered when the chunk is serialised, so commands that
+  // need them can't be deferred
+  if(GetThreadSerialiser().GetChunkMetadataRecording() & WriteSerialiser::ChunkCallstack)
+    return false;
+
+  ScopedDebugMessageSink *sink = GetDebugMessageSink();
+  if(sink && !sink->msgs.empty())
+    return false;
+
+  return true;
+}
+
+void *WrappedVulkan::DeferCmd(VkResourceRecord *record, VulkanChunk chunk, size_t paramSize,
+                              DeferredCmdList::SerialiseCallback serialise)
+{
+  CACHE_THREAD_SERIALISER();
+
+  DeferredCmdList &deferred = record->cmdInfo->deferred;
+
+  DeferredCmdList::Cmd cmd;
+  cmd.serialise = serialise;
+  cmd.params = deferred.Alloc(paramSize);
+  cmd.chunk = chunk;
+  cmd.chunkID = record->ReserveChunkID();
+  cmd.threadID = Threading::GetCurrentID();
+  cmd.durationMicro = ser.ChunkMetadata().durationMicro;
+  cmd.timestampMicro = ser.ChunkMetadata().timestampMicro;
+
+  deferred.Add(cmd);
+
+  // the timings from SERIALISE_TIME_CALL would otherwise be picked up by the next chunk
+  ser.ChunkMetadata() = SDChunkMetaData();
+
+  return (void *)cmd.params;
+}
+
+void WrappedVulkan::FlushDeferredCmds(VkResourceRecord *record)
+{
+  DeferredCmdList &deferred = record->cmdInfo->deferred;
+
+  if(deferred.IsEmpty())
+    return;
+
+  CACHE_THREAD_SERIALISER();
+
+  // we're flushing in the middle of another call, so don't disturb its chunk metadata or pick up
+  // its debug messages. Deferred commands never had any messages of their own.
+  SDChunkMetaData metadata = ser.ChunkMetadata();
+  ScopedDebugMessageSink *sink = GetDebugMessageSink();
+  SetDebugMessageSink(NULL);
+
+  for(const DeferredCmdList::Cmd &cmd : deferred.GetCmds())
+  {
+    // restore the metadata from recording time, so the chunks are identical to if they had been
+    // serialised immediately
+    ser.ChunkMetadata().threadID = cmd.threadID;
+    ser.ChunkMetadata().durationMicro = cmd.durationMicro;
+    ser.ChunkMetadata().timestampMicro = cmd.timestampMicro;
+
+    SCOPED_SERIALISE_CHUNK(cmd.chunk);
+    cmd.serialise(this, ser, cmd.params);
+
+    record->AddChunk(scope.Get(), cmd.chunkID);
+  }
+
+  SetDebugMessageSink(sink);
+  ser.ChunkMetadata() = metadata;
+
+  deferred.Clear();
+}
+
 static VkResult FillPropertyCountAndList(const VkExtensionProperties *src, uint32_t numExts,
                                          uint32_t *dstCount, VkExtensionProperties *dstProps)
 {
@@ -2072,6 +2149,8 @@ void WrappedVulkan::AddResourceCurChunk(ResourceId id)
 
 ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
 {
+  ReplayProfiler::ScopedLoad profileLoad(m_ReplayProfiler);
+
   int sectionIdx = rdc->SectionIndex(SectionType::FrameCapture);
 
   GetResourceManager()->SetState(m_State);
@@ -2126,6 +2205,8 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
     uint64_t offsetStart = reader->GetOffset();
 
+    m_ReplayProfiler.BeginChunk(ser);
+
     VulkanChunk context = ser.ReadChunk<VulkanChunk>();
 
     chunkIdx++;
@@ -2137,6 +2218,8 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
     ser.EndChunk();
 
+    m_ReplayProfiler.EndChunk(ser, (uint32_t)context, offsetStart);
+
     if(reader->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -2238,6 +2321,8 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 {
   m_FrameReader->SetOffset(0);
 
+  ReplayProfiler::ScopedFrame profileFrame(m_ReplayProfiler, !partial);
+
   ReadSerialiser ser(m_FrameReader, Ownership::Nothing);
 
   ser.SetStringDatabase(&m_StringDB);
@@ -2330,6 +2415,8 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    m_ReplayProfiler.BeginChunk(ser);
+
     VulkanChunk chunktype = ser.ReadChunk<VulkanChunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -2343,6 +2430,8 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
     ser.EndChunk();
 
+    m_ReplayProfiler.EndChunk(ser, (uint32_t)chunktype, m_CurChunkOffset);
+
     if(ser.GetReader()->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -2446,6 +2535,8 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
 void WrappedVulkan::ApplyInitialContents()
 {
+  ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "ApplyInitialContents");
+
   // check that we have all external queues necessary
   for(size_t i = 0; i < m_ExternalQueues.size(); i++)
   {
@@ -3008,6 +3099,8 @@ bool WrappedVulkan::ProcessChunk(ReadSerialiser &ser, VulkanChunk chunk)
       }
       else if(system == SystemChunk::InitialContentsList)
       {
+        ReplayProfiler::ScopedPhase profilePhase(m_ReplayProfiler, "CreateInitialContents");
+
         GetResourceManager()->CreateInitialContents(ser);
 
         SERIALISE_CHECK_READ_ERRORS();
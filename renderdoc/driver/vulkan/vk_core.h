@@ -26,6 +26,7 @@
 
 #include <vector>
 #include "common/timing.h"
+#include "core/replay_profiler.h"
 #include "replay/replay_driver.h"
 #include "serialise/serialiser.h"
 #include "vk_common.h"
@@ -283,6 +284,11 @@ private:
   bool m_MarkedActive = false;
   uint32_t m_SubmitCounter = 0;
 
+  // incremented for every submit to give each one a unique epoch, so that per-submit processing of
+  // shared data (like descriptor sets bound in several command buffers) can be skipped if it's
+  // already been stamped with the current epoch.
+  int64_t m_SubmitEpoch = 0;
+
   uint64_t threadSerialiserTLSSlot;
 
   Threading::CriticalSection m_ThreadSerialisersLock;
@@ -354,6 +360,7 @@ private:
 
   std::vector<FrameDescription> m_CapturedFrames;
   FrameRecord m_FrameRecord;
+  ReplayProfiler m_ReplayProfiler;
   std::vector<DrawcallDescription *> m_Drawcalls;
 
   struct PhysicalDeviceData
@@ -807,6 +814,35 @@ private:
                                const VkIndirectRecordData &indirectcopy);
 
   WriteSerialiser &GetThreadSerialiser();
+
+  // commands recorded while background capturing can defer their serialisation until the command
+  // buffer is submitted in a captured frame, see DeferredCmdList. Params must be a trivially
+  // destructible struct with a Serialise(WrappedVulkan *, WriteSerialiser &) const function.
+  bool CanDeferCmd();
+  void *DeferCmd(VkResourceRecord *record, VulkanChunk chunk, size_t paramSize,
+                 DeferredCmdList::SerialiseCallback serialise);
+  template <typename Params>
+  static void SerialiseDeferredCmd(WrappedVulkan *driver, WriteSerialiser &ser, const void *params)
+  {
+    ((const Params *)params)->Serialise(driver, ser);
+  }
+  template <typename Params>
+  Params *DeferCmd(VkResourceRecord *record, VulkanChunk chunk)
+  {
+    return new(DeferCmd(record, chunk, sizeof(Params), &SerialiseDeferredCmd<Params>)) Params;
+  }
+  // copies an array parameter into the deferred storage for record's commands
+  template <typename T>
+  T *DeferArray(VkResourceRecord *record, const T *arr, uint32_t count)
+  {
+    if(arr == NULL || count == 0)
+      return NULL;
+    T *ret = (T *)record->cmdInfo->deferred.Alloc(sizeof(T) * count);
+    memcpy(ret, arr, sizeof(T) * count);
+    return ret;
+  }
+  void FlushDeferredCmds(VkResourceRecord *record);
+
   template <typename SerialiserType>
   bool Serialise_CaptureScope(SerialiserType &ser);
   bool HasSuccessfulCapture();
@@ -968,6 +1004,7 @@ public:
 
   SDFile &GetStructuredFile() { return *m_StructuredFile; }
   FrameRecord &GetFrameRecord() { return m_FrameRecord; }
+  ReplayProfiler &GetReplayProfiler() { return m_ReplayProfiler; }
   const APIEvent &GetEvent(uint32_t eventId);
   uint32_t GetMaxEID() { return m_Events.back().eventId; }
   const DrawcallDescription *GetDrawcall(uint32_t eventId);
@@ -50,6 +50,8 @@ struct CopyPixelParams;
 
 struct PixelHistoryResources;
 
+struct PixelRegionCopyParams;
+
 class VulkanResourceManager;
 
 class VulkanDebugManager
@@ -89,6 +91,16 @@ public:
 
   VkImageLayout GetImageLayout(ResourceId image, VkImageAspectFlags aspect, uint32_t mip);
 
+  void PixelHistoryCopyRegion(VkCommandBuffer cmd, const PixelRegionCopyParams &p,
+                              VkImageLayout layout, VkDeviceSize offset);
+  bool PixelHistorySnapshotRegion(VkCommandBuffer cmd, const PixelRegionCopyParams &p,
+                                  VkDeviceSize offset,
+                                  std::map<ResourceId, VkRenderPass> &resumePasses);
+
+  // the layout of an image subresource at the current point of replay, or UNDEFINED if unknown
+  VkImageLayout GetReplayImageLayout(VkCommandBuffer cmd, ResourceId image,
+                                     VkImageAspectFlags aspect, uint32_t mip, uint32_t layer);
+
   const VulkanCreationInfo::Image &GetImageInfo(ResourceId img);
 
 private:
@@ -439,7 +439,7 @@ bool VulkanResourceManager::Serialise_DeviceMemoryRefs(SerialiserType &ser,
 
       auto res = m_MemFrameRefs.insert(std::pair<ResourceId, MemRefs>(mem, MemRefs()));
       RDCASSERTMSG("MemRefIntervals for each memory resource must be contiguous", res.second);
-      Intervals<FrameRefType> &rangeRefs = res.first->second.rangeRefs;
+      FrameRefIntervals &rangeRefs = res.first->second.rangeRefs;
 
       auto it_ints = rangeRefs.begin();
       uint64_t last = 0;
@@ -538,7 +538,7 @@ void VulkanResourceManager::InsertDeviceMemoryRefs(WriteSerialiser &ser)
   for(auto it = m_MemFrameRefs.begin(); it != m_MemFrameRefs.end(); it++)
   {
     ResourceId mem = it->first;
-    Intervals<FrameRefType> &rangeRefs = it->second.rangeRefs;
+    FrameRefIntervals &rangeRefs = it->second.rangeRefs;
     for(auto jt = rangeRefs.begin(); jt != rangeRefs.end(); jt++)
       data.push_back({mem, jt->start(), jt->value()});
   }
@@ -23,11 +23,13 @@
 ******************************************************************************/
 
 #include <float.h>
+#include <set>
 #include <vector>
 #include "driver/shaders/spirv/spirv_editor.h"
 #include "driver/shaders/spirv/spirv_op_helpers.h"
 #include "driver/vulkan/vk_debug.h"
 #include "driver/vulkan/vk_replay.h"
+#include "maths/formatpacking.h"
 #include "vk_shader_cache.h"
 
 bool isDirectWrite(ResourceUsage usage)
@@ -1316,3 +1318,681 @@ std::vector<PixelModification> VulkanReplay::PixelHistory(std::vector<EventUsage
 }
 
 #endif
+
+struct PixelRegionCopyParams
+{
+  ResourceId image;
+  VkImage srcImage;
+  VkFormat srcImageFormat;
+  VkImageType imageType;
+  VkImageAspectFlags aspects;
+
+  uint32_t x, y, width, height;
+  uint32_t mip;
+  // for 3D textures the slice is a depth offset rather than an array layer
+  uint32_t arrayLayer;
+  uint32_t zOffset;
+
+  // size of a texel in the colour or depth aspect, and where the stencil aspect starts
+  uint32_t texelSize;
+  VkDeviceSize stencilOffset;
+
+  VkBuffer dstBuffer;
+};
+
+static bool RangeContains(const VkImageSubresourceRange &range, VkImageAspectFlags aspect,
+                          uint32_t mip, uint32_t layer)
+{
+  if((range.aspectMask & aspect) == 0)
+    return false;
+
+  if(mip < range.baseMipLevel ||
+     (range.levelCount != VK_REMAINING_MIP_LEVELS && mip >= range.baseMipLevel + range.levelCount))
+    return false;
+
+  if(layer < range.baseArrayLayer || (range.layerCount != VK_REMAINING_ARRAY_LAYERS &&
+                                      layer >= range.baseArrayLayer + range.layerCount))
+    return false;
+
+  return true;
+}
+
+VkImageLayout VulkanDebugManager::GetReplayImageLayout(VkCommandBuffer cmd, ResourceId image,
+                                                       VkImageAspectFlags aspect, uint32_t mip,
+                                                       uint32_t layer)
+{
+  // barriers already recorded in the command buffer being replayed take precedence over the
+  // layouts as of the last submission
+  if(cmd != VK_NULL_HANDLE)
+  {
+    auto cmdit = m_pDriver->m_BakedCmdBufferInfo.find(GetResID(cmd));
+    if(cmdit != m_pDriver->m_BakedCmdBufferInfo.end())
+    {
+      const std::vector<rdcpair<ResourceId, ImageRegionState>> &barriers =
+          cmdit->second.imgbarriers;
+      for(auto it = barriers.rbegin(); it != barriers.rend(); ++it)
+      {
+        if(it->first == image && it->second.newLayout != UNKNOWN_PREV_IMG_LAYOUT &&
+           RangeContains(it->second.subresourceRange, aspect, mip, layer))
+          return it->second.newLayout;
+      }
+    }
+  }
+
+  VkImageLayout ret = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  SCOPED_LOCK(m_pDriver->m_ImageLayoutsLock);
+
+  auto it = m_pDriver->m_ImageLayouts.find(image);
+  if(it == m_pDriver->m_ImageLayouts.end())
+    return ret;
+
+  for(const ImageRegionState &state : it->second.subresourceStates)
+  {
+    if(state.newLayout != UNKNOWN_PREV_IMG_LAYOUT &&
+       RangeContains(state.subresourceRange, aspect, mip, layer))
+      ret = state.newLayout;
+  }
+
+  return ret;
+}
+
+void VulkanDebugManager::PixelHistoryCopyRegion(VkCommandBuffer cmd, const PixelRegionCopyParams &p,
+                                                VkImageLayout layout, VkDeviceSize offset)
+{
+  VkBufferImageCopy regions[2] = {};
+  uint32_t regionCount = 0;
+
+  VkBufferImageCopy region = {};
+  region.bufferOffset = offset;
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, p.mip, p.arrayLayer, 1};
+  region.imageOffset = {int32_t(p.x), int32_t(p.y), int32_t(p.zOffset)};
+  region.imageExtent = {p.width, p.height, 1};
+
+  if(p.aspects & VK_IMAGE_ASPECT_COLOR_BIT)
+  {
+    regions[regionCount++] = region;
+  }
+  else
+  {
+    if(p.aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+    {
+      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+      regions[regionCount++] = region;
+    }
+    if(p.aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+    {
+      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT;
+      region.bufferOffset = offset + p.stencilOffset;
+      regions[regionCount++] = region;
+    }
+  }
+
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                  NULL,
+                                  VK_ACCESS_ALL_WRITE_BITS,
+                                  VK_ACCESS_TRANSFER_READ_BIT,
+                                  layout,
+                                  VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                  VK_QUEUE_FAMILY_IGNORED,
+                                  VK_QUEUE_FAMILY_IGNORED,
+                                  Unwrap(p.srcImage),
+                                  {p.aspects, p.mip, 1, p.arrayLayer, 1}};
+
+  SanitiseOldImageLayout(barrier.oldLayout);
+  DoPipelineBarrier(cmd, 1, &barrier);
+
+  ObjDisp(cmd)->CmdCopyImageToBuffer(Unwrap(cmd), Unwrap(p.srcImage),
+                                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Unwrap(p.dstBuffer),
+                                     regionCount, regions);
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  barrier.dstAccessMask = VK_ACCESS_ALL_READ_BITS | VK_ACCESS_ALL_WRITE_BITS;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  barrier.newLayout = layout;
+  SanitiseNewImageLayout(barrier.newLayout);
+  DoPipelineBarrier(cmd, 1, &barrier);
+}
+
+bool VulkanDebugManager::PixelHistorySnapshotRegion(
+    VkCommandBuffer cmd, const PixelRegionCopyParams &p, VkDeviceSize offset,
+    std::map<ResourceId, VkRenderPass> &resumePasses)
+{
+  if(!m_pDriver->IsDrawInRenderPass())
+  {
+    VkImageLayout layout = GetReplayImageLayout(cmd, p.image, p.aspects, p.mip, p.arrayLayer);
+
+    // nothing meaningful to read from an image with undefined contents
+    if(layout == VK_IMAGE_LAYOUT_UNDEFINED)
+      return false;
+
+    PixelHistoryCopyRegion(cmd, p, layout, offset);
+    return true;
+  }
+
+  const WrappedVulkan::BakedCmdBufferInfo::CmdBufferState &state =
+      m_pDriver->m_BakedCmdBufferInfo[m_pDriver->m_LastCmdBufferID].state;
+
+  // secondary command buffers don't know which render pass they execute in, and resuming partway
+  // through a multi-subpass render pass isn't possible.
+  if(state.renderPass == ResourceId())
+    return false;
+
+  VulkanCreationInfo &c = m_pDriver->m_CreationInfo;
+
+  const VulkanCreationInfo::RenderPass &rpinfo = c.m_RenderPass[state.renderPass];
+  const VulkanCreationInfo::Framebuffer &fbinfo = c.m_Framebuffer[state.framebuffer];
+
+  if(rpinfo.subpasses.size() != 1 || !rpinfo.subpasses[0].multiviews.empty() ||
+     rpinfo.subpasses[0].fragmentDensityAttachment != -1)
+    return false;
+
+  // copies can't happen inside a render pass, so we end it, copy, then resume with a compatible
+  // render pass that loads and stores every attachment. Bound state persists across render pass
+  // instances so the rest of the commands replay unchanged.
+  VkRenderPass &resume = resumePasses[state.renderPass];
+
+  if(resume == VK_NULL_HANDLE)
+  {
+    const VulkanCreationInfo::RenderPass::Subpass &sub = rpinfo.subpasses[0];
+
+    std::vector<VkAttachmentDescription> atts(rpinfo.attachments.size());
+    for(size_t i = 0; i < atts.size(); i++)
+    {
+      atts[i].flags = rpinfo.attachments[i].flags;
+      atts[i].format = rpinfo.attachments[i].format;
+      atts[i].samples = rpinfo.attachments[i].samples;
+      atts[i].loadOp = atts[i].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+      atts[i].storeOp = atts[i].stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+      atts[i].initialLayout = atts[i].finalLayout = rpinfo.attachments[i].finalLayout;
+      SanitiseNewImageLayout(atts[i].initialLayout);
+      SanitiseNewImageLayout(atts[i].finalLayout);
+    }
+
+    std::vector<VkAttachmentReference> inputs, colors, resolves;
+    for(size_t i = 0; i < sub.inputAttachments.size(); i++)
+      inputs.push_back({sub.inputAttachments[i], sub.inputLayouts[i]});
+    for(size_t i = 0; i < sub.colorAttachments.size(); i++)
+      colors.push_back({sub.colorAttachments[i], sub.colorLayouts[i]});
+    for(size_t i = 0; i < sub.resolveAttachments.size(); i++)
+      resolves.push_back({sub.resolveAttachments[i], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+
+    VkAttachmentReference ds = {(uint32_t)sub.depthstencilAttachment, sub.depthstencilLayout};
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.inputAttachmentCount = (uint32_t)inputs.size();
+    subpass.pInputAttachments = inputs.data();
+    subpass.colorAttachmentCount = (uint32_t)colors.size();
+    subpass.pColorAttachments = colors.data();
+    subpass.pResolveAttachments = resolves.empty() ? NULL : resolves.data();
+    subpass.pDepthStencilAttachment = sub.depthstencilAttachment == -1 ? NULL : &ds;
+
+    VkRenderPassCreateInfo rpCreateInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+    rpCreateInfo.attachmentCount = (uint32_t)atts.size();
+    rpCreateInfo.pAttachments = atts.data();
+    rpCreateInfo.subpassCount = 1;
+    rpCreateInfo.pSubpasses = &subpass;
+
+    VkResult vkr = m_pDriver->vkCreateRenderPass(m_Device, &rpCreateInfo, NULL, &resume);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
+  // once the render pass has ended, its attachments are in their final layouts
+  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  for(size_t i = 0; i < state.fbattachments.size() && i < rpinfo.attachments.size(); i++)
+  {
+    const VulkanCreationInfo::ImageView &viewinfo = c.m_ImageView[state.fbattachments[i]];
+    if(viewinfo.image == p.image && RangeContains(viewinfo.range, p.aspects, p.mip, p.arrayLayer))
+    {
+      layout = rpinfo.attachments[i].finalLayout;
+      SanitiseNewImageLayout(layout);
+    }
+  }
+
+  if(layout == VK_IMAGE_LAYOUT_UNDEFINED)
+    layout = GetReplayImageLayout(cmd, p.image, p.aspects, p.mip, p.arrayLayer);
+
+  ObjDisp(cmd)->CmdEndRenderPass(Unwrap(cmd));
+
+  if(layout != VK_IMAGE_LAYOUT_UNDEFINED)
+    PixelHistoryCopyRegion(cmd, p, layout, offset);
+
+  VkRenderPassBeginInfo rpbegin = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+  rpbegin.renderPass = Unwrap(resume);
+  rpbegin.framebuffer =
+      Unwrap(m_pDriver->GetResourceManager()->GetCurrentHandle<VkFramebuffer>(state.framebuffer));
+  rpbegin.renderArea.extent = {fbinfo.width, fbinfo.height};
+
+  VkRenderPassAttachmentBeginInfoKHR attachmentsInfo = {
+      VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO_KHR};
+  std::vector<VkImageView> views;
+
+  if(fbinfo.imageless)
+  {
+    for(ResourceId view : state.fbattachments)
+      views.push_back(Unwrap(m_pDriver->GetResourceManager()->GetCurrentHandle<VkImageView>(view)));
+
+    attachmentsInfo.attachmentCount = (uint32_t)views.size();
+    attachmentsInfo.pAttachments = views.data();
+    rpbegin.pNext = &attachmentsInfo;
+  }
+
+  ObjDisp(cmd)->CmdBeginRenderPass(Unwrap(cmd), &rpbegin, VK_SUBPASS_CONTENTS_INLINE);
+
+  return layout != VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+struct VulkanPixelRegionHistoryCallback : public VulkanDrawcallCallback
+{
+  VulkanPixelRegionHistoryCallback(WrappedVulkan *vk, const PixelRegionCopyParams &params,
+                                   VkDeviceSize snapshotSize, const std::vector<EventUsage> &events)
+      : m_pDriver(vk), m_Params(params), m_SnapshotSize(snapshotSize)
+  {
+    m_pDriver->SetDrawcallCB(this);
+    for(size_t i = 0; i < events.size(); i++)
+      m_EventIndex[events[i].eventId] = i;
+    m_Snapshotted.resize(events.size());
+  }
+  ~VulkanPixelRegionHistoryCallback()
+  {
+    m_pDriver->SetDrawcallCB(NULL);
+    for(auto it = m_ResumePasses.begin(); it != m_ResumePasses.end(); ++it)
+      m_pDriver->vkDestroyRenderPass(m_pDriver->GetDev(), it->second, NULL);
+  }
+
+  // each event gets two consecutive snapshots in the buffer, the region before and after it.
+  void Snapshot(uint32_t eid, VkCommandBuffer cmd, bool post)
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end())
+      return;
+
+    size_t idx = it->second;
+
+    if(post && !m_Snapshotted[idx])
+      return;
+
+    VkDeviceSize offset = m_SnapshotSize * (idx * 2 + (post ? 1 : 0));
+
+    m_Snapshotted[idx] = m_pDriver->GetDebugManager()->PixelHistorySnapshotRegion(
+        cmd, m_Params, offset, m_ResumePasses);
+  }
+
+  void PreDraw(uint32_t eid, VkCommandBuffer cmd) { Snapshot(eid, cmd, false); }
+  bool PostDraw(uint32_t eid, VkCommandBuffer cmd)
+  {
+    Snapshot(eid, cmd, true);
+    return false;
+  }
+  void PostRedraw(uint32_t eid, VkCommandBuffer cmd) {}
+  void PreDispatch(uint32_t eid, VkCommandBuffer cmd) { Snapshot(eid, cmd, false); }
+  bool PostDispatch(uint32_t eid, VkCommandBuffer cmd)
+  {
+    Snapshot(eid, cmd, true);
+    return false;
+  }
+  void PostRedispatch(uint32_t eid, VkCommandBuffer cmd) {}
+  void PreMisc(uint32_t eid, DrawFlags flags, VkCommandBuffer cmd) { Snapshot(eid, cmd, false); }
+  bool PostMisc(uint32_t eid, DrawFlags flags, VkCommandBuffer cmd)
+  {
+    Snapshot(eid, cmd, true);
+    return false;
+  }
+  void PostRemisc(uint32_t eid, DrawFlags flags, VkCommandBuffer cmd) {}
+  void PreEndCommandBuffer(VkCommandBuffer cmd) {}
+  void AliasEvent(uint32_t primary, uint32_t alias)
+  {
+    // a command buffer submitted more than once would overwrite the primary's snapshots on each
+    // submission, so treat all of its events as unknown.
+    auto it = m_EventIndex.find(primary);
+    if(it != m_EventIndex.end())
+      m_Aliased.insert(it->second);
+  }
+
+  bool IsSnapshotted(size_t idx) const
+  {
+    return m_Snapshotted[idx] && m_Aliased.find(idx) == m_Aliased.end();
+  }
+
+  WrappedVulkan *m_pDriver;
+  PixelRegionCopyParams m_Params;
+  VkDeviceSize m_SnapshotSize;
+  std::map<uint32_t, size_t> m_EventIndex;
+  std::vector<bool> m_Snapshotted;
+  std::set<size_t> m_Aliased;
+  std::map<ResourceId, VkRenderPass> m_ResumePasses;
+};
+
+static bool RegionPixelChanged(const byte *pre, const byte *post, const PixelRegionCopyParams &p,
+                               size_t pixel)
+{
+  if(memcmp(pre + pixel * p.texelSize, post + pixel * p.texelSize, p.texelSize) != 0)
+    return true;
+
+  if(p.aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+    return pre[p.stencilOffset + pixel] != post[p.stencilOffset + pixel];
+
+  return false;
+}
+
+static ModificationValue DecodeRegionPixel(const byte *data, const PixelRegionCopyParams &p,
+                                           const ResourceFormat &fmt, size_t pixel)
+{
+  ModificationValue ret;
+  RDCEraseEl(ret);
+  ret.depth = -1.0f;
+  ret.stencil = -1;
+
+  const byte *texel = data + pixel * p.texelSize;
+
+  if(p.aspects & VK_IMAGE_ASPECT_COLOR_BIT)
+  {
+    if(fmt.type == ResourceFormatType::R10G10B10A2)
+    {
+      Vec4f v = fmt.compType == CompType::SNorm ? ConvertFromR10G10B10A2SNorm(*(uint32_t *)texel)
+                                                : ConvertFromR10G10B10A2(*(uint32_t *)texel);
+      ret.col.floatValue[0] = v.x;
+      ret.col.floatValue[1] = v.y;
+      ret.col.floatValue[2] = v.z;
+      ret.col.floatValue[3] = v.w;
+    }
+    else if(fmt.type == ResourceFormatType::R11G11B10)
+    {
+      Vec3f v = ConvertFromR11G11B10(*(uint32_t *)texel);
+      ret.col.floatValue[0] = v.x;
+      ret.col.floatValue[1] = v.y;
+      ret.col.floatValue[2] = v.z;
+    }
+    else if(fmt.type == ResourceFormatType::Regular)
+    {
+      for(uint32_t c = 0; c < fmt.compCount; c++)
+      {
+        const byte *comp = texel + c * fmt.compByteWidth;
+
+        if(fmt.compType == CompType::UInt)
+        {
+          if(fmt.compByteWidth == 1)
+            ret.col.uintValue[c] = *comp;
+          else if(fmt.compByteWidth == 2)
+            ret.col.uintValue[c] = *(const uint16_t *)comp;
+          else
+            ret.col.uintValue[c] = *(const uint32_t *)comp;
+        }
+        else if(fmt.compType == CompType::SInt)
+        {
+          if(fmt.compByteWidth == 1)
+            ret.col.intValue[c] = *(const int8_t *)comp;
+          else if(fmt.compByteWidth == 2)
+            ret.col.intValue[c] = *(const int16_t *)comp;
+          else
+            ret.col.intValue[c] = *(const int32_t *)comp;
+        }
+        else
+        {
+          ret.col.floatValue[c] = ConvertComponent(fmt, comp);
+        }
+      }
+
+      if(fmt.BGRAOrder())
+        std::swap(ret.col.uintValue[0], ret.col.uintValue[2]);
+    }
+
+    return ret;
+  }
+
+  if(p.aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+  {
+    if(p.texelSize == 2)
+      ret.depth = float(*(const uint16_t *)texel) / 65535.0f;
+    else if(p.srcImageFormat == VK_FORMAT_D32_SFLOAT ||
+            p.srcImageFormat == VK_FORMAT_D32_SFLOAT_S8_UINT)
+      ret.depth = *(const float *)texel;
+    else
+      ret.depth = float(*(const uint32_t *)texel & 0xffffff) / 16777215.0f;
+  }
+
+  if(p.aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+    ret.stencil = data[p.stencilOffset + pixel];
+
+  return ret;
+}
+
+PixelRegionHistory VulkanReplay::PixelHistoryRegion(std::vector<EventUsage> events,
+                                                    ResourceId target, uint32_t x, uint32_t y,
+                                                    uint32_t width, uint32_t height, uint32_t slice,
+                                                    uint32_t mip, uint32_t sampleIdx,
+                                                    CompType typeHint)
+{
+  PixelRegionHistory history;
+  history.x = x;
+  history.y = y;
+  history.width = width;
+  history.height = height;
+
+  const uint32_t numPixels = width * height;
+
+  const VulkanCreationInfo::Image &imginfo = m_pDriver->m_CreationInfo.m_Image[target];
+
+  if(imginfo.samples != VK_SAMPLE_COUNT_1_BIT || IsBlockFormat(imginfo.format) ||
+     IsYUVFormat(imginfo.format))
+  {
+    RDCWARN("Region pixel history isn't supported for multisampled, block or YUV images");
+    history.offsets.resize(numPixels + 1);
+    return history;
+  }
+
+  PixelRegionCopyParams params = {};
+  params.image = target;
+  params.srcImage = GetResourceManager()->GetCurrentHandle<VkImage>(target);
+  params.srcImageFormat = imginfo.format;
+  params.imageType = imginfo.type;
+  params.aspects = FormatImageAspects(imginfo.format);
+  params.x = x;
+  params.y = y;
+  params.width = width;
+  params.height = height;
+  params.mip = mip;
+  params.arrayLayer = imginfo.type == VK_IMAGE_TYPE_3D ? 0 : slice;
+  params.zOffset = imginfo.type == VK_IMAGE_TYPE_3D ? slice : 0;
+
+  // pad each aspect to a multiple of 4 texels so that every copy into the snapshot buffer lands on
+  // an offset that is aligned both to the texel size and to 4 bytes.
+  const VkDeviceSize paddedTexels = AlignUp(numPixels, 4U);
+  VkDeviceSize snapshotSize = 0;
+
+  if(params.aspects & VK_IMAGE_ASPECT_COLOR_BIT)
+  {
+    params.texelSize = GetByteSize(1, 1, 1, imginfo.format, 0);
+    snapshotSize = paddedTexels * params.texelSize;
+  }
+  else
+  {
+    if(params.aspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+      params.texelSize = (imginfo.format == VK_FORMAT_D16_UNORM ||
+                          imginfo.format == VK_FORMAT_D16_UNORM_S8_UINT)
+                             ? 2
+                             : 4;
+    snapshotSize = paddedTexels * params.texelSize;
+    params.stencilOffset = snapshotSize;
+    if(params.aspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+      snapshotSize += paddedTexels;
+  }
+
+  ResourceFormat fmt = MakeResourceFormat(imginfo.format);
+  if(typeHint != CompType::Typeless)
+    fmt.compType = typeHint;
+
+  // every event is replayed with a copy of the region before and after it. Very long histories are
+  // split over several replays to bound the size of the readback buffer.
+  const VkDeviceSize maxReadbackSize = 256 * 1024 * 1024;
+  const size_t eventsPerBatch =
+      (size_t)RDCMAX(maxReadbackSize / (snapshotSize * 2), (VkDeviceSize)1);
+
+  // modifications are built per-pixel, then flattened at the end. Events we couldn't snapshot are
+  // always listed with their post-modification value taken from the next known value.
+  std::vector<std::vector<PixelModification>> pixelMods(numPixels);
+  std::vector<ModificationValue> lastValue(numPixels);
+  std::vector<size_t> pendingFrom(numPixels, ~0U);
+
+  for(ModificationValue &val : lastValue)
+  {
+    RDCEraseEl(val);
+    val.depth = -1.0f;
+    val.stencil = -1;
+  }
+
+  VkDevice dev = m_pDriver->GetDev();
+  const VkDevDispatchTable *vt = ObjDisp(dev);
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+  for(size_t batchStart = 0; batchStart < events.size(); batchStart += eventsPerBatch)
+  {
+    std::vector<EventUsage> batch(
+        events.begin() + batchStart,
+        events.begin() + RDCMIN(batchStart + eventsPerBatch, events.size()));
+
+    const bool lastBatch = batchStart + batch.size() == events.size();
+
+    // the last batch also reads back the region after all events, for resolving the final value of
+    // any trailing events that couldn't be snapshotted.
+    const VkDeviceSize finalOffset = snapshotSize * batch.size() * 2;
+
+    GPUBuffer readback;
+    readback.Create(m_pDriver, dev, finalOffset + (lastBatch ? snapshotSize : 0), 1,
+                    GPUBuffer::eGPUBufferReadback);
+
+    params.dstBuffer = readback.buf;
+
+    std::vector<bool> snapshotted(batch.size());
+
+    {
+      VulkanPixelRegionHistoryCallback cb(m_pDriver, params, snapshotSize, batch);
+
+      m_pDriver->ReplayLog(0, batch.back().eventId, eReplay_Full);
+
+      VkCommandBuffer cmd = m_pDriver->GetNextCmd();
+
+      VkResult vkr = vt->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+      if(lastBatch)
+      {
+        VkImageLayout layout = GetDebugManager()->GetReplayImageLayout(
+            VK_NULL_HANDLE, target, params.aspects, mip, params.arrayLayer);
+
+        if(layout != VK_IMAGE_LAYOUT_UNDEFINED)
+          GetDebugManager()->PixelHistoryCopyRegion(cmd, params, layout, finalOffset);
+      }
+
+      VkBufferMemoryBarrier bufBarrier = {
+          VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+          NULL,
+          VK_ACCESS_TRANSFER_WRITE_BIT,
+          VK_ACCESS_HOST_READ_BIT,
+          VK_QUEUE_FAMILY_IGNORED,
+          VK_QUEUE_FAMILY_IGNORED,
+          Unwrap(readback.buf),
+          0,
+          VK_WHOLE_SIZE,
+      };
+
+      DoPipelineBarrier(cmd, 1, &bufBarrier);
+
+      vkr = vt->EndCommandBuffer(Unwrap(cmd));
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+      m_pDriver->SubmitCmds();
+      m_pDriver->FlushQ();
+
+      for(size_t i = 0; i < batch.size(); i++)
+        snapshotted[i] = cb.IsSnapshotted(i);
+    }
+
+    const byte *data = (const byte *)readback.Map();
+
+    for(size_t i = 0; i < batch.size(); i++)
+    {
+      const uint32_t eid = batch[i].eventId;
+
+      PixelModification mod;
+      RDCEraseEl(mod);
+      mod.eventId = eid;
+      mod.directShaderWrite = isDirectWrite(batch[i].usage);
+      mod.shaderOut.depth = -1.0f;
+      mod.shaderOut.stencil = -1;
+
+      if(!snapshotted[i])
+      {
+        for(uint32_t p = 0; p < numPixels; p++)
+        {
+          mod.preMod = lastValue[p];
+          mod.postMod = lastValue[p];
+
+          if(pendingFrom[p] == ~0U)
+            pendingFrom[p] = pixelMods[p].size();
+
+          pixelMods[p].push_back(mod);
+        }
+
+        continue;
+      }
+
+      const byte *pre = data + snapshotSize * i * 2;
+      const byte *post = pre + snapshotSize;
+
+      const DrawcallDescription *draw = m_pDriver->GetDrawcall(eid);
+      const bool clear = draw && (draw->flags & DrawFlags::Clear);
+
+      for(uint32_t p = 0; p < numPixels; p++)
+      {
+        ModificationValue preValue = DecodeRegionPixel(pre, params, fmt, p);
+
+        // resolve any earlier events we couldn't snapshot to the value we now know they left
+        for(size_t m = pendingFrom[p]; m < pixelMods[p].size(); m++)
+          pixelMods[p][m].postMod = preValue;
+        pendingFrom[p] = ~0U;
+
+        lastValue[p] = DecodeRegionPixel(post, params, fmt, p);
+
+        if(!clear && !RegionPixelChanged(pre, post, params, p))
+          continue;
+
+        mod.preMod = preValue;
+        mod.postMod = lastValue[p];
+        pixelMods[p].push_back(mod);
+      }
+    }
+
+    if(lastBatch)
+    {
+      const byte *finalData = data + finalOffset;
+
+      for(uint32_t p = 0; p < numPixels; p++)
+      {
+        if(pendingFrom[p] == ~0U)
+          continue;
+
+        ModificationValue finalValue = DecodeRegionPixel(finalData, params, fmt, p);
+
+        for(size_t m = pendingFrom[p]; m < pixelMods[p].size(); m++)
+          pixelMods[p][m].postMod = finalValue;
+      }
+    }
+
+    readback.Unmap();
+    readback.Destroy();
+  }
+
+  history.offsets.reserve(numPixels + 1);
+  history.offsets.push_back(0);
+
+  for(uint32_t p = 0; p < numPixels; p++)
+  {
+    history.modifications.append(pixelMods[p].data(), pixelMods[p].size());
+    history.offsets.push_back((uint32_t)history.modifications.size());
+  }
+
+  return history;
+}
@@ -2174,15 +2174,13 @@ void VulkanReplay::FetchVSOut(uint32_t eventId)
             }
             else
             {
-              while(src < origVBEnd && dst < dstEnd)
-              {
-                bool valid = false;
-                FloatVector vec = HighlightCache::InterpretVertex(src, 0, 0, fmt, origVBEnd, valid);
+              size_t numVerts = (dstEnd - dst) / sizeof(FloatVector);
+              if(stride > 0)
+                numVerts = RDCMIN(numVerts, size_t(origVBEnd - src + stride - 1) / stride);
 
-                memcpy(dst, &vec, sizeof(FloatVector));
-                dst += sizeof(FloatVector);
-                src += stride;
-              }
+              bool valid = false;
+              HighlightCache::InterpretVertices(src, 0, (uint32_t)numVerts, (uint32_t)stride, fmt,
+                                                origVBEnd, (FloatVector *)dst, valid);
             }
           }
         }
@@ -197,6 +197,15 @@ void VulkanReplay::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
   m_pDriver->ReplayLog(0, endEventID, replayType);
 }
 
+ReplayProfile VulkanReplay::ProfileReplay()
+{
+  m_pDriver->GetReplayProfiler().RequestProfile();
+
+  ReplayLog(~0U, eReplay_Full);
+
+  return m_pDriver->GetReplayProfiler().GetProfile(&WrappedVulkan::GetChunkName);
+}
+
 const SDFile &VulkanReplay::GetStructuredFile()
 {
   return m_pDriver->GetStructuredFile();
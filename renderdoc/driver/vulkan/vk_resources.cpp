@@ -3160,6 +3160,40 @@ void ImgRefs::Split(bool splitAspects, bool splitLevels, bool splitLayers)
   areLayersSplit = newSplitLayerCount > 1;
 }
 
+void *DeferredCmdList::Alloc(size_t size)
+{
+  size = AlignUp16(size);
+
+  // oversized allocations get their own page, inserted before the current one so that it can
+  // continue to be allocated from
+  if(size > PageSize)
+  {
+    byte *page = new byte[size];
+    m_Pages.insert(m_Pages.empty() ? m_Pages.end() : m_Pages.end() - 1, page);
+    return page;
+  }
+
+  if(m_PageUsed + size > PageSize)
+  {
+    m_Pages.push_back(new byte[PageSize]);
+    m_PageUsed = 0;
+  }
+
+  void *ret = m_Pages.back() + m_PageUsed;
+  m_PageUsed += size;
+  return ret;
+}
+
+void DeferredCmdList::Clear()
+{
+  for(byte *page : m_Pages)
+    delete[] page;
+
+  m_Pages.clear();
+  m_PageUsed = PageSize;
+  m_Cmds.clear();
+}
+
 VkResourceRecord::~VkResourceRecord()
 {
   VkResourceType resType = Resource != NULL ? IdentifyTypeByPtr(Resource) : eResUnknown;
@@ -961,6 +961,60 @@ struct ResourceInfo
 struct MemRefs;
 struct ImgRefs;
 
+class WrappedVulkan;
+
+// while background capturing most command buffers are never submitted inside a captured frame, so
+// rather than serialising every command as it's recorded the common ones store their parameters
+// here, and are only serialised into chunks if the command buffer is submitted while capturing.
+// Handles are stored as-is and only resolved to IDs at that point.
+class DeferredCmdList
+{
+public:
+  typedef void (*SerialiseCallback)(WrappedVulkan *driver, WriteSerialiser &ser,
+                                    const void *params);
+
+  struct Cmd
+  {
+    SerialiseCallback serialise;
+    const void *params;
+    VulkanChunk chunk;
+    // the chunk's place in the record, reserved when the command was recorded
+    int32_t chunkID;
+    // chunk metadata from when the command was recorded
+    uint64_t threadID;
+    int64_t durationMicro;
+    int64_t timestampMicro;
+  };
+
+  DeferredCmdList() = default;
+  ~DeferredCmdList() { Clear(); }
+  DeferredCmdList(const DeferredCmdList &) = delete;
+  DeferredCmdList &operator=(const DeferredCmdList &) = delete;
+
+  // returns storage for parameters, valid until the list is cleared. The storage is never
+  // destructed so only trivially destructible types should be placed in it.
+  void *Alloc(size_t size);
+
+  void Add(const Cmd &cmd) { m_Cmds.push_back(cmd); }
+  const std::vector<Cmd> &GetCmds() const { return m_Cmds; }
+  bool IsEmpty() const { return m_Cmds.empty(); }
+  void Clear();
+  void swap(DeferredCmdList &other)
+  {
+    m_Cmds.swap(other.m_Cmds);
+    m_Pages.swap(other.m_Pages);
+    std::swap(m_PageUsed, other.m_PageUsed);
+  }
+
+private:
+  static const size_t PageSize = 4096;
+
+  std::vector<Cmd> m_Cmds;
+  // parameter storage. Only the last page is ever allocated from
+  std::vector<byte *> m_Pages;
+  size_t m_PageUsed = PageSize;
+};
+
 struct CmdBufferRecordingInfo
 {
   VkDevice device;
@@ -993,6 +1047,9 @@ struct CmdBufferRecordingInfo
   std::map<ResourceId, ImgRefs> imgFrameRefs;
   std::map<ResourceId, MemRefs> memFrameRefs;
 
+  // commands that haven't been serialised yet, see DeferredCmdList
+  DeferredCmdList deferred;
+
   // AdvanceFrame/Present should be called after this buffer is submitted
   bool present;
 };
@@ -1027,6 +1084,37 @@ struct DescriptorSetData
   std::map<ResourceId, rdcpair<uint32_t, FrameRefType> > bindFrameRefs;
   std::map<ResourceId, MemRefs> bindMemRefs;
   std::map<ResourceId, ImgRefs> bindImgRefs;
+
+  // incremented whenever bindFrameRefs is modified
+  uint32_t bindFrameRefsGeneration = 0;
+
+  // the submit epoch that this set was last processed in, so that sets bound in multiple command
+  // buffers in one submit are only processed once.
+  int64_t submitEpoch = 0;
+
+  // returns the resources in bindFrameRefs that are written. This is cached in a flat array and
+  // only rebuilt if bindFrameRefs has changed, since with large sets most descriptors are read-only
+  // and the full map is expensive to walk on every submit.
+  // Must be called with refLock held.
+  const std::vector<ResourceId> &GetWrittenRefs()
+  {
+    if(writtenRefsGeneration != bindFrameRefsGeneration)
+    {
+      writtenRefs.clear();
+      for(auto it = bindFrameRefs.begin(); it != bindFrameRefs.end(); ++it)
+      {
+        if(it->second.second == eFrameRef_PartialWrite ||
+           it->second.second == eFrameRef_ReadBeforeWrite)
+          writtenRefs.push_back(it->first);
+      }
+      writtenRefsGeneration = bindFrameRefsGeneration;
+    }
+
+    return writtenRefs;
+  }
+
+  std::vector<ResourceId> writtenRefs;
+  uint32_t writtenRefsGeneration = ~0U;
 };
 
 struct PipelineLayoutData
@@ -1321,9 +1409,15 @@ FrameRefType ImgRefs::Merge(const ImgRefs &other, Compose comp)
   return maxRefType;
 }
 
+#if ENABLED(FLAT_MEMORY_REFS)
+typedef FlatIntervals<FrameRefType> FrameRefIntervals;
+#else
+typedef Intervals<FrameRefType> FrameRefIntervals;
+#endif
+
 struct MemRefs
 {
-  Intervals<FrameRefType> rangeRefs;
+  FrameRefIntervals rangeRefs;
   WrappedVkRes *initializedLiveRes;
   inline MemRefs() : initializedLiveRes(NULL) {}
   inline MemRefs(VkDeviceSize offset, VkDeviceSize size, FrameRefType refType)
@@ -1444,6 +1538,7 @@ public:
     cmdInfo->sparse.swap(bakedCommands->cmdInfo->sparse);
     cmdInfo->imgFrameRefs.swap(bakedCommands->cmdInfo->imgFrameRefs);
     cmdInfo->memFrameRefs.swap(bakedCommands->cmdInfo->memFrameRefs);
+    cmdInfo->deferred.swap(bakedCommands->cmdInfo->deferred);
   }
 
   void AddBindFrameRef(ResourceId id, FrameRefType ref, bool hasSparse = false)
@@ -1453,6 +1548,7 @@ public:
       RDCERR("Unexpected NULL resource ID being added as a bind frame ref");
       return;
     }
+    descInfo->bindFrameRefsGeneration++;
     rdcpair<uint32_t, FrameRefType> &p = descInfo->bindFrameRefs[id];
     if((p.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
     {
@@ -1475,6 +1571,7 @@ public:
     if(view->baseResourceMem != ResourceId())
       AddBindFrameRef(view->baseResourceMem, eFrameRef_Read, false);
 
+    descInfo->bindFrameRefsGeneration++;
     rdcpair<uint32_t, FrameRefType> &p = descInfo->bindFrameRefs[view->baseResource];
     if((p.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
     {
@@ -1503,6 +1600,7 @@ public:
       RDCERR("Unexpected NULL resource ID being added as a bind frame ref");
       return;
     }
+    descInfo->bindFrameRefsGeneration++;
     rdcpair<uint32_t, FrameRefType> &p = descInfo->bindFrameRefs[mem];
     if((p.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
     {
@@ -1535,6 +1633,7 @@ public:
     if(it == descInfo->bindFrameRefs.end())
       return;
 
+    descInfo->bindFrameRefsGeneration++;
     it->second.first--;
 
     if((it->second.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
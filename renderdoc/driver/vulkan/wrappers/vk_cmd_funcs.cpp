@@ -2141,6 +2141,18 @@ bool WrappedVulkan::Serialise_vkCmdBindPipeline(SerialiserType &ser, VkCommandBu
   return true;
 }
 
+struct DeferredCmdBindPipeline
+{
+  VkCommandBuffer commandBuffer;
+  VkPipelineBindPoint pipelineBindPoint;
+  VkPipeline pipeline;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdBindPipeline(ser, commandBuffer, pipelineBindPoint, pipeline);
+  }
+};
+
 void WrappedVulkan::vkCmdBindPipeline(VkCommandBuffer commandBuffer,
                                       VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline)
 {
@@ -2154,12 +2166,21 @@ void WrappedVulkan::vkCmdBindPipeline(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdBindPipeline>(record, VulkanChunk::vkCmdBindPipeline) = {
+          commandBuffer, pipelineBindPoint, pipeline,
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindPipeline);
-    Serialise_vkCmdBindPipeline(ser, commandBuffer, pipelineBindPoint, pipeline);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindPipeline);
+      Serialise_vkCmdBindPipeline(ser, commandBuffer, pipelineBindPoint, pipeline);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(pipeline), eFrameRef_Read);
   }
 }
@@ -2386,6 +2407,21 @@ bool WrappedVulkan::Serialise_vkCmdBindVertexBuffers(SerialiserType &ser,
   return true;
 }
 
+struct DeferredCmdBindVertexBuffers
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t firstBinding;
+  uint32_t bindingCount;
+  const VkBuffer *pBuffers;
+  const VkDeviceSize *pOffsets;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdBindVertexBuffers(ser, commandBuffer, firstBinding, bindingCount,
+                                             pBuffers, pOffsets);
+  }
+};
+
 void WrappedVulkan::vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding,
                                            uint32_t bindingCount, const VkBuffer *pBuffers,
                                            const VkDeviceSize *pOffsets)
@@ -2400,13 +2436,23 @@ void WrappedVulkan::vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdBindVertexBuffers>(record, VulkanChunk::vkCmdBindVertexBuffers) = {
+          commandBuffer, firstBinding, bindingCount, DeferArray(record, pBuffers, bindingCount),
+          DeferArray(record, pOffsets, bindingCount),
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindVertexBuffers);
-    Serialise_vkCmdBindVertexBuffers(ser, commandBuffer, firstBinding, bindingCount, pBuffers,
-                                     pOffsets);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindVertexBuffers);
+      Serialise_vkCmdBindVertexBuffers(ser, commandBuffer, firstBinding, bindingCount, pBuffers,
+                                       pOffsets);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     for(uint32_t i = 0; i < bindingCount; i++)
     {
       record->MarkBufferFrameReferenced(GetRecord(pBuffers[i]), pOffsets[i], VK_WHOLE_SIZE,
@@ -2475,6 +2521,19 @@ bool WrappedVulkan::Serialise_vkCmdBindIndexBuffer(SerialiserType &ser,
   return true;
 }
 
+struct DeferredCmdBindIndexBuffer
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+  VkIndexType indexType;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdBindIndexBuffer(ser, commandBuffer, buffer, offset, indexType);
+  }
+};
+
 void WrappedVulkan::vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                          VkDeviceSize offset, VkIndexType indexType)
 {
@@ -2488,12 +2547,21 @@ void WrappedVulkan::vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdBindIndexBuffer>(record, VulkanChunk::vkCmdBindIndexBuffer) = {
+          commandBuffer, buffer, offset, indexType,
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindIndexBuffer);
-    Serialise_vkCmdBindIndexBuffer(ser, commandBuffer, buffer, offset, indexType);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindIndexBuffer);
+      Serialise_vkCmdBindIndexBuffer(ser, commandBuffer, buffer, offset, indexType);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkBufferFrameReferenced(GetRecord(buffer), 0, VK_WHOLE_SIZE, eFrameRef_Read);
   }
 }
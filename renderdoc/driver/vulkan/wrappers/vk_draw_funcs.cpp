@@ -250,6 +250,21 @@ bool WrappedVulkan::Serialise_vkCmdDraw(SerialiserType &ser, VkCommandBuffer com
   return true;
 }
 
+struct DeferredCmdDraw
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t vertexCount;
+  uint32_t instanceCount;
+  uint32_t firstVertex;
+  uint32_t firstInstance;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdDraw(ser, commandBuffer, vertexCount, instanceCount, firstVertex,
+                                firstInstance);
+  }
+};
+
 void WrappedVulkan::vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount,
                               uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
 {
@@ -263,13 +278,23 @@ void WrappedVulkan::vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCoun
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdDraw>(record, VulkanChunk::vkCmdDraw) = {
+          commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance,
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDraw);
-    Serialise_vkCmdDraw(ser, commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDraw);
+      Serialise_vkCmdDraw(ser, commandBuffer, vertexCount, instanceCount, firstVertex,
+                          firstInstance);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -350,6 +375,22 @@ bool WrappedVulkan::Serialise_vkCmdDrawIndexed(SerialiserType &ser, VkCommandBuf
   return true;
 }
 
+struct DeferredCmdDrawIndexed
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t indexCount;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t vertexOffset;
+  uint32_t firstInstance;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdDrawIndexed(ser, commandBuffer, indexCount, instanceCount, firstIndex,
+                                       vertexOffset, firstInstance);
+  }
+};
+
 void WrappedVulkan::vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount,
                                      uint32_t instanceCount, uint32_t firstIndex,
                                      int32_t vertexOffset, uint32_t firstInstance)
@@ -364,14 +405,23 @@ void WrappedVulkan::vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t ind
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdDrawIndexed>(record, VulkanChunk::vkCmdDrawIndexed) = {
+          commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance,
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexed);
-    Serialise_vkCmdDrawIndexed(ser, commandBuffer, indexCount, instanceCount, firstIndex,
-                               vertexOffset, firstInstance);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexed);
+      Serialise_vkCmdDrawIndexed(ser, commandBuffer, indexCount, instanceCount, firstIndex,
+                                 vertexOffset, firstInstance);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -717,6 +767,20 @@ bool WrappedVulkan::Serialise_vkCmdDrawIndirect(SerialiserType &ser, VkCommandBu
   return true;
 }
 
+struct DeferredCmdDrawIndirect
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+  uint32_t count;
+  uint32_t stride;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdDrawIndirect(ser, commandBuffer, buffer, offset, count, stride);
+  }
+};
+
 void WrappedVulkan::vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                       VkDeviceSize offset, uint32_t count, uint32_t stride)
 {
@@ -730,13 +794,22 @@ void WrappedVulkan::vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer bu
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdDrawIndirect>(record, VulkanChunk::vkCmdDrawIndirect) = {
+          commandBuffer, buffer, offset, count, stride,
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndirect);
-    Serialise_vkCmdDrawIndirect(ser, commandBuffer, buffer, offset, count, stride);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndirect);
+      Serialise_vkCmdDrawIndirect(ser, commandBuffer, buffer, offset, count, stride);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     VkDeviceSize size = 0;
     if(count > 0)
@@ -1098,6 +1171,20 @@ bool WrappedVulkan::Serialise_vkCmdDrawIndexedIndirect(SerialiserType &ser,
   return true;
 }
 
+struct DeferredCmdDrawIndexedIndirect
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+  uint32_t count;
+  uint32_t stride;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdDrawIndexedIndirect(ser, commandBuffer, buffer, offset, count, stride);
+  }
+};
+
 void WrappedVulkan::vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                              VkDeviceSize offset, uint32_t count, uint32_t stride)
 {
@@ -1111,13 +1198,22 @@ void WrappedVulkan::vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBu
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdDrawIndexedIndirect>(record, VulkanChunk::vkCmdDrawIndexedIndirect) = {
+          commandBuffer, buffer, offset, count, stride,
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexedIndirect);
-    Serialise_vkCmdDrawIndexedIndirect(ser, commandBuffer, buffer, offset, count, stride);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexedIndirect);
+      Serialise_vkCmdDrawIndexedIndirect(ser, commandBuffer, buffer, offset, count, stride);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     VkDeviceSize size = 0;
     if(count > 0)
@@ -1185,6 +1281,19 @@ bool WrappedVulkan::Serialise_vkCmdDispatch(SerialiserType &ser, VkCommandBuffer
   return true;
 }
 
+struct DeferredCmdDispatch
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t x;
+  uint32_t y;
+  uint32_t z;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdDispatch(ser, commandBuffer, x, y, z);
+  }
+};
+
 void WrappedVulkan::vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t x, uint32_t y, uint32_t z)
 {
   SCOPED_DBG_SINK();
@@ -1195,13 +1304,20 @@ void WrappedVulkan::vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t x, uin
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdDispatch>(record, VulkanChunk::vkCmdDispatch) = {commandBuffer, x, y, z};
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatch);
-    Serialise_vkCmdDispatch(ser, commandBuffer, x, y, z);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatch);
+      Serialise_vkCmdDispatch(ser, commandBuffer, x, y, z);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
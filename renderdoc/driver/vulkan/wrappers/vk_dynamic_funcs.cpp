@@ -71,6 +71,20 @@ bool WrappedVulkan::Serialise_vkCmdSetViewport(SerialiserType &ser, VkCommandBuf
   return true;
 }
 
+struct DeferredCmdSetViewport
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t firstViewport;
+  uint32_t viewportCount;
+  const VkViewport *pViewports;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdSetViewport(ser, commandBuffer, firstViewport, viewportCount,
+                                       pViewports);
+  }
+};
+
 void WrappedVulkan::vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport,
                                      uint32_t viewportCount, const VkViewport *pViewports)
 {
@@ -84,12 +98,22 @@ void WrappedVulkan::vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t fir
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdSetViewport>(record, VulkanChunk::vkCmdSetViewport) = {
+          commandBuffer, firstViewport, viewportCount,
+          DeferArray(record, pViewports, viewportCount),
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetViewport);
-    Serialise_vkCmdSetViewport(ser, commandBuffer, firstViewport, viewportCount, pViewports);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetViewport);
+      Serialise_vkCmdSetViewport(ser, commandBuffer, firstViewport, viewportCount, pViewports);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -139,6 +163,19 @@ bool WrappedVulkan::Serialise_vkCmdSetScissor(SerialiserType &ser, VkCommandBuff
   return true;
 }
 
+struct DeferredCmdSetScissor
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t firstScissor;
+  uint32_t scissorCount;
+  const VkRect2D *pScissors;
+
+  void Serialise(WrappedVulkan *driver, WriteSerialiser &ser) const
+  {
+    driver->Serialise_vkCmdSetScissor(ser, commandBuffer, firstScissor, scissorCount, pScissors);
+  }
+};
+
 void WrappedVulkan::vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor,
                                     uint32_t scissorCount, const VkRect2D *pScissors)
 {
@@ -152,12 +189,21 @@ void WrappedVulkan::vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firs
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(CanDeferCmd())
+    {
+      *DeferCmd<DeferredCmdSetScissor>(record, VulkanChunk::vkCmdSetScissor) = {
+          commandBuffer, firstScissor, scissorCount, DeferArray(record, pScissors, scissorCount),
+      };
+    }
+    else
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetScissor);
-    Serialise_vkCmdSetScissor(ser, commandBuffer, firstScissor, scissorCount, pScissors);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetScissor);
+      Serialise_vkCmdSetScissor(ser, commandBuffer, firstScissor, scissorCount, pScissors);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -808,7 +808,22 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
     bool capframe = IsActiveCapturing(m_State);
 
-    std::set<ResourceId> refdIDs;
+    const int64_t submitEpoch = Atomic::Inc64(&m_SubmitEpoch);
+
+    // coherent maps only need to be flushed if they're referenced by this submit. Rather than
+    // gathering every referenced ID, we check each mapped memory against the references as we go
+    std::vector<VkResourceRecord *> maps;
+    std::vector<bool> mapsReferenced;
+
+    if(capframe)
+    {
+      {
+        SCOPED_LOCK(m_CoherentMapsLock);
+        maps = m_CoherentMaps;
+      }
+
+      mapsReferenced.resize(maps.size());
+    }
 
     VkResourceRecord *queueRecord = GetRecord(queue);
 
@@ -844,17 +859,19 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
           SCOPED_LOCK(setrecord->descInfo->refLock);
 
-          const std::map<ResourceId, rdcpair<uint32_t, FrameRefType>> &frameRefs =
-              setrecord->descInfo->bindFrameRefs;
+          // marking dirty is idempotent, so if this set has already been processed in this submit
+          // there's no need to do it again
+          if(setrecord->descInfo->submitEpoch == submitEpoch)
+            continue;
+
+          setrecord->descInfo->submitEpoch = submitEpoch;
+
+          const std::vector<ResourceId> &writtenRefs = setrecord->descInfo->GetWrittenRefs();
 
-          for(auto refit = frameRefs.begin(); refit != frameRefs.end(); ++refit)
+          for(auto refit = writtenRefs.begin(); refit != writtenRefs.end(); ++refit)
           {
-            if(refit->second.second == eFrameRef_PartialWrite ||
-               refit->second.second == eFrameRef_ReadBeforeWrite)
-            {
-              if(GetResourceManager()->HasCurrentResource(refit->first))
-                GetResourceManager()->MarkDirtyResource(refit->first);
-            }
+            if(GetResourceManager()->HasCurrentResource(*refit))
+              GetResourceManager()->MarkDirtyResource(*refit);
           }
         }
 
@@ -871,10 +888,16 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
             SCOPED_LOCK(setrecord->descInfo->refLock);
 
+            const std::map<ResourceId, rdcpair<uint32_t, FrameRefType>> &frameRefs =
+                setrecord->descInfo->bindFrameRefs;
+
+            for(size_t m = 0; m < maps.size(); m++)
+              if(!mapsReferenced[m])
+                mapsReferenced[m] = frameRefs.find(maps[m]->GetResourceID()) != frameRefs.end();
+
             for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
                 refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
             {
-              refdIDs.insert(refit->first);
               GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
 
               if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
@@ -895,7 +918,10 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
           // pull in frame refs from this baked command buffer
           record->bakedCommands->AddResourceReferences(GetResourceManager());
-          record->bakedCommands->AddReferencedIDs(refdIDs);
+          for(size_t m = 0; m < maps.size(); m++)
+            if(!mapsReferenced[m])
+              mapsReferenced[m] =
+                  record->bakedCommands->IsFrameReferenced(maps[m]->GetResourceID());
 
           GetResourceManager()->MergeReferencedImages(record->bakedCommands->cmdInfo->imgFrameRefs);
           GetResourceManager()->MergeReferencedMemory(record->bakedCommands->cmdInfo->memFrameRefs);
@@ -906,9 +932,13 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
           for(size_t sub = 0; sub < record->bakedCommands->cmdInfo->subcmds.size(); sub++)
           {
-            record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands->AddResourceReferences(
-                GetResourceManager());
-            record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands->AddReferencedIDs(refdIDs);
+            VkResourceRecord *subrecord = record->bakedCommands->cmdInfo->subcmds[sub];
+
+            subrecord->bakedCommands->AddResourceReferences(GetResourceManager());
+            for(size_t m = 0; m < maps.size(); m++)
+              if(!mapsReferenced[m])
+                mapsReferenced[m] =
+                    subrecord->bakedCommands->IsFrameReferenced(maps[m]->GetResourceID());
             GetResourceManager()->MergeReferencedImages(
                 record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands->cmdInfo->imgFrameRefs);
             GetResourceManager()->MergeReferencedMemory(
@@ -922,6 +952,13 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
           {
             SCOPED_LOCK(m_CmdBufferRecordsLock);
+
+            // now that the commands are needed, serialise any that were deferred. This is under
+            // the lock in case a secondary is submitted from multiple threads.
+            FlushDeferredCmds(record->bakedCommands);
+            for(size_t sub = 0; sub < record->bakedCommands->cmdInfo->subcmds.size(); sub++)
+              FlushDeferredCmds(record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands);
+
             m_CmdBufferRecords.push_back(record->bakedCommands);
             for(size_t sub = 0; sub < record->bakedCommands->cmdInfo->subcmds.size(); sub++)
               m_CmdBufferRecords.push_back(
@@ -942,22 +979,16 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
       if(fence != VK_NULL_HANDLE)
         GetResourceManager()->MarkResourceFrameReferenced(GetResID(fence), eFrameRef_Read);
 
-      std::vector<VkResourceRecord *> maps;
-      {
-        SCOPED_LOCK(m_CoherentMapsLock);
-        maps = m_CoherentMaps;
-      }
-
-      for(auto it = maps.begin(); it != maps.end(); ++it)
+      for(size_t m = 0; m < maps.size(); m++)
       {
-        VkResourceRecord *record = *it;
+        VkResourceRecord *record = maps[m];
         MemMapState &state = *record->memMapState;
 
         // potential persistent map
         if(state.mapCoherent && state.mappedPtr && !state.mapFlushed)
         {
           // only need to flush memory that could affect this submitted batch of work
-          if(refdIDs.find(record->GetResourceID()) == refdIDs.end())
+          if(!mapsReferenced[m])
           {
             RDCDEBUG("Map of memory %llu not referenced in this queue - not flushing",
                      record->GetResourceID());
@@ -25,8 +25,17 @@
 #include "formatpacking.h"
 #include <float.h>
 #include <math.h>
+#include <string.h>
+#include "api/replay/renderdoc_replay.h"
 #include "common/common.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FORMAT_DECODE_SSE2 OPTION_ON
+#else
+#define FORMAT_DECODE_SSE2 OPTION_OFF
+#endif
+
 Vec3f ConvertFromR11G11B10(uint32_t data)
 {
   uint32_t mantissas[3] = {
@@ -142,6 +151,719 @@ uint32_t ConvertToR11G11B10(Vec3f data)
          uint32_t(exponents[0]) << 6 | uint32_t(exponents[1]) << 17 | uint32_t(exponents[2]) << 27;
 }
 
+float ConvertComponent(const ResourceFormat &fmt, const byte *data)
+{
+  if(fmt.compByteWidth == 8)
+  {
+    // we just downcast
+    const uint64_t *u64 = (const uint64_t *)data;
+    const int64_t *i64 = (const int64_t *)data;
+
+    if(fmt.compType == CompType::Double || fmt.compType == CompType::Float)
+    {
+      return float(*(const double *)u64);
+    }
+    else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
+    {
+      return float(*u64);
+    }
+    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
+    {
+      return float(*i64);
+    }
+  }
+  else if(fmt.compByteWidth == 4)
+  {
+    const uint32_t *u32 = (const uint32_t *)data;
+    const int32_t *i32 = (const int32_t *)data;
+
+    if(fmt.compType == CompType::Float || fmt.compType == CompType::Depth)
+    {
+      return *(const float *)u32;
+    }
+    else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
+    {
+      return float(*u32);
+    }
+    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
+    {
+      return float(*i32);
+    }
+  }
+  else if(fmt.compByteWidth == 3 && fmt.compType == CompType::Depth)
+  {
+    // 24-bit depth is a weird edge case we need to assemble it by hand
+    const uint8_t *u8 = (const uint8_t *)data;
+
+    uint32_t depth = 0;
+    depth |= uint32_t(u8[1]);
+    depth |= uint32_t(u8[2]) << 8;
+    depth |= uint32_t(u8[3]) << 16;
+
+    return float(depth) / float(16777215.0f);
+  }
+  else if(fmt.compByteWidth == 2)
+  {
+    const uint16_t *u16 = (const uint16_t *)data;
+    const int16_t *i16 = (const int16_t *)data;
+
+    if(fmt.compType == CompType::Float)
+    {
+      return ConvertFromHalf(*u16);
+    }
+    else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
+    {
+      return float(*u16);
+    }
+    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
+    {
+      return float(*i16);
+    }
+    // 16-bit depth is UNORM
+    else if(fmt.compType == CompType::UNorm || fmt.compType == CompType::Depth)
+    {
+      return float(*u16) / 65535.0f;
+    }
+    else if(fmt.compType == CompType::SNorm)
+    {
+      float f = -1.0f;
+
+      if(*i16 == -32768)
+        f = -1.0f;
+      else
+        f = ((float)*i16) / 32767.0f;
+
+      return f;
+    }
+  }
+  else if(fmt.compByteWidth == 1)
+  {
+    const uint8_t *u8 = (const uint8_t *)data;
+    const int8_t *i8 = (const int8_t *)data;
+
+    if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
+    {
+      return float(*u8);
+    }
+    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
+    {
+      return float(*i8);
+    }
+    else if(fmt.compType == CompType::UNormSRGB)
+    {
+      return SRGB8_lookuptable[*u8];
+    }
+    else if(fmt.compType == CompType::UNorm)
+    {
+      return float(*u8) / 255.0f;
+    }
+    else if(fmt.compType == CompType::SNorm)
+    {
+      float f = -1.0f;
+
+      if(*i8 == -128)
+        f = -1.0f;
+      else
+        f = ((float)*i8) / 127.0f;
+
+      return f;
+    }
+  }
+
+  RDCERR("Unexpected format to convert from %u %u", fmt.compByteWidth, fmt.compType);
+
+  return 0.0f;
+}
+
+// per-component conversions for regular formats, used to instantiate the batch decoders below.
+// These must give exactly the same results as ConvertComponent.
+struct Float64Component
+{
+  typedef double type;
+  static float Convert(double v) { return float(v); }
+};
+
+struct UInt64Component
+{
+  typedef uint64_t type;
+  static float Convert(uint64_t v) { return float(v); }
+};
+
+struct SInt64Component
+{
+  typedef int64_t type;
+  static float Convert(int64_t v) { return float(v); }
+};
+
+struct Float32Component
+{
+  typedef float type;
+  static float Convert(float v) { return v; }
+};
+
+struct UInt32Component
+{
+  typedef uint32_t type;
+  static float Convert(uint32_t v) { return float(v); }
+};
+
+struct SInt32Component
+{
+  typedef int32_t type;
+  static float Convert(int32_t v) { return float(v); }
+};
+
+struct HalfComponent
+{
+  typedef uint16_t type;
+  static float Convert(uint16_t v) { return ConvertFromHalf(v); }
+};
+
+struct UInt16Component
+{
+  typedef uint16_t type;
+  static float Convert(uint16_t v) { return float(v); }
+};
+
+struct SInt16Component
+{
+  typedef int16_t type;
+  static float Convert(int16_t v) { return float(v); }
+};
+
+struct UNorm16Component
+{
+  typedef uint16_t type;
+  static float Convert(uint16_t v) { return float(v) / 65535.0f; }
+};
+
+struct SNorm16Component
+{
+  typedef int16_t type;
+  static float Convert(int16_t v) { return v == -32768 ? -1.0f : float(v) / 32767.0f; }
+};
+
+struct UInt8Component
+{
+  typedef uint8_t type;
+  static float Convert(uint8_t v) { return float(v); }
+};
+
+struct SInt8Component
+{
+  typedef int8_t type;
+  static float Convert(int8_t v) { return float(v); }
+};
+
+struct SRGB8Component
+{
+  typedef uint8_t type;
+  static float Convert(uint8_t v) { return SRGB8_lookuptable[v]; }
+};
+
+struct UNorm8Component
+{
+  typedef uint8_t type;
+  static float Convert(uint8_t v) { return float(v) / 255.0f; }
+};
+
+struct SNorm8Component
+{
+  typedef int8_t type;
+  static float Convert(int8_t v) { return v == -128 ? -1.0f : float(v) / 127.0f; }
+};
+
+typedef void (*FloatDecoder)(const byte *data, uint32_t stride, size_t count, Vec4f *out);
+
+template <typename Component, uint32_t N>
+static void DecodeRegular(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    typename Component::type comps[N];
+    memcpy(comps, data + i * stride, sizeof(comps));
+
+    out[i] = Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+
+    float *o = &out[i].x;
+    for(uint32_t c = 0; c < N; c++)
+      o[c] = Component::Convert(comps[c]);
+  }
+}
+
+template <typename Component>
+static FloatDecoder GetRegularDecoder(uint32_t compCount)
+{
+  static const FloatDecoder decoders[] = {
+      &DecodeRegular<Component, 1>, &DecodeRegular<Component, 2>, &DecodeRegular<Component, 3>,
+      &DecodeRegular<Component, 4>,
+  };
+
+  return decoders[compCount - 1];
+}
+
+#if ENABLED(FORMAT_DECODE_SSE2)
+
+// RGBA8 is by far the most common format to decode
+template <>
+void DecodeRegular<UNorm8Component, 4>(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  const __m128i zero = _mm_setzero_si128();
+  // divide rather than multiplying by the reciprocal, to match the scalar conversion exactly
+  const __m128 scale = _mm_set1_ps(255.0f);
+
+  for(size_t i = 0; i < count; i++)
+  {
+    int32_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+
+    __m128i v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+
+    _mm_storeu_ps(&out[i].x, _mm_div_ps(_mm_cvtepi32_ps(v), scale));
+  }
+}
+
+// converts 4 halfs at a time, by re-biasing the exponent with a float multiply which also takes
+// care of subnormals. Gives the same results as ConvertFromHalf except for NaN payloads.
+template <uint32_t N>
+static void DecodeHalfSSE2(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i expMantMask = _mm_set1_epi32(0x7fff);
+  const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+  const __m128i infNanThreshold = _mm_set1_epi32(0x7bff);
+  const __m128i infNanExp = _mm_set1_epi32(255 << 23);
+
+  for(size_t i = 0; i < count; i++)
+  {
+    uint16_t comps[4] = {};
+    memcpy(comps, data + i * stride, sizeof(uint16_t) * N);
+
+    __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)comps), zero);
+
+    __m128i expMant = _mm_and_si128(h, expMantMask);
+    __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMant), 16);
+
+    // ConvertFromHalf returns +0 for -0
+    sign = _mm_andnot_si128(_mm_cmpeq_epi32(expMant, zero), sign);
+
+    __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)), magic);
+
+    __m128i infNan = _mm_and_si128(_mm_cmpgt_epi32(expMant, infNanThreshold), infNanExp);
+
+    __m128 result = _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNan)));
+
+    _mm_storeu_ps(&out[i].x, result);
+
+    float *o = &out[i].x;
+    for(uint32_t c = N; c < 4; c++)
+      o[c] = (c == 3) ? 1.0f : 0.0f;
+  }
+}
+
+template <>
+FloatDecoder GetRegularDecoder<HalfComponent>(uint32_t compCount)
+{
+  static const FloatDecoder decoders[] = {
+      &DecodeHalfSSE2<1>, &DecodeHalfSSE2<2>, &DecodeHalfSSE2<3>, &DecodeHalfSSE2<4>,
+  };
+
+  return decoders[compCount - 1];
+}
+
+#endif
+
+// 24-bit depth is assembled by hand, the same as ConvertComponent
+static void DecodeDepth24(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    const byte *u8 = data + i * stride;
+
+    uint32_t depth = uint32_t(u8[1]) | uint32_t(u8[2]) << 8 | uint32_t(u8[3]) << 16;
+
+    out[i] = Vec4f(float(depth) / float(16777215.0f), 0.0f, 0.0f, 1.0f);
+  }
+}
+
+static void DecodeR10G10B10A2UNorm(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+#if ENABLED(FORMAT_DECODE_SSE2)
+  // SSE2 has no per-lane shifts, so mask each component in place and scale it back down by a power
+  // of two, which is exact. Alpha is shifted down on the scalar side to keep the lane positive.
+  const __m128i mask = _mm_set_epi32(0x3, 0x3ff << 20, 0x3ff << 10, 0x3ff);
+  const __m128 shift = _mm_set_ps(1.0f, 1.0f / float(1 << 20), 1.0f / float(1 << 10), 1.0f);
+  const __m128 scale = _mm_set_ps(3.0f, 1023.0f, 1023.0f, 1023.0f);
+
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+
+    __m128i v = _mm_and_si128(
+        _mm_set_epi32(int(packed >> 30), int(packed), int(packed), int(packed)), mask);
+
+    _mm_storeu_ps(&out[i].x, _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), shift), scale));
+  }
+#else
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+    out[i] = ConvertFromR10G10B10A2(packed);
+  }
+#endif
+}
+
+static void DecodeR10G10B10A2SNorm(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+    out[i] = ConvertFromR10G10B10A2SNorm(packed);
+  }
+}
+
+template <bool Signed>
+static void DecodeR10G10B10A2Int(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+
+    int32_t r = int32_t(packed >> 0) & 0x3ff;
+    int32_t g = int32_t(packed >> 10) & 0x3ff;
+    int32_t b = int32_t(packed >> 20) & 0x3ff;
+    int32_t a = int32_t(packed >> 30) & 0x3;
+
+    if(Signed)
+    {
+      r = r >= 512 ? r - 1024 : r;
+      g = g >= 512 ? g - 1024 : g;
+      b = b >= 512 ? b - 1024 : b;
+      a = a >= 2 ? a - 4 : a;
+    }
+
+    out[i] = Vec4f(float(r), float(g), float(b), float(a));
+  }
+}
+
+static void DecodeR11G11B10(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+
+    Vec3f v = ConvertFromR11G11B10(packed);
+    out[i] = Vec4f(v.x, v.y, v.z, 1.0f);
+  }
+}
+
+static void DecodeR5G6B5(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint16_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+
+    Vec3f v = ConvertFromB5G6R5(packed);
+    out[i] = Vec4f(v.x, v.y, v.z, 1.0f);
+  }
+}
+
+static void DecodeR5G5B5A1(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint16_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+    out[i] = ConvertFromB5G5R5A1(packed);
+  }
+}
+
+static void DecodeR4G4B4A4(const byte *data, uint32_t stride, size_t count, Vec4f *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint16_t packed;
+    memcpy(&packed, data + i * stride, sizeof(packed));
+    out[i] = ConvertFromB4G4R4A4(packed);
+  }
+}
+
+static FloatDecoder GetFloatDecoder(const ResourceFormat &fmt)
+{
+  const CompType type = fmt.compType;
+
+  switch(fmt.type)
+  {
+    case ResourceFormatType::Regular: break;
+    case ResourceFormatType::R10G10B10A2:
+      if(type == CompType::SNorm)
+        return &DecodeR10G10B10A2SNorm;
+      if(type == CompType::UInt || type == CompType::UScaled)
+        return &DecodeR10G10B10A2Int<false>;
+      if(type == CompType::SInt || type == CompType::SScaled)
+        return &DecodeR10G10B10A2Int<true>;
+      return &DecodeR10G10B10A2UNorm;
+    case ResourceFormatType::R11G11B10: return &DecodeR11G11B10;
+    case ResourceFormatType::R5G6B5: return &DecodeR5G6B5;
+    case ResourceFormatType::R5G5B5A1: return &DecodeR5G5B5A1;
+    case ResourceFormatType::R4G4B4A4: return &DecodeR4G4B4A4;
+    default: return NULL;
+  }
+
+  const uint32_t n = fmt.compCount;
+
+  if(n == 0 || n > 4)
+    return NULL;
+
+  if(fmt.compByteWidth == 8)
+  {
+    if(type == CompType::Double || type == CompType::Float)
+      return GetRegularDecoder<Float64Component>(n);
+    else if(type == CompType::UInt || type == CompType::UScaled)
+      return GetRegularDecoder<UInt64Component>(n);
+    else if(type == CompType::SInt || type == CompType::SScaled)
+      return GetRegularDecoder<SInt64Component>(n);
+  }
+  else if(fmt.compByteWidth == 4)
+  {
+    if(type == CompType::Float || type == CompType::Depth)
+      return GetRegularDecoder<Float32Component>(n);
+    else if(type == CompType::UInt || type == CompType::UScaled)
+      return GetRegularDecoder<UInt32Component>(n);
+    else if(type == CompType::SInt || type == CompType::SScaled)
+      return GetRegularDecoder<SInt32Component>(n);
+  }
+  else if(fmt.compByteWidth == 3 && type == CompType::Depth && n == 1)
+  {
+    return &DecodeDepth24;
+  }
+  else if(fmt.compByteWidth == 2)
+  {
+    if(type == CompType::Float)
+      return GetRegularDecoder<HalfComponent>(n);
+    else if(type == CompType::UInt || type == CompType::UScaled)
+      return GetRegularDecoder<UInt16Component>(n);
+    else if(type == CompType::SInt || type == CompType::SScaled)
+      return GetRegularDecoder<SInt16Component>(n);
+    else if(type == CompType::UNorm || type == CompType::Depth)
+      return GetRegularDecoder<UNorm16Component>(n);
+    else if(type == CompType::SNorm)
+      return GetRegularDecoder<SNorm16Component>(n);
+  }
+  else if(fmt.compByteWidth == 1)
+  {
+    if(type == CompType::UInt || type == CompType::UScaled)
+      return GetRegularDecoder<UInt8Component>(n);
+    else if(type == CompType::SInt || type == CompType::SScaled)
+      return GetRegularDecoder<SInt8Component>(n);
+    else if(type == CompType::UNormSRGB)
+      return GetRegularDecoder<SRGB8Component>(n);
+    else if(type == CompType::UNorm)
+      return GetRegularDecoder<UNorm8Component>(n);
+    else if(type == CompType::SNorm)
+      return GetRegularDecoder<SNorm8Component>(n);
+  }
+
+  return NULL;
+}
+
+// bit layouts of the packed formats, for the integer decoders
+struct PackedLayout
+{
+  uint32_t byteSize;
+  uint32_t numFields;
+  uint32_t shift[4];
+  uint32_t bits[4];
+};
+
+static const PackedLayout *GetPackedLayout(ResourceFormatType type)
+{
+  static const PackedLayout r10g10b10a2 = {4, 4, {0, 10, 20, 30}, {10, 10, 10, 2}};
+  static const PackedLayout r11g11b10 = {4, 3, {0, 11, 22, 0}, {11, 11, 10, 0}};
+  static const PackedLayout r5g6b5 = {2, 3, {0, 5, 11, 0}, {5, 6, 5, 0}};
+  static const PackedLayout r5g5b5a1 = {2, 4, {0, 5, 10, 15}, {5, 5, 5, 1}};
+  static const PackedLayout r4g4b4a4 = {2, 4, {0, 4, 8, 12}, {4, 4, 4, 4}};
+
+  switch(type)
+  {
+    case ResourceFormatType::R10G10B10A2: return &r10g10b10a2;
+    case ResourceFormatType::R11G11B10: return &r11g11b10;
+    case ResourceFormatType::R5G6B5: return &r5g6b5;
+    case ResourceFormatType::R5G5B5A1: return &r5g5b5a1;
+    case ResourceFormatType::R4G4B4A4: return &r4g4b4a4;
+    default: return NULL;
+  }
+}
+
+template <typename Vec, bool Signed>
+static void DecodePackedInteger(const PackedLayout &layout, const byte *data, uint32_t stride,
+                                size_t count, Vec *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t packed = 0;
+    memcpy(&packed, data + i * stride, layout.byteSize);
+
+    out[i] = Vec(0, 0, 0, 1);
+
+    auto *o = &out[i].x;
+    for(uint32_t f = 0; f < layout.numFields; f++)
+    {
+      uint32_t field = (packed >> layout.shift[f]) & ((1U << layout.bits[f]) - 1);
+
+      if(Signed && (field & (1U << (layout.bits[f] - 1))))
+        field -= 1U << layout.bits[f];
+
+      o[f] = decltype(out->x)(field);
+    }
+  }
+}
+
+template <typename Vec, typename T, uint32_t N>
+static void DecodeRegularInteger(const byte *data, uint32_t stride, size_t count, Vec *out)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    T comps[N];
+    memcpy(comps, data + i * stride, sizeof(comps));
+
+    out[i] = Vec(0, 0, 0, 1);
+
+    auto *o = &out[i].x;
+    for(uint32_t c = 0; c < N; c++)
+      o[c] = decltype(out->x)(comps[c]);
+  }
+}
+
+template <typename Vec, typename T>
+static void DecodeRegularInteger(uint32_t compCount, const byte *data, uint32_t stride,
+                                 size_t count, Vec *out)
+{
+  switch(compCount)
+  {
+    case 1: DecodeRegularInteger<Vec, T, 1>(data, stride, count, out); break;
+    case 2: DecodeRegularInteger<Vec, T, 2>(data, stride, count, out); break;
+    case 3: DecodeRegularInteger<Vec, T, 3>(data, stride, count, out); break;
+    case 4: DecodeRegularInteger<Vec, T, 4>(data, stride, count, out); break;
+    default: break;
+  }
+}
+
+template <typename Vec>
+static void SwizzleBGRA(size_t count, Vec *out)
+{
+  for(size_t i = 0; i < count; i++)
+    std::swap(out[i].x, out[i].z);
+}
+
+template <typename Vec>
+static void FillDefault(size_t count, Vec *out)
+{
+  for(size_t i = 0; i < count; i++)
+    out[i] = Vec(0, 0, 0, 1);
+}
+
+template <typename Vec, typename T8, typename T16, typename T32, typename T64, bool Signed>
+static bool DecodeIntegerElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                                  size_t count, Vec *out)
+{
+  const PackedLayout *layout = GetPackedLayout(fmt.type);
+
+  if(layout)
+  {
+    DecodePackedInteger<Vec, Signed>(*layout, data, stride, count, out);
+  }
+  else if(fmt.type != ResourceFormatType::Regular || fmt.compCount == 0 || fmt.compCount > 4)
+  {
+    FillDefault(count, out);
+    return false;
+  }
+  else if(fmt.compByteWidth == 8)
+  {
+    // wider components are truncated
+    DecodeRegularInteger<Vec, T64>(fmt.compCount, data, stride, count, out);
+  }
+  else if(fmt.compByteWidth == 4)
+  {
+    DecodeRegularInteger<Vec, T32>(fmt.compCount, data, stride, count, out);
+  }
+  else if(fmt.compByteWidth == 2)
+  {
+    DecodeRegularInteger<Vec, T16>(fmt.compCount, data, stride, count, out);
+  }
+  else if(fmt.compByteWidth == 1)
+  {
+    DecodeRegularInteger<Vec, T8>(fmt.compCount, data, stride, count, out);
+  }
+  else
+  {
+    FillDefault(count, out);
+    return false;
+  }
+
+  if(fmt.BGRAOrder())
+    SwizzleBGRA(count, out);
+
+  return true;
+}
+
+uint32_t GetFormattedElementSize(const ResourceFormat &fmt)
+{
+  const PackedLayout *layout = GetPackedLayout(fmt.type);
+
+  if(layout)
+    return layout->byteSize;
+
+  if(fmt.type != ResourceFormatType::Regular)
+    return 0;
+
+  // 24-bit depth is read from a 32-bit texel
+  if(fmt.compByteWidth == 3 && fmt.compType == CompType::Depth)
+    return 4;
+
+  return fmt.compCount * fmt.compByteWidth;
+}
+
+bool DecodeFormattedElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                             size_t count, Vec4f *out)
+{
+  FloatDecoder decoder = GetFloatDecoder(fmt);
+
+  if(decoder == NULL)
+  {
+    RDCERR("Unexpected format to decode %s", fmt.Name().c_str());
+    FillDefault(count, out);
+    return false;
+  }
+
+  decoder(data, stride, count, out);
+
+  if(fmt.BGRAOrder())
+    SwizzleBGRA(count, out);
+
+  return true;
+}
+
+bool DecodeFormattedElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                             size_t count, Vec4u *out)
+{
+  return DecodeIntegerElements<Vec4u, uint8_t, uint16_t, uint32_t, uint64_t, false>(
+      fmt, data, stride, count, out);
+}
+
+bool DecodeFormattedElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                             size_t count, Vec4i *out)
+{
+  return DecodeIntegerElements<Vec4i, int8_t, int16_t, int32_t, int64_t, true>(fmt, data, stride,
+                                                                               count, out);
+}
+
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #undef None
@@ -456,4 +1178,383 @@ TEST_CASE("Check format conversion", "[format]")
   };
 }
 
+static bool SameFloat(float a, float b)
+{
+  if(std::isnan(a) || std::isnan(b))
+    return std::isnan(a) && std::isnan(b);
+
+  return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static ResourceFormat MakeFormat(ResourceFormatType type, CompType compType, uint8_t compCount,
+                                 uint8_t compByteWidth)
+{
+  ResourceFormat fmt;
+  fmt.type = type;
+  fmt.compType = compType;
+  fmt.compCount = compCount;
+  fmt.compByteWidth = compByteWidth;
+  return fmt;
+}
+
+TEST_CASE("Check batch format decoding", "[format]")
+{
+  SECTION("Regular formats match ConvertComponent")
+  {
+    const rdcpair<uint8_t, CompType> formats[] = {
+        {8, CompType::Double}, {8, CompType::UInt},     {8, CompType::SInt},
+        {4, CompType::Float},  {4, CompType::Depth},    {4, CompType::UInt},
+        {4, CompType::SInt},   {4, CompType::UScaled},  {4, CompType::SScaled},
+        {2, CompType::Float},  {2, CompType::UInt},     {2, CompType::SInt},
+        {2, CompType::UNorm},  {2, CompType::SNorm},    {2, CompType::Depth},
+        {1, CompType::UInt},   {1, CompType::SInt},     {1, CompType::UNorm},
+        {1, CompType::SNorm},  {1, CompType::UNormSRGB}, {1, CompType::UScaled},
+    };
+
+    // fill with a pattern that isn't aligned to any component boundary
+    bytebuf data;
+    data.resize(4096);
+    for(size_t i = 0; i < data.size(); i++)
+      data[i] = byte((i * 37 + 11) ^ (i >> 3));
+
+    for(const rdcpair<uint8_t, CompType> &f : formats)
+    {
+      for(uint8_t compCount = 1; compCount <= 4; compCount++)
+      {
+        for(bool bgra : {false, true})
+        {
+          if(bgra && (compCount != 4 || f.first != 1))
+            continue;
+
+          ResourceFormat fmt =
+              MakeFormat(ResourceFormatType::Regular, f.second, compCount, f.first);
+          fmt.SetBGRAOrder(bgra);
+
+          INFO(fmt.Name().c_str());
+
+          const uint32_t elemSize = GetFormattedElementSize(fmt);
+          CHECK(elemSize == uint32_t(compCount) * f.first);
+
+          // deliberately odd stride
+          const uint32_t stride = elemSize + 3;
+          const size_t count = (data.size() - elemSize) / stride;
+
+          rdcarray<Vec4f> out;
+          out.resize(count);
+
+          CHECK(DecodeFormattedElements(fmt, data.data(), stride, count, out.data()));
+
+          bool match = true;
+
+          for(size_t i = 0; i < count; i++)
+          {
+            float expected[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            for(uint8_t c = 0; c < compCount; c++)
+              expected[c] = ConvertComponent(fmt, data.data() + i * stride + c * f.first);
+
+            if(bgra)
+              std::swap(expected[0], expected[2]);
+
+            const float *o = &out[i].x;
+            for(int c = 0; c < 4; c++)
+              match &= SameFloat(o[c], expected[c]);
+          }
+
+          CHECK(match);
+        }
+      }
+    }
+  };
+
+  SECTION("Every 8-bit and 16-bit value matches ConvertComponent")
+  {
+    bytebuf data;
+    data.resize(65536 * 2);
+    for(uint32_t i = 0; i < 65536; i++)
+      memcpy(&data[i * 2], &i, 2);
+
+    const CompType types16[] = {CompType::Float, CompType::UInt, CompType::SInt, CompType::UNorm,
+                                CompType::SNorm};
+
+    for(CompType t : types16)
+    {
+      for(uint8_t compCount = 1; compCount <= 4; compCount++)
+      {
+        ResourceFormat fmt = MakeFormat(ResourceFormatType::Regular, t, compCount, 2);
+
+        INFO(fmt.Name().c_str());
+
+        // step one component at a time so every value lands in every lane
+        const size_t count = 65536 - compCount + 1;
+
+        rdcarray<Vec4f> out;
+        out.resize(count);
+
+        CHECK(DecodeFormattedElements(fmt, data.data(), 2, count, out.data()));
+
+        bool match = true;
+
+        for(size_t i = 0; i < count; i++)
+        {
+          const float *o = &out[i].x;
+          for(uint8_t c = 0; c < compCount; c++)
+            match &= SameFloat(o[c], ConvertComponent(fmt, &data[(i + c) * 2]));
+          for(uint8_t c = compCount; c < 4; c++)
+            match &= (o[c] == (c == 3 ? 1.0f : 0.0f));
+        }
+
+        CHECK(match);
+      }
+    }
+
+    const CompType types8[] = {CompType::UInt, CompType::SInt, CompType::UNorm, CompType::SNorm,
+                               CompType::UNormSRGB};
+
+    for(CompType t : types8)
+    {
+      for(uint8_t compCount = 1; compCount <= 4; compCount++)
+      {
+        ResourceFormat fmt = MakeFormat(ResourceFormatType::Regular, t, compCount, 1);
+
+        INFO(fmt.Name().c_str());
+
+        // the low bytes of the 16-bit ramp cover every 8-bit value in each lane
+        const size_t count = 1024;
+
+        rdcarray<Vec4f> out;
+        out.resize(count);
+
+        CHECK(DecodeFormattedElements(fmt, data.data(), 1, count, out.data()));
+
+        bool match = true;
+
+        for(size_t i = 0; i < count; i++)
+        {
+          const float *o = &out[i].x;
+          for(uint8_t c = 0; c < compCount; c++)
+            match &= SameFloat(o[c], ConvertComponent(fmt, &data[i + c]));
+        }
+
+        CHECK(match);
+      }
+    }
+  };
+
+  SECTION("Packed formats match the conversion helpers")
+  {
+    bytebuf data;
+    data.resize(65536 * 4);
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      // spread the bits so that every bit of the 32-bit formats is exercised
+      uint32_t v = i | (i * 0x9E37U) << 16;
+      memcpy(&data[i * 4], &v, 4);
+    }
+
+    rdcarray<Vec4f> out;
+    out.resize(65536);
+
+    ResourceFormat fmt = MakeFormat(ResourceFormatType::R10G10B10A2, CompType::UNorm, 4, 1);
+    CHECK(GetFormattedElementSize(fmt) == 4);
+    CHECK(DecodeFormattedElements(fmt, data.data(), 4, out.size(), out.data()));
+
+    bool match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      uint32_t v;
+      memcpy(&v, &data[i * 4], 4);
+      Vec4f expected = ConvertFromR10G10B10A2(v);
+      match &= SameFloat(out[i].x, expected.x) && SameFloat(out[i].y, expected.y) &&
+               SameFloat(out[i].z, expected.z) && SameFloat(out[i].w, expected.w);
+    }
+    CHECK(match);
+
+    fmt.compType = CompType::SNorm;
+    CHECK(DecodeFormattedElements(fmt, data.data(), 4, out.size(), out.data()));
+
+    match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      uint32_t v;
+      memcpy(&v, &data[i * 4], 4);
+      Vec4f expected = ConvertFromR10G10B10A2SNorm(v);
+      match &= SameFloat(out[i].x, expected.x) && SameFloat(out[i].y, expected.y) &&
+               SameFloat(out[i].z, expected.z) && SameFloat(out[i].w, expected.w);
+    }
+    CHECK(match);
+
+    fmt.compType = CompType::UInt;
+    CHECK(DecodeFormattedElements(fmt, data.data(), 4, out.size(), out.data()));
+
+    match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      uint32_t v;
+      memcpy(&v, &data[i * 4], 4);
+      match &= out[i].x == float(v & 0x3ff) && out[i].y == float((v >> 10) & 0x3ff) &&
+               out[i].z == float((v >> 20) & 0x3ff) && out[i].w == float(v >> 30);
+    }
+    CHECK(match);
+
+    fmt = MakeFormat(ResourceFormatType::R11G11B10, CompType::Float, 3, 1);
+    CHECK(GetFormattedElementSize(fmt) == 4);
+    CHECK(DecodeFormattedElements(fmt, data.data(), 4, out.size(), out.data()));
+
+    match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      uint32_t v;
+      memcpy(&v, &data[i * 4], 4);
+      Vec3f expected = ConvertFromR11G11B10(v);
+      match &= SameFloat(out[i].x, expected.x) && SameFloat(out[i].y, expected.y) &&
+               SameFloat(out[i].z, expected.z) && out[i].w == 1.0f;
+    }
+    CHECK(match);
+
+    // the 16-bit packed formats are tested with every possible value
+    for(uint32_t i = 0; i < 65536; i++)
+      memcpy(&data[i * 2], &i, 2);
+
+    fmt = MakeFormat(ResourceFormatType::R5G6B5, CompType::UNorm, 3, 1);
+    fmt.SetBGRAOrder(true);
+    CHECK(GetFormattedElementSize(fmt) == 2);
+    CHECK(DecodeFormattedElements(fmt, data.data(), 2, out.size(), out.data()));
+
+    match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      Vec3f expected = ConvertFromB5G6R5(uint16_t(i));
+      match &= SameFloat(out[i].x, expected.z) && SameFloat(out[i].y, expected.y) &&
+               SameFloat(out[i].z, expected.x) && out[i].w == 1.0f;
+    }
+    CHECK(match);
+
+    fmt = MakeFormat(ResourceFormatType::R5G5B5A1, CompType::UNorm, 4, 1);
+    CHECK(DecodeFormattedElements(fmt, data.data(), 2, out.size(), out.data()));
+
+    match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      Vec4f expected = ConvertFromB5G5R5A1(uint16_t(i));
+      match &= SameFloat(out[i].x, expected.x) && SameFloat(out[i].y, expected.y) &&
+               SameFloat(out[i].z, expected.z) && SameFloat(out[i].w, expected.w);
+    }
+    CHECK(match);
+
+    fmt = MakeFormat(ResourceFormatType::R4G4B4A4, CompType::UNorm, 4, 1);
+    CHECK(DecodeFormattedElements(fmt, data.data(), 2, out.size(), out.data()));
+
+    match = true;
+    for(uint32_t i = 0; i < 65536; i++)
+    {
+      Vec4f expected = ConvertFromB4G4R4A4(uint16_t(i));
+      match &= SameFloat(out[i].x, expected.x) && SameFloat(out[i].y, expected.y) &&
+               SameFloat(out[i].z, expected.z) && SameFloat(out[i].w, expected.w);
+    }
+    CHECK(match);
+  };
+
+  SECTION("24-bit depth")
+  {
+    const byte data[] = {0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x80, 0x00};
+
+    ResourceFormat fmt = MakeFormat(ResourceFormatType::Regular, CompType::Depth, 1, 3);
+    CHECK(GetFormattedElementSize(fmt) == 4);
+
+    Vec4f out[3];
+    CHECK(DecodeFormattedElements(fmt, data, 4, 3, out));
+
+    CHECK(out[0].x == 0.0f);
+    CHECK(out[1].x == 1.0f);
+    CHECK(out[2].x == ConvertComponent(fmt, data + 8));
+    CHECK(out[2].w == 1.0f);
+  };
+
+  SECTION("Integer decoding")
+  {
+    const byte data[] = {0x01, 0x80, 0xff, 0x7f, 0xfe, 0xff, 0x00, 0x80};
+
+    ResourceFormat fmt = MakeFormat(ResourceFormatType::Regular, CompType::UInt, 4, 1);
+
+    Vec4u u[2];
+    Vec4i s[2];
+
+    CHECK(DecodeFormattedElements(fmt, data, 4, 2, u));
+    CHECK(u[0].x == 0x01);
+    CHECK(u[0].y == 0x80);
+    CHECK(u[0].z == 0xff);
+    CHECK(u[0].w == 0x7f);
+
+    fmt.compType = CompType::SInt;
+    CHECK(DecodeFormattedElements(fmt, data, 4, 2, s));
+    CHECK(s[0].x == 1);
+    CHECK(s[0].y == -128);
+    CHECK(s[0].z == -1);
+    CHECK(s[0].w == 127);
+    CHECK(s[1].x == -2);
+
+    fmt.compByteWidth = 2;
+    fmt.compCount = 2;
+    fmt.compType = CompType::UInt;
+    CHECK(DecodeFormattedElements(fmt, data, 4, 2, u));
+    CHECK(u[0].x == 0x8001);
+    CHECK(u[0].y == 0x7fff);
+    CHECK(u[0].z == 0);
+    CHECK(u[0].w == 1);
+
+    CHECK(DecodeFormattedElements(fmt, data, 4, 2, s));
+    CHECK(s[0].x == -32767);
+    CHECK(s[1].y == -32768);
+
+    fmt.compByteWidth = 4;
+    fmt.compCount = 1;
+    CHECK(DecodeFormattedElements(fmt, data, 4, 2, s));
+    CHECK(s[1].x == int32_t(0x8000fffe));
+
+    // packed formats are sign extended per field
+    uint32_t packed = 0x3ff | (0x200 << 10) | (0x1 << 20) | (0x2U << 30);
+
+    fmt = MakeFormat(ResourceFormatType::R10G10B10A2, CompType::SInt, 4, 1);
+    CHECK(DecodeFormattedElements(fmt, (const byte *)&packed, 4, 1, s));
+    CHECK(s[0].x == -1);
+    CHECK(s[0].y == -512);
+    CHECK(s[0].z == 1);
+    CHECK(s[0].w == -2);
+
+    fmt.compType = CompType::UInt;
+    CHECK(DecodeFormattedElements(fmt, (const byte *)&packed, 4, 1, u));
+    CHECK(u[0].x == 0x3ff);
+    CHECK(u[0].y == 0x200);
+    CHECK(u[0].z == 1);
+    CHECK(u[0].w == 2);
+
+    Vec4f f;
+    CHECK(DecodeFormattedElements(fmt, (const byte *)&packed, 4, 1, &f));
+    CHECK(f.x == 1023.0f);
+    CHECK(f.w == 2.0f);
+
+    fmt.compType = CompType::SInt;
+    CHECK(DecodeFormattedElements(fmt, (const byte *)&packed, 4, 1, &f));
+    CHECK(f.x == -1.0f);
+    CHECK(f.y == -512.0f);
+  };
+
+  SECTION("Unsupported formats")
+  {
+    const byte data[16] = {0xff};
+
+    ResourceFormat fmt = MakeFormat(ResourceFormatType::BC1, CompType::UNorm, 4, 1);
+    CHECK(GetFormattedElementSize(fmt) == 0);
+
+    Vec4f f[2] = {Vec4f(5.0f, 5.0f, 5.0f, 5.0f), Vec4f(5.0f, 5.0f, 5.0f, 5.0f)};
+    CHECK_FALSE(DecodeFormattedElements(fmt, data, 8, 2, f));
+    CHECK(f[1].x == 0.0f);
+    CHECK(f[1].w == 1.0f);
+
+    Vec4u u[1];
+    CHECK_FALSE(DecodeFormattedElements(fmt, data, 8, 1, u));
+    CHECK(u[0].w == 1);
+  };
+}
+
 #endif
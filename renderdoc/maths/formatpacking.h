@@ -139,3 +139,23 @@ typedef uint8_t byte;
 
 struct ResourceFormat;
 float ConvertComponent(const ResourceFormat &fmt, const byte *data);
+
+// Batch decoding of count elements of fmt, each stride bytes after the previous, into 4-component
+// vectors. The conversion is chosen once per call rather than per component so these should be
+// preferred over looping with ConvertComponent. Components the format doesn't have are filled from
+// (0, 0, 0, 1), and BGRA ordered formats are swizzled to RGBA.
+//
+// The float variant converts each component exactly as ConvertComponent and the Convert* functions
+// above do. The integer variants return the raw bits of each component, zero or sign extended, and
+// are intended for UInt and SInt formats.
+//
+// Returns false if the format isn't supported, in which case every element is set to (0, 0, 0, 1).
+bool DecodeFormattedElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                             size_t count, Vec4f *out);
+bool DecodeFormattedElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                             size_t count, Vec4u *out);
+bool DecodeFormattedElements(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                             size_t count, Vec4i *out);
+
+// the number of bytes read for each element by DecodeFormattedElements, or 0 if it's unsupported
+uint32_t GetFormattedElementSize(const ResourceFormat &fmt);
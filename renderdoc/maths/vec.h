@@ -116,4 +116,16 @@ struct Vec4u
     w = W;
   }
   uint32_t x, y, z, w;
+};
+
+struct Vec4i
+{
+  Vec4i(int32_t X = 0, int32_t Y = 0, int32_t Z = 0, int32_t W = 0)
+  {
+    x = X;
+    y = Y;
+    z = Z;
+    w = W;
+  }
+  int32_t x, y, z, w;
 };
\ No newline at end of file
@@ -77,6 +77,8 @@ ExecuteResult LaunchAndInjectIntoProcess(const char *app, const char *workingDir
 void *LoadModule(const char *module);
 void *GetFunctionAddress(void *module, const char *function);
 uint32_t GetCurrentPID();
+// caps the address space the current process may use. Allocations past it will fail
+void LimitMemoryUsage(uint64_t bytes);
 
 void Shutdown();
 };
@@ -309,6 +311,23 @@ bool feof(FILE *f);
 
 int fclose(FILE *f);
 
+// map the first length bytes of a file read-only into memory. Returns NULL if the file can't be
+// mapped, e.g. if it's too large for the address space. The mapping is independent of the FILE *
+// which can be closed while the mapping is still in use.
+const byte *mapfile(FILE *f, uint64_t length);
+void unmapfile(const byte *data, uint64_t length);
+
+enum class MapAccess
+{
+  Normal,
+  Sequential,
+  Random,
+  WillNeed,
+};
+
+// hint to the OS how a range within a mapping will be accessed. This is purely advisory
+void advisemap(const byte *data, uint64_t length, MapAccess access);
+
 // functions for atomically appending to a log that may be in use in multiple
 // processes
 struct LogFileHandle;
@@ -29,6 +29,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -873,6 +874,15 @@ uint32_t Process::GetCurrentPID()
   return (uint32_t)getpid();
 }
 
+void Process::LimitMemoryUsage(uint64_t bytes)
+{
+  rlimit limit = {};
+  limit.rlim_cur = limit.rlim_max = (rlim_t)bytes;
+
+  if(setrlimit(RLIMIT_AS, &limit) != 0)
+    RDCWARN("Couldn't limit memory usage to %llu bytes: %s", bytes, strerror(errno));
+}
+
 void Process::Shutdown()
 {
   // delete all items in the freeChildren list
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -458,6 +459,50 @@ bool fflush(FILE *f)
   return ::fflush(f) == 0;
 }
 
+const byte *mapfile(FILE *f, uint64_t length)
+{
+  if(length == 0 || length > (uint64_t)SIZE_MAX)
+    return NULL;
+
+  ::fflush(f);
+
+  void *ret = ::mmap(NULL, (size_t)length, PROT_READ, MAP_SHARED, ::fileno(f), 0);
+
+  if(ret == MAP_FAILED)
+  {
+    RDCWARN("Couldn't map %llu bytes of file, errno %d", length, errno);
+    return NULL;
+  }
+
+  return (const byte *)ret;
+}
+
+void unmapfile(const byte *data, uint64_t length)
+{
+  if(data)
+    ::munmap((void *)data, (size_t)length);
+}
+
+void advisemap(const byte *data, uint64_t length, MapAccess access)
+{
+  if(data == NULL || length == 0)
+    return;
+
+  int advice = MADV_NORMAL;
+  if(access == MapAccess::Sequential)
+    advice = MADV_SEQUENTIAL;
+  else if(access == MapAccess::Random)
+    advice = MADV_RANDOM;
+  else if(access == MapAccess::WillNeed)
+    advice = MADV_WILLNEED;
+
+  // madvise needs a page aligned start
+  uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t start = uintptr_t(data) & ~(pageSize - 1);
+
+  ::madvise((void *)start, size_t(uintptr_t(data) + length - start), advice);
+}
+
 int fclose(FILE *f)
 {
   return ::fclose(f);
@@ -1678,6 +1678,29 @@ uint32_t Process::GetCurrentPID()
   return (uint32_t)GetCurrentProcessId();
 }
 
+void Process::LimitMemoryUsage(uint64_t bytes)
+{
+  // the job object is intentionally leaked, it must live as long as the process does
+  HANDLE job = CreateJobObjectW(NULL, NULL);
+
+  if(job == NULL)
+  {
+    RDCWARN("Couldn't create job object to limit memory usage: %d", GetLastError());
+    return;
+  }
+
+  JOBOBJECT_EXTENDED_LIMIT_INFORMATION limit = {};
+  limit.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_PROCESS_MEMORY;
+  limit.ProcessMemoryLimit = (SIZE_T)bytes;
+
+  if(!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limit, sizeof(limit)) ||
+     !AssignProcessToJobObject(job, GetCurrentProcess()))
+  {
+    RDCWARN("Couldn't limit memory usage to %llu bytes: %d", bytes, GetLastError());
+    CloseHandle(job);
+  }
+}
+
 void Process::Shutdown()
 {
   // nothing to do
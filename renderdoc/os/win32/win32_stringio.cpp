@@ -657,6 +657,50 @@ bool fflush(FILE *f)
   return ::fflush(f) == 0;
 }
 
+const byte *mapfile(FILE *f, uint64_t length)
+{
+  if(length == 0 || length > (uint64_t)SIZE_MAX)
+    return NULL;
+
+  ::fflush(f);
+
+  HANDLE file = (HANDLE)::_get_osfhandle(::_fileno(f));
+
+  if(file == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, DWORD(length >> 32),
+                                      DWORD(length & 0xffffffff), NULL);
+
+  if(mapping == NULL)
+  {
+    RDCWARN("Couldn't create file mapping for %llu bytes: %d", length, GetLastError());
+    return NULL;
+  }
+
+  void *ret = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)length);
+
+  if(ret == NULL)
+    RDCWARN("Couldn't map view of %llu bytes: %d", length, GetLastError());
+
+  // the view keeps the mapping object alive until it's unmapped
+  CloseHandle(mapping);
+
+  return (const byte *)ret;
+}
+
+void unmapfile(const byte *data, uint64_t length)
+{
+  if(data)
+    UnmapViewOfFile(data);
+}
+
+void advisemap(const byte *data, uint64_t length, MapAccess access)
+{
+  // there's no equivalent of madvise for mapped views that's available on all versions we support,
+  // and the cache manager already detects sequential access itself.
+}
+
 int fclose(FILE *f)
 {
   return ::fclose(f);
@@ -29,6 +29,7 @@
 #include "core/core.h"
 #include "hooks/hooks.h"
 #include "serialise/rdcfile.h"
+#include "serialise/serialiser.h"
 
 static void SetFocusToggleKeys(RENDERDOC_InputButton *keys, int num)
 {
@@ -238,28 +239,38 @@ static uint32_t DiscardFrameCapture(void *device, void *wndHandle)
   return RenderDoc::Inst().DiscardFrameCapture(device, wndHandle) ? 1 : 0;
 }
 
+static void GetCaptureMemoryUsage(uint64_t *resident, uint64_t *spilled)
+{
+  uint64_t spilledMem = Chunk::SpilledMem();
+
+  if(resident)
+    *resident = Chunk::TotalMem() - spilledMem;
+  if(spilled)
+    *spilled = spilledMem;
+}
+
 // defined in capture_options.cpp
 int RENDERDOC_CC SetCaptureOptionU32(RENDERDOC_CaptureOption opt, uint32_t val);
 int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val);
 uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt);
 float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt);
 
-void RENDERDOC_CC GetAPIVersion_1_4_0(int *major, int *minor, int *patch)
+void RENDERDOC_CC GetAPIVersion_1_6_0(int *major, int *minor, int *patch)
 {
   if(major)
     *major = 1;
   if(minor)
-    *minor = 4;
+    *minor = 6;
   if(patch)
     *patch = 0;
 }
 
-RENDERDOC_API_1_4_0 api_1_4_0;
-void Init_1_4_0()
+RENDERDOC_API_1_6_0 api_1_6_0;
+void Init_1_6_0()
 {
-  RENDERDOC_API_1_4_0 &api = api_1_4_0;
+  RENDERDOC_API_1_6_0 &api = api_1_6_0;
 
-  api.GetAPIVersion = &GetAPIVersion_1_4_0;
+  api.GetAPIVersion = &GetAPIVersion_1_6_0;
 
   api.SetCaptureOptionU32 = &SetCaptureOptionU32;
   api.SetCaptureOptionF32 = &SetCaptureOptionF32;
@@ -298,6 +309,8 @@ void Init_1_4_0()
   api.SetCaptureFileComments = &SetCaptureFileComments;
 
   api.DiscardFrameCapture = &DiscardFrameCapture;
+
+  api.GetCaptureMemoryUsage = &GetCaptureMemoryUsage;
 }
 
 extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_GetAPI(RENDERDOC_Version version,
@@ -324,15 +337,17 @@ extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_GetAPI(RENDERDOC_Version ver
     ret = 1;                                                       \
   }
 
-  API_VERSION_HANDLE(1_0_0, 1_4_0);
-  API_VERSION_HANDLE(1_0_1, 1_4_0);
-  API_VERSION_HANDLE(1_0_2, 1_4_0);
-  API_VERSION_HANDLE(1_1_0, 1_4_0);
-  API_VERSION_HANDLE(1_1_1, 1_4_0);
-  API_VERSION_HANDLE(1_1_2, 1_4_0);
-  API_VERSION_HANDLE(1_2_0, 1_4_0);
-  API_VERSION_HANDLE(1_3_0, 1_4_0);
-  API_VERSION_HANDLE(1_4_0, 1_4_0);
+  API_VERSION_HANDLE(1_0_0, 1_6_0);
+  API_VERSION_HANDLE(1_0_1, 1_6_0);
+  API_VERSION_HANDLE(1_0_2, 1_6_0);
+  API_VERSION_HANDLE(1_1_0, 1_6_0);
+  API_VERSION_HANDLE(1_1_1, 1_6_0);
+  API_VERSION_HANDLE(1_1_2, 1_6_0);
+  API_VERSION_HANDLE(1_2_0, 1_6_0);
+  API_VERSION_HANDLE(1_3_0, 1_6_0);
+  API_VERSION_HANDLE(1_4_0, 1_6_0);
+  API_VERSION_HANDLE(1_5_0, 1_6_0);
+  API_VERSION_HANDLE(1_6_0, 1_6_0);
 
 #undef API_VERSION_HANDLE
 
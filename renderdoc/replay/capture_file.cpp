@@ -130,6 +130,8 @@ public:
 
   ReplayStatus Convert(const char *filename, const char *filetype, const SDFile *file,
                        RENDERDOC_ProgressCallback progress);
+  ReplayStatus PackToBlobStore(const char *filename, const char *blobStore,
+                               RENDERDOC_ProgressCallback progress);
 
   rdcarray<CaptureFileFormat> GetCaptureFileFormats()
   {
@@ -520,11 +522,14 @@ ReplayStatus CaptureFile::Convert(const char *filename, const char *filetype, co
   // write all other sections
   for(int i = 0; i < m_RDC->NumSections(); i++)
   {
-    const SectionProperties &props = m_RDC->GetSectionProperties(i);
+    SectionProperties props = m_RDC->GetSectionProperties(i);
 
     if(props.type == SectionType::FrameCapture)
       continue;
 
+    // sections that were packed into a blob store are written out in full
+    props.flags &= ~SectionFlags::BlobReferences;
+
     StreamWriter *writer = output.WriteSection(props);
     StreamReader *reader = m_RDC->ReadSection(i);
 
@@ -544,6 +549,74 @@ ReplayStatus CaptureFile::Convert(const char *filename, const char *filetype, co
   return ReplayStatus::Succeeded;
 }
 
+ReplayStatus CaptureFile::PackToBlobStore(const char *filename, const char *blobStore,
+                                          RENDERDOC_ProgressCallback progress)
+{
+  int frameCaptureIndex = m_RDC ? m_RDC->SectionIndex(SectionType::FrameCapture) : -1;
+
+  if(frameCaptureIndex == -1)
+  {
+    RDCERR("Only captures with frame capture data can be packed.");
+    return ReplayStatus::FileCorrupted;
+  }
+
+  if(!progress)
+    progress = [](float) {};
+
+  RDCFile output;
+
+  output.SetData(m_RDC->GetDriver(), m_RDC->GetDriverName().c_str(), m_RDC->GetMachineIdent(),
+                 &m_RDC->GetThumbnail());
+
+  output.Create(filename);
+
+  if(output.ErrorCode() != ContainerError::NoError)
+  {
+    switch(output.ErrorCode())
+    {
+      case ContainerError::FileNotFound: return ReplayStatus::FileNotFound; break;
+      case ContainerError::FileIO: return ReplayStatus::FileIOFailed; break;
+      default: break;
+    }
+    return ReplayStatus::InternalError;
+  }
+
+  output.SetBlobStore(blobStore);
+
+  // the frame capture must be written first
+  std::vector<int> sections = {frameCaptureIndex};
+  for(int i = 0; i < m_RDC->NumSections(); i++)
+    if(i != frameCaptureIndex)
+      sections.push_back(i);
+
+  for(int i : sections)
+  {
+    SectionProperties props = m_RDC->GetSectionProperties(i);
+
+    // small sections aren't worth splitting up, only the frame capture is likely to be large and
+    // repeated between captures. Any existing compression flag is kept for when it's unpacked
+    if(i == frameCaptureIndex)
+      props.flags |= SectionFlags::BlobReferences;
+
+    StreamWriter *writer = output.WriteSection(props);
+    StreamReader *reader = m_RDC->ReadSection(i);
+
+    StreamTransfer(writer, reader, i == frameCaptureIndex ? progress : NULL);
+
+    writer->Finish();
+
+    bool success = !writer->IsErrored() && !reader->IsErrored();
+
+    delete reader;
+    delete writer;
+
+    if(!success)
+      return ReplayStatus::FileIOFailed;
+  }
+
+  return ReplayStatus::Succeeded;
+}
+
 Thumbnail CaptureFile::GetThumbnail(FileType type, uint32_t maxsize)
 {
   Thumbnail ret;
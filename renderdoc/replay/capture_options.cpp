@@ -50,6 +50,12 @@ int RENDERDOC_CC SetCaptureOptionU32(RENDERDOC_CaptureOption opt, uint32_t val)
       break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.captureAllCmdLists = (val != 0); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.debugOutputMute = (val != 0); break;
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB: opts.captureMemoryBudgetMB = val; break;
+    case eRENDERDOC_Option_RetroactiveFrames: opts.retroactiveFrames = val; break;
+    case eRENDERDOC_Option_RetroactiveMemoryBudgetMB: opts.retroactiveMemoryBudgetMB = val; break;
+    case eRENDERDOC_Option_RetroactiveCPUBudget:
+      opts.retroactiveCPUBudget = RDCCLAMP(val, 1U, 100U);
+      break;
     case eRENDERDOC_Option_AllowUnsupportedVendorExtensions:
       if(val == 0x10DE)
         RenderDoc::Inst().EnableVendorExtensions(VendorExtensions::NvAPI);
@@ -85,6 +91,18 @@ int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val)
       break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.captureAllCmdLists = (val != 0.0f); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.debugOutputMute = (val != 0.0f); break;
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB:
+      opts.captureMemoryBudgetMB = (uint32_t)RDCMAX(val, 0.0f);
+      break;
+    case eRENDERDOC_Option_RetroactiveFrames:
+      opts.retroactiveFrames = (uint32_t)RDCMAX(val, 0.0f);
+      break;
+    case eRENDERDOC_Option_RetroactiveMemoryBudgetMB:
+      opts.retroactiveMemoryBudgetMB = (uint32_t)RDCMAX(val, 0.0f);
+      break;
+    case eRENDERDOC_Option_RetroactiveCPUBudget:
+      opts.retroactiveCPUBudget = (uint32_t)RDCCLAMP(val, 1.0f, 100.0f);
+      break;
     case eRENDERDOC_Option_AllowUnsupportedVendorExtensions:
       RDCWARN("AllowUnsupportedVendorExtensions unexpected parameter %f", val);
       break;
@@ -124,6 +142,14 @@ uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().captureAllCmdLists ? 1 : 0);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().debugOutputMute ? 1 : 0);
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB:
+      return RenderDoc::Inst().GetCaptureOptions().captureMemoryBudgetMB;
+    case eRENDERDOC_Option_RetroactiveFrames:
+      return RenderDoc::Inst().GetCaptureOptions().retroactiveFrames;
+    case eRENDERDOC_Option_RetroactiveMemoryBudgetMB:
+      return RenderDoc::Inst().GetCaptureOptions().retroactiveMemoryBudgetMB;
+    case eRENDERDOC_Option_RetroactiveCPUBudget:
+      return RenderDoc::Inst().GetCaptureOptions().retroactiveCPUBudget;
     case eRENDERDOC_Option_AllowUnsupportedVendorExtensions: return 0;
     default: break;
   }
@@ -161,6 +187,14 @@ float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().captureAllCmdLists ? 1.0f : 0.0f);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().debugOutputMute ? 1.0f : 0.0f);
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB:
+      return float(RenderDoc::Inst().GetCaptureOptions().captureMemoryBudgetMB);
+    case eRENDERDOC_Option_RetroactiveFrames:
+      return float(RenderDoc::Inst().GetCaptureOptions().retroactiveFrames);
+    case eRENDERDOC_Option_RetroactiveMemoryBudgetMB:
+      return float(RenderDoc::Inst().GetCaptureOptions().retroactiveMemoryBudgetMB);
+    case eRENDERDOC_Option_RetroactiveCPUBudget:
+      return float(RenderDoc::Inst().GetCaptureOptions().retroactiveCPUBudget);
     case eRENDERDOC_Option_AllowUnsupportedVendorExtensions: return 0.0f;
     default: break;
   }
@@ -182,4 +216,8 @@ CaptureOptions::CaptureOptions()
   refAllResources = false;
   captureAllCmdLists = false;
   debugOutputMute = true;
+  captureMemoryBudgetMB = 0;
+  retroactiveFrames = 0;
+  retroactiveMemoryBudgetMB = 512;
+  retroactiveCPUBudget = 25;
 }
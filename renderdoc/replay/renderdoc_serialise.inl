@@ -82,8 +82,33 @@ void DoSerialise(SerialiserType &ser, SectionProperties &el)
   SERIALISE_MEMBER(version);
   SERIALISE_MEMBER(uncompressedSize);
   SERIALISE_MEMBER(compressedSize);
+  SERIALISE_MEMBER(dictionaryID);
 
-  SIZE_CHECK(56);
+  SIZE_CHECK(64);
+}
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, RemoteServerSession &el)
+{
+  SERIALISE_MEMBER(client);
+  SERIALISE_MEMBER(workerPID);
+  SERIALISE_MEMBER(duration);
+
+  SIZE_CHECK(40);
+}
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, RemoteServerStats &el)
+{
+  SERIALISE_MEMBER(maxSessions);
+  SERIALISE_MEMBER(maxQueued);
+  SERIALISE_MEMBER(queuedClients);
+  SERIALISE_MEMBER(totalSessions);
+  SERIALISE_MEMBER(rejectedClients);
+  SERIALISE_MEMBER(uptime);
+  SERIALISE_MEMBER(sessions);
+
+  SIZE_CHECK(64);
 }
 
 template <class SerialiserType>
@@ -111,8 +136,12 @@ void DoSerialise(SerialiserType &ser, CaptureOptions &el)
   SERIALISE_MEMBER(refAllResources);
   SERIALISE_MEMBER(captureAllCmdLists);
   SERIALISE_MEMBER(debugOutputMute);
+  SERIALISE_MEMBER(captureMemoryBudgetMB);
+  SERIALISE_MEMBER(retroactiveFrames);
+  SERIALISE_MEMBER(retroactiveMemoryBudgetMB);
+  SERIALISE_MEMBER(retroactiveCPUBudget);
 
-  SIZE_CHECK(20);
+  SIZE_CHECK(36);
 }
 
 template <typename SerialiserType>
@@ -851,6 +880,19 @@ void DoSerialise(SerialiserType &ser, PixelModification &el)
   SIZE_CHECK(100);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, PixelRegionHistory &el)
+{
+  SERIALISE_MEMBER(x);
+  SERIALISE_MEMBER(y);
+  SERIALISE_MEMBER(width);
+  SERIALISE_MEMBER(height);
+  SERIALISE_MEMBER(offsets);
+  SERIALISE_MEMBER(modifications);
+
+  SIZE_CHECK(64);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, EventUsage &el)
 {
@@ -879,6 +921,53 @@ void DoSerialise(SerialiserType &ser, CounterValue &el)
   SIZE_CHECK(8);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ReplayPhaseTiming &el)
+{
+  SERIALISE_MEMBER(name);
+  SERIALISE_MEMBER(startTime);
+  SERIALISE_MEMBER(duration);
+
+  SIZE_CHECK(40);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ReplayChunkTiming &el)
+{
+  SERIALISE_MEMBER(name);
+  SERIALISE_MEMBER(chunkID);
+  SERIALISE_MEMBER(count);
+  SERIALISE_MEMBER(deserialiseTime);
+  SERIALISE_MEMBER(executeTime);
+
+  SIZE_CHECK(48);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ReplayEventTiming &el)
+{
+  SERIALISE_MEMBER(eventId);
+  SERIALISE_MEMBER(chunkID);
+  SERIALISE_MEMBER(fileOffset);
+  SERIALISE_MEMBER(startTime);
+  SERIALISE_MEMBER(deserialiseTime);
+  SERIALISE_MEMBER(executeTime);
+  SERIALISE_MEMBER(gpuTime);
+
+  SIZE_CHECK(48);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ReplayProfile &el)
+{
+  SERIALISE_MEMBER(phases);
+  SERIALISE_MEMBER(loadChunks);
+  SERIALISE_MEMBER(replayChunks);
+  SERIALISE_MEMBER(events);
+
+  SIZE_CHECK(96);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, GPUDevice &el)
 {
@@ -903,6 +992,30 @@ void DoSerialise(SerialiserType &ser, ReplayOptions &el)
   SIZE_CHECK(48);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, APICallTelemetry &el)
+{
+  SERIALISE_MEMBER(function);
+  SERIALISE_MEMBER(count);
+  SERIALISE_MEMBER(duration);
+
+  SIZE_CHECK(40);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, CaptureTelemetryData &el)
+{
+  SERIALISE_MEMBER(numFrames);
+  SERIALISE_MEMBER(frameTime);
+  SERIALISE_MEMBER(hookedTime);
+  SERIALISE_MEMBER(mapTrackingTime);
+  SERIALISE_MEMBER(serialisedBytes);
+  SERIALISE_MEMBER(chunkMemory);
+  SERIALISE_MEMBER(calls);
+
+  SIZE_CHECK(72);
+}
+
 #pragma region Common pipeline state
 
 template <typename SerialiserType>
@@ -2215,6 +2328,8 @@ void DoSerialise(SerialiserType &ser, VKPipe::State &el)
 INSTANTIATE_SERIALISE_TYPE(ExecuteResult)
 INSTANTIATE_SERIALISE_TYPE(PathEntry)
 INSTANTIATE_SERIALISE_TYPE(SectionProperties)
+INSTANTIATE_SERIALISE_TYPE(RemoteServerSession)
+INSTANTIATE_SERIALISE_TYPE(RemoteServerStats)
 INSTANTIATE_SERIALISE_TYPE(EnvironmentModification)
 INSTANTIATE_SERIALISE_TYPE(CaptureOptions)
 INSTANTIATE_SERIALISE_TYPE(ResourceFormat)
@@ -2264,11 +2379,18 @@ INSTANTIATE_SERIALISE_TYPE(FloatVector)
 INSTANTIATE_SERIALISE_TYPE(Uuid)
 INSTANTIATE_SERIALISE_TYPE(CounterDescription)
 INSTANTIATE_SERIALISE_TYPE(PixelModification)
+INSTANTIATE_SERIALISE_TYPE(PixelRegionHistory)
 INSTANTIATE_SERIALISE_TYPE(EventUsage)
 INSTANTIATE_SERIALISE_TYPE(CounterResult)
+INSTANTIATE_SERIALISE_TYPE(ReplayPhaseTiming)
+INSTANTIATE_SERIALISE_TYPE(ReplayChunkTiming)
+INSTANTIATE_SERIALISE_TYPE(ReplayEventTiming)
+INSTANTIATE_SERIALISE_TYPE(ReplayProfile)
 INSTANTIATE_SERIALISE_TYPE(CounterValue)
 INSTANTIATE_SERIALISE_TYPE(GPUDevice)
 INSTANTIATE_SERIALISE_TYPE(ReplayOptions)
+INSTANTIATE_SERIALISE_TYPE(APICallTelemetry)
+INSTANTIATE_SERIALISE_TYPE(CaptureTelemetryData)
 INSTANTIATE_SERIALISE_TYPE(D3D11Pipe::Layout)
 INSTANTIATE_SERIALISE_TYPE(D3D11Pipe::InputAssembly)
 INSTANTIATE_SERIALISE_TYPE(D3D11Pipe::View)
@@ -24,9 +24,11 @@
  ******************************************************************************/
 
 #include "replay_controller.h"
+#include <algorithm>
 #include <string.h>
 #include <time.h>
 #include "common/dds_readwrite.h"
+#include "common/texture_decode.h"
 #include "driver/ihv/amd/amd_isa.h"
 #include "driver/ihv/amd/amd_rgp.h"
 #include "jpeg-compressor/jpgd.h"
@@ -40,130 +42,6 @@
 #include "strings/string_utils.h"
 #include "tinyexr/tinyexr.h"
 
-float ConvertComponent(const ResourceFormat &fmt, const byte *data)
-{
-  if(fmt.compByteWidth == 8)
-  {
-    // we just downcast
-    const uint64_t *u64 = (const uint64_t *)data;
-    const int64_t *i64 = (const int64_t *)data;
-
-    if(fmt.compType == CompType::Double || fmt.compType == CompType::Float)
-    {
-      return float(*(const double *)u64);
-    }
-    else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u64);
-    }
-    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i64);
-    }
-  }
-  else if(fmt.compByteWidth == 4)
-  {
-    const uint32_t *u32 = (const uint32_t *)data;
-    const int32_t *i32 = (const int32_t *)data;
-
-    if(fmt.compType == CompType::Float || fmt.compType == CompType::Depth)
-    {
-      return *(const float *)u32;
-    }
-    else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u32);
-    }
-    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i32);
-    }
-  }
-  else if(fmt.compByteWidth == 3 && fmt.compType == CompType::Depth)
-  {
-    // 24-bit depth is a weird edge case we need to assemble it by hand
-    const uint8_t *u8 = (const uint8_t *)data;
-
-    uint32_t depth = 0;
-    depth |= uint32_t(u8[1]);
-    depth |= uint32_t(u8[2]) << 8;
-    depth |= uint32_t(u8[3]) << 16;
-
-    return float(depth) / float(16777215.0f);
-  }
-  else if(fmt.compByteWidth == 2)
-  {
-    const uint16_t *u16 = (const uint16_t *)data;
-    const int16_t *i16 = (const int16_t *)data;
-
-    if(fmt.compType == CompType::Float)
-    {
-      return ConvertFromHalf(*u16);
-    }
-    else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u16);
-    }
-    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i16);
-    }
-    // 16-bit depth is UNORM
-    else if(fmt.compType == CompType::UNorm || fmt.compType == CompType::Depth)
-    {
-      return float(*u16) / 65535.0f;
-    }
-    else if(fmt.compType == CompType::SNorm)
-    {
-      float f = -1.0f;
-
-      if(*i16 == -32768)
-        f = -1.0f;
-      else
-        f = ((float)*i16) / 32767.0f;
-
-      return f;
-    }
-  }
-  else if(fmt.compByteWidth == 1)
-  {
-    const uint8_t *u8 = (const uint8_t *)data;
-    const int8_t *i8 = (const int8_t *)data;
-
-    if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u8);
-    }
-    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i8);
-    }
-    else if(fmt.compType == CompType::UNormSRGB)
-    {
-      return SRGB8_lookuptable[*u8];
-    }
-    else if(fmt.compType == CompType::UNorm)
-    {
-      return float(*u8) / 255.0f;
-    }
-    else if(fmt.compType == CompType::SNorm)
-    {
-      float f = -1.0f;
-
-      if(*i8 == -128)
-        f = -1.0f;
-      else
-        f = ((float)*i8) / 127.0f;
-
-      return f;
-    }
-  }
-
-  RDCERR("Unexpected format to convert from %u %u", fmt.compByteWidth, fmt.compType);
-
-  return 0.0f;
-}
-
 static void fileWriteFunc(void *context, void *data, int size)
 {
   FileIO::fwrite(data, 1, size, (FILE *)context);
@@ -558,6 +436,61 @@ CounterDescription ReplayController::DescribeCounter(GPUCounter counterID)
   return m_pDevice->DescribeCounter(counterID);
 }
 
+ReplayProfile ReplayController::GetReplayProfile(bool gpuTimings)
+{
+  CHECK_REPLAY_THREAD();
+
+  ReplayProfile ret = m_pDevice->ProfileReplay();
+
+  // the driver only knows the file offset of each chunk, so match those up to events here
+  std::map<uint64_t, uint32_t> offsetToEvent;
+  for(DrawcallDescription *draw : m_Drawcalls)
+  {
+    if(!draw)
+      continue;
+
+    for(const APIEvent &ev : draw->events)
+      offsetToEvent.insert(std::make_pair(ev.fileOffset, ev.eventId));
+  }
+
+  for(ReplayEventTiming &ev : ret.events)
+  {
+    auto it = offsetToEvent.find(ev.fileOffset);
+    if(it != offsetToEvent.end())
+      ev.eventId = it->second;
+  }
+
+  if(gpuTimings)
+  {
+    std::vector<GPUCounter> counters = m_pDevice->EnumerateCounters();
+
+    if(std::find(counters.begin(), counters.end(), GPUCounter::EventGPUDuration) != counters.end())
+    {
+      std::vector<CounterResult> results = m_pDevice->FetchCounters({GPUCounter::EventGPUDuration});
+
+      std::map<uint32_t, double> gpuTimes;
+      for(const CounterResult &r : results)
+        gpuTimes[r.eventId] = r.value.d;
+
+      for(ReplayEventTiming &ev : ret.events)
+      {
+        auto it = gpuTimes.find(ev.eventId);
+        if(ev.eventId != 0 && it != gpuTimes.end())
+          ev.gpuTime = it->second;
+      }
+    }
+    else
+    {
+      RDCWARN("GPU timings requested but not available on this replay implementation");
+    }
+  }
+
+  // restore back to where we were
+  m_pDevice->ReplayLog(m_EventID, eReplay_Full);
+
+  return ret;
+}
+
 const rdcarray<ResourceDescription> &ReplayController::GetResources()
 {
   CHECK_REPLAY_THREAD();
@@ -869,6 +802,9 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
      td.format.type != ResourceFormatType::R11G11B10)
     downcast = true;
 
+  // the format as stored, in case we need to decode it ourselves
+  const ResourceFormat srcFormat = td.format;
+
   // if we're downcasting, pick either RGBA8 or RGBA32 to downcast to
   RemapTexture remap = RemapTexture::NoRemap;
 
@@ -967,6 +903,34 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       bytebuf data;
       m_pDevice->GetTextureData(liveid, slice, mip, params, data);
 
+      // if the device couldn't remap a block compressed texture, e.g. because it can't sample from
+      // that format, fetch the raw blocks and decode them on the CPU. Note that this doesn't apply
+      // the black and white points.
+      if(data.empty() && remap != RemapTexture::NoRemap && IsBlockDecodeSupported(srcFormat))
+      {
+        params.remap = RemapTexture::NoRemap;
+
+        bytebuf compressed;
+        m_pDevice->GetTextureData(liveid, slice, mip, params, compressed);
+
+        const uint32_t w = RDCMAX(1U, td.width >> m);
+        const uint32_t h = RDCMAX(1U, td.height >> m);
+        const uint32_t d = RDCMAX(1U, td.depth >> m);
+
+        const DecodedFormat decodedFormat =
+            remap == RemapTexture::RGBA32 ? DecodedFormat::RGBA32F : DecodedFormat::RGBA8;
+        const size_t srcSize = GetBlockCompressedSize(srcFormat, w, h);
+        const size_t dstSize = size_t(w) * h * GetDecodedTexelSize(decodedFormat);
+
+        if(compressed.size() >= srcSize * d)
+        {
+          data.resize(dstSize * d);
+          for(uint32_t z = 0; z < d; z++)
+            DecodeBlockCompressed(srcFormat, w, h, compressed.data() + srcSize * z, srcSize,
+                                  decodedFormat, data.data() + dstSize * z);
+        }
+      }
+
       if(data.empty())
       {
         RDCERR("Couldn't get bytes for mip %u, slice %u", mip, slice);
@@ -1376,63 +1340,25 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       if(saveFmt.compType == CompType::Typeless)
         saveFmt.compType = saveFmt.compByteWidth == 4 ? CompType::Float : CompType::UNorm;
 
-      uint32_t pixStride = saveFmt.compCount * saveFmt.compByteWidth;
+      // 24-bit depth still has a stride of 4 bytes, which this takes care of.
+      uint32_t pixStride = GetFormattedElementSize(saveFmt);
 
-      // 24-bit depth still has a stride of 4 bytes.
-      if(saveFmt.compType == CompType::Depth && pixStride == 3)
-        pixStride = 4;
+      std::vector<Vec4f> rowData;
+      rowData.resize(td.width);
 
       for(uint32_t y = 0; y < td.height; y++)
       {
-        for(uint32_t x = 0; x < td.width; x++)
-        {
-          float r = 0.0f;
-          float g = 0.0f;
-          float b = 0.0f;
-          float a = 1.0f;
-
-          if(saveFmt.type == ResourceFormatType::R10G10B10A2)
-          {
-            uint32_t *u32 = (uint32_t *)srcData;
-
-            Vec4f vec = ConvertFromR10G10B10A2(*u32);
-
-            r = vec.x;
-            g = vec.y;
-            b = vec.z;
-            a = vec.w;
-
-            srcData += 4;
-          }
-          else if(saveFmt.type == ResourceFormatType::R11G11B10)
-          {
-            uint32_t *u32 = (uint32_t *)srcData;
-
-            Vec3f vec = ConvertFromR11G11B10(*u32);
-
-            r = vec.x;
-            g = vec.y;
-            b = vec.z;
-            a = 1.0f;
+        // decode a whole row at once, choosing the conversion once rather than per-component
+        DecodeFormattedElements(saveFmt, srcData, pixStride, td.width, rowData.data());
 
-            srcData += 4;
-          }
-          else
-          {
-            if(saveFmt.compCount >= 1)
-              r = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 0);
-            if(saveFmt.compCount >= 2)
-              g = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 1);
-            if(saveFmt.compCount >= 3)
-              b = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 2);
-            if(saveFmt.compCount >= 4)
-              a = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 3);
-
-            srcData += pixStride;
-          }
+        srcData += pixStride * td.width;
 
-          if(saveFmt.BGRAOrder())
-            std::swap(r, b);
+        for(uint32_t x = 0; x < td.width; x++)
+        {
+          float r = rowData[x].x;
+          float g = rowData[x].y;
+          float b = rowData[x].z;
+          float a = rowData[x].w;
 
           // HDR can't represent negative values
           if(sd.destType == FileType::HDR)
@@ -1553,55 +1479,15 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   return success;
 }
 
-rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, uint32_t x,
-                                                           uint32_t y, uint32_t slice, uint32_t mip,
-                                                           uint32_t sampleIdx, CompType typeHint)
+// filter a resource's usage down to the events up to eventId that might write to it
+static std::vector<EventUsage> GetPixelHistoryEvents(const std::vector<EventUsage> &usage,
+                                                     uint32_t eventId)
 {
-  CHECK_REPLAY_THREAD();
-
-  rdcarray<PixelModification> ret;
-
-  for(size_t t = 0; t < m_Textures.size(); t++)
-  {
-    if(m_Textures[t].resourceId == target)
-    {
-      if(x >= m_Textures[t].width || y >= m_Textures[t].height)
-      {
-        RDCDEBUG("PixelHistory out of bounds on %llu (%u,%u) vs (%u,%u)", target, x, y,
-                 m_Textures[t].width, m_Textures[t].height);
-        return ret;
-      }
-
-      if(m_Textures[t].msSamp == 1)
-        sampleIdx = ~0U;
-
-      if(m_Textures[t].dimension == 3)
-      {
-        slice = RDCCLAMP(slice, 0U, m_Textures[t].depth >> mip);
-      }
-      else
-      {
-        slice = RDCCLAMP(slice, 0U, m_Textures[t].arraysize);
-      }
-
-      mip = RDCCLAMP(mip, 0U, m_Textures[t].mips);
-
-      break;
-    }
-  }
-
-  ResourceId id = m_pDevice->GetLiveID(target);
-
-  if(id == ResourceId())
-    return ret;
-
-  std::vector<EventUsage> usage = m_pDevice->GetUsage(id);
-
   std::vector<EventUsage> events;
 
   for(size_t i = 0; i < usage.size(); i++)
   {
-    if(usage[i].eventId > m_EventID)
+    if(usage[i].eventId > eventId)
       continue;
 
     switch(usage[i].usage)
@@ -1654,18 +1540,134 @@ rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, ui
     events.push_back(usage[i]);
   }
 
+  return events;
+}
+
+rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, uint32_t x,
+                                                           uint32_t y, uint32_t slice, uint32_t mip,
+                                                           uint32_t sampleIdx, CompType typeHint)
+{
+  CHECK_REPLAY_THREAD();
+
+  rdcarray<PixelModification> ret;
+
+  for(size_t t = 0; t < m_Textures.size(); t++)
+  {
+    if(m_Textures[t].resourceId == target)
+    {
+      if(x >= m_Textures[t].width || y >= m_Textures[t].height)
+      {
+        RDCDEBUG("PixelHistory out of bounds on %llu (%u,%u) vs (%u,%u)", target, x, y,
+                 m_Textures[t].width, m_Textures[t].height);
+        return ret;
+      }
+
+      if(m_Textures[t].msSamp == 1)
+        sampleIdx = ~0U;
+
+      if(m_Textures[t].dimension == 3)
+      {
+        slice = RDCCLAMP(slice, 0U, m_Textures[t].depth >> mip);
+      }
+      else
+      {
+        slice = RDCCLAMP(slice, 0U, m_Textures[t].arraysize);
+      }
+
+      mip = RDCCLAMP(mip, 0U, m_Textures[t].mips);
+
+      break;
+    }
+  }
+
+  ResourceId id = m_pDevice->GetLiveID(target);
+
+  if(id == ResourceId())
+    return ret;
+
+  std::vector<EventUsage> events = GetPixelHistoryEvents(m_pDevice->GetUsage(id), m_EventID);
+
   if(events.empty())
   {
     RDCDEBUG("Target %llu not written to before %u", target, m_EventID);
     return ret;
   }
 
-  id = m_pDevice->GetLiveID(target);
+  ret = m_pDevice->PixelHistory(events, id, x, y, slice, mip, sampleIdx, typeHint);
+
+  SetFrameEvent(m_EventID, true);
+
+  return ret;
+}
+
+PixelRegionHistory ReplayController::PixelHistoryRegion(ResourceId target, uint32_t x, uint32_t y,
+                                                        uint32_t width, uint32_t height,
+                                                        uint32_t slice, uint32_t mip,
+                                                        uint32_t sampleIdx, CompType typeHint)
+{
+  CHECK_REPLAY_THREAD();
+
+  PixelRegionHistory ret;
+
+  for(size_t t = 0; t < m_Textures.size(); t++)
+  {
+    if(m_Textures[t].resourceId == target)
+    {
+      mip = RDCCLAMP(mip, 0U, m_Textures[t].mips);
+
+      uint32_t mipWidth = RDCMAX(1U, m_Textures[t].width >> mip);
+      uint32_t mipHeight = RDCMAX(1U, m_Textures[t].height >> mip);
+
+      if(x >= mipWidth || y >= mipHeight)
+      {
+        RDCDEBUG("PixelHistoryRegion out of bounds on %llu (%u,%u) vs (%u,%u)", target, x, y,
+                 mipWidth, mipHeight);
+        return ret;
+      }
+
+      width = RDCMIN(width, mipWidth - x);
+      height = RDCMIN(height, mipHeight - y);
+
+      if(m_Textures[t].msSamp == 1)
+        sampleIdx = ~0U;
+
+      if(m_Textures[t].dimension == 3)
+      {
+        slice = RDCCLAMP(slice, 0U, m_Textures[t].depth >> mip);
+      }
+      else
+      {
+        slice = RDCCLAMP(slice, 0U, m_Textures[t].arraysize);
+      }
+
+      break;
+    }
+  }
+
+  ret.x = x;
+  ret.y = y;
+  ret.width = width;
+  ret.height = height;
+
+  if(width == 0 || height == 0)
+    return ret;
+
+  ResourceId id = m_pDevice->GetLiveID(target);
 
   if(id == ResourceId())
     return ret;
 
-  ret = m_pDevice->PixelHistory(events, id, x, y, slice, mip, sampleIdx, typeHint);
+  std::vector<EventUsage> events = GetPixelHistoryEvents(m_pDevice->GetUsage(id), m_EventID);
+
+  if(events.empty())
+  {
+    RDCDEBUG("Target %llu not written to before %u", target, m_EventID);
+    ret.offsets.resize(width * height + 1);
+    return ret;
+  }
+
+  ret = m_pDevice->PixelHistoryRegion(events, id, x, y, width, height, slice, mip, sampleIdx,
+                                      typeHint);
 
   SetFrameEvent(m_EventID, true);
 
@@ -176,6 +176,7 @@ public:
   rdcarray<CounterResult> FetchCounters(const rdcarray<GPUCounter> &counters);
   rdcarray<GPUCounter> EnumerateCounters();
   CounterDescription DescribeCounter(GPUCounter counterID);
+  ReplayProfile GetReplayProfile(bool gpuTimings);
   const rdcarray<TextureDescription> &GetTextures();
   const rdcarray<BufferDescription> &GetBuffers();
   const rdcarray<ResourceDescription> &GetResources();
@@ -186,6 +187,9 @@ public:
 
   rdcarray<PixelModification> PixelHistory(ResourceId target, uint32_t x, uint32_t y, uint32_t slice,
                                            uint32_t mip, uint32_t sampleIdx, CompType typeHint);
+  PixelRegionHistory PixelHistoryRegion(ResourceId target, uint32_t x, uint32_t y, uint32_t width,
+                                        uint32_t height, uint32_t slice, uint32_t mip,
+                                        uint32_t sampleIdx, CompType typeHint);
   ShaderDebugTrace *DebugVertex(uint32_t vertid, uint32_t instid, uint32_t idx, uint32_t instOffset,
                                 uint32_t vertOffset);
   ShaderDebugTrace *DebugPixel(uint32_t x, uint32_t y, uint32_t sample, uint32_t primitive);
@@ -574,6 +574,36 @@ uint64_t CalcMeshOutputSize(uint64_t curSize, uint64_t requiredOutput)
   return curSize;
 }
 
+PixelRegionHistory PixelHistoryRegionPerPixel(IRemoteDriver *driver,
+                                              const std::vector<EventUsage> &events,
+                                              ResourceId target, uint32_t x, uint32_t y,
+                                              uint32_t width, uint32_t height, uint32_t slice,
+                                              uint32_t mip, uint32_t sampleIdx, CompType typeHint)
+{
+  PixelRegionHistory ret;
+  ret.x = x;
+  ret.y = y;
+  ret.width = width;
+  ret.height = height;
+
+  ret.offsets.reserve(width * height + 1);
+  ret.offsets.push_back(0);
+
+  for(uint32_t row = 0; row < height; row++)
+  {
+    for(uint32_t col = 0; col < width; col++)
+    {
+      std::vector<PixelModification> mods =
+          driver->PixelHistory(events, target, x + col, y + row, slice, mip, sampleIdx, typeHint);
+
+      ret.modifications.append(mods.data(), mods.size());
+      ret.offsets.push_back((uint32_t)ret.modifications.size());
+    }
+  }
+
+  return ret;
+}
+
 FloatVector HighlightCache::InterpretVertex(const byte *data, uint32_t vert, const MeshDisplay &cfg,
                                             const byte *end, bool useidx, bool &valid)
 {
@@ -610,71 +640,44 @@ FloatVector HighlightCache::InterpretVertex(const byte *data, uint32_t vert,
                                             uint32_t vertexByteStride, const ResourceFormat &fmt,
                                             const byte *end, bool &valid)
 {
-  FloatVector ret(0.0f, 0.0f, 0.0f, 1.0f);
+  FloatVector ret;
+  InterpretVertices(data, vert, 1, vertexByteStride, fmt, end, &ret, valid);
+  return ret;
+}
 
-  data += vert * vertexByteStride;
+void HighlightCache::InterpretVertices(const byte *data, uint32_t firstVert, uint32_t numVerts,
+                                       uint32_t vertexByteStride, const ResourceFormat &fmt,
+                                       const byte *end, FloatVector *out, bool &valid)
+{
+  RDCCOMPILE_ASSERT(sizeof(FloatVector) == sizeof(Vec4f), "FloatVector must match Vec4f layout");
 
-  float *out = &ret.x;
+  if(numVerts == 0)
+    return;
 
-  if(fmt.type == ResourceFormatType::R10G10B10A2)
-  {
-    if(data + 4 >= end)
-    {
-      valid = false;
-      return ret;
-    }
+  const uint32_t elemSize = GetFormattedElementSize(fmt);
 
-    Vec4f v;
-    if(fmt.compType == CompType::SNorm)
-      v = ConvertFromR10G10B10A2SNorm(*(const uint32_t *)data);
-    else
-      v = ConvertFromR10G10B10A2(*(const uint32_t *)data);
-    ret.x = v.x;
-    ret.y = v.y;
-    ret.z = v.z;
-    ret.w = v.w;
-    return ret;
-  }
-  else if(fmt.type == ResourceFormatType::R11G11B10)
-  {
-    if(data + 4 >= end)
-    {
-      valid = false;
-      return ret;
-    }
+  data += firstVert * vertexByteStride;
 
-    Vec3f v = ConvertFromR11G11B10(*(const uint32_t *)data);
-    ret.x = v.x;
-    ret.y = v.y;
-    ret.z = v.z;
-    return ret;
-  }
+  // work out how many vertices fit entirely in the data, the rest are left as defaults
+  uint32_t numValid = 0;
 
-  if(data + fmt.compCount * fmt.compByteWidth > end)
+  if(elemSize > 0 && data + elemSize <= end)
   {
-    valid = false;
-    return ret;
+    if(vertexByteStride == 0)
+      numValid = numVerts;
+    else
+      numValid = RDCMIN(numVerts, uint32_t((end - data - elemSize) / vertexByteStride) + 1);
   }
 
-  for(uint32_t i = 0; i < fmt.compCount; i++)
-  {
-    *out = ConvertComponent(fmt, data);
+  if(numValid > 0 &&
+     !DecodeFormattedElements(fmt, data, vertexByteStride, numValid, (Vec4f *)out))
+    numValid = 0;
 
-    data += fmt.compByteWidth;
-    out++;
-  }
+  for(uint32_t i = numValid; i < numVerts; i++)
+    out[i] = FloatVector(0.0f, 0.0f, 0.0f, 1.0f);
 
-  if(fmt.BGRAOrder())
-  {
-    FloatVector reversed;
-    reversed.x = ret.z;
-    reversed.y = ret.y;
-    reversed.z = ret.x;
-    reversed.w = ret.w;
-    return reversed;
-  }
-
-  return ret;
+  if(numValid < numVerts)
+    valid = false;
 }
 
 uint64_t inthash(uint64_t val, uint64_t seed)
@@ -122,6 +122,7 @@ public:
 
   virtual ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers) = 0;
   virtual void ReplayLog(uint32_t endEventID, ReplayLogType replayType) = 0;
+  virtual ReplayProfile ProfileReplay() = 0;
   virtual const SDFile &GetStructuredFile() = 0;
 
   virtual std::vector<uint32_t> GetPassEvents(uint32_t eventId) = 0;
@@ -158,6 +159,10 @@ public:
                                                       ResourceId target, uint32_t x, uint32_t y,
                                                       uint32_t slice, uint32_t mip,
                                                       uint32_t sampleIdx, CompType typeHint) = 0;
+  virtual PixelRegionHistory PixelHistoryRegion(std::vector<EventUsage> events, ResourceId target,
+                                                uint32_t x, uint32_t y, uint32_t width,
+                                                uint32_t height, uint32_t slice, uint32_t mip,
+                                                uint32_t sampleIdx, CompType typeHint) = 0;
   virtual ShaderDebugTrace DebugVertex(uint32_t eventId, uint32_t vertid, uint32_t instid,
                                        uint32_t idx, uint32_t instOffset, uint32_t vertOffset) = 0;
   virtual ShaderDebugTrace DebugPixel(uint32_t eventId, uint32_t x, uint32_t y, uint32_t sample,
@@ -250,6 +255,13 @@ void PatchTriangleFanRestartIndexBufer(std::vector<uint32_t> &patchedIndices, ui
 
 uint64_t CalcMeshOutputSize(uint64_t curSize, uint64_t requiredOutput);
 
+// for drivers that can't gather the history of a region at once, fetch it one pixel at a time.
+PixelRegionHistory PixelHistoryRegionPerPixel(IRemoteDriver *driver,
+                                              const std::vector<EventUsage> &events,
+                                              ResourceId target, uint32_t x, uint32_t y,
+                                              uint32_t width, uint32_t height, uint32_t slice,
+                                              uint32_t mip, uint32_t sampleIdx, CompType typeHint);
+
 void StandardFillCBufferVariable(uint32_t dataOffset, const bytebuf &data, ShaderVariable &outvar,
                                  uint32_t matStride);
 void StandardFillCBufferVariables(const rdcarray<ShaderConstant> &invars,
@@ -279,6 +291,12 @@ struct HighlightCache
   static FloatVector InterpretVertex(const byte *data, uint32_t vert, uint32_t vertexByteStride,
                                      const ResourceFormat &fmt, const byte *end, bool &valid);
 
+  // decodes numVerts consecutive vertices starting at firstVert. Any that lie past the end of the
+  // data are set to (0, 0, 0, 1) and valid is set to false.
+  static void InterpretVertices(const byte *data, uint32_t firstVert, uint32_t numVerts,
+                                uint32_t vertexByteStride, const ResourceFormat &fmt,
+                                const byte *end, FloatVector *out, bool &valid);
+
   FloatVector InterpretVertex(const byte *data, uint32_t vert, const MeshDisplay &cfg,
                               const byte *end, bool useidx, bool &valid);
 };
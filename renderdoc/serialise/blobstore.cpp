@@ -0,0 +1,408 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "blobstore.h"
+#include <algorithm>
+#include "3rdparty/zstd/xxhash.h"
+#include "os/os_specific.h"
+#include "strings/string_utils.h"
+
+// blobs end wherever the rolling hash of the last bytes matches, so the same data gives the same
+// blobs wherever it appears in a section. The minimum and maximum sizes keep the number of blobs
+// reasonable for data that never or always matches.
+static const uint64_t minBlobSize = 64 * 1024;
+static const uint64_t maxBlobSize = 2 * 1024 * 1024;
+
+// the top bits of the hash depend on the most bytes, this gives around 256kb past the minimum
+// size on average
+static const uint64_t blobBoundaryMask = 0xFFFFC00000000000ULL;
+
+static const uint32_t blobStoreMagic = MAKE_FOURCC('R', 'D', 'B', 'S');
+static const uint32_t blobStoreVersion = 1;
+
+static const uint64_t blobHashSeed = 0x52444f43424c4f42ULL;
+
+struct BlobGearTable
+{
+  BlobGearTable()
+  {
+    // any random values will do, but these must never change or new blobs won't match existing
+    // blobs in a store
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(uint64_t &v : values)
+    {
+      state += 0x9E3779B97F4A7C15ULL;
+      uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      v = z ^ (z >> 31);
+    }
+  }
+
+  uint64_t values[256];
+};
+
+static const BlobGearTable blobGear;
+
+static std::string ResolveStorePath(const std::string &captureFilename, const std::string &store)
+{
+  if(!FileIO::IsRelativePath(store))
+    return store;
+
+  return get_dirname(FileIO::GetFullPathname(captureFilename)) + "/" + store;
+}
+
+static std::string BlobFilename(const std::string &store, const uint64_t hash[2])
+{
+  std::string name = StringFormat::Fmt("%016llx%016llx", hash[0], hash[1]);
+
+  // spread the blobs out a little so no single directory gets too large
+  return store + "/" + name.substr(0, 2) + "/" + name.substr(2);
+}
+
+BlobStoreCompressor::BlobStoreCompressor(StreamWriter *write, Ownership own,
+                                         const std::string &captureFilename,
+                                         const std::string &store)
+    : Compressor(write, own)
+{
+  m_StorePath = ResolveStorePath(captureFilename, store);
+
+  m_Blob = AllocAlignedBuffer(maxBlobSize);
+  m_CompressBuffer = AllocAlignedBuffer(ZSTD_compressBound(maxBlobSize));
+
+  m_Ctx = ZSTD_createCCtx();
+
+  // the section only holds a header then the list of blobs
+  uint32_t storeLen = (uint32_t)store.size();
+
+  m_Write->Write(blobStoreMagic);
+  m_Write->Write(blobStoreVersion);
+  m_Write->Write(storeLen);
+  m_Write->Write(store.c_str(), storeLen);
+}
+
+BlobStoreCompressor::~BlobStoreCompressor()
+{
+  ZSTD_freeCCtx(m_Ctx);
+
+  FreeAlignedBuffer(m_Blob);
+  FreeAlignedBuffer(m_CompressBuffer);
+}
+
+bool BlobStoreCompressor::Write(const void *data, uint64_t numBytes)
+{
+  // if we encountered a stream error this will be NULL
+  if(!m_CompressBuffer)
+    return false;
+
+  const byte *src = (const byte *)data;
+
+  while(numBytes > 0)
+  {
+    // copy in up to the minimum size without hashing, boundaries can't be before that
+    if(m_BlobSize < minBlobSize)
+    {
+      uint64_t len = RDCMIN(numBytes, minBlobSize - m_BlobSize);
+      memcpy(m_Blob + m_BlobSize, src, (size_t)len);
+
+      m_BlobSize += len;
+      src += len;
+      numBytes -= len;
+      continue;
+    }
+
+    bool boundary = false;
+
+    while(numBytes > 0 && m_BlobSize < maxBlobSize)
+    {
+      byte b = *(src++);
+      numBytes--;
+
+      m_Blob[m_BlobSize++] = b;
+      m_RollingHash = (m_RollingHash << 1) + blobGear.values[b];
+
+      if((m_RollingHash & blobBoundaryMask) == 0)
+      {
+        boundary = true;
+        break;
+      }
+    }
+
+    if(boundary || m_BlobSize == maxBlobSize)
+    {
+      if(!FlushBlob())
+        return false;
+    }
+  }
+
+  return true;
+}
+
+bool BlobStoreCompressor::Finish()
+{
+  if(!m_CompressBuffer)
+    return false;
+
+  bool success = true;
+
+  if(m_BlobSize > 0)
+    success &= FlushBlob();
+
+  RDCLOG("Stored %u blobs in %s, %u new (%llu bytes)", m_NumBlobs, m_StorePath.c_str(), m_NewBlobs,
+         m_NewBytes);
+
+  return success;
+}
+
+bool BlobStoreCompressor::FlushBlob()
+{
+  uint64_t hash[2] = {
+      XXH64(m_Blob, (size_t)m_BlobSize, 0), XXH64(m_Blob, (size_t)m_BlobSize, blobHashSeed),
+  };
+
+  std::string filename = BlobFilename(m_StorePath, hash);
+
+  // if the store already has this blob, we can just reference it
+  if(!FileIO::exists(filename.c_str()))
+  {
+    size_t compSize = ZSTD_compressCCtx(m_Ctx, m_CompressBuffer, ZSTD_compressBound(maxBlobSize),
+                                        m_Blob, (size_t)m_BlobSize, 7);
+
+    if(ZSTD_isError(compSize))
+    {
+      RDCERR("Error compressing blob: %s", ZSTD_getErrorName(compSize));
+      FreeAlignedBuffer(m_CompressBuffer);
+      m_CompressBuffer = NULL;
+      return false;
+    }
+
+    // write to a temporary file first and move it into place, so that if several captures are
+    // being stored at once, no-one sees a partially written blob
+    std::string tempFilename =
+        StringFormat::Fmt("%s.%u.tmp", filename.c_str(), Process::GetCurrentPID());
+
+    FileIO::CreateParentDirectory(filename);
+
+    if(!FileIO::dump(tempFilename.c_str(), m_CompressBuffer, compSize) ||
+       !FileIO::Move(tempFilename.c_str(), filename.c_str(), true))
+    {
+      RDCERR("Couldn't write blob to %s", filename.c_str());
+      FileIO::Delete(tempFilename.c_str());
+      FreeAlignedBuffer(m_CompressBuffer);
+      m_CompressBuffer = NULL;
+      return false;
+    }
+
+    m_NewBlobs++;
+    m_NewBytes += compSize;
+  }
+
+  m_NumBlobs++;
+
+  uint32_t size = (uint32_t)m_BlobSize;
+
+  m_Write->Write(hash[0]);
+  m_Write->Write(hash[1]);
+  m_Write->Write(size);
+
+  m_BlobSize = 0;
+  m_RollingHash = 0;
+
+  return !m_Write->IsErrored();
+}
+
+BlobStoreDecompressor::BlobStoreDecompressor(StreamReader *read, Ownership own,
+                                             const std::string &captureFilename)
+    : Decompressor(read, own)
+{
+  m_Blob = AllocAlignedBuffer(maxBlobSize);
+  m_Ctx = ZSTD_createDCtx();
+
+  uint32_t magic = 0, version = 0, storeLen = 0;
+
+  m_Read->Read(magic);
+  m_Read->Read(version);
+  m_Read->Read(storeLen);
+
+  if(magic != blobStoreMagic || version != blobStoreVersion || storeLen > m_Read->GetSize())
+  {
+    RDCERR("Unrecognised blob store section, magic %x version %u", magic, version);
+    m_Errored = true;
+    return;
+  }
+
+  std::string store;
+  store.resize(storeLen);
+  m_Read->Read(&store[0], storeLen);
+
+  m_StorePath = ResolveStorePath(captureFilename, store);
+
+  // read the whole index up front so we can seek to any blob
+  while(!m_Read->AtEnd() && !m_Read->IsErrored())
+  {
+    BlobRef blob;
+
+    m_Read->Read(blob.hash[0]);
+    m_Read->Read(blob.hash[1]);
+    m_Read->Read(blob.size);
+    blob.offset = m_Size;
+
+    if(blob.size > maxBlobSize)
+    {
+      RDCERR("Invalid blob size %u", blob.size);
+      m_Errored = true;
+      return;
+    }
+
+    m_Size += blob.size;
+    m_Blobs.push_back(blob);
+  }
+
+  m_Errored |= m_Read->IsErrored();
+}
+
+BlobStoreDecompressor::~BlobStoreDecompressor()
+{
+  ZSTD_freeDCtx(m_Ctx);
+
+  FreeAlignedBuffer(m_Blob);
+}
+
+bool BlobStoreDecompressor::Recompress(Compressor *comp)
+{
+  bool success = true;
+
+  while(success && m_Offset < m_Size)
+  {
+    size_t idx = FindBlob(m_Offset);
+
+    success &= LoadBlob(idx);
+    if(success)
+    {
+      const BlobRef &blob = m_Blobs[idx];
+      uint64_t blobOffs = m_Offset - blob.offset;
+
+      success &= comp->Write(m_Blob + blobOffs, blob.size - blobOffs);
+      m_Offset = blob.offset + blob.size;
+    }
+  }
+  success &= comp->Finish();
+
+  return success;
+}
+
+bool BlobStoreDecompressor::Read(void *data, uint64_t numBytes)
+{
+  if(m_Errored)
+    return false;
+
+  if(m_Offset + numBytes > m_Size)
+  {
+    RDCERR("Reading %llu bytes at %llu from %llu byte stream", numBytes, m_Offset, m_Size);
+    return false;
+  }
+
+  byte *dst = (byte *)data;
+
+  while(numBytes > 0)
+  {
+    // reads are almost always within the blob that's already loaded
+    size_t idx = m_Loaded;
+
+    if(idx >= m_Blobs.size() || m_Offset < m_Blobs[idx].offset ||
+       m_Offset >= m_Blobs[idx].offset + m_Blobs[idx].size)
+    {
+      idx = FindBlob(m_Offset);
+
+      if(!LoadBlob(idx))
+        return false;
+    }
+
+    const BlobRef &blob = m_Blobs[idx];
+    uint64_t blobOffs = m_Offset - blob.offset;
+    uint64_t size = RDCMIN(numBytes, blob.size - blobOffs);
+
+    if(dst)
+    {
+      memcpy(dst, m_Blob + blobOffs, (size_t)size);
+      dst += size;
+    }
+
+    numBytes -= size;
+    m_Offset += size;
+  }
+
+  return true;
+}
+
+bool BlobStoreDecompressor::Seek(uint64_t offset)
+{
+  if(m_Errored || offset > m_Size)
+    return false;
+
+  m_Offset = offset;
+  return true;
+}
+
+size_t BlobStoreDecompressor::FindBlob(uint64_t offset) const
+{
+  // find the last blob starting at or before the offset
+  auto it = std::upper_bound(m_Blobs.begin(), m_Blobs.end(), offset,
+                             [](uint64_t offs, const BlobRef &b) { return offs < b.offset; });
+
+  return size_t(it - m_Blobs.begin()) - 1;
+}
+
+bool BlobStoreDecompressor::LoadBlob(size_t idx)
+{
+  if(m_Loaded == idx)
+    return true;
+
+  const BlobRef &blob = m_Blobs[idx];
+
+  std::string filename = BlobFilename(m_StorePath, blob.hash);
+
+  if(!FileIO::slurp(filename.c_str(), m_CompressBuffer))
+  {
+    RDCERR("Blob %s is missing from the store", filename.c_str());
+    m_Errored = true;
+    return false;
+  }
+
+  size_t size = ZSTD_decompressDCtx(m_Ctx, m_Blob, maxBlobSize, m_CompressBuffer.data(),
+                                    m_CompressBuffer.size());
+
+  if(ZSTD_isError(size) || size != blob.size || XXH64(m_Blob, size, 0) != blob.hash[0] ||
+     XXH64(m_Blob, size, blobHashSeed) != blob.hash[1])
+  {
+    RDCERR("Blob %s is corrupt", filename.c_str());
+    m_Errored = true;
+    return false;
+  }
+
+  m_Loaded = idx;
+
+  return true;
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "zstd/zstd.h"
+#include "streamio.h"
+
+// splits a section into content-defined blobs and stores each one, compressed, in a shared store
+// directory named by the hash of its contents. Only an index of the blobs is written to the
+// section itself, so any data repeated between sections or captures using the same store is only
+// stored once.
+class BlobStoreCompressor : public Compressor
+{
+public:
+  // a relative store path is relative to the directory containing the capture, and is recorded
+  // as-is so the captures and the store can be moved together
+  BlobStoreCompressor(StreamWriter *write, Ownership own, const std::string &captureFilename,
+                      const std::string &store);
+  ~BlobStoreCompressor();
+
+  bool Write(const void *data, uint64_t numBytes);
+  bool Finish();
+
+private:
+  bool FlushBlob();
+
+  std::string m_StorePath;
+
+  byte *m_Blob;
+  uint64_t m_BlobSize = 0;
+  uint64_t m_RollingHash = 0;
+
+  byte *m_CompressBuffer;
+  ZSTD_CCtx *m_Ctx;
+
+  uint32_t m_NumBlobs = 0;
+  uint32_t m_NewBlobs = 0;
+  uint64_t m_NewBytes = 0;
+};
+
+// reads back the contents of a section written with BlobStoreCompressor by fetching each blob from
+// the store as it's needed.
+class BlobStoreDecompressor : public Decompressor
+{
+public:
+  BlobStoreDecompressor(StreamReader *read, Ownership own, const std::string &captureFilename);
+  ~BlobStoreDecompressor();
+
+  bool Recompress(Compressor *comp);
+  bool Read(void *data, uint64_t numBytes);
+  bool Seek(uint64_t offset);
+
+private:
+  size_t FindBlob(uint64_t offset) const;
+  bool LoadBlob(size_t idx);
+
+  struct BlobRef
+  {
+    uint64_t hash[2];
+    uint32_t size;
+    uint64_t offset;
+  };
+
+  std::string m_StorePath;
+  std::vector<BlobRef> m_Blobs;
+  uint64_t m_Size = 0;
+  uint64_t m_Offset = 0;
+
+  // the blob currently loaded, if any
+  size_t m_Loaded = ~size_t(0);
+  byte *m_Blob;
+  std::vector<byte> m_CompressBuffer;
+  ZSTD_DCtx *m_Ctx;
+
+  bool m_Errored = false;
+};
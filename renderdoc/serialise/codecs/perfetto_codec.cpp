@@ -0,0 +1,414 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include <map>
+#include "common/common.h"
+#include "core/core.h"
+#include "replay/replay_controller.h"
+#include "serialise/rdcfile.h"
+
+// Writes a binary Perfetto trace (https://perfetto.dev), as a stream of protobuf encoded
+// TracePackets. Only the handful of fields needed are encoded, with field numbers from perfetto's
+// trace_packet.proto, track_event.proto and track_descriptor.proto.
+
+namespace
+{
+enum
+{
+  Trace_packet = 1,
+
+  TracePacket_timestamp = 8,
+  TracePacket_trusted_packet_sequence_id = 10,
+  TracePacket_track_event = 11,
+  TracePacket_sequence_flags = 13,
+  TracePacket_track_descriptor = 60,
+
+  TrackDescriptor_uuid = 1,
+  TrackDescriptor_name = 2,
+  TrackDescriptor_process = 3,
+  TrackDescriptor_thread = 4,
+  TrackDescriptor_parent_uuid = 5,
+
+  ProcessDescriptor_pid = 1,
+  ProcessDescriptor_process_name = 6,
+
+  ThreadDescriptor_pid = 1,
+  ThreadDescriptor_tid = 2,
+  ThreadDescriptor_thread_name = 5,
+
+  TrackEvent_debug_annotations = 4,
+  TrackEvent_type = 9,
+  TrackEvent_track_uuid = 11,
+  TrackEvent_categories = 22,
+  TrackEvent_name = 23,
+
+  TrackEvent_Type_SliceBegin = 1,
+  TrackEvent_Type_SliceEnd = 2,
+  TrackEvent_Type_Instant = 3,
+
+  DebugAnnotation_uint_value = 3,
+  DebugAnnotation_double_value = 5,
+  DebugAnnotation_name = 10,
+
+  SequenceFlags_IncrementalStateCleared = 1,
+};
+
+enum WireType
+{
+  WireVarint = 0,
+  Wire64Bit = 1,
+  WireLengthDelimited = 2,
+};
+
+struct ProtoMessage
+{
+  std::string data;
+
+  void Clear() { data.clear(); }
+  void Varint(uint64_t val)
+  {
+    while(val >= 0x80)
+    {
+      data.push_back(char(0x80 | (val & 0x7f)));
+      val >>= 7;
+    }
+    data.push_back(char(val));
+  }
+  void Tag(uint32_t field, WireType type) { Varint((uint64_t(field) << 3) | type); }
+  void UInt(uint32_t field, uint64_t val)
+  {
+    Tag(field, WireVarint);
+    Varint(val);
+  }
+  void Double(uint32_t field, double val)
+  {
+    Tag(field, Wire64Bit);
+    data.append((const char *)&val, sizeof(val));
+  }
+  void String(uint32_t field, const char *str, size_t len)
+  {
+    Tag(field, WireLengthDelimited);
+    Varint(len);
+    data.append(str, len);
+  }
+  void String(uint32_t field, const rdcstr &str) { String(field, str.c_str(), str.size()); }
+  void String(uint32_t field, const std::string &str) { String(field, str.c_str(), str.size()); }
+  void Message(uint32_t field, const ProtoMessage &msg)
+  {
+    String(field, msg.data.c_str(), msg.data.size());
+  }
+};
+
+// all of our packets are on one sequence
+static const uint32_t sequenceId = 1;
+
+static const uint64_t processTrack = 1;
+static const uint64_t frameTrack = 2;
+static const uint64_t firstThreadTrack = 0x100;
+
+class PerfettoWriter
+{
+public:
+  PerfettoWriter(FILE *f) : m_Writer(f, Ownership::Stream) {}
+  bool IsErrored() { return m_Writer.IsErrored(); }
+  void TrackDescriptor(uint64_t uuid, uint64_t parent, const std::string &name, uint64_t tid)
+  {
+    m_Packet.Clear();
+    m_Message.Clear();
+    m_Child.Clear();
+
+    m_Message.UInt(TrackDescriptor_uuid, uuid);
+    m_Message.String(TrackDescriptor_name, name);
+
+    if(parent == 0)
+    {
+      m_Child.UInt(ProcessDescriptor_pid, 5);
+      m_Child.String(ProcessDescriptor_process_name, name);
+      m_Message.Message(TrackDescriptor_process, m_Child);
+    }
+    else
+    {
+      m_Message.UInt(TrackDescriptor_parent_uuid, parent);
+
+      if(tid != 0)
+      {
+        m_Child.UInt(ThreadDescriptor_pid, 5);
+        m_Child.UInt(ThreadDescriptor_tid, tid);
+        m_Child.String(ThreadDescriptor_thread_name, name);
+        m_Message.Message(TrackDescriptor_thread, m_Child);
+      }
+    }
+
+    m_Packet.UInt(TracePacket_trusted_packet_sequence_id, sequenceId);
+
+    // the first packet on the sequence marks that it has no prior state to depend on
+    if(m_First)
+      m_Packet.UInt(TracePacket_sequence_flags, SequenceFlags_IncrementalStateCleared);
+    m_First = false;
+
+    m_Packet.Message(TracePacket_track_descriptor, m_Message);
+
+    WritePacket();
+  }
+
+  // begin or end a slice, or an instant event. Name and category are ignored for slice ends
+  void Event(uint64_t track, uint64_t timestampNS, uint32_t type, const char *name,
+             const char *category, uint32_t eventId = 0, double gpuDuration = -1.0)
+  {
+    m_Packet.Clear();
+    m_Message.Clear();
+
+    m_Message.UInt(TrackEvent_type, type);
+    m_Message.UInt(TrackEvent_track_uuid, track);
+
+    if(type != TrackEvent_Type_SliceEnd)
+    {
+      m_Message.String(TrackEvent_name, name, strlen(name));
+      m_Message.String(TrackEvent_categories, category, strlen(category));
+
+      if(eventId != 0)
+      {
+        m_Child.Clear();
+        m_Child.String(DebugAnnotation_name, "eventId", 7);
+        m_Child.UInt(DebugAnnotation_uint_value, eventId);
+        m_Message.Message(TrackEvent_debug_annotations, m_Child);
+      }
+
+      if(gpuDuration >= 0.0)
+      {
+        m_Child.Clear();
+        m_Child.String(DebugAnnotation_name, "gpuDuration", 11);
+        m_Child.Double(DebugAnnotation_double_value, gpuDuration);
+        m_Message.Message(TrackEvent_debug_annotations, m_Child);
+      }
+    }
+
+    m_Packet.UInt(TracePacket_timestamp, timestampNS);
+    m_Packet.UInt(TracePacket_trusted_packet_sequence_id, sequenceId);
+    m_Packet.Message(TracePacket_track_event, m_Message);
+
+    WritePacket();
+  }
+
+private:
+  void WritePacket()
+  {
+    m_Header.Clear();
+    m_Header.Tag(Trace_packet, WireLengthDelimited);
+    m_Header.Varint(m_Packet.data.size());
+
+    m_Writer.Write(m_Header.data.data(), m_Header.data.size());
+    m_Writer.Write(m_Packet.data.data(), m_Packet.data.size());
+  }
+
+  StreamWriter m_Writer;
+  bool m_First = true;
+
+  // re-used between packets so that writing doesn't allocate once they've grown
+  ProtoMessage m_Header, m_Packet, m_Message, m_Child;
+};
+
+struct FrameTimeline
+{
+  PerfettoWriter &writer;
+  std::map<uint32_t, double> gpuTimes;
+  std::map<uint32_t, double> cpuTimes;
+  bool useGPU;
+  uint64_t time;
+
+  double Duration(const DrawcallDescription &draw)
+  {
+    if(useGPU)
+    {
+      auto it = gpuTimes.find(draw.eventId);
+      return it == gpuTimes.end() ? 0.0 : it->second;
+    }
+
+    double ret = 0.0;
+    for(const APIEvent &ev : draw.events)
+    {
+      auto it = cpuTimes.find(ev.eventId);
+      if(it != cpuTimes.end())
+        ret += it->second;
+    }
+    return ret;
+  }
+
+  // lays the drawcalls out end to end, nesting each marker region around its children
+  void Write(const rdcarray<DrawcallDescription> &draws)
+  {
+    for(const DrawcallDescription &draw : draws)
+    {
+      if(!draw.children.empty())
+      {
+        writer.Event(frameTrack, time, TrackEvent_Type_SliceBegin, draw.name.c_str(), "Marker",
+                     draw.eventId);
+        Write(draw.children);
+        writer.Event(frameTrack, time, TrackEvent_Type_SliceEnd, NULL, NULL);
+      }
+      else if(draw.flags & DrawFlags::SetMarker)
+      {
+        writer.Event(frameTrack, time, TrackEvent_Type_Instant, draw.name.c_str(), "Marker",
+                     draw.eventId);
+      }
+      else
+      {
+        auto it = gpuTimes.find(draw.eventId);
+
+        writer.Event(frameTrack, time, TrackEvent_Type_SliceBegin, draw.name.c_str(), "Drawcall",
+                     draw.eventId, it == gpuTimes.end() ? -1.0 : it->second);
+        time += uint64_t(Duration(draw) * 1.0e9);
+        writer.Event(frameTrack, time, TrackEvent_Type_SliceEnd, NULL, NULL);
+      }
+    }
+  }
+};
+};
+
+ReplayStatus exportPerfetto(const char *filename, const RDCFile &rdc, const SDFile &structData,
+                            RENDERDOC_ProgressCallback progress)
+{
+  FILE *f = FileIO::fopen(filename, "wb");
+
+  if(!f)
+    return ReplayStatus::FileIOFailed;
+
+  PerfettoWriter writer(f);
+
+  writer.TrackDescriptor(processTrack, 0, rdc.GetDriverName() + " capture", 0);
+
+  std::map<uint64_t, uint64_t> threadTracks;
+
+  const char *category = "Initialisation";
+
+  uint64_t frameStart = 0;
+
+  int i = 0;
+  int numChunks = structData.chunks.count();
+
+  // each chunk is written straight out as a slice on the track for the thread that recorded it
+  for(const SDChunk *chunk : structData.chunks)
+  {
+    const SDChunkMetaData &meta = chunk->metadata;
+
+    if(meta.chunkID == (uint32_t)SystemChunk::FirstDriverChunk + 1)
+    {
+      category = "Frame Capture";
+      frameStart = meta.timestampMicro * 1000;
+    }
+
+    auto it = threadTracks.find(meta.threadID);
+    if(it == threadTracks.end())
+    {
+      uint64_t uuid = firstThreadTrack + threadTracks.size();
+      it = threadTracks.insert(std::make_pair(meta.threadID, uuid)).first;
+
+      writer.TrackDescriptor(uuid, processTrack,
+                             StringFormat::Fmt("Thread %llu", meta.threadID), meta.threadID);
+    }
+
+    uint64_t timestamp = meta.timestampMicro * 1000;
+
+    if(meta.durationMicro <= 0)
+    {
+      writer.Event(it->second, timestamp, TrackEvent_Type_Instant, chunk->name.c_str(), category);
+    }
+    else
+    {
+      writer.Event(it->second, timestamp, TrackEvent_Type_SliceBegin, chunk->name.c_str(),
+                   category);
+      writer.Event(it->second, timestamp + meta.durationMicro * 1000, TrackEvent_Type_SliceEnd,
+                   NULL, NULL);
+    }
+
+    if(progress)
+      progress(0.5f * float(i) / float(numChunks));
+
+    i++;
+  }
+
+  // the marker hierarchy comes from the drawcall tree, which needs the capture to be replayed. If
+  // that isn't possible here, the per-thread tracks are still useful on their own.
+  ReplayController *controller = new ReplayController();
+
+  // replaying only reads sections from the file, the same as the caller does.
+  ReplayStatus status = controller->CreateDevice((RDCFile *)&rdc, ReplayOptions());
+
+  if(status == ReplayStatus::Succeeded)
+  {
+    if(progress)
+      progress(0.6f);
+
+    ReplayProfile profile = controller->GetReplayProfile(true);
+
+    if(progress)
+      progress(0.9f);
+
+    FrameTimeline timeline = {writer};
+    timeline.useGPU = false;
+    timeline.time = frameStart;
+
+    for(const ReplayEventTiming &ev : profile.events)
+    {
+      if(ev.eventId == 0)
+        continue;
+
+      timeline.cpuTimes[ev.eventId] += ev.deserialiseTime + ev.executeTime;
+
+      if(ev.gpuTime >= 0.0)
+      {
+        timeline.gpuTimes[ev.eventId] = ev.gpuTime;
+        timeline.useGPU = true;
+      }
+    }
+
+    writer.TrackDescriptor(frameTrack, processTrack,
+                           timeline.useGPU ? "Frame (GPU time)" : "Frame (replay CPU time)", 0);
+
+    timeline.Write(controller->GetDrawcalls());
+  }
+  else
+  {
+    RDCWARN("Couldn't replay capture (%s), exporting without drawcall hierarchy",
+            ToStr(status).c_str());
+  }
+
+  controller->Shutdown();
+
+  if(progress)
+    progress(1.0f);
+
+  return writer.IsErrored() ? ReplayStatus::FileIOFailed : ReplayStatus::Succeeded;
+}
+
+static ConversionRegistration PerfettoConversionRegistration(
+    &exportPerfetto,
+    {
+        "perfetto-trace", "Perfetto trace",
+        R"(Streams the chunk threadID, timestamp and duration data to a binary Perfetto trace that
+can be loaded at ui.perfetto.dev. If the capture can be replayed, the frame's marker regions and
+drawcalls are added as a nested track, timed with GPU durations where available.)",
+        false,
+    });
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include <map>
+#include "common/common.h"
+#include "core/core.h"
+#include "replay/replay_controller.h"
+#include "serialise/rdcfile.h"
+
+ReplayStatus exportReplayProfile(const char *filename, const RDCFile &rdc, const SDFile &structData,
+                                 RENDERDOC_ProgressCallback progress)
+{
+  ReplayController *controller = new ReplayController();
+
+  // replaying only reads sections from the file, the same as the caller does.
+  ReplayStatus status = controller->CreateDevice((RDCFile *)&rdc, ReplayOptions());
+
+  if(status != ReplayStatus::Succeeded)
+  {
+    controller->Shutdown();
+    return status;
+  }
+
+  if(progress)
+    progress(0.3f);
+
+  ReplayProfile profile = controller->GetReplayProfile(true);
+
+  controller->Shutdown();
+
+  if(progress)
+    progress(0.6f);
+
+  FILE *f = FileIO::fopen(filename, "w");
+
+  if(!f)
+    return ReplayStatus::FileIOFailed;
+
+  std::map<uint32_t, rdcstr> chunkNames;
+  for(const ReplayChunkTiming &chunk : profile.replayChunks)
+    chunkNames[chunk.chunkID] = chunk.name;
+
+  std::string str;
+
+  str = R"({
+  "displayTimeUnit": "ns",
+  "traceEvents": [)";
+
+  str += R"(
+    { "name": "thread_name", "ph": "M", "pid": 5, "tid": 1, "args": { "name": "Phases" } },
+    { "name": "thread_name", "ph": "M", "pid": 5, "tid": 2, "args": { "name": "Chunks" } })";
+
+  for(const ReplayPhaseTiming &phase : profile.phases)
+  {
+    str += StringFormat::Fmt(R"(,
+    { "name": "%s", "cat": "Phase", "ph": "X", "ts": %.3f, "dur": %.3f, "pid": 5, "tid": 1 })",
+                             phase.name.c_str(), phase.startTime * 1.0e6, phase.duration * 1.0e6);
+  }
+
+  int i = 0;
+  int numEvents = profile.events.count();
+
+  for(const ReplayEventTiming &ev : profile.events)
+  {
+    // each chunk is a span split into its deserialise and execute parts, with the GPU time as an
+    // argument since it isn't measured on the same timeline.
+    const char *name = chunkNames[ev.chunkID].c_str();
+    double start = ev.startTime * 1.0e6;
+    double deserialise = ev.deserialiseTime * 1.0e6;
+    double execute = ev.executeTime * 1.0e6;
+
+    str += StringFormat::Fmt(R"(,
+    { "name": "%s", "cat": "Chunk", "ph": "X", "ts": %.3f, "dur": %.3f, "pid": 5, "tid": 2,
+      "args": { "eventId": %u, "gpuTime": %.9f } },
+    { "name": "Deserialise", "cat": "Chunk", "ph": "X", "ts": %.3f, "dur": %.3f, "pid": 5,
+      "tid": 2 },
+    { "name": "Execute", "cat": "Chunk", "ph": "X", "ts": %.3f, "dur": %.3f, "pid": 5, "tid": 2 })",
+                             name, start, deserialise + execute, ev.eventId, ev.gpuTime, start,
+                             deserialise, start + deserialise, execute);
+
+    if(progress)
+      progress(0.6f + 0.4f * float(i) / float(numEvents));
+
+    i++;
+  }
+
+  // end trace events
+  str += "\n  ]\n}";
+
+  FileIO::fwrite(str.data(), 1, str.size(), f);
+
+  FileIO::fclose(f);
+
+  if(progress)
+    progress(1.0f);
+
+  return ReplayStatus::Succeeded;
+}
+
+static ConversionRegistration ReplayProfileConversionRegistration(
+    &exportReplayProfile,
+    {
+        "replayprofile.json", "Replay profile JSON",
+        R"(Replays the capture while timing it, and exports the load phases and each chunk's
+deserialise and execute time to a JSON format that can be loaded by chrome's profiler at
+chrome://tracing)",
+        false,
+    });
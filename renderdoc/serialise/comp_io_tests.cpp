@@ -22,8 +22,10 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include "blobstore.h"
 #include "lz4io.h"
 #include "serialiser.h"
+#include "zstd_dictionary.h"
 #include "zstdio.h"
 
 #if ENABLED(ENABLE_UNIT_TESTS)
@@ -110,6 +112,82 @@ TEST_CASE("Test LZ4 compression/decompression", "[streamio][lz4]")
   delete[] randomData;
 };
 
+TEST_CASE("Test seeking in LZ4 block compressed streams", "[streamio][lz4]")
+{
+  // a bit over 10 blocks, so the last block is partial
+  const uint64_t size = 10 * 1024 * 1024 + 12345;
+
+  byte *data = new byte[size];
+
+  for(uint64_t i = 0; i < size; i++)
+    data[i] = byte((i * 7) ^ (i >> 12));
+
+  StreamWriter buf(StreamWriter::DefaultScratchSize);
+
+  {
+    StreamWriter writer(new LZ4Compressor(&buf, Ownership::Nothing), Ownership::Stream);
+    writer.Write(data, size);
+    writer.Finish();
+  }
+
+  StreamReader compReader(
+      new LZ4Decompressor(new StreamReader(buf.GetData(), buf.GetOffset()), Ownership::Stream),
+      size, Ownership::Stream);
+
+  // only keep three blocks decompressed at a time
+  StreamReader reader(new LZ4BlockDecompressor(&compReader, size, 3 * 1024 * 1024), size,
+                      Ownership::Stream);
+
+  CHECK(compReader.AtEnd());
+
+  byte *readData = new byte[1024 * 1024 + 100];
+
+  SECTION("Sequential reads")
+  {
+    for(uint64_t offs = 0; offs < size; offs += 1024 * 1024 + 100)
+    {
+      uint64_t len = RDCMIN<uint64_t>(size - offs, 1024 * 1024 + 100);
+      reader.Read(readData, len);
+      CHECK_FALSE(memcmp(readData, data + offs, (size_t)len));
+    }
+
+    CHECK(reader.AtEnd());
+  };
+
+  SECTION("Random seeks")
+  {
+    uint64_t offsets[] = {
+        5 * 1024 * 1024 + 17, 0, size - 100, 1024 * 1024 - 10, 9 * 1024 * 1024, 5 * 1024 * 1024,
+        3 * 1024 * 1024 + 1, 10,
+    };
+
+    for(uint64_t offs : offsets)
+    {
+      reader.SetOffset(offs);
+      CHECK(reader.GetOffset() == offs);
+
+      uint64_t len = RDCMIN<uint64_t>(size - offs, 200000);
+      reader.Read(readData, len);
+      CHECK_FALSE(memcmp(readData, data + offs, (size_t)len));
+    }
+  };
+
+  SECTION("Skipping")
+  {
+    reader.Read(readData, 100);
+    reader.SkipBytes(4 * 1024 * 1024);
+    CHECK(reader.GetOffset() == 4 * 1024 * 1024 + 100);
+
+    reader.Read(readData, 100);
+    CHECK_FALSE(memcmp(readData, data + 4 * 1024 * 1024 + 100, 100));
+  };
+
+  CHECK_FALSE(reader.IsErrored());
+
+  delete[] readData;
+  delete[] data;
+};
+
 TEST_CASE("Test ZSTD compression/decompression", "[streamio][zstd]")
 {
   StreamWriter buf(StreamWriter::DefaultScratchSize);
@@ -190,4 +268,216 @@ TEST_CASE("Test ZSTD compression/decompression", "[streamio][zstd]")
   delete[] randomData;
 };
 
+TEST_CASE("Test ZSTD dictionary training and compression", "[streamio][zstd]")
+{
+  // build fake chunks that share a layout, with a few fields varying per chunk, much like chunk
+  // headers and structures do in a real chunk stream.
+  byte layout[512];
+  for(size_t i = 0; i < sizeof(layout); i++)
+    layout[i] = rand() & 0xff;
+
+  auto makeChunk = [&layout]() {
+    bytebuf ret;
+    ret.assign(layout, sizeof(layout));
+    for(size_t i = 0; i < ret.size(); i += 64)
+      ret[i] = rand() & 0xff;
+    return ret;
+  };
+
+  rdcarray<bytebuf> samples;
+  for(int i = 0; i < 64; i++)
+    samples.push_back(makeChunk());
+
+  bytebuf dictionary;
+
+  SECTION("Not enough data")
+  {
+    CHECK_FALSE(ZstdDictionaries::Train(samples, 64 * 1024, dictionary));
+    CHECK(dictionary.empty());
+  }
+
+  SECTION("Compression with a dictionary")
+  {
+    REQUIRE(ZstdDictionaries::Train(samples, 4096, dictionary));
+    CHECK(!dictionary.empty());
+    CHECK(dictionary.size() <= 4096);
+
+    ZstdDictionary dict(1, RDCDriver::Unknown, dictionary.data(), dictionary.size());
+
+    // a short stream of chunks that weren't in the samples
+    bytebuf data;
+    for(int i = 0; i < 2; i++)
+    {
+      bytebuf chunk = makeChunk();
+      data.append(chunk.data(), chunk.size());
+    }
+
+    StreamWriter plain(StreamWriter::DefaultScratchSize);
+    StreamWriter primed(StreamWriter::DefaultScratchSize);
+
+    {
+      StreamWriter writer(new ZSTDCompressor(&plain, Ownership::Nothing), Ownership::Stream);
+      writer.Write(data.data(), data.size());
+      writer.Finish();
+      CHECK_FALSE(writer.IsErrored());
+    }
+
+    {
+      StreamWriter writer(new ZSTDCompressor(&primed, Ownership::Nothing, &dict),
+                          Ownership::Stream);
+      writer.Write(data.data(), data.size());
+      writer.Finish();
+      CHECK_FALSE(writer.IsErrored());
+    }
+
+    // the chunks can only reference each other without a dictionary, so should be much larger
+    CHECK(primed.GetOffset() * 2 < plain.GetOffset());
+
+    bytebuf readData;
+    readData.resize(data.size());
+
+    StreamReader reader(
+        new ZSTDDecompressor(new StreamReader(primed.GetData(), primed.GetOffset()),
+                             Ownership::Stream, &dict),
+        data.size(), Ownership::Stream);
+
+    reader.Read(readData.data(), readData.size());
+
+    CHECK_FALSE(reader.IsErrored());
+    CHECK(readData == data);
+  }
+};
+
+TEST_CASE("Test blob store packing/unpacking", "[streamio][blobstore]")
+{
+  std::string store = FileIO::GetTempFolderFilename() + "renderdoc_blobstore_test";
+  // the store path is absolute so the capture filename isn't used
+  std::string capture = store + ".rdc";
+
+  auto listBlobs = [store]() {
+    std::vector<std::string> ret;
+    for(const PathEntry &dir : FileIO::GetFilesInDirectory(store.c_str()))
+    {
+      std::string dirPath = store + "/" + dir.filename.c_str();
+      for(const PathEntry &file : FileIO::GetFilesInDirectory(dirPath.c_str()))
+        if(!(file.flags & PathProperty::Directory))
+          ret.push_back(dirPath + "/" + file.filename.c_str());
+    }
+    return ret;
+  };
+
+  for(const std::string &blob : listBlobs())
+    FileIO::Delete(blob.c_str());
+
+  const uint64_t sharedSize = 8 * 1024 * 1024;
+  const uint64_t uniqueSize = 1024 * 1024;
+
+  byte *shared = new byte[sharedSize];
+  byte *unique[2] = {new byte[uniqueSize], new byte[uniqueSize]};
+
+  for(uint64_t i = 0; i < sharedSize; i++)
+    shared[i] = rand() & 0xff;
+  for(uint64_t i = 0; i < uniqueSize; i++)
+  {
+    unique[0][i] = rand() & 0xff;
+    unique[1][i] = rand() & 0xff;
+  }
+
+  // the first 'capture' has the shared data first, the second has it after different data
+  StreamWriter *buf[2] = {new StreamWriter(StreamWriter::DefaultScratchSize),
+                          new StreamWriter(StreamWriter::DefaultScratchSize)};
+  size_t numBlobs[2] = {};
+
+  for(int i = 0; i < 2; i++)
+  {
+    StreamWriter writer(new BlobStoreCompressor(buf[i], Ownership::Nothing, capture, store),
+                        Ownership::Stream);
+
+    if(i == 0)
+    {
+      writer.Write(shared, sharedSize);
+      writer.Write(unique[0], uniqueSize);
+    }
+    else
+    {
+      writer.Write(unique[1], uniqueSize);
+      writer.Write(shared, sharedSize);
+    }
+
+    writer.Finish();
+
+    CHECK_FALSE(writer.IsErrored());
+    CHECK(writer.GetOffset() == sharedSize + uniqueSize);
+
+    // the section itself only holds a small index
+    CHECK(buf[i]->GetOffset() < 4096);
+
+    numBlobs[i] = listBlobs().size();
+  }
+
+  // the shared data should only be stored once. The second capture only needs new blobs for its
+  // unique data and where it meets the shared data
+  CHECK(numBlobs[0] > 20);
+  CHECK(numBlobs[1] - numBlobs[0] < 10);
+
+  SECTION("Reading back")
+  {
+    for(int i = 0; i < 2; i++)
+    {
+      StreamReader reader(
+          new BlobStoreDecompressor(new StreamReader(buf[i]->GetData(), buf[i]->GetOffset()),
+                                    Ownership::Stream, capture),
+          sharedSize + uniqueSize, Ownership::Stream);
+
+      byte *readData = new byte[sharedSize + uniqueSize];
+      reader.Read(readData, sharedSize + uniqueSize);
+
+      CHECK_FALSE(reader.IsErrored());
+      CHECK(reader.AtEnd());
+
+      if(i == 0)
+      {
+        CHECK_FALSE(memcmp(readData, shared, sharedSize));
+        CHECK_FALSE(memcmp(readData + sharedSize, unique[0], uniqueSize));
+      }
+      else
+      {
+        CHECK_FALSE(memcmp(readData, unique[1], uniqueSize));
+        CHECK_FALSE(memcmp(readData + uniqueSize, shared, sharedSize));
+      }
+
+      // blob sections can be seeked
+      reader.SetOffset(uniqueSize + 12345);
+      reader.Read(readData, 100);
+      CHECK_FALSE(memcmp(readData, i == 0 ? shared + uniqueSize + 12345 : shared + 12345, 100));
+
+      CHECK_FALSE(reader.IsErrored());
+
+      delete[] readData;
+    }
+  };
+
+  SECTION("Missing blobs")
+  {
+    for(const std::string &blob : listBlobs())
+      FileIO::Delete(blob.c_str());
+
+    StreamReader reader(
+        new BlobStoreDecompressor(new StreamReader(buf[0]->GetData(), buf[0]->GetOffset()),
+                                  Ownership::Stream, capture),
+        sharedSize + uniqueSize, Ownership::Stream);
+
+    CHECK(reader.IsErrored());
+  };
+
+  for(const std::string &blob : listBlobs())
+    FileIO::Delete(blob.c_str());
+
+  delete buf[0];
+  delete buf[1];
+  delete[] shared;
+  delete[] unique[0];
+  delete[] unique[1];
+};
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "lz4io.h"
+#include <algorithm>
 
 static const uint64_t lz4BlockSize = 64 * 1024;
 
@@ -295,3 +296,178 @@ bool LZ4Decompressor::FillPage0()
 
   return success;
 }
+
+// larger than the streaming block size, since each block is compressed without any history
+static const uint64_t lz4SeekBlockSize = 1024 * 1024;
+
+LZ4BlockDecompressor::LZ4BlockDecompressor(StreamReader *read, uint64_t uncompressedSize,
+                                           uint64_t cacheSize)
+    : Decompressor(read, Ownership::Nothing)
+{
+  m_Size = uncompressedSize;
+  m_MaxCached = (size_t)RDCMAX<uint64_t>(1, cacheSize / lz4SeekBlockSize);
+
+  byte *uncomp = AllocAlignedBuffer(lz4SeekBlockSize);
+  byte *comp = AllocAlignedBuffer(LZ4_COMPRESSBOUND(lz4SeekBlockSize));
+
+  m_Blocks.reserve(size_t((uncompressedSize + lz4SeekBlockSize - 1) / lz4SeekBlockSize));
+
+  for(uint64_t offs = 0; offs < uncompressedSize; offs += lz4SeekBlockSize)
+  {
+    uint32_t size = (uint32_t)RDCMIN(lz4SeekBlockSize, uncompressedSize - offs);
+
+    if(!read->Read(uncomp, size))
+    {
+      m_Errored = true;
+      break;
+    }
+
+    int compSize = LZ4_compress_default((const char *)uncomp, (char *)comp, (int)size,
+                                        (int)LZ4_COMPRESSBOUND(lz4SeekBlockSize));
+
+    if(compSize <= 0)
+    {
+      RDCERR("Error compressing block: %i", compSize);
+      m_Errored = true;
+      break;
+    }
+
+    Block block;
+    block.compressed = new byte[compSize];
+    block.compSize = compSize;
+    block.size = size;
+    block.data = NULL;
+
+    memcpy(block.compressed, comp, compSize);
+
+    m_Blocks.push_back(block);
+  }
+
+  FreeAlignedBuffer(uncomp);
+  FreeAlignedBuffer(comp);
+}
+
+LZ4BlockDecompressor::~LZ4BlockDecompressor()
+{
+  for(Block &block : m_Blocks)
+  {
+    delete[] block.compressed;
+    FreeAlignedBuffer(block.data);
+  }
+}
+
+bool LZ4BlockDecompressor::Recompress(Compressor *comp)
+{
+  bool success = true;
+
+  while(success && m_Offset < m_Size)
+  {
+    size_t idx = size_t(m_Offset / lz4SeekBlockSize);
+    uint64_t blockOffs = m_Offset % lz4SeekBlockSize;
+
+    const byte *block = GetBlock(idx);
+    success &= (block != NULL);
+    if(success)
+      success &= comp->Write(block + blockOffs, m_Blocks[idx].size - blockOffs);
+
+    m_Offset += m_Blocks[idx].size - blockOffs;
+  }
+  success &= comp->Finish();
+
+  return success;
+}
+
+bool LZ4BlockDecompressor::Read(void *data, uint64_t numBytes)
+{
+  if(m_Errored)
+    return false;
+
+  if(m_Offset + numBytes > m_Size)
+  {
+    RDCERR("Reading %llu bytes at %llu from %llu byte stream", numBytes, m_Offset, m_Size);
+    return false;
+  }
+
+  byte *dst = (byte *)data;
+
+  while(numBytes > 0)
+  {
+    size_t idx = size_t(m_Offset / lz4SeekBlockSize);
+    uint64_t blockOffs = m_Offset % lz4SeekBlockSize;
+
+    const byte *block = GetBlock(idx);
+    if(!block)
+      return false;
+
+    uint64_t size = RDCMIN(numBytes, m_Blocks[idx].size - blockOffs);
+
+    if(dst)
+    {
+      memcpy(dst, block + blockOffs, (size_t)size);
+      dst += size;
+    }
+
+    numBytes -= size;
+    m_Offset += size;
+  }
+
+  return true;
+}
+
+bool LZ4BlockDecompressor::Seek(uint64_t offset)
+{
+  if(m_Errored || offset > m_Size)
+    return false;
+
+  m_Offset = offset;
+  return true;
+}
+
+const byte *LZ4BlockDecompressor::GetBlock(size_t idx)
+{
+  Block &block = m_Blocks[idx];
+
+  if(block.data)
+  {
+    // move to the front of the cache if it isn't already
+    if(m_Cached[0] != idx)
+    {
+      m_Cached.erase(std::find(m_Cached.begin(), m_Cached.end(), idx));
+      m_Cached.insert(m_Cached.begin(), idx);
+    }
+
+    return block.data;
+  }
+
+  byte *data = NULL;
+
+  // re-use the least recently used block if the cache is full
+  if(m_Cached.size() >= m_MaxCached)
+  {
+    size_t evict = m_Cached.back();
+    m_Cached.pop_back();
+
+    data = m_Blocks[evict].data;
+    m_Blocks[evict].data = NULL;
+  }
+  else
+  {
+    data = AllocAlignedBuffer(lz4SeekBlockSize);
+  }
+
+  int size = LZ4_decompress_safe((const char *)block.compressed, (char *)data, block.compSize,
+                                 (int)lz4SeekBlockSize);
+
+  if(size != (int)block.size)
+  {
+    RDCERR("Error decompressing block %llu: %i", (uint64_t)idx, size);
+    FreeAlignedBuffer(data);
+    m_Errored = true;
+    return NULL;
+  }
+
+  block.data = data;
+  m_Cached.insert(m_Cached.begin(), idx);
+
+  return data;
+}
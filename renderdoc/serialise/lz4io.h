@@ -65,3 +65,42 @@ private:
 
   LZ4_streamDecode_t m_LZ4Decomp;
 };
+
+// holds an uncompressed stream compressed in memory as independent blocks, each of which can be
+// decompressed on its own. Only a limited number of blocks are kept decompressed at once, and
+// unlike the other decompressors this supports seeking anywhere in the stream.
+class LZ4BlockDecompressor : public Decompressor
+{
+public:
+  // reads and compresses uncompressedSize bytes from the reader up front. Up to cacheSize bytes
+  // of decompressed blocks are kept in memory
+  LZ4BlockDecompressor(StreamReader *read, uint64_t uncompressedSize, uint64_t cacheSize);
+  ~LZ4BlockDecompressor();
+
+  bool Recompress(Compressor *comp);
+  bool Read(void *data, uint64_t numBytes);
+  bool Seek(uint64_t offset);
+
+  static const uint64_t DefaultCacheSize = 64 * 1024 * 1024;
+
+private:
+  const byte *GetBlock(size_t idx);
+
+  struct Block
+  {
+    byte *compressed;
+    int32_t compSize;
+    uint32_t size;
+    // NULL if the block isn't currently cached
+    byte *data;
+  };
+
+  std::vector<Block> m_Blocks;
+  // cached block indices, most recently used first
+  std::vector<size_t> m_Cached;
+  size_t m_MaxCached;
+
+  uint64_t m_Offset = 0;
+  uint64_t m_Size;
+  bool m_Errored = false;
+};
@@ -28,7 +28,9 @@
 #include "3rdparty/stb/stb_image.h"
 #include "api/replay/version.h"
 #include "common/dds_readwrite.h"
+#include "blobstore.h"
 #include "lz4io.h"
+#include "zstd_dictionary.h"
 #include "zstdio.h"
 
 // not provided by tinyexr, just do by hand
@@ -104,7 +106,8 @@ bool is_exr_file(FILE *f)
    }
    else if(isASCII == '\0')
    {
-     byte zero[3]; // pad out the above character with 0 bytes. Reserved for future use
+     byte dictionaryID; // the ID of the Zstd dictionary the section is compressed with, or 0
+     byte zero[2]; // pad out the above characters with 0 bytes. Reserved for future use
      uint32_t sectionType; // section type enum, see SectionType. Could be SectionType::Unknown
      uint64_t sectionCompressedLength;   // byte length of the actual section data on disk
      uint64_t sectionUncompressedLength; // byte length of the section data after decompression.
@@ -186,8 +189,10 @@ struct BinarySectionHeader
 {
   // 0x0
   byte isASCII;
-  // 0x0, 0x0, 0x0
-  byte zero[3];
+  // ID of the Zstd dictionary used, or 0x0 for none
+  byte dictionaryID;
+  // 0x0, 0x0
+  byte zero[2];
   // section type enum, see SectionType. Could be SectionType::Unknown
   SectionType sectionType;
   // byte length of the actual section data on disk
@@ -224,6 +229,9 @@ struct BinarySectionHeader
 
 RDCFile::~RDCFile()
 {
+  if(m_Mapping)
+    m_Mapping->Release();
+
   if(m_File)
     FileIO::fclose(m_File);
 
@@ -286,6 +294,11 @@ void RDCFile::Open(const char *path)
   StreamReader reader(m_File, fileSize, Ownership::Nothing);
 
   Init(reader);
+
+  // map the file so that sections can be read without buffering through the FILE *, and without
+  // copying at all if they're uncompressed. If this fails we fall back to reading normally
+  if(m_Error == ContainerError::NoError)
+    m_Mapping = StreamMapping::Create(m_File, fileSize);
 }
 
 void RDCFile::Open(const std::vector<byte> &buffer)
@@ -540,6 +553,7 @@ void RDCFile::Init(StreamReader &reader)
       props.compressedSize = sectionHeader.sectionCompressedLength;
       props.uncompressedSize = sectionHeader.sectionUncompressedLength;
       props.version = sectionHeader.sectionVersion;
+      props.dictionaryID = sectionHeader.dictionaryID;
 
       if(sectionHeader.sectionNameLength == 0 || sectionHeader.sectionNameLength > 2 * 1024)
       {
@@ -799,13 +813,47 @@ StreamReader *RDCFile::ReadSection(int index) const
 
   const SectionProperties &props = m_Sections[index];
   SectionLocation offsetSize = m_SectionLocations[index];
-  FileIO::fseek64(m_File, offsetSize.dataOffset, SEEK_SET);
 
-  StreamReader *fileReader = new StreamReader(m_File, offsetSize.diskLength, Ownership::Nothing);
+  const ZstdDictionary *dict = NULL;
+
+  if(props.dictionaryID != 0)
+  {
+    dict = ZstdDictionaries::Find((uint8_t)props.dictionaryID);
+
+    if(!dict)
+    {
+      RDCERR("Section %d is compressed with Zstd dictionary %u, which this build doesn't have.",
+             index, props.dictionaryID);
+      return new StreamReader(StreamReader::InvalidStream);
+    }
+  }
+
+  StreamReader *fileReader = NULL;
+
+  if(m_Mapping && offsetSize.dataOffset + offsetSize.diskLength <= m_Mapping->GetSize())
+  {
+    fileReader = new StreamReader(m_Mapping, offsetSize.dataOffset, offsetSize.diskLength);
+
+    // whether it's decompressed or read directly, sections are read front to back once
+    fileReader->AdviseAccess(FileIO::MapAccess::Sequential);
+  }
+  else
+  {
+    FileIO::fseek64(m_File, offsetSize.dataOffset, SEEK_SET);
+
+    fileReader = new StreamReader(m_File, offsetSize.diskLength, Ownership::Nothing);
+  }
 
   StreamReader *compReader = NULL;
 
-  if(props.flags & SectionFlags::LZ4Compressed)
+  if(props.flags & SectionFlags::BlobReferences)
+  {
+    // the section only holds the blob index, the data comes from the store
+    compReader =
+        new StreamReader(new BlobStoreDecompressor(fileReader, Ownership::Stream, m_Filename),
+                         props.uncompressedSize, Ownership::Stream);
+  }
+  else if(props.flags & SectionFlags::LZ4Compressed)
   {
     // the user will delete the compressed reader, and then it will delete the compressor and the
     // file reader
@@ -814,7 +862,7 @@ StreamReader *RDCFile::ReadSection(int index) const
   }
   else if(props.flags & SectionFlags::ZstdCompressed)
   {
-    compReader = new StreamReader(new ZSTDDecompressor(fileReader, Ownership::Stream),
+    compReader = new StreamReader(new ZSTDDecompressor(fileReader, Ownership::Stream, dict),
                                   props.uncompressedSize, Ownership::Stream);
   }
 
@@ -846,6 +894,14 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
     return w;
   }
 
+  // sections may be moved around or the file truncated, so the existing mapping can't be used for
+  // any new sections. Readers that are still alive keep it alive until they're done
+  if(m_Mapping)
+  {
+    m_Mapping->Release();
+    m_Mapping = NULL;
+  }
+
   // re-open the file as read-write
   {
     uint64_t offs = FileIO::ftell64(m_File);
@@ -876,6 +932,12 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
     return new StreamWriter(StreamWriter::InvalidStream);
   }
 
+  if((props.flags & SectionFlags::BlobReferences) && m_BlobStore.empty())
+  {
+    RDCERR("Sections can't be written to a blob store without one being set.");
+    return new StreamWriter(StreamWriter::InvalidStream);
+  }
+
   std::string name = props.name;
   SectionType type = props.type;
 
@@ -1093,13 +1155,27 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
 
   uint64_t headerOffset = FileIO::ftell64(m_File);
 
+  // chunk streams are compressed with the driver's Zstd dictionary if one has been trained for it.
+  // Sections copied from another capture keep the dictionary they were written with.
+  const ZstdDictionary *dict = NULL;
+
+  if((props.flags & SectionFlags::ZstdCompressed) && !(props.flags & SectionFlags::BlobReferences))
+  {
+    if(props.dictionaryID != 0)
+      dict = ZstdDictionaries::Find((uint8_t)props.dictionaryID);
+    else if(type == SectionType::FrameCapture)
+      dict = ZstdDictionaries::FindForDriver(m_Driver);
+  }
+
   size_t numWritten;
 
   // write section header
   BinarySectionHeader header = {// IsASCII
                                 '\0',
+                                // dictionaryID
+                                dict ? dict->GetID() : (byte)0,
                                 // zero
-                                {0, 0, 0},
+                                {0, 0},
                                 // sectionType
                                 type,
                                 // sectionCompressedLength
@@ -1128,7 +1204,13 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
 
   StreamWriter *compWriter = NULL;
 
-  if(props.flags & SectionFlags::LZ4Compressed)
+  if(props.flags & SectionFlags::BlobReferences)
+  {
+    compWriter = new StreamWriter(
+        new BlobStoreCompressor(fileWriter, Ownership::Stream, m_Filename, m_BlobStore),
+        Ownership::Stream);
+  }
+  else if(props.flags & SectionFlags::LZ4Compressed)
   {
     // the user will delete the compressed writer, and then it will delete the compressor and the
     // file writer
@@ -1137,14 +1219,15 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
   }
   else if(props.flags & SectionFlags::ZstdCompressed)
   {
-    compWriter =
-        new StreamWriter(new ZSTDCompressor(fileWriter, Ownership::Stream), Ownership::Stream);
+    compWriter = new StreamWriter(new ZSTDCompressor(fileWriter, Ownership::Stream, dict),
+                                  Ownership::Stream);
   }
 
   uint64_t dataOffset = FileIO::ftell64(m_File);
 
   m_CurrentWritingProps = props;
   m_CurrentWritingProps.name = name;
+  m_CurrentWritingProps.dictionaryID = dict ? dict->GetID() : 0;
 
   // register a destroy callback to tidy up the section at the end
   fileWriter->AddCloseCallback([this, type, name, headerOffset, dataOffset, fileWriter, compWriter]() {
@@ -83,6 +83,10 @@ public:
   // creates a new file with current properties, file will be overwritten if it already exists
   void Create(const char *filename);
 
+  // sets the store directory used for sections written with SectionFlags::BlobReferences. A
+  // relative path is relative to the directory containing the file.
+  void SetBlobStore(const char *store) { m_BlobStore = store; }
+
   ContainerError ErrorCode() const { return m_Error; }
   std::string ErrorString() const { return m_ErrorString; }
   RDCDriver GetDriver() const { return m_Driver; }
@@ -104,7 +108,9 @@ private:
   void Init(StreamReader &reader);
 
   FILE *m_File = NULL;
+  StreamMapping *m_Mapping = NULL;
   std::string m_Filename;
+  std::string m_BlobStore;
   std::vector<byte> m_Buffer;
 
   SectionProperties m_CurrentWritingProps;
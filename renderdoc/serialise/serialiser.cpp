@@ -29,10 +29,257 @@
 #include "core/core.h"
 #include "strings/string_utils.h"
 
-#if ENABLED(RDOC_DEVEL)
-
 int64_t Chunk::m_LiveChunks = 0;
 int64_t Chunk::m_TotalMem = 0;
+int64_t Chunk::m_SpilledMem = 0;
+int64_t Chunk::m_MemoryBudget = 0;
+int64_t Chunk::m_TotalSerialised = 0;
+
+/////////////////////////////////////////////////////////////
+// Chunk spilling
+
+namespace
+{
+// everything here is protected by the lock. The candidate list is only resident chunks that can be
+// spilled, oldest at the head
+Threading::CriticalSection spillLock;
+Chunk *candidateHead = NULL, *candidateTail = NULL;
+
+// the spill file is created the first time something spills and deleted again once the last
+// spilled chunk is freed. Space isn't reclaimed until then, since captures free their chunks en
+// masse once they're written out.
+FILE *spillFile = NULL;
+std::string spillFilename;
+uint64_t spillFileEnd = 0;
+uint64_t spilledChunks = 0;
+bool spillFailed = false;
+
+void ReleaseSpilledChunk()
+{
+  spilledChunks--;
+
+  if(spilledChunks == 0 && spillFile)
+  {
+    FileIO::fclose(spillFile);
+    FileIO::Delete(spillFilename.c_str());
+    spillFile = NULL;
+    spillFileEnd = 0;
+  }
+}
+}
+
+void Chunk::Track()
+{
+  SCOPED_LOCK(spillLock);
+
+  // make room for this chunk by spilling older chunks, before it becomes a candidate itself
+  if(m_TotalMem - m_SpilledMem > m_MemoryBudget)
+    SpillOverBudget();
+
+  m_SpillState = SpillState::Resident;
+
+  m_PrevCandidate = candidateTail;
+  m_NextCandidate = NULL;
+  if(candidateTail)
+    candidateTail->m_NextCandidate = this;
+  else
+    candidateHead = this;
+  candidateTail = this;
+}
+
+void Chunk::RemoveCandidate()
+{
+  if(m_PrevCandidate)
+    m_PrevCandidate->m_NextCandidate = m_NextCandidate;
+  else
+    candidateHead = m_NextCandidate;
+
+  if(m_NextCandidate)
+    m_NextCandidate->m_PrevCandidate = m_PrevCandidate;
+  else
+    candidateTail = m_PrevCandidate;
+
+  m_PrevCandidate = m_NextCandidate = NULL;
+}
+
+void Chunk::Untrack()
+{
+  SCOPED_LOCK(spillLock);
+
+  if(m_SpillState == SpillState::Resident)
+  {
+    RemoveCandidate();
+  }
+  else if(m_SpillState == SpillState::Spilled)
+  {
+    Atomic::ExchAdd64(&m_SpilledMem, -int64_t(m_Length));
+    ReleaseSpilledChunk();
+  }
+
+  m_SpillState = SpillState::Untracked;
+}
+
+void Chunk::Pin()
+{
+  SCOPED_LOCK(spillLock);
+
+  if(m_SpillState == SpillState::Spilled)
+  {
+    m_Data = ReadSpilled();
+    Atomic::ExchAdd64(&m_SpilledMem, -int64_t(m_Length));
+    ReleaseSpilledChunk();
+  }
+  else if(m_SpillState == SpillState::Resident)
+  {
+    RemoveCandidate();
+  }
+
+  m_SpillState = SpillState::Pinned;
+}
+
+void Chunk::WriteTracked(Serialiser<SerialiserMode::Writing> &ser)
+{
+  byte *paged = NULL;
+
+  {
+    SCOPED_LOCK(spillLock);
+
+    // resident data is written under the lock so it can't be spilled out from under us
+    if(m_SpillState != SpillState::Spilled)
+    {
+      ser.GetWriter()->Write((const void *)m_Data, (size_t)m_Length);
+      return;
+    }
+
+    // spilled data is only paged in temporarily, so that writing out a capture doesn't bring every
+    // spilled chunk back into memory at once
+    paged = ReadSpilled();
+  }
+
+  ser.GetWriter()->Write((const void *)paged, (size_t)m_Length);
+
+  FreeAlignedBuffer(paged);
+}
+
+Chunk *Chunk::Duplicate()
+{
+  Chunk *ret = new Chunk();
+  ret->m_Length = m_Length;
+  ret->m_ChunkType = m_ChunkType;
+
+  if(m_SpillState == SpillState::Untracked || m_SpillState == SpillState::Pinned)
+  {
+    ret->m_Data = AllocAlignedBuffer(m_Length);
+    memcpy(ret->m_Data, m_Data, (size_t)m_Length);
+  }
+  else
+  {
+    SCOPED_LOCK(spillLock);
+
+    if(m_SpillState == SpillState::Spilled)
+    {
+      ret->m_Data = ReadSpilled();
+    }
+    else
+    {
+      ret->m_Data = AllocAlignedBuffer(m_Length);
+      memcpy(ret->m_Data, m_Data, (size_t)m_Length);
+    }
+  }
+
+  Atomic::Inc64(&m_LiveChunks);
+  Atomic::ExchAdd64(&m_TotalMem, int64_t(m_Length));
+
+  if(m_MemoryBudget > 0 && m_Length >= MinimumSpillSize)
+    ret->Track();
+
+  return ret;
+}
+
+bool Chunk::Spill()
+{
+  if(spillFile == NULL)
+  {
+    if(spillFailed)
+      return false;
+
+    spillFilename = FileIO::GetTempFolderFilename() +
+                    StringFormat::Fmt("renderdoc_spill_%u.bin", Process::GetCurrentPID());
+
+    spillFile = FileIO::fopen(spillFilename.c_str(), "w+b");
+
+    if(spillFile == NULL)
+    {
+      RDCERR("Couldn't open capture spill file '%s', chunks will be kept in memory",
+             spillFilename.c_str());
+      spillFailed = true;
+      return false;
+    }
+
+    spillFileEnd = 0;
+  }
+
+  FileIO::fseek64(spillFile, spillFileEnd, SEEK_SET);
+  size_t written = FileIO::fwrite(m_Data, 1, m_Length, spillFile);
+
+  if(written != m_Length)
+  {
+    RDCERR("Failed to write %u bytes to capture spill file, chunks will be kept in memory",
+           m_Length);
+    spillFailed = true;
+    return false;
+  }
+
+  m_SpillOffset = spillFileEnd;
+  spillFileEnd += m_Length;
+  spilledChunks++;
+
+  FreeAlignedBuffer(m_Data);
+  m_Data = NULL;
+
+  m_SpillState = SpillState::Spilled;
+  Atomic::ExchAdd64(&m_SpilledMem, int64_t(m_Length));
+
+  return true;
+}
+
+byte *Chunk::ReadSpilled()
+{
+  byte *ret = AllocAlignedBuffer(m_Length);
+
+  FileIO::fseek64(spillFile, m_SpillOffset, SEEK_SET);
+  size_t read = FileIO::fread(ret, 1, m_Length, spillFile);
+
+  if(read != m_Length)
+  {
+    RDCERR("Failed to read back %u bytes from capture spill file", m_Length);
+    memset(ret + read, 0, m_Length - read);
+  }
+
+  return ret;
+}
+
+void Chunk::SpillOverBudget()
+{
+  // spill down to a bit under the budget, so we aren't spilling a chunk every time one is created
+  const int64_t target = m_MemoryBudget - m_MemoryBudget / 8;
+
+  while(candidateHead && m_TotalMem - m_SpilledMem > target)
+  {
+    Chunk *chunk = candidateHead;
+
+    chunk->RemoveCandidate();
+
+    // if we couldn't spill, nothing else will either. Keep this one resident for good
+    if(!chunk->Spill())
+    {
+      chunk->m_SpillState = SpillState::Pinned;
+      break;
+    }
+  }
+}
+
+#if ENABLED(RDOC_DEVEL)
 
 void DumpObject(FileIO::LogFileHandle *log, const rdcstr &indent, SDObject *obj)
 {
@@ -112,6 +359,7 @@ uint32_t Serialiser<SerialiserMode::Reading>::BeginChunk(uint32_t, uint64_t)
   uint32_t chunkID = 0;
 
   m_ChunkMetadata = SDChunkMetaData();
+  m_DeserialisedTick = 0;
 
   {
     uint32_t c = 0;
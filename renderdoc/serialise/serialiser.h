@@ -57,6 +57,11 @@ enum class SerialiserFlags
 {
   NoFlags = 0x0,
   AllocateMemory = 0x1,
+  // only valid for buffers. When reading, point directly into the stream instead of allocating and
+  // copying if the stream is in memory, or else read into scratch memory owned by the serialiser.
+  // Either way the data must not be modified or freed, and is only valid until the next buffer is
+  // read.
+  ReadDirect = 0x2,
 };
 
 BITMASK_OPERATORS(SerialiserFlags);
@@ -158,6 +163,15 @@ public:
   // to flag if some context-sensitive members might be invalid
   void SetStructArg(uint64_t arg) { m_StructArg = arg; }
   uint64_t GetStructArg() { return m_StructArg; }
+  // when enabled, records the tick at which the current chunk's parameters finished being read so
+  // that replay profiling can split a chunk's time between deserialising and executing it.
+  void SetDeserialiseTiming(bool enabled) { m_DeserialiseTiming = enabled; }
+  void MarkDeserialised()
+  {
+    if(IsReading() && m_DeserialiseTiming && m_DeserialisedTick == 0)
+      m_DeserialisedTick = Timing::GetTick();
+  }
+  uint64_t GetDeserialisedTick() const { return m_DeserialisedTick; }
   //////////////////////////////////////////
   // Public serialisation interface
 
@@ -290,6 +304,20 @@ public:
         else
           RDCASSERT(byteSize == 0);
       }
+      else if(IsReading() && (flags & SerialiserFlags::ReadDirect))
+      {
+        // ensure byte alignment
+        m_Read->AlignTo<ChunkAlignment>();
+
+        el = (byte *)m_Read->ReadDirect(byteSize);
+
+        if(el == NULL && byteSize > 0)
+        {
+          m_DirectScratch.resize((size_t)byteSize);
+          el = m_DirectScratch.data();
+          m_Read->Read(el, byteSize);
+        }
+      }
       else if(IsReading())
       {
         // ensure byte alignment
@@ -1551,12 +1579,18 @@ private:
   bool m_DataStreaming = false;
   bool m_DrawChunk = false;
 
+  bool m_DeserialiseTiming = false;
+  uint64_t m_DeserialisedTick = 0;
+
   uint64_t m_LastChunkOffset = 0;
   uint64_t m_ChunkFixup = 0;
 
   bool m_ExportStructured = false;
   bool m_ExportBuffers = false;
   bool m_InternalElement = false;
+
+  // storage for ReadDirect buffers when the stream can't provide a pointer itself
+  bytebuf m_DirectScratch;
   SDFile m_StructData;
   SDFile *m_StructuredFile = &m_StructData;
   std::vector<SDObject *> m_StructureStack;
@@ -1701,18 +1735,23 @@ DECLARE_STRINGISE_TYPE(SDObject *);
 class ScopedChunk;
 
 // holds the memory, length and type for a given chunk, so that it can be
-// passed around and moved between owners before being serialised out
+// passed around and moved between owners before being serialised out.
+//
+// If a capture memory budget is set and live chunks go over it, the contents of the oldest large
+// chunks are spilled to a temporary file. They're read back when the chunk is written out, or kept
+// resident from then on if anyone asks for a pointer to the data.
 class Chunk
 {
 public:
   ~Chunk()
   {
+    if(m_SpillState != SpillState::Untracked)
+      Untrack();
+
     FreeAlignedBuffer(m_Data);
 
-#if ENABLED(RDOC_DEVEL)
     Atomic::Dec64(&m_LiveChunks);
     Atomic::ExchAdd64(&m_TotalMem, -int64_t(m_Length));
-#endif
   }
 
   template <typename ChunkType>
@@ -1720,13 +1759,17 @@ public:
   {
     return (ChunkType)m_ChunkType;
   }
-#if ENABLED(RDOC_DEVEL)
-  static uint64_t NumLiveChunks() { return m_LiveChunks; }
-  static uint64_t TotalMem() { return m_TotalMem; }
-#else
-  static uint64_t NumLiveChunks() { return 0; }
-  static uint64_t TotalMem() { return 0; }
-#endif
+  static uint64_t NumLiveChunks() { return (uint64_t)m_LiveChunks; }
+  // total size of all live chunks, whether they're resident or spilled
+  static uint64_t TotalMem() { return (uint64_t)m_TotalMem; }
+  static uint64_t SpilledMem() { return (uint64_t)m_SpilledMem; }
+  // running total of bytes ever written into new chunks, for overhead telemetry
+  static uint64_t TotalSerialised() { return (uint64_t)m_TotalSerialised; }
+  // set the amount of chunk memory to keep resident before spilling. 0 means no limit
+  static void SetMemoryBudget(uint64_t bytes) { m_MemoryBudget = (int64_t)bytes; }
+  static uint64_t GetMemoryBudget() { return (uint64_t)m_MemoryBudget; }
+  // chunks smaller than this are never spilled, they aren't worth the file IO
+  static const uint32_t MinimumSpillSize = 64 * 1024;
 
   // grab current contents of the serialiser into this chunk
   Chunk(Serialiser<SerialiserMode::Writing> &ser, uint32_t chunkType)
@@ -1743,34 +1786,30 @@ public:
 
     ser.GetWriter()->Rewind();
 
-#if ENABLED(RDOC_DEVEL)
     Atomic::Inc64(&m_LiveChunks);
     Atomic::ExchAdd64(&m_TotalMem, int64_t(m_Length));
-#endif
+    Atomic::ExchAdd64(&m_TotalSerialised, int64_t(m_Length));
+
+    if(m_MemoryBudget > 0 && m_Length >= MinimumSpillSize)
+      Track();
   }
 
-  byte *GetData() const { return m_Data; }
-  Chunk *Duplicate()
+  // returns the data in memory. If the chunk is being tracked for spilling it's paged back in if
+  // necessary, and then kept resident since the caller may hold onto the pointer.
+  byte *GetData()
   {
-    Chunk *ret = new Chunk();
-    ret->m_Length = m_Length;
-    ret->m_ChunkType = m_ChunkType;
-
-    ret->m_Data = AllocAlignedBuffer(m_Length);
-
-    memcpy(ret->m_Data, m_Data, (size_t)m_Length);
-
-#if ENABLED(RDOC_DEVEL)
-    Atomic::Inc64(&m_LiveChunks);
-    Atomic::ExchAdd64(&m_TotalMem, int64_t(m_Length));
-#endif
-
-    return ret;
+    if(m_SpillState != SpillState::Untracked && m_SpillState != SpillState::Pinned)
+      Pin();
+    return m_Data;
   }
+  Chunk *Duplicate();
 
   void Write(Serialiser<SerialiserMode::Writing> &ser)
   {
-    ser.GetWriter()->Write((const void *)m_Data, (size_t)m_Length);
+    if(m_SpillState == SpillState::Untracked || m_SpillState == SpillState::Pinned)
+      ser.GetWriter()->Write((const void *)m_Data, (size_t)m_Length);
+    else
+      WriteTracked(ser);
   }
 
 private:
@@ -1780,14 +1819,39 @@ private:
 
   friend class ScopedChunk;
 
+  enum class SpillState : uint8_t
+  {
+    // never considered for spilling
+    Untracked,
+    // resident, and a candidate to spill
+    Resident,
+    // contents are in the spill file, m_Data is NULL
+    Spilled,
+    // resident, and will stay that way
+    Pinned,
+  };
+
+  void Track();
+  void Untrack();
+  void RemoveCandidate();
+  void Pin();
+  void WriteTracked(Serialiser<SerialiserMode::Writing> &ser);
+  bool Spill();
+  byte *ReadSpilled();
+  static void SpillOverBudget();
+
   uint32_t m_ChunkType;
 
   uint32_t m_Length;
   byte *m_Data;
 
-#if ENABLED(RDOC_DEVEL)
-  static int64_t m_LiveChunks, m_TotalMem;
-#endif
+  SpillState m_SpillState = SpillState::Untracked;
+  uint64_t m_SpillOffset = 0;
+  // intrusive list of resident spill candidates, oldest first
+  Chunk *m_PrevCandidate = NULL;
+  Chunk *m_NextCandidate = NULL;
+
+  static int64_t m_LiveChunks, m_TotalMem, m_SpilledMem, m_MemoryBudget, m_TotalSerialised;
 };
 
 #ifndef SERIALISER_IMPL
@@ -2031,8 +2095,10 @@ struct ScopedDeserialiseArray<SerialiserType, byte *>
   }
 
 // simple utility function for inside serialise functions, to check if the serialiser has hit an
-// error and then bail, without trying to replay anything.
+// error and then bail, without trying to replay anything. This also marks the point where
+// deserialising ends and replaying begins, for replay profiling.
 #define SERIALISE_CHECK_READ_ERRORS()                                       \
+  ser.MarkDeserialised();                                                   \
   if(ser.IsReading() && ser.IsErrored())                                    \
   {                                                                         \
     RDCERR("Serialisation failed in '%s'.", ser.GetCurChunkName().c_str()); \
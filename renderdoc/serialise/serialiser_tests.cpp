@@ -720,6 +720,106 @@ TEST_CASE("Verify multiple chunks can be merged", "[serialiser][chunks]")
   delete buf;
 };
 
+TEST_CASE("Verify chunks over the memory budget are spilled and read back", "[serialiser][chunks]")
+{
+  const uint64_t prevBudget = Chunk::GetMemoryBudget();
+  const uint64_t prevSpilled = Chunk::SpilledMem();
+
+  const uint32_t chunkSize = 128 * 1024;
+  const uint32_t numChunks = 8;
+
+  Chunk::SetMemoryBudget(chunkSize * 2);
+
+  std::vector<Chunk *> chunks;
+  {
+    WriteSerialiser ser(new StreamWriter(StreamWriter::DefaultScratchSize), Ownership::Stream);
+
+    for(uint32_t c = 0; c < numChunks; c++)
+    {
+      SCOPED_SERIALISE_CHUNK(c + 1);
+
+      bytebuf data;
+      data.resize(chunkSize);
+      for(uint32_t i = 0; i < chunkSize; i++)
+        data[i] = byte(i * 7 + c);
+
+      SERIALISE_ELEMENT(data);
+
+      chunks.push_back(scope.Get());
+      REQUIRE(chunks.back());
+    }
+
+    REQUIRE_FALSE(ser.IsErrored());
+  }
+
+  // the oldest chunks should have been moved out of memory
+  CHECK(Chunk::SpilledMem() > prevSpilled);
+
+  // duplicating a spilled chunk reads it back without changing the original
+  Chunk *dup = chunks[0]->Duplicate();
+  chunks.push_back(dup);
+
+  // requesting a pointer brings the data back into memory for good
+  {
+    const uint64_t spilled = Chunk::SpilledMem();
+    byte *ptr = chunks[1]->GetData();
+    REQUIRE(ptr);
+    CHECK(Chunk::SpilledMem() < spilled);
+  }
+
+  StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+  {
+    WriteSerialiser ser(buf, Ownership::Nothing);
+
+    for(Chunk *c : chunks)
+      c->Write(ser);
+
+    REQUIRE_FALSE(ser.IsErrored());
+  }
+
+  for(Chunk *c : chunks)
+    delete c;
+
+  Chunk::SetMemoryBudget(prevBudget);
+
+  // once every chunk is freed nothing should be left spilled
+  CHECK(Chunk::SpilledMem() == prevSpilled);
+
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+
+    uint32_t idx = 0;
+    while(!ser.GetReader()->AtEnd())
+    {
+      uint32_t chunkID = ser.ReadChunk<uint32_t>();
+
+      // the duplicate of the first chunk is written last
+      uint32_t expected = idx < numChunks ? idx + 1 : 1;
+      CHECK(chunkID == expected);
+
+      bytebuf data;
+      SERIALISE_ELEMENT(data);
+
+      REQUIRE(data.size() == chunkSize);
+
+      uint32_t mismatches = 0;
+      for(uint32_t i = 0; i < chunkSize; i++)
+        if(data[i] != byte(i * 7 + (chunkID - 1)))
+          mismatches++;
+
+      CHECK(mismatches == 0);
+
+      ser.EndChunk();
+      idx++;
+    }
+
+    CHECK(idx == numChunks + 1);
+  }
+
+  delete buf;
+};
+
 TEST_CASE("Read/write container types", "[serialiser][structured]")
 {
   StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
@@ -25,6 +25,7 @@
 #include "streamio.h"
 #include <errno.h>
 #include "common/timing.h"
+#include "lz4io.h"
 
 Compressor::~Compressor()
 {
@@ -41,6 +42,32 @@ Decompressor::~Decompressor()
 static const uint64_t initialBufferSize = 64 * 1024;
 const byte StreamWriter::empty[128] = {};
 
+StreamMapping *StreamMapping::Create(FILE *file, uint64_t fileSize)
+{
+  const byte *data = FileIO::mapfile(file, fileSize);
+
+  if(data == NULL)
+    return NULL;
+
+  return new StreamMapping(data, fileSize);
+}
+
+StreamMapping::~StreamMapping()
+{
+  FileIO::unmapfile(m_Data, m_Size);
+}
+
+void StreamMapping::AddRef()
+{
+  Atomic::Inc32(&m_RefCount);
+}
+
+void StreamMapping::Release()
+{
+  if(Atomic::Dec32(&m_RefCount) == 0)
+    delete this;
+}
+
 StreamReader::StreamReader(const byte *buffer, uint64_t bufferSize)
 {
   m_InputSize = m_BufferSize = bufferSize;
@@ -150,8 +177,58 @@ StreamReader::StreamReader(FILE *file)
   m_Ownership = Ownership::Stream;
 }
 
+StreamReader::StreamReader(StreamMapping *mapping, uint64_t offset, uint64_t size)
+{
+  m_Mapping = mapping;
+  m_Mapping->AddRef();
+
+  RDCASSERT(offset + size <= m_Mapping->GetSize(), offset, size, m_Mapping->GetSize());
+
+  m_InputSize = m_BufferSize = size;
+  m_BufferHead = m_BufferBase = (byte *)m_Mapping->GetData() + offset;
+
+  m_Ownership = Ownership::Nothing;
+}
+
 StreamReader::StreamReader(StreamReader *reader, uint64_t bufferSize)
 {
+  // if the source is mapped, point into the same mapping instead of copying
+  if(reader->m_Mapping && reader->GetOffset() + bufferSize <= reader->GetSize())
+  {
+    m_Mapping = reader->m_Mapping;
+    m_Mapping->AddRef();
+
+    m_InputSize = m_BufferSize = bufferSize;
+    m_BufferHead = m_BufferBase = reader->m_BufferHead;
+
+    m_Ownership = Ownership::Nothing;
+
+    reader->SkipBytes(bufferSize);
+
+    // sub-streams like this are kept around and read repeatedly, so undo any sequential hint from
+    // the parent and have the data paged in ahead of time
+    AdviseAccess(FileIO::MapAccess::Normal);
+    AdviseAccess(FileIO::MapAccess::WillNeed);
+    return;
+  }
+
+  // if the source is compressed and this is large, keep it compressed in blocks that are
+  // decompressed on demand rather than holding the whole thing in memory
+  if(reader->m_Decompressor && bufferSize > LZ4BlockDecompressor::DefaultCacheSize)
+  {
+    m_Decompressor =
+        new LZ4BlockDecompressor(reader, bufferSize, LZ4BlockDecompressor::DefaultCacheSize);
+    m_InputSize = bufferSize;
+
+    m_BufferSize = initialBufferSize;
+    m_BufferHead = m_BufferBase = AllocAlignedBuffer(m_BufferSize);
+
+    m_Ownership = Ownership::Stream;
+
+    ReadFromExternal(0, RDCMIN(bufferSize, m_BufferSize));
+    return;
+  }
+
   m_InputSize = m_BufferSize = bufferSize;
   m_BufferHead = m_BufferBase = AllocAlignedBuffer(m_BufferSize);
 
@@ -178,7 +255,10 @@ StreamReader::~StreamReader()
   for(StreamCloseCallback cb : m_Callbacks)
     cb();
 
-  FreeAlignedBuffer(m_BufferBase);
+  if(m_Mapping)
+    m_Mapping->Release();
+  else
+    FreeAlignedBuffer(m_BufferBase);
 
   if(m_Ownership == Ownership::Stream)
   {
@@ -192,15 +272,45 @@ StreamReader::~StreamReader()
 
 void StreamReader::SetOffset(uint64_t offs)
 {
-  if(m_File || m_Decompressor)
+  if(m_Decompressor)
   {
-    RDCERR("File and decompress stream readers do not support seeking");
+    // seeking within what's already been decompressed is free
+    uint64_t filled = RDCMIN(m_BufferSize, m_InputSize - m_ReadOffset);
+    if(offs >= m_ReadOffset && offs <= m_ReadOffset + filled)
+    {
+      m_BufferHead = m_BufferBase + (offs - m_ReadOffset);
+      return;
+    }
+
+    if(offs > m_InputSize || !SeekDecompressor(offs))
+      RDCERR("Decompress stream reader can't seek to %llu", offs);
+
+    return;
+  }
+
+  if(m_File)
+  {
+    RDCERR("File stream readers do not support seeking");
     return;
   }
 
   m_BufferHead = m_BufferBase + offs;
 }
 
+bool StreamReader::SeekDecompressor(uint64_t offs)
+{
+  if(!m_Decompressor->Seek(offs))
+    return false;
+
+  // start the window again from the new offset
+  m_ReadOffset = offs;
+  m_BufferHead = m_BufferBase;
+
+  ReadFromExternal(0, RDCMIN(m_BufferSize, m_InputSize - offs));
+
+  return true;
+}
+
 bool StreamReader::Reserve(uint64_t numBytes)
 {
   RDCASSERT(m_Sock || m_File || m_Decompressor);
@@ -61,11 +61,36 @@ public:
   virtual bool Recompress(Compressor *comp) = 0;
   virtual bool Read(void *data, uint64_t numBytes) = 0;
 
+  // most decompressors can only read forwards, those that can seek to an offset in the
+  // uncompressed data override this
+  virtual bool Seek(uint64_t offset) { return false; }
 protected:
   StreamReader *m_Read;
   Ownership m_Ownership;
 };
 
+// a read-only mapping of a whole file into memory, which can be shared between any number of
+// readers. It's freed when the last reference is released.
+class StreamMapping
+{
+public:
+  // returns NULL if the file couldn't be mapped, in which case it should be read normally
+  static StreamMapping *Create(FILE *file, uint64_t fileSize);
+
+  void AddRef();
+  void Release();
+
+  const byte *GetData() const { return m_Data; }
+  uint64_t GetSize() const { return m_Size; }
+private:
+  StreamMapping(const byte *data, uint64_t size) : m_Data(data), m_Size(size) {}
+  ~StreamMapping();
+
+  const byte *m_Data;
+  uint64_t m_Size;
+  int32_t m_RefCount = 1;
+};
+
 class StreamReader
 {
 public:
@@ -88,6 +113,9 @@ public:
   StreamReader(FILE *file);
   StreamReader(StreamReader *reader, uint64_t bufferSize);
   StreamReader(Decompressor *decompressor, uint64_t uncompressedSize, Ownership own);
+  // reads size bytes from offset in the mapping, without copying. The reader holds a reference on
+  // the mapping for its lifetime
+  StreamReader(StreamMapping *mapping, uint64_t offset, uint64_t size);
 
   ~StreamReader();
 
@@ -192,9 +220,38 @@ public:
       return true;
     }
 
+    // seekable decompressors don't need to decompress everything that's skipped
+    if(m_Decompressor && numBytes > Available() && GetOffset() + numBytes <= GetSize() &&
+       SeekDecompressor(GetOffset() + numBytes))
+      return !m_HasError;
+
     return Read(NULL, numBytes);
   }
 
+  // returns a pointer directly to the next numBytes in the stream and advances past them, if the
+  // stream is entirely in memory. The pointer is valid for the lifetime of the reader and must not
+  // be written to. Otherwise returns NULL without advancing, and the data must be copied with Read
+  const byte *ReadDirect(uint64_t numBytes)
+  {
+    if(numBytes == 0 || m_Dummy || !m_BufferBase || m_File || m_Sock || m_Decompressor)
+      return NULL;
+
+    // let Read handle the error for reading off the end
+    if(GetOffset() + numBytes > GetSize())
+      return NULL;
+
+    const byte *ret = m_BufferHead;
+    m_BufferHead += numBytes;
+    return ret;
+  }
+
+  // hint how the rest of the stream will be read, for streams that are mapped from a file
+  void AdviseAccess(FileIO::MapAccess access)
+  {
+    if(m_Mapping)
+      FileIO::advisemap(m_BufferHead, m_InputSize - GetOffset(), access);
+  }
+
   // compile-time constant element to let the compiler inline the memcpy
   template <typename T>
   bool Read(T &data)
@@ -212,6 +269,7 @@ private:
   }
   bool Reserve(uint64_t numBytes);
   bool ReadFromExternal(uint64_t bufferOffs, uint64_t length);
+  bool SeekDecompressor(uint64_t offs);
 
   // base of the buffer allocation
   byte *m_BufferBase;
@@ -236,6 +294,9 @@ private:
   // the decompressor, if reading from it
   Decompressor *m_Decompressor = NULL;
 
+  // the file mapping, if m_BufferBase points into one instead of our own allocation
+  StreamMapping *m_Mapping = NULL;
+
   // the offset in the file/decompressor that corresponds to the start of m_BufferBase
   uint64_t m_ReadOffset = 0;
 
@@ -418,11 +479,20 @@ public:
     else if(m_File)
       return FileIO::fflush(m_File);
     else if(m_Sock)
-      return FlushSocketData();
+      return m_DeferFlush ? true : FlushSocketData();
 
     return true;
   }
 
+  // while flushes are deferred, socket data is only sent when the buffer fills up. This allows many
+  // small packets to be batched together into one send. Stopping the deferral flushes immediately.
+  void DeferFlush(bool defer)
+  {
+    m_DeferFlush = defer;
+    if(!defer)
+      Flush();
+  }
+
   bool Finish()
   {
     if(m_Compressor)
@@ -494,6 +564,9 @@ private:
   // true if we're not writing to file/compressor, used to optimise checks in Write
   bool m_InMemory = true;
 
+  // true if socket flushes are deferred until the buffer is full, see DeferFlush()
+  bool m_DeferFlush = false;
+
   // flag indicating if an error has been encountered and the stream is now invalid
   bool m_HasError = false;
 
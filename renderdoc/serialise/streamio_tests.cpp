@@ -94,6 +94,92 @@ TEST_CASE("Test basic stream I/O operations", "[streamio]")
   CHECK(reader.IsErrored());
 };
 
+TEST_CASE("Test stream I/O reading from a mapped file", "[streamio]")
+{
+  std::string filename = FileIO::GetTempFolderFilename() + "renderdoc_streamio_mapped.bin";
+
+  std::vector<uint32_t> values;
+  for(uint32_t i = 0; i < 1024; i++)
+    values.push_back(i * 3);
+
+  REQUIRE(FileIO::dump(filename.c_str(), values.data(), values.size() * sizeof(uint32_t)));
+
+  FILE *f = FileIO::fopen(filename.c_str(), "rb");
+  REQUIRE(f);
+
+  StreamMapping *mapping = StreamMapping::Create(f, values.size() * sizeof(uint32_t));
+
+  // the mapping should be independent of the file handle
+  FileIO::fclose(f);
+
+  REQUIRE(mapping);
+  CHECK(mapping->GetSize() == values.size() * sizeof(uint32_t));
+
+  // read a window of the file, starting at the 16th value
+  StreamReader *reader = new StreamReader(mapping, 16 * sizeof(uint32_t), 512 * sizeof(uint32_t));
+
+  // the reader holds its own reference
+  mapping->Release();
+
+  CHECK(reader->GetSize() == 512 * sizeof(uint32_t));
+
+  uint32_t test = 0;
+  reader->Read(test);
+  CHECK(test == 16 * 3);
+
+  reader->SkipBytes(14 * sizeof(uint32_t));
+  reader->Read(test);
+  CHECK(test == 31 * 3);
+
+  // direct reads return pointers straight into the file's contents
+  const uint32_t *direct = (const uint32_t *)reader->ReadDirect(4 * sizeof(uint32_t));
+  REQUIRE(direct);
+  CHECK(direct[0] == 32 * 3);
+  CHECK(direct[3] == 35 * 3);
+  CHECK(reader->GetOffset() == 20 * sizeof(uint32_t));
+
+  // sub-streams of a mapped stream share the mapping instead of copying
+  StreamReader *sub = new StreamReader(reader, 64 * sizeof(uint32_t));
+
+  CHECK(reader->GetOffset() == 84 * sizeof(uint32_t));
+
+  const uint32_t *subDirect = (const uint32_t *)sub->ReadDirect(sizeof(uint32_t));
+  CHECK(subDirect == direct + 4);
+
+  // the sub-stream keeps the mapping alive after its parent is gone
+  delete reader;
+
+  sub->SetOffset(63 * sizeof(uint32_t));
+  sub->Read(test);
+  CHECK(test == 99 * 3);
+  CHECK(sub->AtEnd());
+  CHECK_FALSE(sub->IsErrored());
+
+  // direct reads can't go off the end
+  CHECK(sub->ReadDirect(sizeof(uint32_t)) == NULL);
+
+  // reading off the end errors as normal
+  sub->Read(test);
+  CHECK(test == 0);
+  CHECK(sub->IsErrored());
+
+  delete sub;
+
+  // file-backed streams can't read directly
+  {
+    StreamReader fileReader(FileIO::fopen(filename.c_str(), "rb"));
+
+    CHECK(fileReader.ReadDirect(sizeof(uint32_t)) == NULL);
+    CHECK(fileReader.GetOffset() == 0);
+
+    fileReader.Read(test);
+    CHECK(test == 0);
+    CHECK_FALSE(fileReader.IsErrored());
+  }
+
+  FileIO::Delete(filename.c_str());
+};
+
 TEST_CASE("Test stream I/O operations over the network", "[streamio][network]")
 {
   uint16_t port = 8235;
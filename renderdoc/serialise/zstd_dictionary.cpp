@@ -0,0 +1,432 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd_dictionary.h"
+#include <algorithm>
+#include "zstd/zstd.h"
+#include "lz4io.h"
+#include "rdcfile.h"
+#include "serialiser.h"
+#include "zstdio.h"
+
+// dictionary compression is primed with the common content up front, so it can use a faster level
+// than ZSTDCompressor does on its own and still come out smaller.
+static const int dictionaryCompressionLevel = 3;
+
+// ZSTDCompressor compresses in independent blocks of this size, so parameters are tuned for it.
+static const size_t dictionaryBlockSize = 128 * 1024;
+
+ZstdDictionary::ZstdDictionary(uint8_t id, RDCDriver driver, const byte *data, size_t size)
+    : m_ID(id), m_Driver(driver)
+{
+  m_Data.assign(data, size);
+
+  // the dictionaries aren't trained by zstd so they're always plain content, never the zstd
+  // dictionary format with its own entropy tables and ID.
+  m_CDict = ZSTD_createCDict_advanced(
+      m_Data.data(), m_Data.size(), ZSTD_dlm_byRef, ZSTD_dct_rawContent,
+      ZSTD_getCParams(dictionaryCompressionLevel, dictionaryBlockSize, m_Data.size()),
+      ZSTD_defaultCMem);
+  m_DDict = ZSTD_createDDict_advanced(m_Data.data(), m_Data.size(), ZSTD_dlm_byRef,
+                                      ZSTD_dct_rawContent, ZSTD_defaultCMem);
+
+  if(!m_CDict || !m_DDict)
+    RDCERR("Couldn't create Zstd dictionary %u from %zu bytes", id, size);
+}
+
+ZstdDictionary::~ZstdDictionary()
+{
+  ZSTD_freeCDict(m_CDict);
+  ZSTD_freeDDict(m_DDict);
+}
+
+// Dictionaries are trained offline from representative captures of each API with
+// `renderdoccmd zstddict`, then embedded from data/zstd/ like the other data files and added here
+// with the ID that is written into section headers. Drivers without a dictionary compress their
+// chunk streams with plain Zstd.
+static const rdcarray<ZstdDictionary *> &GetDictionaries()
+{
+  static rdcarray<ZstdDictionary *> dicts;
+  return dicts;
+}
+
+const ZstdDictionary *ZstdDictionaries::Find(uint8_t id)
+{
+  for(const ZstdDictionary *dict : GetDictionaries())
+    if(dict->GetID() == id)
+      return dict;
+
+  return NULL;
+}
+
+const ZstdDictionary *ZstdDictionaries::FindForDriver(RDCDriver driver)
+{
+  // if a driver has been retrained, the newest dictionary is the one to write with
+  const ZstdDictionary *ret = NULL;
+
+  for(const ZstdDictionary *dict : GetDictionaries())
+    if(dict->GetDriver() == driver)
+      ret = dict;
+
+  return ret;
+}
+
+// This is a simplified form of the COVER algorithm zstd's own trainer uses. Content is scored in
+// d-byte pieces (dmers) by how many samples contain them, the data is split into epochs and the
+// best scoring segment of each epoch is picked, zeroing the score of its dmers so later segments
+// cover different content.
+static const size_t dmerSize = 8;
+static const uint32_t dmerHashBits = 20;
+
+static uint32_t HashDmer(const byte *data)
+{
+  uint64_t val;
+  memcpy(&val, data, sizeof(val));
+  return uint32_t((val * 0xcf1bbcdcb7a56463ULL) >> (64 - dmerHashBits));
+}
+
+bool ZstdDictionaries::Train(const rdcarray<bytebuf> &samples, size_t maxSize, bytebuf &dictionary)
+{
+  dictionary.clear();
+
+  const size_t segmentSize = RDCCLAMP(maxSize / 128, (size_t)64, (size_t)1024);
+
+  bytebuf data;
+  for(const bytebuf &sample : samples)
+    data.append(sample.data(), sample.size());
+
+  if(maxSize < segmentSize || data.size() < maxSize)
+  {
+    RDCERR("Need at least %zu bytes of samples to train a %zu byte dictionary, only have %zu",
+           maxSize, maxSize, data.size());
+    return false;
+  }
+
+  std::vector<uint32_t> freqs(1 << dmerHashBits, 0);
+
+  // count each dmer only once per sample, so that content common to many chunks is preferred over
+  // content repeated within just one.
+  {
+    std::vector<uint32_t> lastSample(1 << dmerHashBits, ~0U);
+
+    const byte *sampleData = data.data();
+    for(uint32_t s = 0; s < (uint32_t)samples.size(); s++)
+    {
+      const size_t size = samples[s].size();
+      for(size_t i = 0; i + dmerSize <= size; i++)
+      {
+        uint32_t h = HashDmer(sampleData + i);
+        if(lastSample[h] != s)
+        {
+          lastSample[h] = s;
+          freqs[h]++;
+        }
+      }
+      sampleData += size;
+    }
+  }
+
+  struct Segment
+  {
+    size_t offset;
+    size_t size;
+    uint64_t score;
+    bool operator<(const Segment &o) const { return score < o.score; }
+  };
+
+  std::vector<Segment> segments;
+
+  // how many times each dmer appears in the current window, so it's only scored once
+  std::vector<uint16_t> active(1 << dmerHashBits, 0);
+
+  const size_t numEpochs = maxSize / segmentSize;
+  const size_t epochSize = data.size() / numEpochs;
+  const size_t windowDmers = segmentSize - dmerSize + 1;
+
+  for(size_t e = 0; e < numEpochs; e++)
+  {
+    const size_t begin = e * epochSize;
+    const size_t end = (e + 1 == numEpochs) ? data.size() : begin + epochSize;
+
+    if(end - begin < segmentSize)
+      continue;
+
+    const size_t numDmers = end - begin - dmerSize + 1;
+    const byte *epoch = data.data() + begin;
+
+    uint64_t score = 0;
+    Segment best = {begin, segmentSize, 0};
+
+    for(size_t i = 0; i < numDmers; i++)
+    {
+      uint32_t h = HashDmer(epoch + i);
+      if(active[h]++ == 0)
+        score += freqs[h];
+
+      // slide the window along, removing the dmer that has fallen off the front
+      if(i >= windowDmers)
+      {
+        h = HashDmer(epoch + i - windowDmers);
+        if(--active[h] == 0)
+          score -= freqs[h];
+      }
+
+      if(i + 1 >= windowDmers && score > best.score)
+      {
+        best.offset = begin + i + 1 - windowDmers;
+        best.score = score;
+      }
+    }
+
+    // empty the window for the next epoch
+    for(size_t i = numDmers - windowDmers; i < numDmers; i++)
+      active[HashDmer(epoch + i)]--;
+
+    if(best.score == 0)
+      continue;
+
+    for(size_t i = 0; i < windowDmers; i++)
+      freqs[HashDmer(data.data() + best.offset + i)] = 0;
+
+    segments.push_back(best);
+  }
+
+  if(segments.empty())
+  {
+    RDCERR("No recurring content found in %zu bytes of samples", data.size());
+    return false;
+  }
+
+  // matches are cheaper the closer they are to the data, which follows the end of the dictionary,
+  // so the most valuable segments go last.
+  std::sort(segments.begin(), segments.end());
+
+  for(const Segment &seg : segments)
+    dictionary.append(data.data() + seg.offset, seg.size);
+
+  return true;
+}
+
+// reads the uncompressed chunk stream of a capture's frame capture section
+static ReplayStatus ReadChunkStream(const rdcstr &path, RDCDriver &driver, bytebuf &stream)
+{
+  RDCFile rdc;
+  rdc.Open(path.c_str());
+
+  if(rdc.ErrorCode() != ContainerError::NoError)
+  {
+    RDCERR("Couldn't open '%s': %s", path.c_str(), rdc.ErrorString().c_str());
+    return ReplayStatus::FileCorrupted;
+  }
+
+  if(driver != RDCDriver::Unknown && rdc.GetDriver() != driver)
+  {
+    RDCERR("'%s' is a %s capture, dictionaries are per-API and the first capture was %s",
+           path.c_str(), ToStr(rdc.GetDriver()).c_str(), ToStr(driver).c_str());
+    return ReplayStatus::APIIncompatibleVersion;
+  }
+
+  driver = rdc.GetDriver();
+
+  int idx = rdc.SectionIndex(SectionType::FrameCapture);
+
+  if(idx < 0)
+  {
+    RDCERR("'%s' has no frame capture section", path.c_str());
+    return ReplayStatus::FileCorrupted;
+  }
+
+  StreamReader *reader = rdc.ReadSection(idx);
+
+  stream.resize((size_t)reader->GetSize());
+  reader->Read(stream.data(), stream.size());
+
+  bool errored = reader->IsErrored();
+
+  delete reader;
+
+  return errored ? ReplayStatus::FileIOFailed : ReplayStatus::Succeeded;
+}
+
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC RENDERDOC_TrainZstdDictionary(
+    const rdcarray<rdcstr> &captures, uint32_t maxSize, bytebuf &dictionary)
+{
+  dictionary.clear();
+
+  if(captures.empty())
+    return ReplayStatus::InternalError;
+
+  // sample around 100x the dictionary size, spread evenly between the captures. Large chunks are
+  // mostly buffer and texture contents that won't recur, so only their start is sampled.
+  const uint64_t captureBudget = uint64_t(maxSize) * 128 / captures.size();
+  const uint64_t maxSampleSize = 16 * 1024;
+
+  RDCDriver driver = RDCDriver::Unknown;
+  rdcarray<bytebuf> samples;
+
+  for(const rdcstr &path : captures)
+  {
+    bytebuf stream;
+    ReplayStatus status = ReadChunkStream(path, driver, stream);
+
+    if(status != ReplayStatus::Succeeded)
+      return status;
+
+    ReadSerialiser ser(new StreamReader(stream.data(), stream.size()), Ownership::Stream);
+
+    uint64_t sampled = 0;
+
+    while(sampled < captureBudget && !ser.GetReader()->AtEnd() && !ser.IsErrored())
+    {
+      uint64_t start = ser.GetReader()->GetOffset();
+
+      ser.ReadChunk<uint32_t>();
+      ser.SkipCurrentChunk();
+      ser.EndChunk();
+
+      uint64_t size = RDCMIN(ser.GetReader()->GetOffset() - start, maxSampleSize);
+
+      samples.push_back(bytebuf());
+      samples.back().assign(stream.data() + start, (size_t)size);
+      sampled += size;
+    }
+  }
+
+  RDCLOG("Training %u byte %s dictionary from %zu chunks in %zu captures", maxSize,
+         ToStr(driver).c_str(), samples.size(), captures.size());
+
+  if(!ZstdDictionaries::Train(samples, maxSize, dictionary))
+    return ReplayStatus::InternalError;
+
+  return ReplayStatus::Succeeded;
+}
+
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC RENDERDOC_EvaluateZstdDictionary(
+    const rdcarray<rdcstr> &captures, const bytebuf &dictionary, rdcstr &report)
+{
+  report.clear();
+
+  if(dictionary.empty())
+    return ReplayStatus::InternalError;
+
+  ZstdDictionary dict(0, RDCDriver::Unknown, dictionary.data(), dictionary.size());
+
+  if(!dict.GetCompressDict() || !dict.GetDecompressDict())
+    return ReplayStatus::InternalError;
+
+  enum
+  {
+    LZ4,
+    Zstd,
+    ZstdDict,
+    Count,
+  };
+
+  const char *names[Count] = {"LZ4", "Zstd", "Zstd + dictionary"};
+
+  uint64_t uncompressed = 0;
+  uint64_t compressed[Count] = {};
+  double compressMS[Count] = {};
+  double decompressMS[Count] = {};
+
+  RDCDriver driver = RDCDriver::Unknown;
+
+  for(const rdcstr &path : captures)
+  {
+    bytebuf stream;
+    ReplayStatus status = ReadChunkStream(path, driver, stream);
+
+    if(status != ReplayStatus::Succeeded)
+      return status;
+
+    uncompressed += stream.size();
+
+    bytebuf readback;
+    readback.resize(stream.size());
+
+    for(int c = 0; c < Count; c++)
+    {
+      StreamWriter buf(StreamWriter::DefaultScratchSize);
+
+      PerformanceTimer timer;
+
+      {
+        Compressor *comp = NULL;
+        if(c == LZ4)
+          comp = new LZ4Compressor(&buf, Ownership::Nothing);
+        else
+          comp = new ZSTDCompressor(&buf, Ownership::Nothing, c == ZstdDict ? &dict : NULL);
+
+        StreamWriter writer(comp, Ownership::Stream);
+        writer.Write(stream.data(), stream.size());
+        writer.Finish();
+      }
+
+      compressMS[c] += timer.GetMilliseconds();
+      compressed[c] += buf.GetOffset();
+
+      timer.Restart();
+
+      {
+        Decompressor *decomp = NULL;
+        StreamReader *compData = new StreamReader(buf.GetData(), buf.GetOffset());
+        if(c == LZ4)
+          decomp = new LZ4Decompressor(compData, Ownership::Stream);
+        else
+          decomp = new ZSTDDecompressor(compData, Ownership::Stream,
+                                        c == ZstdDict ? &dict : NULL);
+
+        StreamReader reader(decomp, stream.size(), Ownership::Stream);
+        reader.Read(readback.data(), readback.size());
+      }
+
+      decompressMS[c] += timer.GetMilliseconds();
+
+      if(!(readback == stream))
+      {
+        RDCERR("%s didn't round-trip '%s' correctly", names[c], path.c_str());
+        return ReplayStatus::InternalError;
+      }
+    }
+  }
+
+  const double MB = 1024.0 * 1024.0;
+
+  report = StringFormat::Fmt("%zu %s capture(s), %.2f MB of chunk data, %zu byte dictionary\n",
+                             captures.size(), ToStr(driver).c_str(), uncompressed / MB,
+                             dictionary.size());
+
+  for(int c = 0; c < Count; c++)
+  {
+    report += StringFormat::Fmt(
+        "  %-18s %10.2f MB (%5.2fx)  compress %8.1f MB/s  decompress %8.1f MB/s\n", names[c],
+        compressed[c] / MB, double(uncompressed) / RDCMAX(compressed[c], (uint64_t)1),
+        (uncompressed / MB) / RDCMAX(compressMS[c] / 1000.0, 1e-6),
+        (uncompressed / MB) / RDCMAX(decompressMS[c] / 1000.0, 1e-6));
+  }
+
+  return ReplayStatus::Succeeded;
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "core/core.h"
+
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+typedef struct ZSTD_DDict_s ZSTD_DDict;
+
+// A raw-content Zstd dictionary used to prime compression of chunk streams, which repeat the same
+// chunk headers and structure layouts throughout. Dictionaries are identified in section headers by
+// a byte ID, so once any capture has been written with an ID it must always refer to the same data.
+class ZstdDictionary
+{
+public:
+  ZstdDictionary(uint8_t id, RDCDriver driver, const byte *data, size_t size);
+  ~ZstdDictionary();
+
+  uint8_t GetID() const { return m_ID; }
+  RDCDriver GetDriver() const { return m_Driver; }
+  const ZSTD_CDict *GetCompressDict() const { return m_CDict; }
+  const ZSTD_DDict *GetDecompressDict() const { return m_DDict; }
+private:
+  uint8_t m_ID;
+  RDCDriver m_Driver;
+  bytebuf m_Data;
+  ZSTD_CDict *m_CDict = NULL;
+  ZSTD_DDict *m_DDict = NULL;
+};
+
+namespace ZstdDictionaries
+{
+// returns the embedded dictionary with this ID, or NULL if it isn't known to this build
+const ZstdDictionary *Find(uint8_t id);
+
+// returns the dictionary to use when writing chunk streams for this driver, or NULL if none
+const ZstdDictionary *FindForDriver(RDCDriver driver);
+
+// trains a raw-content dictionary of at most maxSize bytes from the given samples, by choosing the
+// segments whose contents recur in the most samples. Returns false if there isn't enough data.
+bool Train(const rdcarray<bytebuf> &samples, size_t maxSize, bytebuf &dictionary);
+};
@@ -24,11 +24,13 @@
 
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstdio.h"
+#include "zstd_dictionary.h"
 
 static const uint64_t zstdBlockSize = 128 * 1024;
 static const uint64_t compressBlockSize = ZSTD_compressBound(zstdBlockSize);
 
-ZSTDCompressor::ZSTDCompressor(StreamWriter *write, Ownership own) : Compressor(write, own)
+ZSTDCompressor::ZSTDCompressor(StreamWriter *write, Ownership own, const ZstdDictionary *dict)
+    : Compressor(write, own), m_Dict(dict)
 {
   m_Page = AllocAlignedBuffer(zstdBlockSize);
   m_CompressBuffer = AllocAlignedBuffer(compressBlockSize);
@@ -145,7 +147,9 @@ bool ZSTDCompressor::FlushPage()
 
 bool ZSTDCompressor::CompressZSTDFrame(ZSTD_inBuffer &in, ZSTD_outBuffer &out)
 {
-  size_t err = ZSTD_initCStream(m_Stream, 7);
+  // each frame is primed with the dictionary if there is one, since frames are independent
+  size_t err = m_Dict ? ZSTD_initCStream_usingCDict(m_Stream, m_Dict->GetCompressDict())
+                      : ZSTD_initCStream(m_Stream, 7);
 
   if(ZSTD_isError(err))
   {
@@ -194,7 +198,8 @@ bool ZSTDCompressor::CompressZSTDFrame(ZSTD_inBuffer &in, ZSTD_outBuffer &out)
   return true;
 }
 
-ZSTDDecompressor::ZSTDDecompressor(StreamReader *read, Ownership own) : Decompressor(read, own)
+ZSTDDecompressor::ZSTDDecompressor(StreamReader *read, Ownership own, const ZstdDictionary *dict)
+    : Decompressor(read, own), m_Dict(dict)
 {
   m_Page = AllocAlignedBuffer(zstdBlockSize);
   m_CompressBuffer = AllocAlignedBuffer(compressBlockSize);
@@ -303,7 +308,8 @@ bool ZSTDDecompressor::FillPage()
     return false;
   }
 
-  size_t err = ZSTD_initDStream(m_Stream);
+  size_t err = m_Dict ? ZSTD_initDStream_usingDDict(m_Stream, m_Dict->GetDecompressDict())
+                      : ZSTD_initDStream(m_Stream);
 
   if(ZSTD_isError(err))
   {
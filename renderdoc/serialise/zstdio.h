@@ -27,10 +27,12 @@
 #include "zstd/zstd.h"
 #include "streamio.h"
 
+class ZstdDictionary;
+
 class ZSTDCompressor : public Compressor
 {
 public:
-  ZSTDCompressor(StreamWriter *write, Ownership own);
+  ZSTDCompressor(StreamWriter *write, Ownership own, const ZstdDictionary *dict = NULL);
   ~ZSTDCompressor();
 
   bool Write(const void *data, uint64_t numBytes);
@@ -45,13 +47,14 @@ private:
   byte *m_CompressBuffer;
   uint64_t m_PageOffset;
 
+  const ZstdDictionary *m_Dict;
   ZSTD_CStream *m_Stream;
 };
 
 class ZSTDDecompressor : public Decompressor
 {
 public:
-  ZSTDDecompressor(StreamReader *read, Ownership own);
+  ZSTDDecompressor(StreamReader *read, Ownership own, const ZstdDictionary *dict = NULL);
   ~ZSTDDecompressor();
 
   bool Recompress(Compressor *comp);
@@ -65,5 +68,6 @@ private:
   uint64_t m_PageOffset;
   uint64_t m_PageLength;
 
+  const ZstdDictionary *m_Dict;
   ZSTD_DStream *m_Stream;
 };
@@ -26,6 +26,11 @@
 #include "renderdoccmd.h"
 #include <app/renderdoc_app.h>
 #include <replay/version.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <sstream>
 #include <string>
 
 // normally this is in the renderdoc core library, but it's needed for the 'unknown enum' path,
@@ -462,6 +467,7 @@ struct RemoteServerCommand : public Command
     parser.add<std::string>(
         "host", 'h', "The interface to listen on. By default listens on all interfaces", false, "");
     parser.add("preview", 'v', "Display a preview window when a replay is active.");
+    parser.stop_at_rest(true);
   }
   virtual const char *Description()
   {
@@ -617,6 +623,415 @@ struct ReplayCommand : public Command
   }
 };
 
+static std::string json_escape(const std::string &str)
+{
+  std::string ret;
+  ret.reserve(str.size() + 2);
+
+  for(char c : str)
+  {
+    if(c == '"' || c == '\\')
+    {
+      ret.push_back('\\');
+      ret.push_back(c);
+    }
+    else if(c == '\n')
+    {
+      ret += "\\n";
+    }
+    else if((unsigned char)c < 0x20)
+    {
+      char hex[8];
+      snprintf(hex, sizeof(hex), "\\u%04x", (unsigned char)c);
+      ret += hex;
+    }
+    else
+    {
+      ret.push_back(c);
+    }
+  }
+
+  return ret;
+}
+
+struct BenchmarkPass
+{
+  std::string name;
+  uint32_t firstEvent = ~0U;
+  uint32_t lastEvent = 0;
+  double cpuTime = 0.0;
+  double gpuTime = 0.0;
+  bool hasGPUTime = false;
+};
+
+// assign every event under a drawcall to a pass and list the leaf drawcalls in order
+static void collect_benchmark_events(const DrawcallDescription &draw, size_t pass,
+                                     std::map<uint32_t, size_t> &passForEvent,
+                                     std::vector<const DrawcallDescription *> &leaves)
+{
+  for(const APIEvent &ev : draw.events)
+    passForEvent[ev.eventId] = pass;
+  passForEvent[draw.eventId] = pass;
+
+  if(draw.children.empty())
+  {
+    leaves.push_back(&draw);
+    return;
+  }
+
+  for(const DrawcallDescription &child : draw.children)
+    collect_benchmark_events(child, pass, passForEvent, leaves);
+}
+
+static void write_benchmark_stats(std::ostream &out, const char *name, std::vector<double> values)
+{
+  out << "  \"" << name << "\": {";
+
+  if(values.empty())
+  {
+    out << "}";
+    return;
+  }
+
+  double sum = 0.0;
+  for(double v : values)
+    sum += v;
+
+  double mean = sum / double(values.size());
+
+  double variance = 0.0;
+  for(double v : values)
+    variance += (v - mean) * (v - mean);
+  variance /= double(values.size());
+
+  out << "\"values\": [";
+  for(size_t i = 0; i < values.size(); i++)
+    out << (i > 0 ? ", " : "") << values[i];
+  out << "], ";
+
+  std::sort(values.begin(), values.end());
+
+  out << "\"mean\": " << mean << ", \"median\": " << values[values.size() / 2]
+      << ", \"min\": " << values.front() << ", \"max\": " << values.back()
+      << ", \"stddev\": " << sqrt(variance) << "}";
+}
+
+struct BenchmarkCommand : public Command
+{
+  BenchmarkCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add<uint32_t>("iterations", 'n', "How many times to replay the frame while timing.",
+                         false, 20);
+    parser.add<uint32_t>("warmup", 'w', "How many times to replay the frame before timing.", false,
+                         3);
+    parser.add<std::string>("output", 'o', "Write the JSON report to this file instead of stdout.",
+                            false);
+    parser.add("gpu-timings", 0,
+               "Fetch GPU timings for each iteration. This replays the frame a second time per "
+               "iteration, which isn't included in the CPU timings.");
+    parser.add("skip-present", 0, "Replay up to the last event before the final present.");
+    parser.add<int>("gpu", 0,
+                    "Replay on this GPU, by index in the list from --list-gpus. By default the "
+                    "best match for the capture is used.",
+                    false, -1);
+    parser.add("list-gpus", 0, "List the GPUs available to replay on, then exit.");
+  }
+  virtual const char *Description()
+  {
+    return "Replay the frame repeatedly without a window and report timings as JSON.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: benchmark command requires a filename to load." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    std::string filename = rest[0];
+
+    rest.erase(rest.begin());
+
+    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(rest));
+
+    ICaptureFile *file = RENDERDOC_OpenCaptureFile();
+
+    if(file->OpenFile(filename.c_str(), "rdc", NULL) != ReplayStatus::Succeeded)
+    {
+      std::cerr << "Couldn't load '" << filename << "'." << std::endl;
+      file->Shutdown();
+      return 1;
+    }
+
+    rdcarray<GPUDevice> gpus = file->GetAvailableGPUs();
+
+    if(parser.exist("list-gpus"))
+    {
+      for(size_t i = 0; i < gpus.size(); i++)
+      {
+        std::cout << i << ": " << gpus[i].name.c_str() << " (" << ToStr(gpus[i].vendor).c_str();
+        if(!gpus[i].driver.empty())
+          std::cout << ", " << gpus[i].driver.c_str();
+        std::cout << ")" << std::endl;
+      }
+
+      file->Shutdown();
+      return 0;
+    }
+
+    ReplayOptions opts;
+
+    int gpu = parser.get<int>("gpu");
+    if(gpu >= 0)
+    {
+      if(gpu >= gpus.count())
+      {
+        std::cerr << "GPU index " << gpu << " is out of range, see --list-gpus." << std::endl;
+        file->Shutdown();
+        return 1;
+      }
+
+      opts.forceGPUVendor = gpus[gpu].vendor;
+      opts.forceGPUDeviceID = gpus[gpu].deviceID;
+      opts.forceGPUDriverName = gpus[gpu].driver;
+    }
+
+    std::cerr << "Loading '" << filename << "'" << std::endl;
+
+    auto loadStart = std::chrono::high_resolution_clock::now();
+
+    IReplayController *renderer = NULL;
+    ReplayStatus status = ReplayStatus::InternalError;
+    rdctie(status, renderer) = file->OpenCapture(opts, NULL);
+
+    double loadTime = std::chrono::duration<double, std::milli>(
+                          std::chrono::high_resolution_clock::now() - loadStart)
+                          .count();
+
+    file->Shutdown();
+
+    if(status != ReplayStatus::Succeeded)
+    {
+      std::cerr << "Couldn't load and replay '" << filename << "': " << ToStr(status) << std::endl;
+      return 1;
+    }
+
+    uint64_t peakMemory = RENDERDOC_GetCurrentProcessMemoryUsage();
+
+    // top-level markers are treated as passes. Anything outside a marker goes into the first
+    // entry, which is only reported if it has any events
+    std::vector<BenchmarkPass> passes(1);
+    passes[0].name = "(no marker)";
+
+    std::map<uint32_t, size_t> passForEvent;
+    std::vector<const DrawcallDescription *> leaves;
+
+    for(const DrawcallDescription &d : renderer->GetDrawcalls())
+    {
+      size_t pass = 0;
+
+      if(!d.children.empty())
+      {
+        pass = passes.size();
+        passes.push_back(BenchmarkPass());
+        passes.back().name = d.name.c_str();
+      }
+
+      collect_benchmark_events(d, pass, passForEvent, leaves);
+    }
+
+    for(auto it = passForEvent.begin(); it != passForEvent.end(); ++it)
+    {
+      BenchmarkPass &pass = passes[it->second];
+      pass.firstEvent = std::min(pass.firstEvent, it->first);
+      pass.lastEvent = std::max(pass.lastEvent, it->first);
+    }
+
+    if(leaves.empty())
+    {
+      std::cerr << "Capture contains no events to replay." << std::endl;
+      renderer->Shutdown();
+      return 1;
+    }
+
+    const bool skipPresent = parser.exist("skip-present");
+    const bool gpuTimings = parser.exist("gpu-timings");
+
+    size_t targetLeaf = leaves.size() - 1;
+    if(skipPresent)
+    {
+      while(targetLeaf > 0 && (leaves[targetLeaf]->flags & DrawFlags::Present))
+        targetLeaf--;
+    }
+
+    const uint32_t firstEvent = leaves[0]->eventId;
+    const uint32_t targetEvent = leaves[targetLeaf]->eventId;
+
+    // accumulate a replay profile's chunk timings into the passes. Only events up to the target
+    // count, so that a skipped present isn't included.
+    auto accumulateProfile = [&](const ReplayProfile &profile, double &gpuTotal) -> bool {
+      bool anyGPU = false;
+      gpuTotal = 0.0;
+
+      for(const ReplayEventTiming &ev : profile.events)
+      {
+        if(ev.eventId == 0 || ev.eventId > targetEvent)
+          continue;
+
+        auto it = passForEvent.find(ev.eventId);
+        BenchmarkPass &pass = passes[it == passForEvent.end() ? 0 : it->second];
+
+        pass.cpuTime += (ev.deserialiseTime + ev.executeTime) * 1000.0;
+
+        if(ev.gpuTime >= 0.0)
+        {
+          pass.gpuTime += ev.gpuTime * 1000.0;
+          pass.hasGPUTime = true;
+          gpuTotal += ev.gpuTime * 1000.0;
+          anyGPU = true;
+        }
+      }
+
+      return anyGPU;
+    };
+
+    const uint32_t warmup = parser.get<uint32_t>("warmup");
+    const uint32_t iterations = std::max(1U, parser.get<uint32_t>("iterations"));
+
+    std::vector<double> cpuTimes, gpuTimes;
+
+    for(uint32_t i = 0; i < warmup + iterations; i++)
+    {
+      bool timed = (i >= warmup);
+
+      std::cerr << (timed ? "Iteration " : "Warm-up ") << (timed ? i - warmup + 1 : i + 1) << "/"
+                << (timed ? iterations : warmup) << std::endl;
+
+      // jump to the start first, so that replaying to the target replays the whole frame from the
+      // initial state
+      renderer->SetFrameEvent(firstEvent, true);
+
+      auto start = std::chrono::high_resolution_clock::now();
+
+      renderer->SetFrameEvent(targetEvent, true);
+
+      double cpuTime = std::chrono::duration<double, std::milli>(
+                           std::chrono::high_resolution_clock::now() - start)
+                           .count();
+
+      peakMemory = std::max(peakMemory, RENDERDOC_GetCurrentProcessMemoryUsage());
+
+      if(!timed)
+        continue;
+
+      cpuTimes.push_back(cpuTime);
+
+      if(gpuTimings)
+      {
+        double gpuTime = 0.0;
+        if(accumulateProfile(renderer->GetReplayProfile(true), gpuTime))
+          gpuTimes.push_back(gpuTime);
+
+        peakMemory = std::max(peakMemory, RENDERDOC_GetCurrentProcessMemoryUsage());
+      }
+    }
+
+    if(gpuTimings)
+    {
+      // the passes accumulated every iteration, average them
+      for(BenchmarkPass &pass : passes)
+      {
+        pass.cpuTime /= double(iterations);
+        pass.gpuTime /= double(iterations);
+      }
+
+      if(gpuTimes.empty())
+        std::cerr << "GPU timings are not available for this capture." << std::endl;
+    }
+    else
+    {
+      // without GPU timings, profile one more replay just for the per-pass CPU breakdown
+      double dummy = 0.0;
+      accumulateProfile(renderer->GetReplayProfile(false), dummy);
+    }
+
+    std::ostringstream out;
+    out.precision(6);
+    out << std::fixed;
+
+    out << "{" << std::endl;
+    out << "  \"capture\": \"" << json_escape(filename) << "\"," << std::endl;
+    out << "  \"api\": \"" << ToStr(renderer->GetAPIProperties().pipelineType).c_str() << "\","
+        << std::endl;
+    if(gpu >= 0)
+      out << "  \"gpu\": \"" << json_escape(gpus[gpu].name.c_str()) << "\"," << std::endl;
+    out << "  \"iterations\": " << iterations << "," << std::endl;
+    out << "  \"warmup\": " << warmup << "," << std::endl;
+    out << "  \"skip_present\": " << (skipPresent ? "true" : "false") << "," << std::endl;
+    out << "  \"target_event\": " << targetEvent << "," << std::endl;
+    out << "  \"load_time_ms\": " << loadTime << "," << std::endl;
+    out << "  \"peak_memory\": " << peakMemory << "," << std::endl;
+    write_benchmark_stats(out, "cpu_ms", cpuTimes);
+    out << "," << std::endl;
+    write_benchmark_stats(out, "gpu_ms", gpuTimes);
+    out << "," << std::endl;
+    out << "  \"passes\": [";
+
+    bool first = true;
+    for(const BenchmarkPass &pass : passes)
+    {
+      if(pass.firstEvent > pass.lastEvent || pass.firstEvent > targetEvent)
+        continue;
+
+      out << (first ? "" : ",") << std::endl;
+      first = false;
+
+      out << "    {\"name\": \"" << json_escape(pass.name) << "\", \"first_event\": "
+          << pass.firstEvent << ", \"last_event\": " << pass.lastEvent
+          << ", \"cpu_ms\": " << pass.cpuTime;
+      if(pass.hasGPUTime)
+        out << ", \"gpu_ms\": " << pass.gpuTime;
+      out << "}";
+    }
+
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+    renderer->Shutdown();
+
+    if(parser.exist("output"))
+    {
+      std::string output = parser.get<std::string>("output");
+
+      FILE *f = fopen(output.c_str(), "w");
+
+      if(!f)
+      {
+        std::cerr << "Couldn't open destination file '" << output << "'" << std::endl;
+        return 1;
+      }
+
+      std::string report = out.str();
+      fwrite(report.c_str(), 1, report.size(), f);
+      fclose(f);
+
+      std::cerr << "Wrote benchmark report to '" << output << "'." << std::endl;
+    }
+    else
+    {
+      std::cout << out.str();
+    }
+
+    return 0;
+  }
+};
+
 struct formats_reader
 {
   formats_reader(bool input)
@@ -1167,6 +1582,224 @@ struct EmbeddedSectionCommand : public Command
   }
 };
 
+struct PackCommand : public Command
+{
+  bool m_Unpack = false;
+  PackCommand(const GlobalEnvironment &env, bool unpack) : Command(env) { m_Unpack = unpack; }
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc> [<capture.rdc> ...]");
+
+    if(!m_Unpack)
+      parser.add<std::string>(
+          "store", 's',
+          "The blob store directory. A relative path is relative to the packed capture.");
+
+    parser.add<std::string>("output", 'o',
+                            "A directory to write the captures to, instead of replacing them.",
+                            false);
+  }
+  virtual const char *Description()
+  {
+    if(m_Unpack)
+      return "Unpack captures from a blob store back into standalone captures.";
+    else
+      return "Pack captures into a shared blob store, storing data repeated between them once.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: this command requires at least one capture filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    RENDERDOC_InitGlobalEnv(m_Env, rdcarray<rdcstr>());
+
+    std::string store = m_Unpack ? "" : parser.get<std::string>("store");
+    std::string output = parser.get<std::string>("output");
+
+    int ret = 0;
+
+    for(const std::string &rdc : rest)
+    {
+      std::string dest = rdc;
+
+      if(!output.empty())
+      {
+        size_t sep = rdc.find_last_of("/\\");
+        dest = output + "/" + (sep == std::string::npos ? rdc : rdc.substr(sep + 1));
+      }
+
+      // write next to the destination first, since the capture can't be replaced while it's open
+      std::string temp = dest + ".tmp";
+
+      ICaptureFile *capfile = RENDERDOC_OpenCaptureFile();
+
+      ReplayStatus status = capfile->OpenFile(rdc.c_str(), "", NULL);
+
+      if(status == ReplayStatus::Succeeded)
+      {
+        if(m_Unpack)
+          status = capfile->Convert(temp.c_str(), "rdc", NULL, NULL);
+        else
+          status = capfile->PackToBlobStore(temp.c_str(), store.c_str(), NULL);
+      }
+
+      capfile->Shutdown();
+
+      if(status != ReplayStatus::Succeeded)
+      {
+        remove(temp.c_str());
+        std::cerr << "Couldn't " << (m_Unpack ? "unpack" : "pack") << " '" << rdc
+                  << "': " << ToStr(status) << std::endl;
+        ret = 1;
+        continue;
+      }
+
+      remove(dest.c_str());
+
+      if(rename(temp.c_str(), dest.c_str()) != 0)
+      {
+        std::cerr << "Couldn't move '" << temp << "' to '" << dest << "'" << std::endl;
+        ret = 1;
+        continue;
+      }
+
+      std::cout << (m_Unpack ? "Unpacked '" : "Packed '") << rdc << "' to '" << dest << "'"
+                << std::endl;
+    }
+
+    return ret;
+  }
+};
+
+struct ZstdDictionaryCommand : public Command
+{
+  ZstdDictionaryCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc> [<capture.rdc> ...]");
+    parser.add<std::string>("train", 't', "Train a new dictionary and write it to this file.",
+                            false);
+    parser.add<uint32_t>("size", 's', "The maximum size of a trained dictionary in bytes.", false,
+                         112640);
+    parser.add<std::string>("evaluate", 'e',
+                            "Compare compression of the captures with this dictionary, to LZ4 "
+                            "and to Zstd without a dictionary.",
+                            false);
+  }
+  virtual const char *Description()
+  {
+    return "Train and evaluate Zstd dictionaries for compressing captures of one API.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: this command requires at least one capture filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    std::string train = parser.get<std::string>("train");
+    std::string evaluate = parser.get<std::string>("evaluate");
+
+    if(train.empty() && evaluate.empty())
+    {
+      std::cerr << "Error: either --train or --evaluate must be specified." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    RENDERDOC_InitGlobalEnv(m_Env, rdcarray<rdcstr>());
+
+    rdcarray<rdcstr> captures;
+    for(const std::string &rdc : rest)
+      captures.push_back(rdc);
+
+    bytebuf dictionary;
+
+    if(!train.empty())
+    {
+      ReplayStatus status =
+          RENDERDOC_TrainZstdDictionary(captures, parser.get<uint32_t>("size"), dictionary);
+
+      if(status != ReplayStatus::Succeeded)
+      {
+        std::cerr << "Couldn't train dictionary: " << ToStr(status) << std::endl;
+        return 1;
+      }
+
+      FILE *f = fopen(train.c_str(), "wb");
+
+      if(!f)
+      {
+        std::cerr << "Couldn't open destination file '" << train << "'" << std::endl;
+        return 1;
+      }
+
+      fwrite(dictionary.data(), 1, dictionary.size(), f);
+      fclose(f);
+
+      std::cout << "Wrote " << dictionary.size() << " byte dictionary to '" << train << "'."
+                << std::endl;
+    }
+
+    if(!evaluate.empty())
+    {
+      // evaluate the dictionary we just trained if it's the same file
+      if(evaluate != train)
+      {
+        FILE *f = fopen(evaluate.c_str(), "rb");
+
+        if(!f)
+        {
+          std::cerr << "Couldn't open dictionary file '" << evaluate << "'" << std::endl;
+          return 1;
+        }
+
+        fseek(f, 0, SEEK_END);
+        long len = ftell(f);
+        fseek(f, 0, SEEK_SET);
+
+        dictionary.resize(len > 0 ? (size_t)len : 0);
+        size_t read = fread(dictionary.data(), 1, dictionary.size(), f);
+        fclose(f);
+
+        if(len <= 0 || read != dictionary.size())
+        {
+          std::cerr << "Couldn't read dictionary file '" << evaluate << "'" << std::endl;
+          return 1;
+        }
+      }
+
+      rdcstr report;
+      ReplayStatus status = RENDERDOC_EvaluateZstdDictionary(captures, dictionary, report);
+
+      if(status != ReplayStatus::Succeeded)
+      {
+        std::cerr << "Couldn't evaluate dictionary: " << ToStr(status) << std::endl;
+        return 1;
+      }
+
+      std::cout << report.c_str();
+    }
+
+    return 0;
+  }
+};
+
 REPLAY_PROGRAM_MARKER()
 
 int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
@@ -1199,11 +1832,15 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
     add_command("inject", new InjectCommand(env));
     add_command("remoteserver", new RemoteServerCommand(env));
     add_command("replay", new ReplayCommand(env));
+    add_command("benchmark", new BenchmarkCommand(env));
     add_command("capaltbit", new CapAltBitCommand(env));
     add_command("test", new TestCommand(env));
     add_command("convert", new ConvertCommand(env));
     add_command("embed", new EmbeddedSectionCommand(env, false));
     add_command("extract", new EmbeddedSectionCommand(env, true));
+    add_command("pack", new PackCommand(env, false));
+    add_command("unpack", new PackCommand(env, true));
+    add_command("zstddict", new ZstdDictionaryCommand(env));
 
     if(argv.size() <= 1)
     {
@@ -1278,6 +1915,22 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
               "Capturing Option: Include all live resources, not just those used by a frame.");
       cmd.add("opt-capture-all-cmd-lists", 0,
               "Capturing Option: In D3D11, record all command lists from application start.");
+      cmd.add<int>("opt-capture-memory-budget", 0,
+                   "Capturing Option: Specify a limit in MB for captured data to keep in memory, "
+                   "before moving older data to disk. 0 means no limit.",
+                   false, 0, cmdline::range(0, 1024 * 1024));
+      cmd.add<int>("opt-retroactive-frames", 0,
+                   "Capturing Option: Hold the N most recent frames in memory so they can be saved "
+                   "after being presented. 0 disables.",
+                   false, 0, cmdline::range(0, 1024));
+      cmd.add<int>("opt-retroactive-memory-budget", 0,
+                   "Capturing Option: Specify a limit in MB for frames held for retroactive "
+                   "capture. 0 means no limit.",
+                   false, 512, cmdline::range(0, 1024 * 1024));
+      cmd.add<int>("opt-retroactive-cpu-budget", 0,
+                   "Capturing Option: Specify the percentage of time that may be spent recording "
+                   "frames for retroactive capture.",
+                   false, 25, cmdline::range(1, 100));
     }
 
     cmd.parse_check(argv, true);
@@ -1309,6 +1962,10 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
         opts.captureAllCmdLists = true;
 
       opts.delayForDebugger = (uint32_t)cmd.get<int>("opt-delay-for-debugger");
+      opts.captureMemoryBudgetMB = (uint32_t)cmd.get<int>("opt-capture-memory-budget");
+      opts.retroactiveFrames = (uint32_t)cmd.get<int>("opt-retroactive-frames");
+      opts.retroactiveMemoryBudgetMB = (uint32_t)cmd.get<int>("opt-retroactive-memory-budget");
+      opts.retroactiveCPUBudget = (uint32_t)cmd.get<int>("opt-retroactive-cpu-budget");
     }
 
     if(!it->second->HandlesUsageManually() && cmd.exist("help"))
@@ -0,0 +1,168 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2019 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "gl_test.h"
+
+RD_TEST(GL_Large_Texture_Contents, OpenGLGraphicsTest)
+{
+  static constexpr const char *Description =
+      "Samples from a large amount of GPU-written texture data, to measure how long reading back "
+      "texture initial contents takes when capturing.";
+
+  std::string vertex = R"EOSHADER(
+#version 420 core
+
+out vec2 uv;
+
+void main()
+{
+  const vec4 verts[4] = vec4[4](vec4(-1.0, -1.0, 0.5, 1.0), vec4(1.0, -1.0, 0.5, 1.0),
+                                vec4(-1.0, 1.0, 0.5, 1.0), vec4(1.0, 1.0, 0.5, 1.0));
+
+  gl_Position = verts[gl_VertexID];
+  uv = gl_Position.xy * 0.5f + 0.5f;
+}
+
+)EOSHADER";
+
+  std::string pixel = R"EOSHADER(
+#version 420 core
+
+in vec2 uv;
+
+layout(location = 0, index = 0) out vec4 Color;
+
+layout(binding = 0) uniform sampler2D tex2D[8];
+layout(binding = 8) uniform samplerCube texCube;
+layout(binding = 9) uniform sampler2DArray tex2DArray;
+
+void main()
+{
+  vec4 col = vec4(0.0f);
+
+  for(int i = 0; i < 8; i++)
+    col += texture(tex2D[i], uv);
+
+  col += texture(texCube, vec3(uv * 2.0f - 1.0f, 1.0f));
+  col += texture(tex2DArray, vec3(uv, uv.x * 16.0f));
+
+  Color = col / 10.0f;
+}
+
+)EOSHADER";
+
+  int main()
+  {
+    // initialise, create window, create context, etc
+    if(!Init())
+      return 3;
+
+    GLuint vao = MakeVAO();
+    glBindVertexArray(vao);
+
+    GLuint program = MakeProgram(vertex, pixel);
+
+    const GLsizei texDim = 2048;
+    const GLsizei cubeDim = 1024;
+    const GLsizei arrayDim = 1024;
+    const GLsizei arraySlices = 16;
+
+    std::vector<uint32_t> data(texDim * texDim);
+
+    // fill the data with a different pattern for each texture, and generate the mips on the GPU so
+    // that all of the textures are dirty and need their contents read back when capturing.
+    auto fill = [&data](uint32_t seed, size_t count) {
+      for(size_t i = 0; i < count; i++)
+        data[i] = uint32_t(i * 2654435761U + seed) | 0xff000000;
+    };
+
+    GLuint tex2D[8];
+    for(int t = 0; t < 8; t++)
+    {
+      tex2D[t] = MakeTexture();
+      glBindTexture(GL_TEXTURE_2D, tex2D[t]);
+      glTexStorage2D(GL_TEXTURE_2D, 12, GL_RGBA8, texDim, texDim);
+
+      fill(t, data.size());
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texDim, texDim, GL_RGBA, GL_UNSIGNED_BYTE,
+                      data.data());
+      glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    GLuint texCube = MakeTexture();
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texCube);
+    glTexStorage2D(GL_TEXTURE_CUBE_MAP, 11, GL_RGBA8, cubeDim, cubeDim);
+    for(int face = 0; face < 6; face++)
+    {
+      fill(100 + face, cubeDim * cubeDim);
+      glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, cubeDim, cubeDim, GL_RGBA,
+                      GL_UNSIGNED_BYTE, data.data());
+    }
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+
+    GLuint tex2DArray = MakeTexture();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tex2DArray);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 11, GL_RGBA8, arrayDim, arrayDim, arraySlices);
+    for(int slice = 0; slice < arraySlices; slice++)
+    {
+      fill(200 + slice, arrayDim * arrayDim);
+      glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, slice, arrayDim, arrayDim, 1, GL_RGBA,
+                      GL_UNSIGNED_BYTE, data.data());
+    }
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    while(Running())
+    {
+      float col[] = {0.4f, 0.5f, 0.6f, 1.0f};
+      glClearBufferfv(GL_COLOR, 0, col);
+
+      glBindVertexArray(vao);
+
+      glUseProgram(program);
+
+      for(int t = 0; t < 8; t++)
+      {
+        glActiveTexture(GL_TEXTURE0 + t);
+        glBindTexture(GL_TEXTURE_2D, tex2D[t]);
+      }
+
+      glActiveTexture(GL_TEXTURE8);
+      glBindTexture(GL_TEXTURE_CUBE_MAP, texCube);
+      glActiveTexture(GL_TEXTURE9);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, tex2DArray);
+      glActiveTexture(GL_TEXTURE0);
+
+      glViewport(0, 0, GLsizei(screenWidth), GLsizei(screenHeight));
+
+      glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+      Present();
+    }
+
+    return 0;
+  }
+};
+
+REGISTER_TEST();
@@ -23,6 +23,7 @@
 ******************************************************************************/
 
 #include <stdlib.h>
+#include <sys/resource.h>
 #include "test_common.h"
 
 std::string GetCWD()
@@ -51,6 +52,15 @@ std::string GetEnvVar(const char *var)
   return "";
 }
 
+uint64_t GetPeakMemoryUsage()
+{
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+
+  // ru_maxrss is in kilobytes
+  return uint64_t(usage.ru_maxrss) * 1024;
+}
+
 void tmpnam_via_mkstemp(char (&buf)[MAX_PATH])
 {
   snprintf(buf, MAX_PATH - 1, "/tmp/rdoc_tmp_%x", rand());
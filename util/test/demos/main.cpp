@@ -238,6 +238,51 @@ void RegisterTest(TestMetadata test)
   test_list().push_back(test);
 }
 
+void WriteBenchmarkReport(const TestMetadata &test)
+{
+  const std::string &path = GraphicsTest::benchmarkReport;
+
+  // write to a temporary file and rename it into place, so that anything waiting for the report
+  // never sees a partially written file
+  std::string tmpPath = path + ".tmp";
+
+  FILE *f = fopen(tmpPath.c_str(), "w");
+
+  if(!f)
+  {
+    TEST_ERROR("Couldn't open benchmark report %s for writing", tmpPath.c_str());
+    return;
+  }
+
+  const GraphicsTest &t = *test.test;
+
+  fprintf(f, "{\n");
+  fprintf(f, "  \"test\": \"%s\",\n", test.Name);
+  fprintf(f, "  \"api\": \"%s\",\n", APIName(test.API));
+  fprintf(f, "  \"injected\": %s,\n", t.rdoc ? "true" : "false");
+  fprintf(f, "  \"width\": %d,\n", GraphicsTest::screenWidth);
+  fprintf(f, "  \"height\": %d,\n", GraphicsTest::screenHeight);
+  fprintf(f, "  \"peak_memory\": %llu,\n", (unsigned long long)GetPeakMemoryUsage());
+
+  fprintf(f, "  \"captured_frames\": [");
+  for(size_t i = 0; i < t.capturedFrames.size(); i++)
+    fprintf(f, "%s%d", i == 0 ? "" : ", ", t.capturedFrames[i]);
+  fprintf(f, "],\n");
+
+  fprintf(f, "  \"frame_times\": [");
+  for(size_t i = 0; i < t.frameTimes.size(); i++)
+    fprintf(f, "%s%s%.4f", i == 0 ? "" : ",", i % 8 == 0 ? "\n    " : " ", t.frameTimes[i]);
+  fprintf(f, "\n  ]\n");
+
+  fprintf(f, "}\n");
+
+  fclose(f);
+
+  remove(path.c_str());
+  if(rename(tmpPath.c_str(), path.c_str()) != 0)
+    TEST_ERROR("Couldn't move benchmark report into place at %s", path.c_str());
+}
+
 int main(int argc, char **argv)
 {
   std::vector<TestMetadata> &tests = test_list();
@@ -264,6 +309,8 @@ Usage: %s Test_Name [test_options]
   --frames <n>
   --max-frames <n>
   --frame-count <n>             Only run the demo for this number of frames
+  --benchmark <path>            Record per-frame CPU timings and peak memory use, and write them
+                                as a JSON report to the given path when the demo exits.
   --data <path>                 Specfiy where extended data should come from.
                                 By default in the path in $RENDERDOC_DEMOS_DATA
                                 environment variable, or else in the data/demos
@@ -513,6 +560,10 @@ Usage: %s Test_Name [test_options]
 
       int ret = test.test->main();
       test.test->Shutdown();
+
+      if(!GraphicsTest::benchmarkReport.empty())
+        WriteBenchmarkReport(test);
+
       return ret;
     }
   }
@@ -213,6 +213,47 @@ typedef enum RENDERDOC_CaptureOption {
   // necessary as directed by a RenderDoc developer.
   eRENDERDOC_Option_AllowUnsupportedVendorExtensions = 12,
 
+  // The amount of memory in megabytes that captured data is allowed to occupy
+  // in the process. When this is exceeded the contents of older large chunks
+  // of captured data are moved to a temporary file on disk, and read back when
+  // the capture is written out.
+  //
+  // Default - 0
+  //
+  // 0 - No limit, all captured data is kept in memory
+  // N - Keep at most N megabytes of captured data in memory where possible
+  eRENDERDOC_Option_CaptureMemoryBudgetMB = 13,
+
+  // Keep the most recent frames captured in memory, so that a frame can be
+  // saved after it has already been presented. While this is enabled a
+  // capture trigger saves the most recently completed frames from memory,
+  // and queueing a capture of a past frame saves it if it is still held.
+  //
+  // Default - 0
+  //
+  // 0 - Disabled, only frames that are explicitly captured are recorded
+  // N - Hold up to the N most recent frames in memory
+  eRENDERDOC_Option_RetroactiveFrames = 14,
+
+  // The amount of memory in megabytes that frames held for retroactive
+  // capture may occupy. The oldest frames are dropped to stay under this.
+  //
+  // Default - 512
+  //
+  // 0 - No limit, only eRENDERDOC_Option_RetroactiveFrames bounds memory use
+  // N - Hold at most N megabytes of frames in memory
+  eRENDERDOC_Option_RetroactiveMemoryBudgetMB = 15,
+
+  // The percentage of the application's time that may be spent recording
+  // frames for retroactive capture. Frames are skipped as needed to stay
+  // within this, so held frames may not be consecutive.
+  //
+  // Default - 25
+  //
+  // 100 - Record every frame regardless of the overhead
+  // N - Spend at most N percent of the time recording frames
+  eRENDERDOC_Option_RetroactiveCPUBudget = 16,
+
 } RENDERDOC_CaptureOption;
 
 // Sets an option that controls how RenderDoc behaves on capture.
@@ -520,6 +561,13 @@ typedef uint32_t(RENDERDOC_CC *pRENDERDOC_EndFrameCapture)(RENDERDOC_DevicePoint
 typedef uint32_t(RENDERDOC_CC *pRENDERDOC_DiscardFrameCapture)(RENDERDOC_DevicePointer device,
                                                                RENDERDOC_WindowHandle wndHandle);
 
+// Returns how much memory captured data is currently using. Any parameter can be NULL.
+//
+// resident is filled with the number of bytes held in memory, and spilled with the number of
+// bytes that were moved to disk to stay under eRENDERDOC_Option_CaptureMemoryBudgetMB. This
+// includes data recorded in the background between captures, not just the current capture.
+typedef void(RENDERDOC_CC *pRENDERDOC_GetCaptureMemoryUsage)(uint64_t *resident, uint64_t *spilled);
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // RenderDoc API versions
 //
@@ -543,6 +591,8 @@ typedef enum RENDERDOC_Version {
   eRENDERDOC_API_Version_1_2_0 = 10200,    // RENDERDOC_API_1_2_0 = 1 02 00
   eRENDERDOC_API_Version_1_3_0 = 10300,    // RENDERDOC_API_1_3_0 = 1 03 00
   eRENDERDOC_API_Version_1_4_0 = 10400,    // RENDERDOC_API_1_4_0 = 1 04 00
+  eRENDERDOC_API_Version_1_5_0 = 10500,    // RENDERDOC_API_1_5_0 = 1 05 00
+  eRENDERDOC_API_Version_1_6_0 = 10600,    // RENDERDOC_API_1_6_0 = 1 06 00
 } RENDERDOC_Version;
 
 // API version changelog:
@@ -568,8 +618,13 @@ typedef enum RENDERDOC_Version {
 //         0xdddddddd of uninitialised buffer contents.
 // 1.4.0 - Added feature: DiscardFrameCapture() to discard a frame capture in progress and stop
 //         capturing without saving anything to disk.
+// 1.5.0 - Added feature: New capture option eRENDERDOC_Option_CaptureMemoryBudgetMB to limit the
+//         memory used by captured data, and GetCaptureMemoryUsage() to query it.
+// 1.6.0 - Added feature: New capture options eRENDERDOC_Option_RetroactiveFrames,
+//         eRENDERDOC_Option_RetroactiveMemoryBudgetMB and eRENDERDOC_Option_RetroactiveCPUBudget
+//         to hold recent frames in memory and save them after they have been presented.
 
-typedef struct RENDERDOC_API_1_4_0
+typedef struct RENDERDOC_API_1_6_0
 {
   pRENDERDOC_GetAPIVersion GetAPIVersion;
 
@@ -635,16 +690,21 @@ typedef struct RENDERDOC_API_1_4_0
 
   // new function in 1.4.0
   pRENDERDOC_DiscardFrameCapture DiscardFrameCapture;
-} RENDERDOC_API_1_4_0;
-
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_0_0;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_0_1;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_0_2;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_1_0;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_1_1;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_1_2;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_2_0;
-typedef RENDERDOC_API_1_4_0 RENDERDOC_API_1_3_0;
+
+  // new function in 1.5.0
+  pRENDERDOC_GetCaptureMemoryUsage GetCaptureMemoryUsage;
+} RENDERDOC_API_1_6_0;
+
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_0_0;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_0_1;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_0_2;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_1_0;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_1_1;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_1_2;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_2_0;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_3_0;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_4_0;
+typedef RENDERDOC_API_1_6_0 RENDERDOC_API_1_5_0;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // RenderDoc API entry point
@@ -381,6 +381,7 @@ std::string GraphicsTest::dataRoot;
 int GraphicsTest::screenWidth = 400;
 int GraphicsTest::screenHeight = 300;
 bool GraphicsTest::debugDevice = false;
+std::string GraphicsTest::benchmarkReport;
 
 void GraphicsTest::Prepare(int argc, char **argv)
 {
@@ -411,6 +412,11 @@ void GraphicsTest::Prepare(int argc, char **argv)
       maxFrameCount = atoi(argv[i + 1]);
     }
 
+    if(i + 1 < argc && !strcmp(argv[i], "--benchmark"))
+    {
+      benchmarkReport = argv[i + 1];
+    }
+
     if(i + 1 < argc && (!strcmp(argv[i], "--width") || !strcmp(argv[i], "-w")))
     {
       screenWidth = atoi(argv[i + 1]);
@@ -479,6 +485,22 @@ std::string GraphicsTest::GetDataPath(const std::string &filename)
 
 bool GraphicsTest::FrameLimit()
 {
+  if(!benchmarkReport.empty())
+  {
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+
+    // the first call is before any frame has been rendered, so there's nothing to record
+    if(curFrame >= 0)
+      frameTimes.push_back(std::chrono::duration<double, std::milli>(now - lastFrameTime).count());
+
+    lastFrameTime = now;
+
+    // the capture starts at the previous present, so this tells us if the frame we're about to
+    // render is being captured
+    if(rdoc && rdoc->IsFrameCapturing())
+      capturedFrames.push_back(curFrame + 1);
+  }
+
   curFrame++;
   if(maxFrameCount > 0 && curFrame >= maxFrameCount)
     return false;
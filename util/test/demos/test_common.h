@@ -34,6 +34,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -174,6 +175,12 @@ struct GraphicsTest
 
   int curFrame = -1;
 
+  // per-frame CPU times in milliseconds, only recorded when benchmarking
+  std::vector<double> frameTimes;
+  // the frames which were being captured, if we're running under RenderDoc
+  std::vector<int> capturedFrames;
+  std::chrono::high_resolution_clock::time_point lastFrameTime;
+
   const char *screenTitle = "RenderDoc test program";
 
   bool headless = false;
@@ -186,6 +193,7 @@ struct GraphicsTest
   static int screenWidth;
   static int screenHeight;
   static bool debugDevice;
+  static std::string benchmarkReport;
 };
 
 enum class TestAPI
@@ -265,6 +273,7 @@ void RegisterTest(TestMetadata test);
 
 std::string GetCWD();
 std::string GetEnvVar(const char *var);
+uint64_t GetPeakMemoryUsage();
 
 #ifndef ARRAY_COUNT
 #define ARRAY_COUNT(arr) (sizeof(arr) / sizeof(arr[0]))
@@ -23,6 +23,9 @@
 ******************************************************************************/
 
 #include "../test_common.h"
+#include <psapi.h>
+
+#pragma comment(lib, "psapi.lib")
 
 std::string GetCWD()
 {
@@ -99,4 +102,15 @@ std::string GetEnvVar(const char *var)
     return Wide2UTF8(wval);
 
   return "";
-}
\ No newline at end of file
+}
+
+uint64_t GetPeakMemoryUsage()
+{
+  PROCESS_MEMORY_COUNTERS counters = {};
+  counters.cb = sizeof(counters);
+
+  if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return counters.PeakWorkingSetSize;
+
+  return 0;
+}
@@ -0,0 +1,281 @@
+import os
+import json
+import time
+import subprocess
+import renderdoc as rd
+from . import util
+from . import capture
+from . import analyse
+from . import testcase
+from .logging import log, TestFailureException
+
+
+def _wait_for_report(path: str, timeout: int):
+    start_time = time.time()
+
+    # The demos program renames the report into place once it's fully written, so as soon as it exists we can read it
+    while not os.path.exists(path):
+        if time.time() - start_time > timeout:
+            raise RuntimeError("Timed out waiting for benchmark report {}".format(util.sanitise_filename(path)))
+        time.sleep(0.5)
+
+    with open(path, 'r') as f:
+        return json.load(f)
+
+
+def frame_time_stats(frame_times: list):
+    """
+    Calculates summary statistics over a list of frame times.
+
+    :param frame_times: The frame times in milliseconds.
+    :return: A dict with the mean, median, min, max and 95th percentile frame times.
+    """
+    if len(frame_times) == 0:
+        return {'mean': 0.0, 'median': 0.0, 'min': 0.0, 'max': 0.0, 'p95': 0.0}
+
+    ordered = sorted(frame_times)
+
+    return {
+        'mean': sum(ordered) / len(ordered),
+        'median': ordered[len(ordered) // 2],
+        'min': ordered[0],
+        'max': ordered[-1],
+        'p95': ordered[min(len(ordered) - 1, int(len(ordered) * 0.95))],
+    }
+
+
+def run_demo_benchmark(demos_test_name: str, frames: int, warmup: int = 10, inject: bool = True,
+                       capture_frame: int = None, opts=rd.GetDefaultCaptureOptions(), timeout: int = 300):
+    """
+    Runs a demos program with per-frame timing enabled, and returns the report it wrote.
+
+    :param demos_test_name: The demo to run.
+    :param frames: The number of frames to run the demo for.
+    :param warmup: The number of initial frames to exclude from the statistics.
+    :param inject: Whether to run the demo with RenderDoc injected.
+    :param capture_frame: If set, the frame to capture. Requires inject to be ``True``.
+    :param opts: The capture options to use when injecting.
+    :param timeout: The timeout in seconds to wait for the demo to finish.
+    :return: A dict containing the report, with added 'stats' for frames outside of the warmup
+      and not being captured, and 'capture_path' if a capture was made.
+    """
+    mode = 'native'
+    if inject:
+        mode = 'capture' if capture_frame is not None else 'idle'
+        if mode == 'idle' and opts.retroactiveFrames > 0:
+            mode = 'retroactive'
+
+    report_path = util.get_tmp_path('benchmark_{}_{}.json'.format(demos_test_name, mode))
+
+    if os.path.exists(report_path):
+        os.remove(report_path)
+
+    cmdline = '{} --frames {} --benchmark "{}"'.format(demos_test_name, frames, report_path)
+
+    capture_path = None
+
+    if inject:
+        control = capture.TargetControl(capture.run_executable(util.get_demos_binary(), cmdline, opts=opts),
+                                        timeout=timeout, exit_kill=False)
+
+        if capture_frame is not None:
+            control.queue_capture(capture_frame)
+            control.run()
+
+            if len(control.captures()) == 0:
+                raise RuntimeError("No capture made while benchmarking {}".format(demos_test_name))
+
+            capture_path = control.captures()[0].path
+        else:
+            control.run(keep_running=lambda c: True)
+    else:
+        args = [util.get_demos_binary(), demos_test_name, '--frames', str(frames), '--benchmark', report_path]
+        subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=timeout)
+
+    report = _wait_for_report(report_path, timeout)
+
+    captured = report['captured_frames']
+    report['stats'] = frame_time_stats([t for i, t in enumerate(report['frame_times'])
+                                        if i >= warmup and i not in captured])
+
+    if len(captured) > 0:
+        report['captured_frame_times'] = [report['frame_times'][i] for i in captured
+                                          if i < len(report['frame_times'])]
+
+    report['capture_path'] = capture_path
+
+    return report
+
+
+def time_replay(capture_filename: str, opts=rd.ReplayOptions()):
+    """
+    Measures how long common replay operations take on a capture.
+
+    :param capture_filename: The capture to open.
+    :param opts: The replay options to use.
+    :return: A dict of timings in milliseconds, and the peak memory use sampled during replay.
+    """
+    results = {}
+    peak_memory = rd.GetCurrentProcessMemoryUsage()
+
+    def timed(name, callback):
+        nonlocal peak_memory
+        start_time = time.perf_counter()
+        ret = callback()
+        results[name] = (time.perf_counter() - start_time) * 1000.0
+        peak_memory = max(peak_memory, rd.GetCurrentProcessMemoryUsage())
+        return ret
+
+    controller: rd.ReplayController = timed('open_capture', lambda: analyse.open_capture(capture_filename, opts=opts))
+
+    draws = controller.GetDrawcalls()
+
+    first_draw: rd.DrawcallDescription = draws[0]
+    while len(first_draw.children) > 0:
+        first_draw = first_draw.children[0]
+
+    last_draw: rd.DrawcallDescription = draws[-1]
+    while len(last_draw.children) > 0:
+        last_draw = last_draw.children[-1]
+
+    # Jumping from the end to the start and back again forces a full replay from the beginning of the frame
+    timed('set_frame_event_last', lambda: controller.SetFrameEvent(last_draw.eventId, True))
+    timed('set_frame_event_first', lambda: controller.SetFrameEvent(first_draw.eventId, True))
+    timed('set_frame_event_last_again', lambda: controller.SetFrameEvent(last_draw.eventId, True))
+
+    tex = last_draw.copyDestination
+    if tex == rd.ResourceId.Null():
+        tex = controller.GetPipelineState().GetOutputTargets()[0].resourceId
+
+    if tex != rd.ResourceId.Null():
+        timed('get_texture_data', lambda: controller.GetTextureData(tex, 0, 0))
+
+        save_data = rd.TextureSave()
+        save_data.resourceId = tex
+        save_data.destType = rd.FileType.PNG
+
+        img_path = util.get_tmp_path('benchmark_save.png')
+        timed('save_texture', lambda: controller.SaveTexture(save_data, img_path))
+
+    timed('shutdown', lambda: controller.Shutdown())
+
+    results['peak_memory'] = peak_memory
+
+    return results
+
+
+def compare_to_baseline(results: dict, baseline: dict, tolerance: float):
+    """
+    Compares benchmark results against a baseline. Both are flat dicts of metric name to value, where lower
+    values are better.
+
+    :param results: The new results.
+    :param baseline: The baseline results.
+    :param tolerance: The fraction a metric can exceed the baseline by before it's considered a regression.
+    :return: A list of (name, result, baseline) tuples for each metric that regressed.
+    """
+    regressions = []
+
+    for name in sorted(baseline.keys()):
+        if name not in results:
+            continue
+
+        if results[name] > baseline[name] * (1.0 + tolerance):
+            regressions.append((name, results[name], baseline[name]))
+
+    return regressions
+
+
+class BenchmarkTestCase(testcase.TestCase):
+    """
+    A test which measures performance instead of correctness. The demo named by demos_test_name is run natively,
+    injected but idle, and injected while capturing. The capture that is made is then replayed to time common
+    operations.
+
+    Results are written to the artifacts folder and compared against the benchmark_baseline.json reference file,
+    if it exists.
+    """
+    benchmark_test = True
+    benchmark_frames = 300
+    benchmark_warmup = 30
+    benchmark_tolerance = 0.25
+    # If non-zero, the demo is also run injected with retroactive capture holding this many frames, to compare
+    # against running idle
+    benchmark_retroactive_frames = 0
+
+    def get_metrics(self):
+        native = run_demo_benchmark(self.demos_test_name, self.benchmark_frames, self.benchmark_warmup, inject=False)
+        idle = run_demo_benchmark(self.demos_test_name, self.benchmark_frames, self.benchmark_warmup, inject=True)
+        captured = run_demo_benchmark(self.demos_test_name, self.benchmark_frames, self.benchmark_warmup,
+                                      inject=True, capture_frame=self.benchmark_frames // 2,
+                                      opts=self.get_capture_options())
+
+        runs = [('native', native), ('idle', idle), ('capturing', captured)]
+
+        if self.benchmark_retroactive_frames > 0:
+            opts = self.get_capture_options()
+            opts.retroactiveFrames = self.benchmark_retroactive_frames
+            runs.append(('retroactive', run_demo_benchmark(self.demos_test_name, self.benchmark_frames,
+                                                           self.benchmark_warmup, inject=True, opts=opts)))
+
+        metrics = {}
+
+        for name, report in runs:
+            for stat in ['mean', 'median', 'p95']:
+                metrics['{}_frame_{}'.format(name, stat)] = report['stats'][stat]
+            metrics['{}_peak_memory'.format(name)] = report['peak_memory']
+
+        if 'captured_frame_times' in captured:
+            metrics['capture_frame_time'] = max(captured['captured_frame_times'])
+
+        replay = time_replay(captured['capture_path'], opts=self.get_replay_options())
+
+        for name in replay:
+            metrics['replay_{}'.format(name)] = replay[name]
+
+        return metrics
+
+    def run(self):
+        metrics = self.get_metrics()
+
+        native_mean = metrics['native_frame_mean']
+        if native_mean > 0.0:
+            log.print("Idle injected overhead is {:.2f}%, capturing overhead is {:.2f}%"
+                      .format((metrics['idle_frame_mean'] / native_mean - 1.0) * 100.0,
+                              (metrics['capturing_frame_mean'] / native_mean - 1.0) * 100.0))
+
+        idle_mean = metrics['idle_frame_mean']
+        if 'retroactive_frame_mean' in metrics and idle_mean > 0.0:
+            log.print("Retroactive capture overhead is {:.2f}% compared to idle"
+                      .format((metrics['retroactive_frame_mean'] / idle_mean - 1.0) * 100.0))
+
+        for name in sorted(metrics.keys()):
+            log.print("{}: {}".format(name, metrics[name]))
+
+        os.makedirs(util.get_artifact_path('benchmarks'), exist_ok=True)
+        result_path = util.get_artifact_path(os.path.join('benchmarks', '{}.json'.format(self.__class__.__name__)))
+
+        with open(result_path, 'w') as f:
+            json.dump(metrics, f, indent=2, sort_keys=True)
+
+        baseline_path = self.get_ref_path('benchmark_baseline.json')
+
+        if not os.path.exists(baseline_path):
+            log.print("No baseline found at {}, results can be used as a new baseline"
+                      .format(util.sanitise_filename(baseline_path)))
+            return
+
+        with open(baseline_path, 'r') as f:
+            baseline = json.load(f)
+
+        regressions = compare_to_baseline(metrics, baseline, self.benchmark_tolerance)
+
+        for name, result, base in regressions:
+            log.error("{} regressed: {} compared to baseline {}".format(name, result, base))
+
+        if len(regressions) > 0:
+            raise TestFailureException("{} metrics regressed by more than {:.0f}% compared to baseline"
+                                       .format(len(regressions), self.benchmark_tolerance * 100.0),
+                                       baseline_path, result_path)
+
+        log.success("All metrics are within {:.0f}% of baseline".format(self.benchmark_tolerance * 100.0))
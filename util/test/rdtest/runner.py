@@ -11,6 +11,7 @@ import time
 import renderdoc as rd
 from . import util
 from . import testcase
+from . import benchmark
 from .logging import log
 
 
@@ -20,10 +21,11 @@ def get_tests():
     for m in sys.modules.values():
         for name in m.__dict__:
             obj = m.__dict__[name]
-            if isinstance(obj, type) and issubclass(obj, testcase.TestCase) and obj != testcase.TestCase:
+            if isinstance(obj, type) and issubclass(obj, testcase.TestCase) and \
+                    obj not in [testcase.TestCase, benchmark.BenchmarkTestCase]:
                 testcases.append(obj)
 
-    testcases.sort(key=lambda t: (t.slow_test,t.__name__))
+    testcases.sort(key=lambda t: (t.benchmark_test,t.slow_test,t.__name__))
 
     return testcases
 
@@ -153,7 +155,8 @@ def fetch_tests():
     return { x[0]: (x[1] == 'True', x[2]) for x in split_tests }
 
 
-def run_tests(test_include: str, test_exclude: str, in_process: bool, slow_tests: bool, debugger: bool):
+def run_tests(test_include: str, test_exclude: str, in_process: bool, slow_tests: bool, benchmarks: bool,
+              debugger: bool):
     start_time = time.time()
 
     rd.InitGlobalEnv(rd.GlobalEnvironment(), [])
@@ -292,6 +295,14 @@ def run_tests(test_include: str, test_exclude: str, in_process: bool, slow_tests
             skippedcases.append(testclass)
             continue
 
+        if benchmarks != testclass.benchmark_test:
+            if benchmarks:
+                log.print("Skipping {} as it is not a benchmark".format(name))
+            else:
+                log.print("Skipping {} as it is a benchmark, which are not enabled".format(name))
+            skippedcases.append(testclass)
+            continue
+
         # Print header (and footer) outside the exec so we know they will always be printed successfully
         log.begin_test(name)
 
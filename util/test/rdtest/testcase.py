@@ -127,6 +127,7 @@ class ConstantBufferChecker:
 
 class TestCase:
     slow_test = False
+    benchmark_test = False
     demos_test_name = ''
     demos_frame_cap = 5
     _test_list = {}
@@ -19,6 +19,8 @@ parser.add_argument('--in-process',
                     help="Lists the tests available to run", action="store_true")
 parser.add_argument('--slow-tests',
                     help="Run potentially slow tests", action="store_true")
+parser.add_argument('--benchmarks',
+                    help="Run only benchmark tests, which measure capture overhead and replay timings", action="store_true")
 parser.add_argument('--data', default=os.path.join(script_dir, "data"),
                     help="The folder that reference data is in. Will not be modified.", type=str)
 parser.add_argument('--demos-binary', default="",
@@ -113,4 +115,5 @@ if args.internal_vulkan_register:
 elif args.internal_run_test is not None:
     rdtest.internal_run_test(args.internal_run_test)
 else:
-    rdtest.run_tests(args.test_include, args.test_exclude, args.in_process, args.slow_tests, args.debugger)
+    rdtest.run_tests(args.test_include, args.test_exclude, args.in_process, args.slow_tests, args.benchmarks,
+                     args.debugger)
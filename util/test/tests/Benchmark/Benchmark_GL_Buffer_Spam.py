@@ -0,0 +1,5 @@
+import rdtest
+
+
+class Benchmark_GL_Buffer_Spam(rdtest.BenchmarkTestCase):
+    demos_test_name = 'GL_Buffer_Spam'
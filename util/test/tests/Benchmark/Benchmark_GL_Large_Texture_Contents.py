@@ -0,0 +1,8 @@
+import rdtest
+
+
+class Benchmark_GL_Large_Texture_Contents(rdtest.BenchmarkTestCase):
+    demos_test_name = 'GL_Large_Texture_Contents'
+    # each frame samples a lot of texture data, so run fewer frames than usual
+    benchmark_frames = 120
+    benchmark_warmup = 10
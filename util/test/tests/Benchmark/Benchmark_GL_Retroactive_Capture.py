@@ -0,0 +1,6 @@
+import rdtest
+
+
+class Benchmark_GL_Retroactive_Capture(rdtest.BenchmarkTestCase):
+    demos_test_name = 'GL_Simple_Triangle'
+    benchmark_retroactive_frames = 8
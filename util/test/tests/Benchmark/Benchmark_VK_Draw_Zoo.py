@@ -0,0 +1,5 @@
+import rdtest
+
+
+class Benchmark_VK_Draw_Zoo(rdtest.BenchmarkTestCase):
+    demos_test_name = 'VK_Draw_Zoo'
@@ -0,0 +1,5 @@
+import rdtest
+
+
+class Benchmark_VK_Multi_Thread_Windows(rdtest.BenchmarkTestCase):
+    demos_test_name = 'VK_Multi_Thread_Windows'
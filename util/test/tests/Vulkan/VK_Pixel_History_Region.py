@@ -0,0 +1,87 @@
+import renderdoc as rd
+import rdtest
+
+
+class VK_Pixel_History_Region(rdtest.TestCase):
+    demos_test_name = 'VK_Simple_Triangle'
+
+    def check_region(self, tex: rd.ResourceId, clear: rd.DrawcallDescription, draw: rd.DrawcallDescription,
+                     x: int, y: int, width: int, height: int):
+        region: rd.PixelRegionHistory = self.controller.PixelHistoryRegion(tex, x, y, width, height, 0, 0, 0,
+                                                                           rd.CompType.Typeless)
+
+        self.check(region.x == x and region.y == y and region.width == width and region.height == height)
+        offsets = region.offsets
+        modifications = region.modifications
+
+        self.check(len(offsets) == width * height + 1)
+        self.check(offsets[0] == 0)
+        self.check(offsets[width * height] == len(modifications))
+
+        inside = 0
+
+        for py in range(height):
+            for px in range(width):
+                idx = py * width + px
+                self.check(offsets[idx] <= offsets[idx + 1])
+
+                mods = modifications[offsets[idx]:offsets[idx + 1]]
+                events = [m.eventId for m in mods]
+
+                self.check(clear.eventId in events,
+                           "Clear missing from history of {},{}: {}".format(x + px, y + py, events))
+
+                picked = self.controller.PickPixel(tex, False, x + px, y + py, 0, 0, 0)
+
+                # the triangle didn't touch this pixel if it still has the clear colour
+                clear_mod = mods[events.index(clear.eventId)]
+                if rdtest.value_compare(picked.floatValue, clear_mod.postMod.col.floatValue, eps=1.0/255.0):
+                    self.check(draw.eventId not in events,
+                               "Draw listed for untouched pixel {},{}".format(x + px, y + py))
+                    continue
+
+                inside += 1
+
+                self.check(draw.eventId in events,
+                           "Draw missing from history of {},{}: {}".format(x + px, y + py, events))
+
+                draw_mod = mods[events.index(draw.eventId)]
+
+                if not rdtest.value_compare(picked.floatValue, draw_mod.postMod.col.floatValue, eps=1.0/255.0):
+                    raise rdtest.TestFailureException("History value {} at {},{} doesn't match picked value {}"
+                                                      .format(draw_mod.postMod.col.floatValue, x + px, y + py,
+                                                              picked.floatValue))
+
+        return inside
+
+    def check_capture(self):
+        clear = self.find_draw("vkCmdClearColorImage")
+        draw = self.find_draw("Draw")
+
+        self.check(clear is not None and draw is not None)
+
+        self.controller.SetFrameEvent(draw.eventId, False)
+
+        tex = self.controller.GetPipelineState().GetOutputTargets()[0].resourceId
+        tex_details = self.get_texture(tex)
+
+        cx = tex_details.width // 2
+        cy = tex_details.height // 2
+
+        # a tile in the middle of the triangle, which every pixel of should be covered
+        inside = self.check_region(tex, clear, draw, cx - 8, cy - 8, 16, 16)
+        self.check(inside == 16 * 16)
+
+        rdtest.log.success("Region inside the triangle has the expected history")
+
+        # a tile in the corner the triangle never reaches
+        inside = self.check_region(tex, clear, draw, 0, 0, 16, 16)
+        self.check(inside == 0)
+
+        rdtest.log.success("Region outside the triangle has the expected history")
+
+        # a tile straddling the triangle's top vertex, with pixels on both sides of the edges
+        inside = self.check_region(tex, clear, draw, cx - 8, tex_details.height // 4 - 4, 16, 16)
+        self.check(0 < inside < 16 * 16)
+
+        rdtest.log.success("Region on the triangle's edge has the expected history")